@@ -54,7 +54,15 @@ namespace lbann {
  *      or a subset of the weights? Hyperparameters?
  *    - Can this be used to explore model architectures?
  *
- *  @todo Exchange optimizer state.
+ *  Tournaments can be made cheaper in several ways. Models can be
+ *  scored on a fixed subset of the validation set, a trainer can
+ *  trust the score its partner computed for its own model instead of
+ *  evaluating the partner model itself, and the model exchange can be
+ *  posted with non-blocking communication and completed at the next
+ *  tournament, so that it overlaps with training. In the asynchronous
+ *  mode, the tournament winner is chosen when the exchange completes
+ *  and compares the scores from when the exchange was posted.
+ *
  *  @todo Support heterogeneous models.
  */
 class lbann_callback_ltfb : public lbann_callback {
@@ -75,8 +83,8 @@ public:
      *    - Requires all models to be identical aside from their
      *      weights values, so this is not suitable for hyperparameter
      *      or model architecture exploration.
-     *    - Optimizer state is not exchanged, so there may be wonky
-     *      learning behavior immediately after a tournament.
+     *    - Optimizer state is exchanged, but optimizer
+     *      hyperparameters are only exchanged if requested.
      *    - Optimal if communication performance between ranks is
      *      uniform and independent. If intra-trainer communication is
      *      fast or if communication performance is sensitive to
@@ -86,19 +94,18 @@ public:
      */
     sendrecv_weights,
 
-    /** Save and load model data with checkpoint files.
+    /** Exchange in-memory model checkpoints.
      *
-     *  @todo Implement.
+     *  Each rank packs its local portion of every weights' values,
+     *  optimizer state, and optimizer hyperparameters into a
+     *  contiguous buffer and exchanges it with the corresponding rank
+     *  in the partner trainer. Nothing goes through the file system.
      *
      *  Notes:
      *    - Supports hyperparameter exploration.
-     *    - Checkpoint files currently do not store model architecture
+     *    - The checkpoint does not store model architecture
      *      information, so this is not suitable for model
      *      architecture exploraiton.
-     *    - This approach is temporary and experimental, since going
-     *      through the file system is very suboptimal. When a wire
-     *      format for model checkpoints is developed, it should be
-     *      used instead.
      */
     checkpoint_file
   };
@@ -112,6 +119,19 @@ public:
    *  @param low_score_wins Whether low-scoring or high-scoring models
    *                        survive a tournament.
    *  @param comm_algo      Inter-trainer communication scheme.
+   *  @param exchange_hyperparameters
+   *                        Whether to exchange optimizer
+   *                        hyperparameters with sendrecv_weights.
+   *  @param eval_subset_batches
+   *                        Number of validation mini-batches used to
+   *                        score models. If zero, the full validation
+   *                        set is used.
+   *  @param reuse_partner_score
+   *                        Whether to use the score the partner
+   *                        computed for its own model instead of
+   *                        evaluating the partner model locally.
+   *  @param async_exchange Whether to overlap the model exchange with
+   *                        training until the next tournament.
    *  @param summarizer     The summarizer to use for this callback
    */
   lbann_callback_ltfb(
@@ -121,6 +141,9 @@ public:
     bool low_score_wins = false,
     communication_algorithm comm_algo = communication_algorithm::sendrecv_weights,
     bool exchange_hyperparameters = false,
+    El::Int eval_subset_batches = 0,
+    bool reuse_partner_score = false,
+    bool async_exchange = false,
     lbann_summary *summarizer = nullptr);
   lbann_callback_ltfb(const lbann_callback_ltfb& other);
   lbann_callback_ltfb& operator=(const lbann_callback_ltfb& other);
@@ -130,6 +153,7 @@ public:
   void setup(model *m) override;
   void on_train_begin(model *m) override;
   void on_batch_begin(model *m) override;
+  void on_train_end(model *m) override;
 
   /** Convert string to LTFB communication algorithm.
    *
@@ -160,12 +184,51 @@ private:
   */
   bool m_exchange_hyperparameters;
 
+  /** Number of validation mini-batches used to score models.
+   *
+   *  If zero, the full validation set is used.
+   */
+  El::Int m_eval_subset_batches;
+
+  /** Whether to use the partner's score for its own model. */
+  bool m_reuse_partner_score;
+
+  /** Whether to complete model exchanges at the next tournament. */
+  bool m_async_exchange;
+
   /** Workspace weights.
    *
    *  Used to temporarily store local weights during a tournament.
    */
   std::vector<std::unique_ptr<weights>> m_workspace_weights;
 
+  /** Validation data orderings used for subset evaluation.
+   *
+   *  One entry per input layer. Captured at the first tournament so
+   *  that every tournament scores models on the same samples.
+   */
+  std::vector<std::vector<int>> m_eval_subset_indices;
+
+  /** Packed local model data sent to the partner trainer. */
+  std::vector<El::byte> m_send_buffer;
+  /** Packed partner model data received from the partner trainer. */
+  std::vector<El::byte> m_recv_buffer;
+  /** Requests for an outstanding model exchange. */
+  std::vector<El::mpi::Request<El::byte>> m_exchange_requests;
+  /** Whether a model exchange has been posted but not completed. */
+  bool m_exchange_pending = false;
+  /** Partner trainer for the outstanding model exchange. */
+  El::Int m_pending_partner_trainer = 0;
+  /** Local score for the outstanding model exchange. */
+  EvalType m_pending_local_score = 0;
+
+  /** Pack local model data and post the exchange with the partner. */
+  void start_exchange(model& m, El::Int partner_trainer, EvalType local_score);
+  /** Wait for the model exchange and choose the tournament winner. */
+  void finish_exchange(model& m, const std::string& message_prefix);
+  /** Score the current model on the validation set. */
+  EvalType evaluate(model& m);
+
 };
 
 } // namespace lbann
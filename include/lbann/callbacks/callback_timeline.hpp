@@ -31,20 +31,34 @@
 
 #include <unordered_map>
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/utils/trace.hpp"
 
 namespace lbann {
 
 /**
  * Record a timeline of training runtime on each rank and output it to a
- * logfile for external processing.
- * The logfile is named timeline.m\<model-rank\>.\<rank\>.txt.
- * Each line is a separate event, written as name:start-time:end-time.
- * Times are relative to the beginning of training.
+ * trace file for external processing.
+ * The trace file is named timeline.m\<model-rank\>.\<rank\>.trace.
+ * Layer forward/backward passes and optimizer steps are recorded by
+ * this callback. While it is active, communication, I/O thread pool
+ * jobs, and data store exchanges are recorded as well (see tracer).
+ * Traces are streamed to disk during training and can be combined
+ * into a Chrome trace with lbann_trace2chrome.
  */
 class lbann_callback_timeline : public lbann_callback {
  public:
-  lbann_callback_timeline(std::string outdir) : lbann_callback(1),
-                                                m_outdir(outdir) {}
+  /**
+   * @param outdir Directory to write trace files to.
+   * @param flush_interval Time between streaming writes (seconds).
+   * @param buffer_size Events buffered per thread between writes.
+   */
+  lbann_callback_timeline(std::string outdir,
+                          double flush_interval = 1.0,
+                          size_t buffer_size = 65536)
+    : lbann_callback(1),
+      m_outdir(outdir),
+      m_flush_interval(flush_interval),
+      m_buffer_size(buffer_size) {}
   lbann_callback_timeline(const lbann_callback_timeline&) = default;
   lbann_callback_timeline& operator=(const lbann_callback_timeline&) = default;
   lbann_callback_timeline* copy() const override {
@@ -60,6 +74,8 @@ class lbann_callback_timeline : public lbann_callback {
   using lbann_callback::on_backward_prop_end;
   using lbann_callback::on_optimize_begin;
   using lbann_callback::on_optimize_end;
+  using lbann_callback::on_evaluate_forward_prop_begin;
+  using lbann_callback::on_evaluate_forward_prop_end;
 
   void on_forward_prop_begin(model *m, Layer *l) override;
   void on_forward_prop_end(model *m, Layer *l) override;
@@ -67,24 +83,26 @@ class lbann_callback_timeline : public lbann_callback {
   void on_backward_prop_end(model *m, Layer *l) override;
   void on_optimize_begin(model *m, weights *w) override;
   void on_optimize_end(model *m, weights *w) override;
+  void on_evaluate_forward_prop_begin(model *m, Layer *l) override;
+  void on_evaluate_forward_prop_end(model *m, Layer *l) override;
  private:
-  /// Get time relative to the start time.
-  EvalType get_rel_time() const { return get_time() - m_start_time; }
+  /// Get the interned trace name for a layer or weights.
+  std::uint32_t get_name_id(const std::string& name);
 
   /// Directory to write output to.
   std::string m_outdir;
-  /// Time training started; all times are relative to this.
-  EvalType m_start_time = EvalType(0);
+  /// Time between streaming writes (seconds).
+  double m_flush_interval;
+  /// Events buffered per thread between writes.
+  size_t m_buffer_size;
   /// Time the current layer's forward pass started.
-  EvalType m_fp_start_time = EvalType(0);
+  std::uint64_t m_fp_start_time = 0;
   /// Time the current layer's backward pass started.
-  EvalType m_bp_start_time = EvalType(0);
+  std::uint64_t m_bp_start_time = 0;
   /// Time the current weights' optimization pass started.
-  EvalType m_opt_start_time = EvalType(0);
-  /// Store (relative) timing information.
-  std::unordered_map<std::string, std::vector<std::pair<EvalType, EvalType>>> m_fp_times;
-  std::unordered_map<std::string, std::vector<std::pair<EvalType, EvalType>>> m_bp_times;
-  std::unordered_map<std::string, std::vector<std::pair<EvalType, EvalType>>> m_opt_times;
+  std::uint64_t m_opt_start_time = 0;
+  /// Interned trace names for layers and weights.
+  std::unordered_map<std::string, std::uint32_t> m_name_ids;
 };
 
 }  // namespace lbann
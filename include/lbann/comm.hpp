@@ -31,6 +31,7 @@
 #include <map>
 #include <typeindex>
 #include "base.hpp"
+#include "lbann/utils/trace.hpp"
 #ifdef LBANN_HAS_CUDA
 #include <cuda_runtime.h>
 #endif // LBANN_HAS_CUDA
@@ -666,6 +667,7 @@ class lbann_comm {
   /** Scalar-array allreduce. */
   template <typename T>
   void allreduce(T *snd, int count, T *rcv, const El::mpi::Comm& c, El::mpi::Op op = El::mpi::SUM) {
+    LBANN_TRACE_SCOPE(trace_category::comm, "allreduce");
     auto const size_c = El::mpi::Size(c);
     bytes_sent += count * sizeof(T);
 #ifdef LBANN_HAS_ALUMINUM
@@ -685,6 +687,7 @@ class lbann_comm {
   /** In-place scalar-array allreduce. */
   template <typename T>
   void allreduce(T *data, int count, const El::mpi::Comm& c, El::mpi::Op op = El::mpi::SUM) {
+    LBANN_TRACE_SCOPE(trace_category::comm, "allreduce");
     auto const size_c = El::mpi::Size(c);
     bytes_sent += count * sizeof(T);
 #ifdef LBANN_HAS_ALUMINUM
@@ -709,6 +712,12 @@ class lbann_comm {
   void allreduce(AbsDistMat& m,
                  const El::mpi::Comm& c,
                  El::mpi::Op op = El::mpi::SUM);
+  /** Allreduce packed softmax statistics.
+   *  Each column of stats is a tuple of statistics that is combined
+   *  with softmax_stats_op (see online_softmax.hpp), so max and sum
+   *  are reduced in one message. stats must be contiguous.
+   */
+  void allreduce_softmax_stats(AbsMat& stats, const El::mpi::Comm& c);
   /** Non-blocking matrix allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a
    *  blocking matrix allreduce.
@@ -733,6 +742,7 @@ class lbann_comm {
   template <typename T>
   void nb_allreduce(T *data, int count, const El::mpi::Comm& c, Al::request& req,
                     El::mpi::Op op = El::mpi::SUM) {
+    LBANN_TRACE_SCOPE(trace_category::comm, "nb_allreduce");
 #ifdef LBANN_HAS_ALUMINUM
     bytes_sent += count * sizeof(T);
     req.mpi_req = Al::mpi_null_req;
@@ -923,6 +933,17 @@ class lbann_comm {
     sendrecv(snd, send_count, send_trainer, rank_in_trainer,
              rcv, recv_count, recv_trainer, rank_in_trainer, syncInfo);
   }
+  /** Send/recv to/from ranks in an arbitrary communicator. */
+  template <typename T>
+  void sendrecv(const T *snd, int send_count, int send_rank,
+                T *rcv, int recv_count, int recv_rank,
+                const El::mpi::Comm& c) {
+    bytes_sent += sizeof(T) * send_count;
+    bytes_received += sizeof(T) * recv_count;
+    El::mpi::SendRecv(snd, send_count, send_rank,
+                      rcv, recv_count, recv_rank,
+                      c, El::SyncInfo<El::Device::CPU>{});
+  }
 
   /** Determine the size (count) of an incoming message. */
   template <typename T> int get_count(int trainer, int rank) {
@@ -1039,6 +1060,8 @@ class lbann_comm {
    *  num_threads directive has not been provided.
    */
   int threads_per_proc;
+  /** MPI reduction operation for packed softmax statistics. */
+  MPI_Op softmax_stats_mpi_op;
 
 #ifdef LBANN_HAS_ALUMINUM
   /** Convert an MPI_Op to an Aluminum reduction operator. */
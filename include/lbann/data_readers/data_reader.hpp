@@ -496,6 +496,11 @@ class generic_data_reader {
   }
   /// Get the next position in the data reader.
   int get_next_position() const;
+  /**
+   * Get the sample indices this rank will load in its next mini-batch
+   * (empty if the epoch ends first).
+   */
+  std::vector<int> get_next_mini_batch_indices() const;
   /// Get a pointer to the start of the shuffled indices.
   int *get_indices() {
     return &m_shuffled_indices[0];
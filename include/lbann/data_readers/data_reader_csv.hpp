@@ -30,6 +30,8 @@
 #define LBANN_DATA_READER_CSV_HPP
 
 #include "data_reader.hpp"
+#include "lbann/utils/mapped_file.hpp"
+#include <memory>
 #include <unordered_map>
 
 namespace lbann {
@@ -73,6 +75,27 @@ class csv_reader : public generic_data_reader {
   void set_skip_rows(int rows) { m_skip_rows = rows; }
   /// Set whether the CSV file has a header; default true.
   void set_has_header(bool b) { m_has_header = b; }
+  /**
+   * Memory-map the CSV file; default false.
+   * The line index is built in parallel, and lines are parsed straight from
+   * the mapping into the mini-batch matrix with a fast number parser.
+   */
+  void set_mmap(bool b) { m_mmap = b; }
+  /**
+   * Use a binary cache of the parsed data; default false.
+   * On first load, the world master parses the whole CSV file and writes the
+   * parsed values, labels, and responses to a cache file. Later loads map the
+   * cache and skip text parsing entirely. The cache is rebuilt if the CSV
+   * file or the parsing options change. It is not rebuilt if custom column,
+   * label, or response transforms change, so delete it in that case.
+   * @param b Whether to use the cache.
+   * @param dir Directory for the cache file. Defaults to the CSV file's
+   * directory.
+   */
+  void set_binary_cache(bool b, const std::string& dir = "") {
+    m_binary_cache = b;
+    m_binary_cache_dir = dir;
+  }
 
   /**
    * Supply a custom transform to convert an input string to a numerical value.
@@ -106,12 +129,26 @@ class csv_reader : public generic_data_reader {
 
   int get_num_labels() const override { return m_num_labels; }
   int get_linearized_data_size() const override {
-    // Account for label and skipped columns.
-    if (m_label_col < m_skip_cols) {
-      return m_num_cols - m_skip_cols;
-    } else {
-      return m_num_cols - 1 - m_skip_cols;
+    return get_num_data_cols(m_num_cols, m_skip_cols,
+                             m_disable_labels ? -1 : m_label_col,
+                             m_disable_responses ? -1 : m_response_col);
+  }
+  /**
+   * Number of columns that are parsed as data, i.e. that are not
+   * skipped and are not the label or response column. Pass -1 for a
+   * disabled label or response column.
+   */
+  static int get_num_data_cols(int num_cols, int skip_cols,
+                               int label_col, int response_col) {
+    int num_data_cols = num_cols - skip_cols;
+    if (label_col >= skip_cols && label_col < num_cols) {
+      --num_data_cols;
     }
+    if (response_col >= skip_cols && response_col < num_cols
+        && response_col != label_col) {
+      --num_data_cols;
+    }
+    return num_data_cols;
   }
   int get_linearized_label_size() const override {
     return m_num_labels;
@@ -150,6 +187,19 @@ class csv_reader : public generic_data_reader {
   /// Initialize the ifstreams vector.
   void setup_ifstreams();
 
+  /// Load a memory-mapped CSV file or its binary cache.
+  void load_mapped();
+  /// Map the CSV file and build the line index, labels, and responses.
+  void index_mapped_file(const std::string& path);
+  /// Parse a line of the mapped CSV file, without the label and response.
+  void parse_mapped_line(int data_id, DataType* out);
+  /// Path of the binary cache file.
+  std::string get_binary_cache_filename() const;
+  /// Map the binary cache; returns false if it is missing or stale.
+  bool open_binary_cache(const std::string& path);
+  /// Parse the mapped CSV file and write the binary cache.
+  void write_binary_cache(const std::string& path);
+
   /** Return a raw line from the CSV file.
    *  (Made public to support data store functionality)
    */
@@ -181,6 +231,18 @@ class csv_reader : public generic_data_reader {
   int m_num_samples = 0;
   /// Number of label classes.
   int m_num_labels = 0;
+  /// Whether to memory-map the CSV file.
+  bool m_mmap = false;
+  /// Whether to use a binary cache of the parsed data.
+  bool m_binary_cache = false;
+  /// Directory for the binary cache (empty for the CSV file's directory).
+  std::string m_binary_cache_dir;
+  /// Memory-mapped CSV file.
+  std::shared_ptr<const mapped_file> m_file;
+  /// Memory-mapped binary cache.
+  std::shared_ptr<const mapped_file> m_cache;
+  /// Parsed data in the binary cache (one contiguous row per sample).
+  const DataType* m_cache_data = nullptr;
   /// Input file streams (per-thread).
   std::vector<std::ifstream*> m_ifstreams;
   /**
@@ -31,6 +31,7 @@
 
 #include "data_reader.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
+#include "lbann/utils/packed_dataset.hpp"
 
 namespace lbann {
 class image_data_reader : public generic_data_reader {
@@ -52,9 +53,21 @@ class image_data_reader : public generic_data_reader {
    */
   virtual void set_input_params(const int width=0, const int height=0, const int num_ch=0, const int num_labels=0);
 
+  /** Set how packed datasets are read.
+   *  If the data file is a packed dataset index (see packed_dataset),
+   *  samples are read from its shard files, optionally with O_DIRECT
+   *  or with readahead hints.
+   */
+  void set_packed_dataset_io(bool direct_io, bool readahead) {
+    m_packed_direct_io = direct_io;
+    m_packed_readahead = readahead;
+  }
+
   // dataset specific functions
   void load() override;
 
+  int fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) override;
+
   void setup(int num_io_threads, std::shared_ptr<thread_pool> io_thread_pool) override;
 
   int get_num_labels() const override {
@@ -116,6 +129,19 @@ class image_data_reader : public generic_data_reader {
 
   void load_conduit_node_from_file(int data_id, conduit::Node &node);
 
+  /** Load the encoded image for a sample, either from its own file or
+   *  from a packed dataset. The matrix may refer to memory owned by
+   *  the packed dataset that is valid until the next mini-batch.
+   */
+  void load_encoded_sample(int data_id, El::Matrix<uint8_t>& encoded);
+
+  /** Packed dataset that holds the images, if any. */
+  std::unique_ptr<packed_dataset> m_packed_dataset;
+  /** Whether to read packed datasets with O_DIRECT. */
+  bool m_packed_direct_io = false;
+  /** Whether to hint readahead when reading packed datasets. */
+  bool m_packed_readahead = true;
+
 };
 
 }  // namespace lbann
@@ -178,6 +178,14 @@ class data_reader_jag_conduit : public generic_data_reader {
   bool has_list_per_model() const { return m_list_per_model; }
   bool has_list_per_trainer() const { return m_list_per_trainer; }
 
+  /**
+   * Shuffle samples within windows of this many files; default 0 (full
+   * shuffle). See sample_list_open_files::shuffle_with_file_locality.
+   */
+  void set_locality_shuffle_window(size_t files) { m_locality_shuffle_window = files; }
+  /// Number of sample files opened by this rank in each completed epoch
+  const std::vector<size_t>& get_file_opens_per_epoch() const { return m_file_opens_per_epoch; }
+
 
   /// Fetch data of a mini-batch or reuse it from the cache of the leading reader
   int fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) override;
@@ -361,6 +369,12 @@ class data_reader_jag_conduit : public generic_data_reader {
   /// Obtain image data
   std::vector< std::vector<DataType> > get_image_data(const size_t i, conduit::Node& sample) const;
 
+  /** Return the leaf of sample i that holds a field, loading it into the
+   *  sample node first if needed. The returned node is only valid while
+   *  sample is not modified.
+   */
+  conduit::Node& get_conduit_leaf(const size_t i, conduit::Node& sample, const std::string& conduit_field) const;
+
   bool data_store_active() const {
     bool flag = generic_data_reader::data_store_active();
     return (m_data_store != nullptr && flag);
@@ -391,6 +405,13 @@ class data_reader_jag_conduit : public generic_data_reader {
 
   /// Whether data have been loaded
   bool m_is_data_loaded;
+  /**
+   * Index of the first sample in this rank's part of the sample list.
+   * The keys and images are checked against this sample, since its
+   * file is the one opened during load. With a shared index, sample 0
+   * may be in a file that this rank never opens.
+   */
+  size_t m_first_local_sample;
 
   int m_num_labels; ///< number of labels
 
@@ -464,6 +485,10 @@ class data_reader_jag_conduit : public generic_data_reader {
   sample_list_t m_sample_list;
   bool m_list_per_trainer;
   bool m_list_per_model;
+  /// Number of files per window for locality-aware shuffling (0 to disable)
+  size_t m_locality_shuffle_window;
+  /// Number of sample files opened by this rank in each completed epoch
+  std::vector<size_t> m_file_opens_per_epoch;
 };
 
 /**
@@ -30,6 +30,7 @@
 #define LBANN_DATA_READER_NUMPY_HPP
 
 #include "data_reader.hpp"
+#include "lbann/utils/mapped_npy.hpp"
 #include <cnpy.h>
 
 namespace lbann {
@@ -60,15 +61,22 @@ class numpy_reader : public generic_data_reader {
   void set_has_labels(bool b) { m_has_labels = b; }
   /// Set whether to fetch responses.
   void set_has_responses(bool b) { m_has_responses = b; }
+  /**
+   * Memory-map the file instead of loading it; default false.
+   * Only the rows that are fetched are read from disk.
+   */
+  void set_mmap(bool b) { m_mmap = b; }
 
   void load() override;
 
+  int fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) override;
+
   int get_num_labels() const override { return m_num_labels; }
   int get_linearized_data_size() const override { return m_num_features; }
   int get_linearized_label_size() const override { return m_num_labels; }
   const std::vector<int> get_data_dims() const override {
-    std::vector<int> dims(m_data.shape.begin() + 1,
-                          m_data.shape.end());
+    const auto& shape = m_mapped.is_open() ? m_mapped.get_shape() : m_data.shape;
+    std::vector<int> dims(shape.begin() + 1, shape.end());
     if (m_has_labels || m_has_responses) {
       dims.back() -= 1;
     }
@@ -80,6 +88,9 @@ class numpy_reader : public generic_data_reader {
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /// Memory-map the file and determine the number of label classes.
+  void load_mapped();
+
   /// Number of samples.
   int m_num_samples = 0;
   /// Number of features in each sample.
@@ -96,6 +107,10 @@ class numpy_reader : public generic_data_reader {
    * for copying).
    */
   cnpy::NpyArray m_data;
+  /// Whether to memory-map the file.
+  bool m_mmap = false;
+  /// Memory-mapped numpy data (used instead of m_data if open).
+  mapped_npy_array m_mapped;
 };
 
 }  // namespace lbann
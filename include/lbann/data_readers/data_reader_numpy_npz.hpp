@@ -31,6 +31,7 @@
 
 #include "data_reader.hpp"
 #include "data_reader_numpy.hpp"
+#include "lbann/utils/mapped_npy.hpp"
 #include <cnpy.h>
 
 namespace lbann {
@@ -61,17 +62,27 @@ namespace lbann {
     void set_has_responses(bool b) { m_has_responses = b; }
     /// Set a scaling factor for int16 data.
     void set_scaling_factor_int16(DataType s) { m_scaling_factor_int16 = s; }
+    /**
+     * Memory-map uncompressed arrays instead of loading them; default false.
+     * Only the rows that are fetched are read from disk. Files written with
+     * np.savez_compressed are loaded as usual.
+     */
+    void set_mmap(bool b) { m_mmap = b; }
 
     void load() override;
 
+    int fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) override;
+
     int get_num_labels() const override { return m_num_labels; }
     int get_num_responses() const override { return get_linearized_response_size(); }
     int get_linearized_data_size() const override { return m_num_features; }
     int get_linearized_label_size() const override { return m_num_labels; }
     int get_linearized_response_size() const override { return m_num_response_features; }
     const std::vector<int> get_data_dims() const override {
-      std::vector<int> dims(m_data.shape.begin() + 1,
-                            m_data.shape.end());
+      const auto& shape = (m_mapped_data.is_open() ?
+                           m_mapped_data.get_shape() :
+                           m_data.shape);
+      std::vector<int> dims(shape.begin() + 1, shape.end());
       return dims;
     }
 
@@ -80,6 +91,9 @@ namespace lbann {
     bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
     bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+    /// Memory-map the arrays; returns false if any is compressed or missing.
+    bool load_mapped();
+
     /// Number of samples.
     int m_num_samples = 0;
     /// Number of features in each sample.
@@ -103,6 +117,11 @@ namespace lbann {
     // from int16 to DataType.
     DataType m_scaling_factor_int16 = 1.0;
 
+    /// Whether to memory-map uncompressed arrays.
+    bool m_mmap = false;
+    /// Memory-mapped numpy data (used instead of cnpy arrays if open).
+    mapped_npy_array m_mapped_data, m_mapped_labels, m_mapped_responses;
+
   private:
     // Keys to retrieve data, labels, responses from a given .npz file.
     static const std::string NPZ_KEY_DATA, NPZ_KEY_LABELS, NPZ_KEY_RESPONSES;
@@ -2,6 +2,12 @@
 #define __SAMPLE_LIST_OPEN_FILES_HPP__
 
 #include "sample_list.hpp"
+#include "lbann/utils/mapped_file.hpp"
+#include "lbann/utils/node_shared_buffer.hpp"
+#include "lbann/utils/sample_list_index.hpp"
+#include <algorithm>
+#include <memory>
+#include <numeric>
 
 /// Number of system and other files that may be open during execution
 #define LBANN_MAX_OPEN_FILE_MARGIN 128
@@ -55,11 +61,35 @@ class sample_list_open_files : public sample_list<sample_name_t> {
   /// Serialize this sample list into an std::string object
   bool to_string(std::string& sstr) const override;
 
-  /// Allow read-only access to the internal list data
+  /** Load a slice of a binary, indexed sample list (see sample_list_index).
+   *  The samples are split into num_slices contiguous slices and only the
+   *  given slice is read from the memory-mapped index. Unlike a text list,
+   *  the data files are not opened to find the sample names.
+   */
+  void load_index(const std::string& index_file, size_t num_slices=1, size_t slice=0);
+
+  /** Use a binary, indexed sample list in place from node-shared memory.
+   *  Collective over the trainer. The index is read once per node into
+   *  an MPI shared-memory window and every process of the trainer on the
+   *  node looks samples up in that copy, so the list is not duplicated per
+   *  process and does not need to be gathered.
+   */
+  void share_index(const std::string& index_file, lbann_comm& comm);
+
+  /// Tells if samples are looked up in a node-shared index
+  bool is_index_shared() const { return m_index.is_attached(); }
+
+  /// Write the list as a binary, indexed sample list
+  void write_index(const std::string& filename) const;
+
+  /// Allow read-only access to the internal list data (empty if the index is shared)
   const samples_t& get_list() const;
 
   /// Allow read-only access to the metadata of the idx-th sample in the list
-  const sample_t& operator[](size_t idx) const;
+  sample_t operator[](size_t idx) const;
+
+  /// Id of the file that holds the idx-th sample in the list
+  sample_file_id_t get_sample_file_id(size_t idx) const;
 
   const std::string& get_samples_filename(sample_file_id_t id) const override;
 
@@ -77,6 +107,19 @@ class sample_list_open_files : public sample_list<sample_name_t> {
 
   void compute_epochs_file_usage(const std::vector<int>& shufled_indices, int mini_batch_size, const lbann_comm& comm);
 
+  /** Shuffle sample indices so that samples from the same file stay close.
+   *  The files are randomly permuted and grouped into windows of
+   *  files_per_window files. The samples of each window are shuffled
+   *  together and the windows are concatenated, so a mini-batch only draws
+   *  from a few files. Larger windows give more randomness; 0 performs a
+   *  regular shuffle. The result only depends on the state of gen.
+   */
+  template <typename RNG>
+  void shuffle_with_file_locality(std::vector<int>& indices, size_t files_per_window, RNG& gen) const;
+
+  /// Number of files opened since the last call to compute_epochs_file_usage
+  size_t get_num_file_opens() const { return m_num_file_opens; }
+
   virtual bool is_file_handle_valid(const file_handle_t& h) const = 0;
 
   void all_gather_packed_lists(lbann_comm& comm) override;
@@ -114,6 +157,12 @@ class sample_list_open_files : public sample_list<sample_name_t> {
   virtual void close_file_handle(file_handle_t& h) = 0;
   virtual void clear_file_handle(file_handle_t& h) = 0;
 
+  /// Set the list header from a binary index
+  void set_header_from_index(const sample_list_index& index, const std::string& index_file);
+
+  /// Add a file of a binary index to the file information
+  void add_file_from_index(const sample_list_index& index, size_t index_file_id);
+
  private:
   using sample_list<sample_name_t>::serialize;
   template <class Archive> void serialize( Archive & ar ) = delete;
@@ -135,6 +184,15 @@ class sample_list_open_files : public sample_list<sample_name_t> {
   std::deque<fd_use_map_t> m_open_fd_pq;
 
   size_t m_max_open_files;
+
+  /// Number of files opened since the last call to compute_epochs_file_usage
+  size_t m_num_file_opens;
+
+  /// Node-shared index that the samples are looked up in, if any
+  sample_list_index m_index;
+
+  /// Memory holding m_index, shared between copies of this list
+  std::shared_ptr<void> m_index_storage;
 };
 
 template<typename T>
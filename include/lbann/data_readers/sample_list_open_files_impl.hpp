@@ -3,6 +3,7 @@ namespace lbann {
 template <typename sample_name_t, typename file_handle_t>
 inline sample_list_open_files<sample_name_t, file_handle_t>::sample_list_open_files() {
   m_max_open_files = getdtablesize() - LBANN_MAX_OPEN_FILE_MARGIN;
+  m_num_file_opens = 0;
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -51,6 +52,9 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
   m_sample_list = rhs.m_sample_list;
   m_file_map = rhs.m_file_map;
   m_max_open_files = rhs.m_max_open_files;
+  m_num_file_opens = 0;
+  m_index = rhs.m_index;
+  m_index_storage = rhs.m_index_storage;
 
   /// Keep track of existing filenames but do not copy any file
   /// descriptor information
@@ -71,6 +75,9 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
 template <typename sample_name_t, typename file_handle_t>
 inline size_t sample_list_open_files<sample_name_t, file_handle_t>
 ::size() const {
+  if (is_index_shared()) {
+    return m_index.get_num_samples();
+  }
   return m_sample_list.size();
 }
 
@@ -283,6 +290,144 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
 }
 
 
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::set_header_from_index(const sample_list_index& index,
+                        const std::string& index_file) {
+  m_header.m_is_exclusive = false;
+  m_header.m_included_sample_count = index.get_num_samples();
+  m_header.m_excluded_sample_count = 0u;
+  for (size_t f = 0u; f < index.get_num_files(); ++f) {
+    m_header.m_excluded_sample_count += index.get_file_num_samples(f);
+  }
+  m_header.m_excluded_sample_count -= index.get_num_samples();
+  m_header.m_num_files = index.get_num_files();
+  m_header.m_file_dir = index.get_file_dir();
+  m_header.m_sample_list_filename = index_file;
+
+  if (m_header.get_file_dir().empty() || !check_if_dir_exists(m_header.get_file_dir())) {
+    LBANN_ERROR(std::string{} + "file " + index_file
+                 + " :: data root directory '" + m_header.get_file_dir() + "' does not exist.");
+  }
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::add_file_from_index(const sample_list_index& index, size_t index_file_id) {
+  const std::string filename = index.get_file_name(index_file_id);
+  m_file_id_stats_map.emplace_back(std::make_tuple(filename, uninitialized_file_handle<file_handle_t>(), std::deque<std::pair<int,int>>{}));
+  m_file_map[filename] = index.get_file_num_samples(index_file_id);
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::load_index(const std::string& index_file, size_t num_slices, size_t slice) {
+  mapped_file file(index_file);
+  sample_list_index index;
+  index.attach(file.data(), file.size(), index_file);
+  set_header_from_index(index, index_file);
+
+  size_t begin, end;
+  sample_list_index::get_slice(index.get_num_samples(), num_slices, slice, begin, end);
+
+  /// Only keep the files used by this slice, numbered in order of first use
+  std::unordered_map<size_t, sample_file_id_t> file_ids;
+  m_sample_list.reserve(m_sample_list.size() + (end - begin));
+  for (size_t i = begin; i < end; ++i) {
+    const size_t f = index.get_sample_file_id(i);
+    auto it = file_ids.find(f);
+    if (it == file_ids.end()) {
+      it = file_ids.emplace(f, m_file_id_stats_map.size()).first;
+      add_file_from_index(index, f);
+    }
+    m_sample_list.emplace_back(it->second, to_sample_name_t<sample_name_t>(index.get_sample_name(i)));
+  }
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::share_index(const std::string& index_file, lbann_comm& comm) {
+  /// Only the trainer master looks up the size of the index
+  size_t index_size = 0u;
+  if (comm.am_trainer_master()) {
+    std::ifstream ifs(index_file, std::ios::in | std::ios::binary | std::ios::ate);
+    if (ifs) {
+      index_size = ifs.tellg();
+    }
+  }
+  comm.trainer_broadcast(0, index_size);
+  if (index_size == 0u) {
+    LBANN_ERROR("unable to read sample list index " + index_file);
+  }
+
+  /// The first process on each node reads the index into shared memory
+  auto buffer = std::make_shared<node_shared_buffer>();
+  buffer->allocate(comm.get_trainer_comm(), index_size);
+  bool read_ok = true;
+  if (buffer->is_node_root()) {
+    std::ifstream ifs(index_file, std::ios::in | std::ios::binary);
+    read_ok = static_cast<bool>(ifs.read(buffer->data(), index_size));
+    if (!read_ok) {
+      // Make the other processes fail to attach instead of reading garbage
+      std::fill_n(buffer->data(), std::min(index_size, size_t{8}), '\0');
+    }
+  }
+  buffer->barrier();
+  if (!read_ok) {
+    LBANN_ERROR("unable to read sample list index " + index_file);
+  }
+
+  m_index.attach(buffer->data(), buffer->size(), index_file);
+  m_index_storage = buffer;
+  set_header_from_index(m_index, index_file);
+
+  /// Samples are looked up in the index, but every file needs a handle
+  m_sample_list.clear();
+  m_file_id_stats_map.clear();
+  m_file_map.clear();
+  m_file_id_stats_map.reserve(m_index.get_num_files());
+  for (size_t f = 0u; f < m_index.get_num_files(); ++f) {
+    add_file_from_index(m_index, f);
+  }
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::write_index(const std::string& filename) const {
+  std::string dir, basename;
+  parse_path(filename, dir, basename);
+  if (!dir.empty() && !check_if_dir_exists(dir)) {
+    std::cerr << "The sample list output directory (" + dir + ") does not exist" << std::endl;
+    return;
+  }
+
+  /// Group the samples by file so that contiguous slices span few files
+  const size_t num_files = get_num_files();
+  std::vector<size_t> file_offsets(num_files + 1, 0);
+  for (size_t i = 0u; i < size(); ++i) {
+    file_offsets[get_sample_file_id(i) + 1]++;
+  }
+  std::partial_sum(file_offsets.begin(), file_offsets.end(), file_offsets.begin());
+  std::vector<size_t> file_samples(size());
+  std::vector<size_t> pos(file_offsets.begin(), file_offsets.end() - 1);
+  for (size_t i = 0u; i < size(); ++i) {
+    file_samples[pos[get_sample_file_id(i)]++] = i;
+  }
+
+  sample_list_index_writer writer(m_header.get_file_dir());
+  for (sample_file_id_t f = 0u; f < num_files; ++f) {
+    if (file_offsets[f] == file_offsets[f + 1]) {
+      continue;
+    }
+    const std::string& file_name = get_samples_filename(f);
+    const size_t index_file_id = writer.add_file(file_name, m_file_map.at(file_name));
+    for (size_t j = file_offsets[f]; j < file_offsets[f + 1]; ++j) {
+      writer.add_sample(index_file_id, lbann::to_string((*this)[file_samples[j]].second));
+    }
+  }
+  writer.write(filename);
+}
+
 template <typename sample_name_t, typename file_handle_t>
 template <class Archive>
 void sample_list_open_files<sample_name_t, file_handle_t>
@@ -293,7 +438,16 @@ void sample_list_open_files<sample_name_t, file_handle_t>
   for(auto&& e : m_file_id_stats_map) {
     file_stats.emplace_back(std::make_tuple(std::get<0>(e), std::get<2>(e)));
   }
-  ar(m_header, m_sample_list, file_stats);
+  if (is_index_shared()) {
+    samples_t samples;
+    samples.reserve(size());
+    for (size_t i = 0u; i < size(); ++i) {
+      samples.emplace_back((*this)[i]);
+    }
+    ar(m_header, samples, file_stats);
+  } else {
+    ar(m_header, m_sample_list, file_stats);
+  }
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -302,6 +456,8 @@ void sample_list_open_files<sample_name_t, file_handle_t>
 ::load( Archive & ar ) {
   using ar_file_stats_t = std::tuple<std::string, std::deque<std::pair<int,int>>>;
   std::vector<ar_file_stats_t> file_stats;
+  m_index = sample_list_index();
+  m_index_storage.reset();
   ar(m_header, m_sample_list, file_stats);
   m_file_id_stats_map.reserve(file_stats.size());
   for(auto&& e : file_stats) {
@@ -315,7 +471,8 @@ template <typename sample_name_t, typename file_handle_t>
 inline bool sample_list_open_files<sample_name_t, file_handle_t>
 ::to_string(std::string& sstr) const {
   std::map<std::string, std::template vector<sample_name_t>> tmp_file_map;
-  for (const auto& s : m_sample_list) {
+  for (size_t i = 0u; i < size(); ++i) {
+    const sample_t s = (*this)[i];
     const std::string& filename = get_samples_filename(s.first);
     tmp_file_map[filename].emplace_back(s.second);
   }
@@ -374,11 +531,24 @@ sample_list_open_files<sample_name_t, file_handle_t>::get_list() const {
 }
 
 template <typename sample_name_t, typename file_handle_t>
-inline const typename sample_list_open_files<sample_name_t, file_handle_t>::sample_t&
+inline typename sample_list_open_files<sample_name_t, file_handle_t>::sample_t
 sample_list_open_files<sample_name_t, file_handle_t>::operator[](size_t idx) const {
+  if (is_index_shared()) {
+    return sample_t(m_index.get_sample_file_id(idx),
+                    to_sample_name_t<sample_name_t>(m_index.get_sample_name(idx)));
+  }
   return m_sample_list[idx];
 }
 
+template <typename sample_name_t, typename file_handle_t>
+inline typename sample_list_open_files<sample_name_t, file_handle_t>::sample_file_id_t
+sample_list_open_files<sample_name_t, file_handle_t>::get_sample_file_id(size_t idx) const {
+  if (is_index_shared()) {
+    return m_index.get_sample_file_id(idx);
+  }
+  return m_sample_list[idx].first;
+}
+
 template <typename sample_name_t, typename file_handle_t>
 inline const std::string& sample_list_open_files<sample_name_t, file_handle_t>
 ::get_samples_filename(sample_file_id_t id) const {
@@ -477,6 +647,11 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
   }
   m_open_fd_pq.clear();
 
+  // Every process already sees the whole list in the shared index
+  if (is_index_shared()) {
+    return;
+  }
+
   size_t num_samples = this->all_gather_field(m_sample_list, per_rank_samples, comm);
   size_t num_ids = this->all_gather_field(my_files, per_rank_files, comm);
   size_t num_files = this->all_gather_field(m_file_map, per_rank_file_map, comm);
@@ -531,10 +706,10 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
   }
   // Once all of the file handles are closed, clear the priority queue
   m_open_fd_pq.clear();
+  m_num_file_opens = 0;
   for (size_t i = 0; i < shuffled_indices.size(); i++) {
     int idx = shuffled_indices[i];
-    const auto& s = m_sample_list[idx];
-    sample_file_id_t index = s.first;
+    sample_file_id_t index = get_sample_file_id(idx);
 
     if((i % mini_batch_size) % comm.get_procs_per_trainer() == static_cast<size_t>(comm.get_rank_in_trainer())) {
       /// Enqueue the iteration step when the sample will get used
@@ -545,6 +720,47 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
   }
 }
 
+template <typename sample_name_t, typename file_handle_t>
+template <typename RNG>
+inline void sample_list_open_files<sample_name_t, file_handle_t>
+::shuffle_with_file_locality(std::vector<int>& indices,
+                             size_t files_per_window,
+                             RNG& gen) const {
+  if (files_per_window == 0) {
+    std::shuffle(indices.begin(), indices.end(), gen);
+    return;
+  }
+
+  /// Group the indices by file with a counting sort
+  const size_t num_files = get_num_files();
+  std::vector<size_t> file_offsets(num_files + 1, 0);
+  for (const auto& idx : indices) {
+    file_offsets[get_sample_file_id(idx) + 1]++;
+  }
+  std::partial_sum(file_offsets.begin(), file_offsets.end(), file_offsets.begin());
+  std::vector<int> file_samples(indices.size());
+  std::vector<size_t> pos(file_offsets.begin(), file_offsets.end() - 1);
+  for (const auto& idx : indices) {
+    file_samples[pos[get_sample_file_id(idx)]++] = idx;
+  }
+
+  /// Visit the files in random order and shuffle within each window
+  std::vector<sample_file_id_t> files(num_files);
+  std::iota(files.begin(), files.end(), 0);
+  std::shuffle(files.begin(), files.end(), gen);
+  auto out = indices.begin();
+  for (size_t window = 0; window < num_files; window += files_per_window) {
+    const auto window_begin = out;
+    const size_t window_end = std::min(window + files_per_window, num_files);
+    for (size_t f = window; f < window_end; ++f) {
+      out = std::copy(file_samples.begin() + file_offsets[files[f]],
+                      file_samples.begin() + file_offsets[files[f] + 1],
+                      out);
+    }
+    std::shuffle(window_begin, out, gen);
+  }
+}
+
 template <typename sample_name_t, typename file_handle_t>
 inline void sample_list_open_files<sample_name_t, file_handle_t>
 ::delete_file_handle_pq_entry(sample_file_id_t id) {
@@ -576,7 +792,7 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
   /// Before we can enqueue the any new access times for this descriptor, remove any
   /// earlier descriptor
   std::sort_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-  if(m_open_fd_pq.front().first == id) {
+  if(!m_open_fd_pq.empty() && m_open_fd_pq.front().first == id) {
     m_open_fd_pq.pop_front();
   }
   std::make_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
@@ -602,8 +818,7 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>
 template <typename sample_name_t, typename file_handle_t>
 inline file_handle_t sample_list_open_files<sample_name_t, file_handle_t>
 ::open_samples_file_handle(const size_t i, bool pre_open_fd) {
-  const sample_t& s = m_sample_list[i];
-  sample_file_id_t id = s.first;
+  sample_file_id_t id = get_sample_file_id(i);
   file_handle_t h = get_samples_file_handle(id);
   if (!is_file_handle_valid(h)) {
     const std::string& file_name = get_samples_filename(id);
@@ -629,6 +844,7 @@ inline file_handle_t sample_list_open_files<sample_name_t, file_handle_t>
     }
     auto& e = m_file_id_stats_map[id];
     std::get<1>(e) = h;
+    m_num_file_opens++;
     /// If a new file is opened, place it in the priority queue
     manage_open_file_handles(id, pre_open_fd);
   }
@@ -638,8 +854,7 @@ inline file_handle_t sample_list_open_files<sample_name_t, file_handle_t>
 template <typename sample_name_t, typename file_handle_t>
 inline void sample_list_open_files<sample_name_t, file_handle_t>
 ::close_if_done_samples_file_handle(const size_t i) {
-  const sample_t& s = m_sample_list[i];
-  sample_file_id_t id = s.first;
+  sample_file_id_t id = get_sample_file_id(i);
   auto h = get_samples_file_handle(id);
   if (!is_file_handle_valid(h)) {
     auto& e = m_file_id_stats_map[id];
@@ -32,9 +32,12 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include "lbann/utils/node_shared_buffer.hpp"
+#include "lbann/utils/trace.hpp"
 #include "conduit/conduit_node.hpp"
 #include <unordered_map>
 #include <unordered_set>
+#include <memory>
 #include <mutex>
 
 
@@ -142,6 +145,7 @@ class data_store_conduit {
     if (is_local_cache()) {
       return;
     }
+    LBANN_TRACE_SCOPE(trace_category::data_store, "exchange_mini_batch_data");
     if (m_super_node) {
       exchange_data_by_super_node(current_pos, mb_size);
     } else {
@@ -290,6 +294,30 @@ protected :
 
   /// used in exchange_data_by_sample, when sample sizes are non-uniform
   bool m_have_sample_sizes;
+
+  /// if true, preloaded samples are kept in memory shared by the ranks
+  /// of a node, which read each other's samples in place; only samples
+  /// owned on other nodes are exchanged. Set by --node_local_data_store
+  bool m_node_local;
+
+  /// memory holding the samples owned by the ranks of this node
+  std::shared_ptr<node_shared_buffer> m_node_local_buffer;
+
+  /// maps data_id -> sample in m_node_local_buffer
+  std::unordered_map<int, const conduit::uint8*> m_node_local_data;
+
+  /// maps rank in the trainer -> whether it is on this node
+  std::vector<bool> m_is_rank_node_local;
+
+  /// copies the samples this rank owns into node-shared memory and
+  /// indexes the samples owned by the other ranks of the node;
+  /// collective over the trainer
+  void build_node_local_store();
+
+  /// true if samples owned by rank p are read in place
+  bool is_node_local(int p) const {
+    return m_node_local && m_is_rank_node_local[p];
+  }
 };
 
 }  // namespace lbann
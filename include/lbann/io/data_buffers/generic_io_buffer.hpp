@@ -119,6 +119,8 @@ public:
   virtual bool is_data_fetched_in_background(execution_mode mode) = 0;
   virtual El::Matrix<El::Int>* get_sample_indices_fetched_per_mb(execution_mode mode) = 0;
   virtual int num_samples_ready(execution_mode mode) = 0;
+  /** Discard samples that have been fetched but not distributed. */
+  virtual void discard_fetched_data(execution_mode mode) = 0;
   virtual void set_data_fetch_future(std::future<void> future, execution_mode mode) = 0;
   virtual std::future<void> get_data_fetch_future(execution_mode mode) = 0;
 
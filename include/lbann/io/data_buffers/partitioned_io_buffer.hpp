@@ -101,6 +101,7 @@ class partitioned_io_buffer : public generic_io_buffer {
   bool is_data_fetched_in_background(execution_mode mode) override;
   El::Matrix<El::Int>* get_sample_indices_fetched_per_mb(execution_mode mode) override;
   int num_samples_ready(execution_mode mode) override;
+  void discard_fetched_data(execution_mode mode) override;
   void set_data_fetch_future(std::future<void> future, execution_mode mode) override;
   std::future<void> get_data_fetch_future(execution_mode mode) override;
 
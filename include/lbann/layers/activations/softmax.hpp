@@ -107,7 +107,8 @@ public:
     const auto& dist_data = get_prev_activations().DistData();
     m_workspace->Empty(false);
     m_workspace->AlignWith(dist_data);
-    m_workspace->Resize(1, mini_batch_size);
+    // Note: The CPU implementation stores (max, sum) pairs.
+    m_workspace->Resize(Device == El::Device::CPU ? 2 : 1, mini_batch_size);
   }
 
   void fp_compute() override;
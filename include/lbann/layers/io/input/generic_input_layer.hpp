@@ -247,6 +247,22 @@ class generic_input_layer : public io_layer {
     }
   }
 
+  /** Discard prefetched data and rewind the data reader.
+   *  The next mini-batch in this execution mode is read from the
+   *  beginning of the data reader's current ordering.
+   */
+  void reset_data_set(execution_mode mode) {
+    collect_background_data_fetch(mode);
+    for(auto& io_buffer : m_io_buffers) {
+      io_buffer->discard_fetched_data(mode);
+    }
+    generic_data_reader *data_reader = get_data_reader(mode);
+    if(data_reader != nullptr) {
+      data_reader->set_initial_position();
+    }
+    m_data_set_processed = false;
+  }
+
   void fp_compute() override {
     execution_mode mode = this->m_model->get_execution_mode();
 
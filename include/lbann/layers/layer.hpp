@@ -34,6 +34,7 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/description.hpp"
+#include "lbann/utils/workspace.hpp"
 #include "lbann/io/persist.hpp"
 #include <lbann.pb.h>
 #include <string>
@@ -44,6 +45,7 @@ namespace lbann {
 // Forward declarations
 class model;
 class weights;
+class autotune_cache;
 class lbann_callback_sync_layers;
 
 /**
@@ -112,6 +114,28 @@ public:
    *  chain rule.
    */
   virtual void back_prop();
+  /** Set up input and output tensors for forward prop.
+   *  forward_prop is equivalent to this followed by
+   *  forward_prop_compute. Tensor setup may allocate memory, so it
+   *  must not run at the same time as other layers.
+   */
+  void forward_prop_setup();
+  /** Forward prop computation, after forward_prop_setup. */
+  void forward_prop_compute();
+  /** Set up gradient tensors for backward prop.
+   *  back_prop is equivalent to this followed by back_prop_compute.
+   */
+  void back_prop_setup();
+  /** Backward prop computation, after back_prop_setup. */
+  void back_prop_compute();
+  /** Whether the layer can run at the same time as other layers.
+   *  Forward and backward prop must only do rank-local work that is
+   *  safe to run on a separate team of OpenMP threads, e.g. no
+   *  communication and no random number generation. The model
+   *  ensures that concurrent layers do not share weights and sets up
+   *  their tensors one at a time beforehand.
+   */
+  virtual bool supports_concurrent_execution() const { return false; }
   /** Update step.
    *  Update the layer's internal members. Note that the optimization
    *  step for the weights happens elsewhere.
@@ -320,8 +344,51 @@ public:
   void unfreeze();
   bool is_frozen() const;
 
+  // ===========================================================
+  // Autotuning functions
+  // ===========================================================
+
+  /** Names of CPU algorithms that can be chosen by autotuning.
+   *  Layers without tunable CPU compute functions return an empty
+   *  list and are not tuned.
+   */
+  virtual std::vector<std::string> get_cpu_algorithms() const { return {}; }
+  /** Choose one of the algorithms from get_cpu_algorithms. */
+  virtual void set_cpu_algorithm(const std::string&) {}
+  /** Set number of OpenMP threads for compute functions.
+   *  A non-positive value uses the process default.
+   */
+  void set_num_threads(int num_threads) { m_num_threads = num_threads; }
+  /** Get number of OpenMP threads for compute functions. */
+  int get_num_threads() const { return m_num_threads; }
+  /** Choose CPU algorithm and number of threads.
+   *  The choice is taken from the cache if possible. Otherwise each
+   *  combination of algorithm and thread count is timed with
+   *  forward prop on a synthetic mini-batch and the fastest is
+   *  added to the cache. Must be called on every rank in the
+   *  trainer, after the layer and its weights are setup.
+   */
+  void autotune(autotune_cache& cache, int num_trials = 3);
+
 protected:
 
+  /** Key describing the layer's computation for autotuning.
+   *  Includes the layer type, tensor and weights dimensions, and
+   *  mini-batch size. Layers should append any parameters that
+   *  change the computation without changing these dimensions.
+   */
+  virtual std::string get_autotune_key() const;
+
+  /** Reserve a temporary buffer in the model's workspace.
+   *  Should be called during setup with the largest number of bytes
+   *  the layer will borrow at once with get_workspace.
+   */
+  void declare_workspace(size_t size);
+  /** Borrow a temporary buffer from the model's workspace.
+   *  The buffer is returned when it goes out of scope.
+   */
+  workspace_manager::buffer get_workspace(size_t size);
+
   // ===========================================================
   // Setup helper functions
   // ===========================================================
@@ -446,6 +513,11 @@ protected:
   /** Avoid back prop if frozen */
   bool m_frozen;
 
+  /** Number of OpenMP threads for compute functions.
+   *  A non-positive value uses the process default.
+   */
+  int m_num_threads = 0;
+
   /** Time spent in forward propagation. */
   EvalType m_fp_time;
   /** Time spent in the forward propagation computation. */
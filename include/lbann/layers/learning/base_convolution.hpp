@@ -70,6 +70,17 @@ protected:
    */
   DataType m_bias_scaling_factor;
 
+  /** Maximum number of entries in batched im2col matrices.
+   *  im2col matrices for a block of samples are applied with one
+   *  GEMM. If one sample does not fit, samples are processed one at
+   *  a time.
+   */
+  El::Int m_im2col_workspace_size = default_im2col_workspace_size;
+  /** Whether im2col matrices are batched across samples.
+   *  Chosen by autotuning.
+   */
+  bool m_batched_im2col = true;
+
 #ifdef LBANN_HAS_CUDNN
 
   /** Convolution kernel cuDNN descriptor. */
@@ -121,7 +132,9 @@ public:
       m_strides(other.m_strides),
       m_dilations(other.m_dilations),
       m_groups(other.m_groups),
-      m_bias_scaling_factor(other.m_bias_scaling_factor)
+      m_bias_scaling_factor(other.m_bias_scaling_factor),
+      m_im2col_workspace_size(other.m_im2col_workspace_size),
+      m_batched_im2col(other.m_batched_im2col)
 #ifdef LBANN_HAS_CUDNN
     , m_tensors_cudnn_desc(other.m_tensors_cudnn_desc),
       m_fwd_cudnn_algos(other.m_fwd_cudnn_algos),
@@ -151,6 +164,8 @@ public:
     m_dilations = other.m_dilations;
     m_groups = other.m_groups;
     m_bias_scaling_factor = other.m_bias_scaling_factor;
+    m_im2col_workspace_size = other.m_im2col_workspace_size;
+    m_batched_im2col = other.m_batched_im2col;
 
 #ifdef LBANN_HAS_CUDNN
     // Copy cuDNN objects
@@ -186,6 +201,22 @@ public:
 #endif // LBANN_HAS_CUDNN
   }
 
+  /** Set the maximum number of entries in batched im2col matrices. */
+  void set_im2col_workspace_size(El::Int size) {
+    m_im2col_workspace_size = size;
+  }
+
+  bool supports_concurrent_execution() const override { return true; }
+
+  /** Batched im2col is only implemented for 1D and 2D convolution. */
+  std::vector<std::string> get_cpu_algorithms() const override {
+    if (m_conv_dims.size() == 3) { return {"im2col"}; }
+    return {"im2col", "batched_im2col"};
+  }
+  void set_cpu_algorithm(const std::string& algorithm) override {
+    m_batched_im2col = (algorithm == "batched_im2col");
+  }
+
   description get_description() const override {
     auto&& desc = Layer::get_description();
     std::ostringstream ss;
@@ -457,6 +488,99 @@ protected:
   /** Dimensions of convolution kernel. */
   virtual std::vector<int> get_kernel_dims() const = 0;
 
+  std::string get_autotune_key() const override {
+    std::ostringstream ss;
+    ss << Layer::get_autotune_key();
+    ss << ";strides=";
+    for (size_t i = 0; i < m_strides.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_strides[i];
+    }
+    ss << ";pads=";
+    for (size_t i = 0; i < m_pads.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_pads[i];
+    }
+    ss << ";dilations=";
+    for (size_t i = 0; i < m_dilations.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_dilations[i];
+    }
+    ss << ";groups=" << m_groups;
+    return ss.str();
+  }
+
+  /** Number of samples whose im2col matrices fit in the workspace.
+   *  @param im2col_size  Number of entries in a sample's im2col matrix.
+   *  @param local_width  Number of local samples.
+   */
+  El::Int get_im2col_block_width(El::Int im2col_size, El::Int local_width) const {
+    if (!m_batched_im2col) { return 1; }
+    const El::Int block_width = m_im2col_workspace_size / std::max(im2col_size, El::Int(1));
+    return std::max(std::min(block_width, local_width), El::Int(1));
+  }
+
+  /** Number of entries in the temporary buffers of an im2col GEMM.
+   *  @param window_size  Number of entries in a window, including
+   *                      channels.
+   *  @param num_shifts   Number of window shifts per sample.
+   *  @param other_size   Width of the other GEMM operand, which is
+   *                      stacked when samples are batched.
+   *  @param num_slices   Depth slices of window shifts for 3D
+   *                      convolution, zero otherwise.
+   *  @param block_width  Number of samples per GEMM.
+   */
+  static El::Int get_im2col_workspace_entries(El::Int window_size,
+                                              El::Int num_shifts,
+                                              El::Int other_size,
+                                              int num_slices,
+                                              El::Int block_width) {
+    if (num_slices > 0) {
+      const El::Int slice_size = num_shifts / num_slices;
+      const int slab_depth = im2col_3d_slab_depth(window_size, slice_size);
+      return std::min(slab_depth, num_slices) * slice_size * window_size;
+    }
+    if (block_width > 1) {
+      return block_width * num_shifts * (window_size + other_size);
+    }
+    return window_size * num_shifts;
+  }
+
+  /** Reserve model workspace for the im2col GEMM kernels.
+   *  Convolution, transposed convolution and kernel gradient kernels
+   *  all need the same workspace, which depends on the tensor whose
+   *  entries correspond to window shifts.
+   *  @param shift_dims   Output dimensions for convolution, input
+   *                      dimensions for deconvolution.
+   */
+  void declare_im2col_workspace(const std::vector<int>& shift_dims) {
+    if (this->using_gpus()) { return; }
+    const auto& kernel_dims = get_kernel_dims();
+    const El::Int kernel_size = std::accumulate(kernel_dims.begin(),
+                                                kernel_dims.end(),
+                                                El::Int(1),
+                                                std::multiplies<El::Int>());
+    const El::Int shift_size = std::accumulate(shift_dims.begin(),
+                                               shift_dims.end(),
+                                               El::Int(1),
+                                               std::multiplies<El::Int>());
+    const El::Int window_size = kernel_size / shift_dims[0];
+    const El::Int num_shifts = shift_size / shift_dims[0];
+    const int num_slices = (shift_dims.size() == 4 ? shift_dims[1] : 0);
+
+    // Reserve room for batched GEMMs even if they are disabled, since
+    // autotuning may enable them after setup
+    const El::Int max_width = this->m_model->get_max_mini_batch_size();
+    const El::Int block_width
+      = std::max(std::min(m_im2col_workspace_size / std::max(window_size * num_shifts, El::Int(1)),
+                          max_width),
+                 El::Int(1));
+    const auto& entries = get_im2col_workspace_entries(window_size,
+                                                       num_shifts,
+                                                       shift_dims[0],
+                                                       num_slices,
+                                                       block_width);
+    this->declare_workspace(entries * sizeof(DataType));
+
+  }
+
   /** Convolution with cuDNN. */
   void apply_convolution_cudnn(bool during_forward_prop) {
 #ifndef LBANN_HAS_CUDNN
@@ -782,8 +906,98 @@ protected:
     const int m = output_size / output_dims[0];
     const int n = output_dims[0];
     const int k = kernel_size / output_dims[0];
+
+    // 3D convolution with transposed im2col matrix
+    // Note: The im2col matrix is built for a slab of output depth
+    // slices at a time to bound the workspace size.
+    if (input_dims.size() == 4) {
+      const int num_slices = output_dims[1];
+      const int slice_size = m / num_slices;
+      const int slab_depth = im2col_3d_slab_depth(k, slice_size);
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(k, m, n, num_slices, 1) * sizeof(DataType));
+      const int max_slab_size = std::min(slab_depth, num_slices) * slice_size;
+      DMat<Device> im2col_matrix(max_slab_size, k,
+                                 workspace.template get<DataType>(),
+                                 max_slab_size);
+      const DMat<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
+      DMat<Device> output_slab;
+      for (El::Int col = 0; col < local_width; ++col) {
+        for (int slab_begin = 0; slab_begin < num_slices; slab_begin += slab_depth) {
+          const int slab_end = std::min(slab_begin + slab_depth, num_slices);
+          const int slab_size = (slab_end - slab_begin) * slice_size;
+          im2col_transposed_3d(local_input.LockedBuffer(0, col),
+                               im2col_matrix.Buffer(),
+                               slab_size,
+                               input_dims[3], input_dims[2], input_dims[1],
+                               m_pads[2], m_pads[1], m_pads[0],
+                               input_dims[0],
+                               kernel_dims[4], kernel_dims[3], kernel_dims[2],
+                               m_strides[2], m_strides[1], m_strides[0],
+                               slab_begin, slab_end);
+          const DMat<Device> im2col_slab(slab_size, k,
+                                         im2col_matrix.LockedBuffer(),
+                                         slab_size);
+          output_slab.Attach(slab_size, n,
+                             local_output.Buffer(slab_begin * slice_size, col),
+                             m);
+          El::Gemm(El::NORMAL, El::NORMAL,
+                   DataType(1), im2col_slab, kernel_matrix,
+                   DataType(0), output_slab);
+        }
+      }
+      return;
+    }
+
+    // Batched im2col GEMM
+    // Note: im2col matrices for a block of samples are built in
+    // parallel and applied with one GEMM, which is much more efficient
+    // than per-sample GEMMs when feature maps are small.
+    const El::Int block_width = get_im2col_block_width(El::Int(k) * m, local_width);
+    if (block_width > 1) {
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(k, m, n, 0, block_width) * sizeof(DataType));
+      auto* workspace_buffer = workspace.template get<DataType>();
+      DMat<Device> im2col_matrix(k, block_width * m, workspace_buffer, k);
+      DMat<Device> output_block(block_width * m, n,
+                                workspace_buffer + k * block_width * m,
+                                block_width * m);
+      const DMat<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
+      for (El::Int block_begin = 0; block_begin < local_width; block_begin += block_width) {
+        const El::Int block_end = std::min(block_begin + block_width, local_width);
+        const El::Int block_size = block_end - block_begin;
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int col = block_begin; col < block_end; ++col) {
+          DMat<Device> input_col, im2col_col;
+          El::LockedView(input_col, local_input, El::ALL, El::IR(col));
+          im2col_col.Attach(k, m, im2col_matrix.Buffer(0, (col - block_begin) * m), k);
+          im2col(input_col,
+                 im2col_col,
+                 input_dims[0],
+                 input_dims.size() - 1,
+                 &input_dims[1],
+                 m_pads.data(),
+                 &kernel_dims[2],
+                 m_strides.data());
+        }
+        const DMat<Device> im2col_block(k, block_size * m,
+                                        im2col_matrix.LockedBuffer(), k);
+        DMat<Device> output_view(block_size * m, n,
+                                 output_block.Buffer(), block_size * m);
+        El::Gemm(El::TRANSPOSE, El::NORMAL,
+                 DataType(1), im2col_block, kernel_matrix,
+                 DataType(0), output_view);
+        unstack_samples(output_view.LockedBuffer(), output_view.LDim(),
+                        local_output.Buffer(0, block_begin), local_output.LDim(),
+                        block_size, m, n);
+      }
+      return;
+    }
+
+    auto workspace = this->get_workspace(
+      get_im2col_workspace_entries(k, m, n, 0, 1) * sizeof(DataType));
     DMat<Device> input_col, output_col;
-    DMat<Device> im2col_matrix(k, m);
+    DMat<Device> im2col_matrix(k, m, workspace.template get<DataType>(), k);
     const DMat<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
 
     // Iterate through input columns
@@ -843,8 +1057,98 @@ protected:
     const int m = kernel_size / input_dims[0];
     const int n = input_size / input_dims[0];
     const int k = input_dims[0];
+
+    // 3D transposed convolution with transposed im2col matrix
+    // Note: Contributions are accumulated for a slab of input depth
+    // slices at a time to bound the workspace size.
+    if (output_dims.size() == 4) {
+      const int num_slices = input_dims[1];
+      const int slice_size = n / num_slices;
+      const int slab_depth = im2col_3d_slab_depth(m, slice_size);
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(m, n, k, num_slices, 1) * sizeof(DataType));
+      const int max_slab_size = std::min(slab_depth, num_slices) * slice_size;
+      DMat<Device> im2col_matrix(max_slab_size, m,
+                                 workspace.template get<DataType>(),
+                                 max_slab_size);
+      const DMat<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
+      DMat<Device> input_slab;
+      for (El::Int col = 0; col < local_width; ++col) {
+        auto* output_buffer = local_output.Buffer(0, col);
+        std::fill(output_buffer, output_buffer + local_output.Height(), DataType(0));
+        for (int slab_begin = 0; slab_begin < num_slices; slab_begin += slab_depth) {
+          const int slab_end = std::min(slab_begin + slab_depth, num_slices);
+          const int slab_size = (slab_end - slab_begin) * slice_size;
+          input_slab.LockedAttach(slab_size, k,
+                                  local_input.LockedBuffer(slab_begin * slice_size, col),
+                                  n);
+          DMat<Device> im2col_slab(slab_size, m, im2col_matrix.Buffer(), slab_size);
+          El::Gemm(El::NORMAL, El::TRANSPOSE,
+                   DataType(1), input_slab, kernel_matrix,
+                   DataType(0), im2col_slab);
+          col2im_transposed_3d(im2col_slab.LockedBuffer(),
+                               slab_size,
+                               output_buffer,
+                               output_dims[3], output_dims[2], output_dims[1],
+                               m_pads[2], m_pads[1], m_pads[0],
+                               output_dims[0],
+                               kernel_dims[4], kernel_dims[3], kernel_dims[2],
+                               m_strides[2], m_strides[1], m_strides[0],
+                               slab_begin, slab_end);
+        }
+      }
+      return;
+    }
+
+    // Batched im2col GEMM
+    // Note: One GEMM produces the col matrices for a block of samples,
+    // which are then accumulated into images in parallel.
+    const El::Int block_width = get_im2col_block_width(El::Int(m) * n, local_width);
+    if (block_width > 1) {
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(m, n, k, 0, block_width) * sizeof(DataType));
+      auto* workspace_buffer = workspace.template get<DataType>();
+      DMat<Device> im2col_matrix(m, block_width * n, workspace_buffer, m);
+      DMat<Device> input_block(block_width * n, k,
+                               workspace_buffer + m * block_width * n,
+                               block_width * n);
+      const DMat<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
+      for (El::Int block_begin = 0; block_begin < local_width; block_begin += block_width) {
+        const El::Int block_end = std::min(block_begin + block_width, local_width);
+        const El::Int block_size = block_end - block_begin;
+        stack_samples(local_input.LockedBuffer(0, block_begin), local_input.LDim(),
+                      input_block.Buffer(), block_size * n,
+                      block_size, n, k);
+        const DMat<Device> input_view(block_size * n, k,
+                                      input_block.LockedBuffer(), block_size * n);
+        DMat<Device> im2col_block(m, block_size * n, im2col_matrix.Buffer(), m);
+        El::Gemm(El::NORMAL, El::TRANSPOSE,
+                 DataType(1), kernel_matrix, input_view,
+                 DataType(0), im2col_block);
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int col = block_begin; col < block_end; ++col) {
+          DMat<Device> im2col_col, output_col;
+          im2col_col.LockedAttach(m, n,
+                                  im2col_matrix.LockedBuffer(0, (col - block_begin) * n),
+                                  m);
+          El::View(output_col, local_output, El::ALL, El::IR(col));
+          col2im(im2col_col,
+                 output_col,
+                 output_dims[0],
+                 output_dims.size() - 1,
+                 &output_dims[1],
+                 m_pads.data(),
+                 &kernel_dims[2],
+                 m_strides.data());
+        }
+      }
+      return;
+    }
+
+    auto workspace = this->get_workspace(
+      get_im2col_workspace_entries(m, n, k, 0, 1) * sizeof(DataType));
     DMat<Device> input_col, output_col;
-    DMat<Device> im2col_matrix(m, n);
+    DMat<Device> im2col_matrix(m, n, workspace.template get<DataType>(), m);
     const DMat<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
 
     // Iterate through input columns
@@ -976,7 +1280,113 @@ protected:
       dst_scale, gradient_scale, true);
     El::Scale(dst_scale, kernel_gradient);
     gradient_scale /= effective_mini_batch_size;
-    DMat<Device> im2col_matrix(m, k);
+
+    // 3D convolution with transposed im2col matrix
+    // Note: The im2col matrix is built for a slab of window shift
+    // depth slices at a time to bound the workspace size.
+    if (input_dims.size() == 4) {
+      const auto& im_dims = (using_transposed_convolution ?
+                             output_dims : input_dims);
+      const auto& shift_dims = (using_transposed_convolution ?
+                                input_dims : output_dims);
+      const DMat<Device>& local_im = (using_transposed_convolution ?
+                                      local_gradient_wrt_output :
+                                      local_input);
+      const DMat<Device>& local_other = (using_transposed_convolution ?
+                                         local_input :
+                                         local_gradient_wrt_output);
+      const int num_slices = shift_dims[1];
+      const int slice_size = k / num_slices;
+      const int slab_depth = im2col_3d_slab_depth(m, slice_size);
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(m, k, n, num_slices, 1) * sizeof(DataType));
+      const int max_slab_size = std::min(slab_depth, num_slices) * slice_size;
+      DMat<Device> im2col_matrix(max_slab_size, m,
+                                 workspace.template get<DataType>(),
+                                 max_slab_size);
+      DMat<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
+      for (El::Int col = 0; col < local_width; ++col) {
+        for (int slab_begin = 0; slab_begin < num_slices; slab_begin += slab_depth) {
+          const int slab_end = std::min(slab_begin + slab_depth, num_slices);
+          const int slab_size = (slab_end - slab_begin) * slice_size;
+          im2col_transposed_3d(local_im.LockedBuffer(0, col),
+                               im2col_matrix.Buffer(),
+                               slab_size,
+                               im_dims[3], im_dims[2], im_dims[1],
+                               m_pads[2], m_pads[1], m_pads[0],
+                               im_dims[0],
+                               kernel_dims[4], kernel_dims[3], kernel_dims[2],
+                               m_strides[2], m_strides[1], m_strides[0],
+                               slab_begin, slab_end);
+          const DMat<Device> im2col_slab(slab_size, m,
+                                         im2col_matrix.LockedBuffer(),
+                                         slab_size);
+          const DMat<Device> other_slab(slab_size, n,
+                                        local_other.LockedBuffer(slab_begin * slice_size, col),
+                                        k);
+          El::Gemm(El::TRANSPOSE, El::NORMAL,
+                   gradient_scale, im2col_slab, other_slab,
+                   DataType(1), kernel_gradient_matrix);
+        }
+      }
+      return;
+    }
+
+    // Batched im2col GEMM
+    // Note: Contributions from a block of samples are accumulated with
+    // one GEMM over the stacked window shifts of all samples.
+    const El::Int block_width = get_im2col_block_width(El::Int(m) * k, local_width);
+    if (block_width > 1) {
+      const auto& im_dims = (using_transposed_convolution ?
+                             output_dims : input_dims);
+      const DMat<Device>& local_im = (using_transposed_convolution ?
+                                      local_gradient_wrt_output :
+                                      local_input);
+      const DMat<Device>& local_other = (using_transposed_convolution ?
+                                         local_input :
+                                         local_gradient_wrt_output);
+      auto workspace = this->get_workspace(
+        get_im2col_workspace_entries(m, k, n, 0, block_width) * sizeof(DataType));
+      auto* workspace_buffer = workspace.template get<DataType>();
+      DMat<Device> im2col_matrix(m, block_width * k, workspace_buffer, m);
+      DMat<Device> other_block(block_width * k, n,
+                               workspace_buffer + m * block_width * k,
+                               block_width * k);
+      DMat<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
+      for (El::Int block_begin = 0; block_begin < local_width; block_begin += block_width) {
+        const El::Int block_end = std::min(block_begin + block_width, local_width);
+        const El::Int block_size = block_end - block_begin;
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int col = block_begin; col < block_end; ++col) {
+          DMat<Device> im_col, im2col_col;
+          El::LockedView(im_col, local_im, El::ALL, El::IR(col));
+          im2col_col.Attach(m, k, im2col_matrix.Buffer(0, (col - block_begin) * k), m);
+          im2col(im_col,
+                 im2col_col,
+                 im_dims[0],
+                 im_dims.size() - 1,
+                 &im_dims[1],
+                 m_pads.data(),
+                 &kernel_dims[2],
+                 m_strides.data());
+        }
+        stack_samples(local_other.LockedBuffer(0, block_begin), local_other.LDim(),
+                      other_block.Buffer(), block_size * k,
+                      block_size, k, n);
+        const DMat<Device> im2col_block(m, block_size * k,
+                                        im2col_matrix.LockedBuffer(), m);
+        const DMat<Device> other_view(block_size * k, n,
+                                      other_block.LockedBuffer(), block_size * k);
+        El::Gemm(El::NORMAL, El::NORMAL,
+                 gradient_scale, im2col_block, other_view,
+                 DataType(1), kernel_gradient_matrix);
+      }
+      return;
+    }
+
+    auto workspace = this->get_workspace(
+      get_im2col_workspace_entries(m, k, n, 0, 1) * sizeof(DataType));
+    DMat<Device> im2col_matrix(m, k, workspace.template get<DataType>(), m);
     DMat<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
 
     // Compute kernel gradient contributions from each data sample
@@ -123,6 +123,11 @@ protected:
 
   }
 
+  void setup_data() override {
+    base_convolution_layer<Device>::setup_data();
+    this->declare_im2col_workspace(this->get_output_dims());
+  }
+
   std::vector<int> get_kernel_dims() const {
     std::vector<int> dims;
     dims.push_back(this->m_output_channels);
@@ -140,6 +140,11 @@ public:
 
   }
 
+  void setup_data() override {
+    base_convolution_layer<Device>::setup_data();
+    this->declare_im2col_workspace(this->get_input_dims());
+  }
+
 protected:
 
   std::vector<int> get_kernel_dims() const {
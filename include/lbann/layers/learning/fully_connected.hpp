@@ -98,6 +98,7 @@ public:
   std::string get_type() const override { return "fully connected"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_concurrent_execution() const override { return true; }
 
   description get_description() const override {
     auto&& desc = learning_layer::get_description();
@@ -107,8 +108,20 @@ public:
     return desc;
   }
 
+  /** Only the number of threads is tuned. */
+  std::vector<std::string> get_cpu_algorithms() const override {
+    return {"gemm"};
+  }
+
 protected:
 
+  std::string get_autotune_key() const override {
+    std::ostringstream ss;
+    ss << learning_layer::get_autotune_key()
+       << ";transpose=" << (m_transpose ? 1 : 0);
+    return ss.str();
+  }
+
   void setup_matrices(const El::Grid& grid) override;
 
   void setup_data() override {
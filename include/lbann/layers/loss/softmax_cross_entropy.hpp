@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+#define LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+
+#include "lbann/layers/layer.hpp"
+
+namespace lbann {
+
+/** @brief Softmax followed by cross entropy loss.
+ *
+ *  Given unnormalized log-probabilities @f$x@f$ and ground truth
+ *  distribution @f$\hat{y}@f$,
+ *  @f[
+ *    CE(\text{softmax}(x),\hat{y})
+ *      = - \sum\limits_{i} \hat{y}_i x_i
+ *        + \left(\sum\limits_{i} \hat{y}_i\right)
+ *          \log \sum\limits_{j} e^{x_j}
+ *  @f]
+ *  This is equivalent to a softmax layer followed by a cross entropy
+ *  layer, but the forward pass reads each input once and performs a
+ *  single reduction. The gradient w.r.t. @f$x@f$ is
+ *  @f$ \text{softmax}(x) \sum_i \hat{y}_i - \hat{y} @f$, which is
+ *  @f$ \text{softmax}(x) - \hat{y} @f$ for one-hot labels.
+ *
+ *  @todo GPU implementation.
+ */
+template <data_layout T_layout, El::Device Dev>
+class softmax_cross_entropy_layer : public Layer {
+public:
+
+  softmax_cross_entropy_layer(lbann_comm *comm) : Layer(comm) {
+    this->m_expected_num_parent_layers = 2;
+  }
+
+  softmax_cross_entropy_layer(const softmax_cross_entropy_layer& other)
+    : Layer(other) {
+    m_workspace.reset(other.m_workspace ?
+                      other.m_workspace->Copy() :
+                      nullptr);
+    m_output_workspace.reset(other.m_output_workspace ?
+                             other.m_output_workspace->Copy() :
+                             nullptr);
+  }
+
+  softmax_cross_entropy_layer& operator=(const softmax_cross_entropy_layer& other) {
+    Layer::operator=(other);
+    m_workspace.reset(other.m_workspace ?
+                      other.m_workspace->Copy() :
+                      nullptr);
+    m_output_workspace.reset(other.m_output_workspace ?
+                             other.m_output_workspace->Copy() :
+                             nullptr);
+    return *this;
+  }
+
+  softmax_cross_entropy_layer* copy() const override { return new softmax_cross_entropy_layer(*this); }
+  std::string get_type() const override { return "softmax cross entropy"; }
+  data_layout get_data_layout() const override { return T_layout; }
+  El::Device get_device_allocation() const override { return Dev; }
+
+  void setup_dims() override {
+    Layer::setup_dims();
+    set_output_dims({1});
+
+    // Check that input dimensions match
+    if (get_input_dims(0) != get_input_dims(1)) {
+      const auto& parents = get_parent_layers();
+      std::stringstream err;
+      err << get_type() << " layer \"" << get_name() << "\" "
+          << "has input tensors with different dimensions (";
+      for (int i = 0; i < get_num_parents(); ++i) {
+        const auto& dims = get_input_dims(i);
+        err << (i > 0 ? ", " : "")
+            << "layer \"" << parents[i]->get_name() << "\" outputs ";
+        for (size_t j = 0; j < dims.size(); ++j) {
+          err << (j > 0 ? " x " : "") << dims[j];
+        }
+      }
+      err << ")";
+      LBANN_ERROR(err.str());
+    }
+
+  }
+
+  void setup_data() override {
+    Layer::setup_data();
+
+    // Initialize workspaces
+    const auto& input = get_prev_activations(0);
+    switch (get_data_layout()) {
+    case data_layout::DATA_PARALLEL:
+      m_workspace.reset(new StarVCMat<Dev>(input.Grid(), input.Root()));
+      m_output_workspace.reset(new StarVCMat<Dev>(input.Grid(), input.Root()));
+      break;
+    case data_layout::MODEL_PARALLEL:
+      m_workspace.reset(new StarMRMat<Dev>(input.Grid(), input.Root()));
+      m_output_workspace.reset(new StarMRMat<Dev>(input.Grid(), input.Root()));
+      break;
+    default: LBANN_ERROR("invalid data layout");
+    }
+
+  }
+
+  void fp_compute() override {
+
+    // Initialize workspace
+    // Note: Each column holds (max, sum, dot(x, y_hat), sum(y_hat)).
+    const auto& input = get_prev_activations(0);
+    m_workspace->AlignWith(input.DistData());
+    m_workspace->Resize(4, input.Width());
+
+    // Compute local statistics and accumulate
+    local_fp_compute(get_local_prev_activations(0),
+                     get_local_prev_activations(1),
+                     m_workspace->Matrix());
+    allreduce_statistics(*get_comm(),
+                         m_workspace->RedundantComm(),
+                         m_workspace->Matrix());
+
+    // Compute loss
+    m_output_workspace->AlignWith(input.DistData());
+    m_output_workspace->Resize(1, input.Width());
+    local_loss_compute(m_workspace->LockedMatrix(),
+                       m_output_workspace->Matrix());
+    El::Copy(*m_output_workspace, get_activations());
+
+  }
+
+  void bp_compute() override {
+
+    // Initialize workspace
+    const auto& input = get_prev_activations(0);
+    m_output_workspace->AlignWith(input.DistData());
+    El::Copy(get_prev_error_signals(), *m_output_workspace);
+
+    // Compute local gradients
+    // Note: Softmax statistics are reused from forward prop.
+    local_bp_compute(get_local_prev_activations(0),
+                     get_local_prev_activations(1),
+                     m_workspace->LockedMatrix(),
+                     m_output_workspace->LockedMatrix(),
+                     get_local_error_signals(0),
+                     get_local_error_signals(1));
+
+  }
+
+private:
+
+  /** Compute local softmax and cross entropy statistics. */
+  static void local_fp_compute(const AbsMat& local_input,
+                               const AbsMat& local_ground_truth,
+                               AbsMat& local_statistics);
+  /** Combine local statistics over a communicator. */
+  static void allreduce_statistics(lbann_comm& comm,
+                                   const El::mpi::Comm& c,
+                                   AbsMat& local_statistics);
+  /** Compute loss from statistics. */
+  static void local_loss_compute(const AbsMat& local_statistics,
+                                 AbsMat& local_loss);
+  /** Compute local gradients. */
+  static void local_bp_compute(const AbsMat& local_input,
+                               const AbsMat& local_ground_truth,
+                               const AbsMat& local_statistics,
+                               const AbsMat& local_gradient_wrt_output,
+                               AbsMat& local_gradient_wrt_input,
+                               AbsMat& local_gradient_wrt_ground_truth);
+
+  /** Softmax and cross entropy statistics. */
+  std::unique_ptr<AbsDistMat> m_workspace;
+  /** Output or gradient w.r.t. output, aligned with input. */
+  std::unique_ptr<AbsDistMat> m_output_workspace;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
@@ -28,6 +28,7 @@
 #define LBANN_LAYERS_LOSS_TOP_K_CATEGORICAL_ACCURACY_HPP_INCLUDED
 
 #include "lbann/layers/layer.hpp"
+#include "lbann/utils/top_k.hpp"
 
 namespace lbann {
 
@@ -90,6 +91,13 @@ protected:
 
   }
 
+  void setup_data() override {
+    Layer::setup_data();
+    if (!using_gpus()) {
+      declare_workspace(get_workspace_size(m_model->get_max_mini_batch_size()));
+    }
+  }
+
   void fp_compute() override;
 
 private:
@@ -97,6 +105,15 @@ private:
   /** Parameter for top-k search. */
   const El::Int m_k;
 
+  /** Workspace size, in bytes, for the CPU implementation.
+   *  Holds label indices followed by top-k lists for each local
+   *  mini-batch sample.
+   */
+  size_t get_workspace_size(El::Int local_width) const {
+    return (workspace_manager::align(local_width * sizeof(El::Int))
+            + local_width * std::max(m_k, El::Int(0)) * sizeof(top_k_entry));
+  }
+
 };
 
 } // namespace lbann
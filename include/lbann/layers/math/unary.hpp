@@ -46,6 +46,7 @@ public:
   std::string get_type() const override { return Name(); }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_concurrent_execution() const override { return true; }
 protected:
   void setup_dims() override {
     Layer::setup_dims();
@@ -68,7 +68,9 @@ public:
       m_window_width(other.m_window_width),
       m_alpha(other.m_alpha),
       m_beta(other.m_beta),
-      m_k(other.m_k)
+      m_k(other.m_k),
+      m_scale_factors(other.m_scale_factors ?
+                      other.m_scale_factors->Copy() : nullptr)
 #ifdef LBANN_HAS_CUDNN
     , m_lrn_cudnn_desc(nullptr),
       m_tensors_cudnn_desc(other.m_tensors_cudnn_desc)
@@ -92,6 +94,8 @@ public:
     m_alpha = other.m_alpha;
     m_beta = other.m_beta;
     m_k = other.m_k;
+    m_scale_factors.reset(other.m_scale_factors ?
+                          other.m_scale_factors->Copy() : nullptr);
 #ifdef LBANN_HAS_CUDNN
     if (other.m_lrn_cudnn_desc != nullptr
         && m_lrn_cudnn_desc == nullptr) {
@@ -110,6 +114,7 @@ public:
     m_tensors_cudnn_desc = other.m_tensors_cudnn_desc;
     m_tensors_cudnn_desc.set_layer(this);
 #endif // LBANN_HAS_CUDNN
+    return *this;
   }
 
   ~local_response_normalization_layer() override {
@@ -126,6 +131,7 @@ public:
   std::string get_type() const override { return "LRN"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_concurrent_execution() const override { return true; }
 
   description get_description() const override {
     auto&& desc = regularizer_layer::get_description();
@@ -142,6 +148,21 @@ protected:
     set_output_dims(get_input_dims());
   }
 
+  void setup_matrices(const El::Grid& grid) override {
+    regularizer_layer::setup_matrices(grid);
+    if (Dev == El::Device::CPU) {
+      m_scale_factors = std::unique_ptr<AbsDistMat>(get_activations().Copy());
+    }
+  }
+
+  void fp_setup_outputs(El::Int mini_batch_size) override {
+    regularizer_layer::fp_setup_outputs(mini_batch_size);
+    if (m_scale_factors != nullptr) {
+      m_scale_factors->Resize(get_activations().Height(),
+                              get_activations().Width());
+    }
+  }
+
   /// Initialize GPU objects
   void setup_gpu() override {
     regularizer_layer::setup_gpu();
@@ -184,6 +205,12 @@ private:
   /** LRN k parameter. */
   DataType m_k;
 
+  /** Scale factors from forward prop (CPU only).
+   *  Each entry is 1 / (k + alpha * sum(x^2)) for the corresponding
+   *  output entry.
+   */
+  std::unique_ptr<AbsDistMat> m_scale_factors;
+
 #ifdef LBANN_HAS_CUDNN
   /** LRN cuDNN descriptor. */
   cudnnLRNDescriptor_t m_lrn_cudnn_desc;
@@ -249,6 +276,7 @@ private:
     // Local matrices
     const auto& local_input = get_local_prev_activations();
     auto& local_output = get_local_activations();
+    auto& local_scale_factors = m_scale_factors->Matrix();
 
     // Matrix parameters
     const int local_width = local_input.Width();
@@ -256,25 +284,30 @@ private:
     const int input_ldim = local_input.LDim();
     DataType* output_buffer = local_output.Buffer();
     const int output_ldim = local_output.LDim();
+    DataType* scale_factors_buffer = local_scale_factors.Buffer();
+    const int scale_factors_ldim = local_scale_factors.LDim();
 
     // Get LRN parameters
     const auto& output_dims = get_output_dims();
     const int num_channels = output_dims[0];
     const int num_per_channel = get_output_size() / num_channels;
+    const int half_width = m_window_width / 2;
 
     // Check if LRN is using default beta parameter
     const bool default_beta = (std::fabs((m_beta - 0.75) / 0.75)
                                < 2 * std::numeric_limits<DataType>::epsilon());
 
     ////////////////////////////////////////////////////////////////
-    // activations(i) = prev_activations(i) / scale_factor(i) ^ beta
+    // activations(i) = prev_activations(i) * scale_factor(i) ^ beta
     // scale_factor(i)
-    //   = k + alpha * sum( prev_activations(j) ^ 2 )
-    // Note: The sum is over entries in the normalization window.
+    //   = 1 / ( k + alpha * sum( prev_activations(j) ^ 2 ) )
+    // Note: The sum is over entries in the normalization window. It
+    //   is updated incrementally as the window slides across
+    //   channels. Scale factors are stored for backprop.
     ////////////////////////////////////////////////////////////////
 
     // Iterate through blocks in channels of each data sample
-    const int max_block_size = 16;
+    const int max_block_size = 64;
     LBANN_OMP_PARALLEL_FOR_COLLAPSE2
     for (int sample = 0; sample < local_width; ++sample) {
       for (int block_start = 0;
@@ -282,40 +315,56 @@ private:
           block_start += max_block_size) {
         const int block_size = std::min(max_block_size,
                                         num_per_channel - block_start);
-        DataType workspace[max_block_size];
+        const auto* __restrict__ x = &input_buffer[block_start + sample * input_ldim];
+        auto* __restrict__ y = &output_buffer[block_start + sample * output_ldim];
+        auto* __restrict__ scale = &scale_factors_buffer[block_start + sample * scale_factors_ldim];
+        DataType sum[max_block_size];
+
+        // Sum of squares for window at channel -1
+        std::fill(sum, sum + block_size, DataType(0));
+        for (int window_pos = 0;
+             window_pos < std::min(half_width, num_channels);
+             ++window_pos) {
+          const auto* x_window = &x[window_pos * num_per_channel];
+          for (int block_pos = 0; block_pos < block_size; ++block_pos) {
+            sum[block_pos] += x_window[block_pos] * x_window[block_pos];
+          }
+        }
 
         // Iterate through channels
         for (int channel = 0; channel < num_channels; ++channel) {
-          const int window_start = std::max(channel - m_window_width / 2, 0);
-          const int window_end = std::min(channel + m_window_width / 2, num_channels - 1);
 
-          // Compute sum of squares in workspace
-          std::fill(workspace, workspace + block_size, DataType(0));
-          for (int window_pos = window_start; window_pos <= window_end; ++window_pos) {
+          // Slide window to current channel
+          const int add_pos = channel + half_width;
+          const int remove_pos = channel - half_width - 1;
+          if (add_pos < num_channels) {
+            const auto* x_add = &x[add_pos * num_per_channel];
             for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-              const int index = block_start + block_pos + window_pos * num_per_channel;
-              const DataType input_entry = input_buffer[index + sample * input_ldim];
-              workspace[block_pos] += input_entry * input_entry;
+              sum[block_pos] += x_add[block_pos] * x_add[block_pos];
             }
           }
-
-          // Compute 1 / (k + alpha * sum(x^2) ) in workspace
-          for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-            workspace[block_pos] = 1 / (m_k + m_alpha * workspace[block_pos]);
+          if (remove_pos >= 0) {
+            const auto* x_remove = &x[remove_pos * num_per_channel];
+            for (int block_pos = 0; block_pos < block_size; ++block_pos) {
+              sum[block_pos] -= x_remove[block_pos] * x_remove[block_pos];
+            }
           }
 
           // Compute output
+          // Note: Rounding error in the running sum can make it
+          // slightly negative when the window becomes all zeros.
+          const int offset = channel * num_per_channel;
           for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-            const int index = block_start + block_pos + channel * num_per_channel;
-            const DataType scale_factor = workspace[block_pos];
-            const DataType input_entry = input_buffer[index + sample * input_ldim];
-            DataType& output_entry = output_buffer[index + sample * output_ldim];
+            const DataType sum_entry = std::max(sum[block_pos], DataType(0));
+            const DataType scale_factor = 1 / (m_k + m_alpha * sum_entry);
+            scale[offset + block_pos] = scale_factor;
             if (default_beta) { // Special case when beta = 0.75
-              output_entry = (input_entry
-                              * std::sqrt(scale_factor * std::sqrt(scale_factor)));
+              y[offset + block_pos] = (x[offset + block_pos]
+                                       * std::sqrt(scale_factor * std::sqrt(scale_factor)));
             }
             else {
-              output_entry = input_entry * std::pow(scale_factor, m_beta);
+              y[offset + block_pos] = (x[offset + block_pos]
+                                       * std::pow(scale_factor, m_beta));
             }
           }
 
@@ -334,6 +383,7 @@ private:
     const auto& local_output = get_local_activations();
     const auto& local_gradient_wrt_output = get_local_prev_error_signals();
     auto& local_gradient_wrt_input = get_local_error_signals();
+    const auto& local_scale_factors = m_scale_factors->LockedMatrix();
 
     // Get matrix buffers
     const int local_width = local_input.Width();
@@ -345,11 +395,15 @@ private:
     const int gradient_wrt_output_ldim = local_gradient_wrt_output.LDim();
     DataType* gradient_wrt_input_buffer = local_gradient_wrt_input.Buffer();
     const int gradient_wrt_input_ldim = local_gradient_wrt_input.LDim();
+    const DataType* scale_factors_buffer = local_scale_factors.LockedBuffer();
+    const int scale_factors_ldim = local_scale_factors.LDim();
 
     // Get LRN parameters
     const auto& output_dims = get_output_dims();
     const int num_channels = output_dims[0];
     const int num_per_channel = get_output_size() / num_channels;
+    const int half_width = m_window_width / 2;
+    const DataType coeff = -2 * m_alpha * m_beta;
 
     // Check if LRN is using default beta parameter
     const bool default_beta = (std::fabs((m_beta - 0.75) / 0.75)
@@ -357,17 +411,17 @@ private:
 
     ////////////////////////////////////////////////////////////////
     // error_signal(i)
-    //   = prev_error_signal(i) / scale_factor(i) ^ beta
-    //     - 2 * alpha * beta / window_width * prev_activations(i)
+    //   = prev_error_signal(i) * scale_factor(i) ^ beta
+    //     - 2 * alpha * beta * prev_activations(i)
     //       * sum( prev_error_signal(j) * activations(j)
-    //              / scale_factor(j) )
-    // Note: See comments in fp_linearity_cpu for a definition of
+    //              * scale_factor(j) )
+    // Note: See comments in fp_compute_cpu for a definition of
     //   scale_factor. The sum is over entries in the normalization
-    //   window.
+    //   window and is updated incrementally as in forward prop.
     ////////////////////////////////////////////////////////////////
 
     // Iterate through blocks in channels of each data sample
-    const int max_block_size = 16;
+    const int max_block_size = 64;
     LBANN_OMP_PARALLEL_FOR_COLLAPSE2
     for (int sample = 0; sample < local_width; ++sample) {
       for (int block_start = 0;
@@ -375,64 +429,55 @@ private:
           block_start += max_block_size) {
         const int block_size = std::min(max_block_size,
                                         num_per_channel - block_start);
-        DataType workspace[max_block_size];
+        const auto* __restrict__ x = &input_buffer[block_start + sample * input_ldim];
+        const auto* __restrict__ y = &output_buffer[block_start + sample * output_ldim];
+        const auto* __restrict__ dy = &gradient_wrt_output_buffer[block_start + sample * gradient_wrt_output_ldim];
+        auto* __restrict__ dx = &gradient_wrt_input_buffer[block_start + sample * gradient_wrt_input_ldim];
+        const auto* __restrict__ scale = &scale_factors_buffer[block_start + sample * scale_factors_ldim];
+        DataType sum[max_block_size];
+
+        // Sum of y * dy * scale_factor for window at channel -1
+        std::fill(sum, sum + block_size, DataType(0));
+        for (int window_pos = 0;
+             window_pos < std::min(half_width, num_channels);
+             ++window_pos) {
+          const int offset = window_pos * num_per_channel;
+          for (int block_pos = 0; block_pos < block_size; ++block_pos) {
+            const int i = offset + block_pos;
+            sum[block_pos] += y[i] * dy[i] * scale[i];
+          }
+        }
 
         // Iterate through channels
         for (int channel = 0; channel < num_channels; ++channel) {
-          const int window_start = std::max(channel - m_window_width / 2, 0);
-          const int window_end = std::min(channel + m_window_width / 2, num_channels - 1);
 
-          // Compute sum of squares in workspace
-          std::fill(workspace, workspace + block_size, DataType(0));
-          for (int window_pos = window_start; window_pos <= window_end; ++window_pos) {
+          // Slide window to current channel
+          const int add_pos = channel + half_width;
+          const int remove_pos = channel - half_width - 1;
+          if (add_pos < num_channels) {
+            const int offset = add_pos * num_per_channel;
             for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-              const int index = block_start + block_pos + window_pos * num_per_channel;
-              const DataType input_entry = input_buffer[index + sample * input_ldim];
-              workspace[block_pos] += input_entry * input_entry;
+              const int i = offset + block_pos;
+              sum[block_pos] += y[i] * dy[i] * scale[i];
             }
           }
-
-          // Compute 1 / (k + alpha * sum(x^2) ) in workspace
-          for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-            workspace[block_pos] = 1 / (m_k + m_alpha * workspace[block_pos]);
-          }
-
-          // Compute error signal contribution for current entry
-          for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-            const int index = block_start + block_pos + channel * num_per_channel;
-            const DataType scale_factor = workspace[block_pos];
-            const DataType gradient_wrt_output_entry
-              = gradient_wrt_output_buffer[index + sample * gradient_wrt_output_ldim];
-            DataType& gradient_wrt_input_entry
-              = gradient_wrt_input_buffer[index + sample * gradient_wrt_input_ldim];
-            if (default_beta) { // Special case when beta = 0.75
-              gradient_wrt_input_entry
-                = gradient_wrt_output_entry * std::sqrt(scale_factor * std::sqrt(scale_factor));
-            }
-            else {
-              gradient_wrt_input_entry
-                = gradient_wrt_output_entry * std::pow(scale_factor, m_beta);
+          if (remove_pos >= 0) {
+            const int offset = remove_pos * num_per_channel;
+            for (int block_pos = 0; block_pos < block_size; ++block_pos) {
+              const int i = offset + block_pos;
+              sum[block_pos] -= y[i] * dy[i] * scale[i];
             }
           }
 
-          // Compute y * dy / (k + alpha * sum(x^2) ) in workspace
+          // Compute error signal
+          const int offset = channel * num_per_channel;
           for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-            const int index = block_start + block_pos + channel * num_per_channel;
-            const DataType output_entry = output_buffer[index + sample * output_ldim];
-            const DataType gradient_wrt_output_entry
-              = gradient_wrt_output_buffer[index + sample * gradient_wrt_output_ldim];
-            workspace[block_pos] = (-2 * m_alpha * m_beta * workspace[block_pos]
-                                    * output_entry * gradient_wrt_output_entry);
-          }
-
-          // Compute error signal contribution for entries in window
-          for (int window_pos = window_start; window_pos <= window_end; ++window_pos) {
-            for (int block_pos = 0; block_pos < block_size; ++block_pos) {
-              const int index = block_start + block_pos + window_pos * num_per_channel;
-              const DataType input_entry = input_buffer[index + sample * input_ldim];
-              gradient_wrt_input_buffer[index + sample * gradient_wrt_input_ldim]
-                += workspace[block_pos] * input_entry;
-            }
+            const int i = offset + block_pos;
+            const DataType scale_factor = scale[i];
+            const DataType scale_pow = (default_beta ?
+                                        std::sqrt(scale_factor * std::sqrt(scale_factor)) :
+                                        std::pow(scale_factor, m_beta));
+            dx[i] = dy[i] * scale_pow + coeff * x[i] * sum[block_pos];
           }
 
         }
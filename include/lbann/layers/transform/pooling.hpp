@@ -161,6 +161,7 @@ public:
   std::string get_type() const override { return "pooling"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_concurrent_execution() const override { return true; }
 
   description get_description() const override {
     auto&& desc = transform_layer::get_description();
@@ -208,8 +209,32 @@ public:
 
   }
 
+  /** Only the number of threads is tuned. */
+  std::vector<std::string> get_cpu_algorithms() const override {
+    return {"im2col"};
+  }
+
 protected:
 
+  std::string get_autotune_key() const override {
+    std::ostringstream ss;
+    ss << transform_layer::get_autotune_key()
+       << ";mode=" << get_pool_mode_name(m_pool_mode);
+    ss << ";pool_dims=";
+    for (size_t i = 0; i < m_pool_dims.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_pool_dims[i];
+    }
+    ss << ";strides=";
+    for (size_t i = 0; i < m_strides.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_strides[i];
+    }
+    ss << ";pads=";
+    for (size_t i = 0; i < m_pads.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << m_pads[i];
+    }
+    return ss.str();
+  }
+
   void setup_dims() override {
     transform_layer::setup_dims();
     const auto& input_dims = get_input_dims();
@@ -222,6 +247,13 @@ protected:
     set_output_dims(output_dims);
   }
 
+  void setup_data() override {
+    transform_layer::setup_data();
+    if (!using_gpus()) {
+      declare_workspace(m_pool_size * get_output_size() * sizeof(DataType));
+    }
+  }
+
   /// Initialize GPU objects
   void setup_gpu() override {
     transform_layer::setup_gpu();
@@ -355,7 +387,9 @@ private:
     }
 
     // Initialize matrices
-    DMat<Dev> im2col_mat(m_pool_size * num_channels, num_per_output_channel);
+    auto workspace = get_workspace(m_pool_size * get_output_size() * sizeof(DataType));
+    DMat<Dev> im2col_mat(m_pool_size * num_channels, num_per_output_channel,
+                         workspace.get<DataType>(), m_pool_size * num_channels);
     DMat<Dev> input_mat;
 
     // Iterate through data samples
@@ -437,7 +471,9 @@ private:
     const int num_per_input_channel = get_output_size() / num_channels;
 
     // Initialize matrices
-    CPUMat im2col_mat(m_pool_size * num_channels, num_per_input_channel);
+    auto workspace = get_workspace(m_pool_size * get_output_size() * sizeof(DataType));
+    CPUMat im2col_mat(m_pool_size * num_channels, num_per_input_channel,
+                      workspace.get<DataType>(), m_pool_size * num_channels);
     CPUMat gradient_wrt_input_col;
 
     // Iterate through data samples
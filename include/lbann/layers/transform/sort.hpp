@@ -28,22 +28,29 @@
 #define LBANN_LAYER_SORT_HPP_INCLUDED
 
 #include "lbann/layers/transform/transform.hpp"
+#include "lbann/utils/key_index_sort.hpp"
 
 namespace lbann {
 
-/** @brief Sort tensor entries. */
+/** @brief Sort tensor entries.
+ *
+ *  If k is positive, only the first k output entries are guaranteed
+ *  to be sorted. The remaining entries hold the rest of the input in
+ *  unspecified order.
+ */
 template <data_layout T_layout = data_layout::DATA_PARALLEL, El::Device Dev = El::Device::CPU>
 class sort_layer : public transform_layer {
  public:
 
-  sort_layer(lbann_comm *comm, bool descending = false)
-    : transform_layer(comm), m_descending(descending) {
+  sort_layer(lbann_comm *comm, bool descending = false, El::Int k = 0)
+    : transform_layer(comm), m_descending(descending), m_k(k) {
     static_assert(T_layout == data_layout::DATA_PARALLEL,
                   "sort layer only supports DATA_PARALLEL");
   }
   sort_layer(const sort_layer& other)
     : transform_layer(other),
-      m_descending(other.m_descending) {
+      m_descending(other.m_descending),
+      m_k(other.m_k) {
     if (other.m_indices) {
       switch (other.m_indices->GetDevice()) {
       case El::Device::CPU:
@@ -62,6 +69,7 @@ class sort_layer : public transform_layer {
   sort_layer& operator=(const sort_layer& other) {
     transform_layer::operator=(other);
     m_descending = other.m_descending;
+    m_k = other.m_k;
     if (!other.m_indices) {
       m_indices.reset(nullptr);
     } else {
@@ -89,6 +97,9 @@ class sort_layer : public transform_layer {
   description get_description() const override {
     auto&& desc = transform_layer::get_description();
     desc.add("Descending", m_descending);
+    if (m_k > 0) {
+      desc.add("k", m_k);
+    }
     return desc;
   }
 
@@ -129,6 +140,10 @@ class sort_layer : public transform_layer {
 
   /** Whether values are sorted by descending order. */
   bool m_descending;
+  /** Number of leading output entries that must be sorted.
+   *  A non-positive value means a full sort.
+   */
+  El::Int m_k;
 
   /** Input indices corresponding to output entries.
    *  @todo Switch to distributed integer matrix once it's supported
@@ -136,6 +151,9 @@ class sort_layer : public transform_layer {
    */
   std::unique_ptr<El::AbstractMatrix<El::Int>> m_indices;
 
+  /** Per-thread sort workspaces (CPU only). */
+  std::vector<key_index_sorter<DataType, El::Int>> m_sorters;
+
 };
 
 } // namespace lbann
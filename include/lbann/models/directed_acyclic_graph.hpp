@@ -29,6 +29,7 @@
 
 #include "lbann/models/model.hpp"
 #include "lbann/layers/layer.hpp"
+#include <vector>
 
 namespace lbann {
 
@@ -46,8 +47,35 @@ public:
   directed_acyclic_graph_model* copy() const override { return new directed_acyclic_graph_model(*this); }
   std::string get_type() const override { return "directed acyclic graph"; }
 
+  /** Run independent layers concurrently.
+   *
+   *  Layers are grouped into stages of layers whose dependencies are
+   *  all in earlier stages. Within a stage, layers that support
+   *  concurrent execution and do not share weights are run at the
+   *  same time, each on its own team of OpenMP threads (or as an
+   *  OpenMP task in builds with taskloops). Their tensors are set up
+   *  one layer at a time beforehand. The other layers in the stage
+   *  are run afterward, one at a time, with all threads.
+   */
+  void set_concurrent_layers(bool concurrent) { m_concurrent_layers = concurrent; }
+  bool get_concurrent_layers() const { return m_concurrent_layers; }
+
+  /** Summarize critical path length and total layer compute time.
+   *  Only reported if layers are run concurrently. Both are averaged
+   *  over the mini-batch steps since the last summary.
+   */
+  void summarize_stats(lbann_summary& summarizer) override;
+
 protected:
 
+  /** Set up layers and layer stages. */
+  void setup_layers() override;
+  /** Allocate a workspace slot for each concurrent layer. */
+  void setup_workspace() override;
+
+  void forward_prop(execution_mode mode) override;
+  void backward_prop() override;
+
   /** Set up layer execution order.
    *
    *  Called in setup function. A topological sort applied is to the
@@ -56,6 +84,53 @@ protected:
    */
   void setup_layer_execution_order() override;
 
+private:
+
+  /** Layers that can be run at the same time. */
+  struct layer_stage {
+    /** Layers that are run concurrently. */
+    std::vector<El::Int> concurrent;
+    /** Layers that are run afterward, one at a time. */
+    std::vector<El::Int> serial;
+  };
+
+  /** Whether to run independent layers concurrently. */
+  bool m_concurrent_layers = false;
+
+  /** Indices of parent layers. */
+  std::vector<std::vector<El::Int>> m_layer_parents;
+  /** Indices of child layers. */
+  std::vector<std::vector<El::Int>> m_layer_children;
+  /** Stages for forward prop, in execution order. */
+  std::vector<layer_stage> m_fp_stages;
+  /** Stages for backward prop, in execution order. */
+  std::vector<layer_stage> m_bp_stages;
+
+  /** Wall time of each layer in the latest forward or backward prop. */
+  std::vector<EvalType> m_layer_times;
+  /** Sum of critical path lengths since last summary. */
+  EvalType m_critical_path_time = 0;
+  /** Sum of layer times since last summary. */
+  EvalType m_total_layer_time = 0;
+  /** Mini-batch steps since last summary. */
+  El::Int m_num_timed_steps = 0;
+  /** Whether falling back to serial execution has been reported. */
+  bool m_warned_serial_fallback = false;
+
+  /** Group layers into forward or backward prop stages. */
+  std::vector<layer_stage> make_stages(bool forward) const;
+  /** Run a stage of forward or backward prop. */
+  void run_stage(const layer_stage& stage, execution_mode mode, bool forward);
+  /** Run layers at the same time on partitioned thread teams.
+   *  Falls back to running them one at a time if called within an
+   *  OpenMP parallel region, except in builds with taskloops.
+   */
+  void run_concurrently(const std::vector<El::Int>& layers, bool forward);
+  /** Add longest path through layer times to statistics and reset
+   *  layer times.
+   */
+  void record_critical_path(bool forward);
+
 };
 
 } // namespace lbann
@@ -32,6 +32,7 @@
 #include "lbann/layers/layer.hpp"
 #include "lbann/utils/summary.hpp"
 #include "lbann/utils/graph.hpp"
+#include "lbann/utils/workspace.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
@@ -170,6 +171,9 @@ public:
   }
   int get_num_iterations_per_epoch(execution_mode mode) const;
 
+  /** @brief Get the model's workspace for layer temporaries. */
+  workspace_manager& get_workspace() { return m_workspace; }
+
   /** @brief Return true if the flag to stop training is set. */
   bool get_terminate_training() const {
     return m_terminate_training;
@@ -347,6 +351,27 @@ protected:
    *  weights are deleted.
    */
   virtual void setup_weights();
+  /** @brief Allocate workspace for layer temporaries.
+   *
+   *  Called in setup function, after layers have declared their
+   *  temporary buffers.
+   */
+  virtual void setup_workspace();
+  /** @brief Choose CPU algorithms and thread counts for layers.
+   *
+   *  Called in setup function if the "autotune" option is set. Choices
+   *  are cached in the file given by the "autotune_cache" option.
+   */
+  virtual void autotune_layers();
+  /** @brief Check placement of CPU activations after first touch.
+   *
+   *  Called once in setup function if the "numa_placement" option is
+   *  set. Stores the fraction of activation pages that are not on the
+   *  NUMA node of the OpenMP thread a static schedule would assign
+   *  them to. This is a check of the initial placement, not a measure
+   *  of remote accesses during training.
+   */
+  void count_activation_pages_off_node();
 
   /** @brief Reset model pointer and execution mode. */
   virtual void reset_mode_and_model(execution_mode mode);
@@ -497,6 +522,14 @@ private:
   /** @brief Flag that allows input layers to fetch data in the background */
   bool m_background_io_allowed = true;
 
+  /** @brief Scratch memory shared by layers. */
+  workspace_manager m_workspace;
+
+  /** @brief Fraction of CPU activation pages off their expected
+   *  NUMA node at setup.
+   */
+  EvalType m_activation_pages_off_node = EvalType(0);
+
   // ===========================================
   // Functions to add utility layers
   // ===========================================
@@ -83,6 +83,45 @@ class objective_function {
    */
   void compute_weight_regularization();
 
+  /** Enable dynamic loss scaling.
+   *
+   *  Gradients are computed with the objective function multiplied
+   *  by a loss scale, which keeps small error signals representable
+   *  in reduced precision. unscale_gradients must be called
+   *  before the optimization step. If a non-finite gradient is
+   *  detected, the step is skipped and the loss scale is multiplied
+   *  by backoff_factor. After growth_interval steps without
+   *  overflow, the loss scale is multiplied by growth_factor.
+   */
+  void set_loss_scaling(EvalType initial_scale,
+                        El::Int growth_interval,
+                        EvalType growth_factor,
+                        EvalType backoff_factor);
+  /** Get current loss scale. */
+  EvalType get_loss_scale() const { return m_loss_scale; }
+  /** Get number of optimization steps skipped due to overflow. */
+  El::Int get_num_skipped_steps() const { return m_num_skipped_steps; }
+
+  /** Remove loss scaling from weight gradients.
+   *  Also checks for non-finite gradients and updates the loss
+   *  scale. This must be called by every process in the trainer.
+   *  @returns Whether the optimization step should be performed.
+   */
+  bool unscale_gradients(lbann_comm& comm,
+                         const std::vector<weights*>& weights_list);
+
+  /** Save loss scaling state to checkpoint.
+   *  Only the trainer master writes. Nothing is written if loss
+   *  scaling is disabled.
+   */
+  bool save_to_checkpoint_shared(persist& p, lbann_comm& comm);
+  /** Load loss scaling state from checkpoint. */
+  bool load_from_checkpoint_shared(persist& p, lbann_comm& comm);
+  /** Save loss scaling state to per-rank checkpoint. */
+  bool save_to_checkpoint_distributed(persist& p);
+  /** Load loss scaling state from per-rank checkpoint. */
+  bool load_from_checkpoint_distributed(persist& p);
+
   /** Clear all statistics. */
   void reset_statistics() { m_statistics.clear(); }
   /** Clear statistics for an execution mode. */
@@ -128,6 +167,21 @@ class objective_function {
   /** Time spent computing the objective function gradient. */
   EvalType m_differentiation_time = EvalType(0);
 
+  /** Whether dynamic loss scaling is enabled. */
+  bool m_loss_scaling = false;
+  /** Current loss scale. */
+  EvalType m_loss_scale = EvalType(1);
+  /** Number of steps without overflow before loss scale increases. */
+  El::Int m_loss_scale_growth_interval = 0;
+  /** Loss scale increase factor. */
+  EvalType m_loss_scale_growth_factor = EvalType(1);
+  /** Loss scale decrease factor after overflow. */
+  EvalType m_loss_scale_backoff_factor = EvalType(1);
+  /** Number of steps without overflow since last loss scale change. */
+  El::Int m_num_good_steps = 0;
+  /** Number of steps skipped due to overflow. */
+  El::Int m_num_skipped_steps = 0;
+
 };
 
 } // namespace lbann
@@ -84,10 +84,19 @@ class objective_function_term {
   /** Set list of pointers to weights. */
   void set_weights_pointers(std::vector<weights*> w) { m_weights = w; }
 
+  /** Set loss scaling factor.
+   *  Gradients are multiplied by this factor in addition to the
+   *  term's scaling factor. It does not affect the objective
+   *  function value.
+   */
+  void set_loss_scale(EvalType scale) { m_loss_scale = scale; }
+
  protected:
 
   /** Scaling factor for objective function term. */
   EvalType m_scale_factor;
+  /** Loss scaling factor applied to gradients. */
+  EvalType m_loss_scale = EvalType(1);
 
   /** Layers used to compute objective function term. */
   std::vector<Layer*> m_layers;
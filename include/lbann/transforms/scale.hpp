@@ -42,6 +42,18 @@ public:
 
   std::string get_type() const override { return "scale"; }
 
+  fusion_role get_fusion_role() const override {
+    return fusion_role::channel_affine;
+  }
+
+  bool get_channel_affine(size_t num_channels,
+                          std::vector<DataType>& scale,
+                          std::vector<DataType>& bias) const override {
+    scale.assign(num_channels, m_scale);
+    bias.assign(num_channels, DataType(0));
+    return true;
+  }
+
   void apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) override;
 private:
   /** Amount to scale data by. */
@@ -32,10 +32,49 @@
 #include "lbann/utils/random.hpp"
 #include "lbann/utils/type_erased_matrix.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/image.hpp"
 
 namespace lbann {
 namespace transform {
 
+/**
+ * Region of an image that a transform reads, and the size it is resized to.
+ * Coordinates are in pixels of the image the crop was planned for.
+ */
+struct image_crop {
+  /** Column and row of the top-left corner. */
+  size_t x, y;
+  /** Height and width of the crop. */
+  size_t h, w;
+  /** Height and width of the output. */
+  size_t out_h, out_w;
+};
+
+/**
+ * How a transform can take part in a fused transform pipeline (see
+ * transform_pipeline).
+ */
+enum class fusion_role {
+  /** Cannot be fused. */
+  none,
+  /** Crops and resizes an image (see transform::plan_crop). */
+  crop,
+  /** Flips an image (see transform::plan_flip). */
+  flip,
+  /**
+   * Changes pixel values independently of pixel positions and keeps the
+   * number of channels, so it commutes with flips.
+   */
+  pixelwise,
+  /**
+   * Converts a uint8 image to LBANN's layout with a channel-wise affine map
+   * (see transform::get_channel_affine).
+   */
+  to_lbann_layout,
+  /** Applies a channel-wise affine map to DataType data. */
+  channel_affine
+};
+
 /**
  * Abstract base class for transforms on data.
  * 
@@ -88,6 +127,66 @@ public:
                      std::vector<size_t>& dims) {
     LBANN_ERROR("Non-in-place apply not implemented.");
   }
+
+  /**
+   * Plan the crop this transform would take from an image.
+   * Transforms that crop a rectangle of an image and resize it to a fixed
+   * size can report the rectangle before the image is decoded, so that the
+   * decoder can skip detail that would be discarded (see
+   * transform_pipeline::apply_encoded). Any random choices are made here.
+   * Applying the transform is equivalent to planning a crop and passing it
+   * to apply_crop.
+   * @param dims Dimensions of the image (channels, height, width).
+   * @param crop Will contain the planned crop.
+   * @returns False if the transform does not just crop and resize.
+   */
+  virtual bool plan_crop(const std::vector<size_t>& dims,
+                         image_crop& crop) const {
+    return false;
+  }
+
+  /** How this transform can be fused with its neighbors. */
+  virtual fusion_role get_fusion_role() const {
+    return fusion_role::none;
+  }
+
+  /**
+   * Plan the flips this transform would apply to an image.
+   * Any random choices are made here.
+   * @param horizontal Will be true if the image is flipped horizontally.
+   * @param vertical Will be true if the image is flipped vertically.
+   */
+  virtual void plan_flip(bool& horizontal, bool& vertical) const {
+    horizontal = false;
+    vertical = false;
+  }
+
+  /**
+   * Get the channel-wise affine map this transform applies.
+   * Value x in channel c is mapped to scale[c]*x + bias[c]. For transforms
+   * that convert to LBANN's layout, x is the original uint8 value.
+   * @param num_channels Number of channels in the data.
+   * @param scale Will contain num_channels scale factors.
+   * @param bias Will contain num_channels offsets.
+   * @returns False if the transform does not support num_channels.
+   */
+  virtual bool get_channel_affine(size_t num_channels,
+                                  std::vector<DataType>& scale,
+                                  std::vector<DataType>& bias) const {
+    return false;
+  }
+
+  /** Crop data and resize the crop to the crop's output size. */
+  static void apply_crop(utils::type_erased_matrix& data,
+                         std::vector<size_t>& dims,
+                         const image_crop& crop) {
+    El::Matrix<uint8_t> dst;
+    crop_and_resize(data.template get<uint8_t>(), dims,
+                    crop.x, crop.y, crop.h, crop.w,
+                    dst, crop.out_h, crop.out_w);
+    data.emplace<uint8_t>(std::move(dst));
+    dims = {dims[0], crop.out_h, crop.out_w};
+  }
 protected:
   /** Return a value uniformly at random in [a, b). */
   static inline float get_uniform_random(float a, float b) {
@@ -36,6 +36,22 @@ namespace transform {
 
 /**
  * Applies a sequence of transforms to input data.
+ *
+ * When converting uint8 images to LBANN's layout, common chains of vision
+ * transforms are run as a single fused kernel instead of one transform at a
+ * time. A chain can be fused if it consists of, in order:
+ *   - optionally, a transform that crops and resizes (e.g. resize or
+ *     random_resized_crop);
+ *   - any number of flips and pixel-wise transforms (e.g. horizontal_flip or
+ *     color_jitter);
+ *   - a conversion to LBANN's layout (to_lbann_layout or
+ *     normalize_to_lbann_layout);
+ *   - any number of channel-wise affine transforms (e.g. normalize or scale).
+ * The fused kernel bilinearly samples the crop, flips by mirroring sample
+ * positions, and applies the composed affine maps, writing straight into the
+ * output matrix. Pixel-wise transforms still run on a uint8 image between
+ * the crop and the fused kernel; since they commute with flips, flips are
+ * deferred to the kernel. Other pipelines use the per-transform path.
  */
 class transform_pipeline {
 public:
@@ -53,6 +69,7 @@ public:
    */
   void add_transform(std::unique_ptr<transform> trans) {
     m_transforms.push_back(std::move(trans));
+    plan_fusion();
   }
 
   /**
@@ -79,11 +96,58 @@ public:
    */
   void apply(El::Matrix<uint8_t>& data, CPUMat& out_data,
              std::vector<size_t>& dims);
+  /**
+   * Decode an encoded image and apply the transforms to it.
+   * If reduced-resolution decoding is enabled and the first transform
+   * crops and resizes (see transform::plan_crop), its crop is planned
+   * from the image header. JPEGs are then decoded at the smallest
+   * 1/2, 1/4, or 1/8 scale that still covers the output size, and the
+   * crop is taken from the reduced image.
+   * @param encoded The encoded image.
+   * @param out_data Output will be placed here. It will not be reallocated.
+   * @param dims Will contain the dimensions of the output.
+   */
+  void apply_encoded(El::Matrix<uint8_t>& encoded, CPUMat& out_data,
+                     std::vector<size_t>& dims);
+
+  /** Whether apply_encoded may decode images at reduced resolution. */
+  void set_reduced_resolution_decode(bool reduced) {
+    m_reduced_resolution_decode = reduced;
+  }
+
+  /** Whether apply may run fusable transform chains as one kernel. */
+  void set_fusion(bool fuse) { m_fuse = fuse; }
+  /** True if uint8 images are transformed with the fused kernel. */
+  bool is_fused() const { return m_fuse && m_fusable; }
 private:
   /** Ordered list of transforms to apply. */
   std::vector<std::unique_ptr<transform>> m_transforms;
   /** Expected dimensions after applying all transforms. */
   std::vector<size_t> m_expected_out_dims;
+  /** Whether apply_encoded may decode images at reduced resolution. */
+  bool m_reduced_resolution_decode = false;
+  /** Whether apply may run fusable transform chains as one kernel. */
+  bool m_fuse = true;
+  /** Whether the transforms form a fusable chain (see plan_fusion). */
+  bool m_fusable = false;
+  /** Index of the transform that converts to LBANN's layout. */
+  size_t m_layout_index = 0;
+
+  /**
+   * Apply transforms to uint8 data.
+   * @param crop If not null, the crop planned for the first transform.
+   */
+  void apply(El::Matrix<uint8_t>& data, CPUMat& out_data,
+             std::vector<size_t>& dims, const image_crop* crop);
+  /**
+   * Apply transforms to uint8 data with the fused kernel.
+   * @returns False, without modifying anything, if the transforms do not
+   * support the data.
+   */
+  bool apply_fused(El::Matrix<uint8_t>& data, CPUMat& out_data,
+                   std::vector<size_t>& dims, const image_crop* crop);
+  /** Determine whether the transforms form a fusable chain. */
+  void plan_fusion();
 
   /** Assert dims matches expected_out_dims (if set). */
   void assert_expected_out_dims(const std::vector<size_t>& dims);
@@ -54,6 +54,10 @@ public:
 
   std::string get_type() const override { return "adjust_contrast"; }
 
+  fusion_role get_fusion_role() const override {
+    return fusion_role::pixelwise;
+  }
+
   void apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) override;
 
 private:
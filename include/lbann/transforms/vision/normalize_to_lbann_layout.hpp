@@ -54,6 +54,14 @@ public:
 
   std::string get_type() const override { return "normalize_to_lbann_layout"; }
 
+  fusion_role get_fusion_role() const override {
+    return fusion_role::to_lbann_layout;
+  }
+
+  bool get_channel_affine(size_t num_channels,
+                          std::vector<DataType>& scale,
+                          std::vector<DataType>& bias) const override;
+
   bool supports_non_inplace() const { return true; }
 
   void apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) override;
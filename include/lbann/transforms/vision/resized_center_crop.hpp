@@ -43,7 +43,14 @@ public:
 
   std::string get_type() const override { return "resized_center_crop"; }
 
+  fusion_role get_fusion_role() const override {
+    return fusion_role::crop;
+  }
+
   void apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) override;
+
+  bool plan_crop(const std::vector<size_t>& dims,
+                 image_crop& crop) const override;
 private:
   /** Height and width of the resized image. */
   size_t m_h, m_w;
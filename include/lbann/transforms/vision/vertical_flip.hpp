@@ -42,6 +42,12 @@ public:
 
   std::string get_type() const override { return "vertical_flip"; }
 
+  fusion_role get_fusion_role() const override {
+    return fusion_role::flip;
+  }
+
+  void plan_flip(bool& horizontal, bool& vertical) const override;
+
   void apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) override;
 
 private:
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_AUTOTUNE_HPP_INCLUDED
+#define LBANN_UTILS_AUTOTUNE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Algorithm and thread count chosen by autotuning. */
+struct autotune_choice {
+  /** Name of CPU algorithm. */
+  std::string algorithm;
+  /** Number of OpenMP threads. */
+  int num_threads = 0;
+};
+
+/** @brief Persistent cache of autotuning choices.
+ *
+ *  Maps a key describing a layer's exact shape, the number of
+ *  threads and the CPU model to the fastest algorithm and thread
+ *  count found for it. The cache is stored as a text file with one
+ *  entry per line (key, algorithm name and number of threads,
+ *  separated by tabs), so a later job with the same model does no
+ *  tuning.
+ */
+class autotune_cache {
+public:
+
+  /** @param file_name  Cache file. Empty for an in-memory cache. */
+  autotune_cache(std::string file_name = "");
+
+  /** Read entries from cache file.
+   *  Does nothing if the file does not exist. Entries that cannot be
+   *  parsed are ignored.
+   */
+  void load();
+  /** Write all entries to cache file. */
+  void save() const;
+
+  /** Get cached choice for key.
+   *  Returns false if the key is not in the cache.
+   */
+  bool find(const std::string& key, autotune_choice& choice) const;
+  /** Add or replace cached choice for key. */
+  void insert(const std::string& key, autotune_choice choice);
+
+  /** Number of cached entries. */
+  size_t size() const { return m_choices.size(); }
+
+private:
+
+  /** Cache file. */
+  std::string m_file_name;
+  /** Cached choices. */
+  std::map<std::string, autotune_choice> m_choices;
+
+};
+
+/** Get CPU model name.
+ *  Read from /proc/cpuinfo if available, otherwise "unknown".
+ */
+std::string get_cpu_model_name();
+
+/** Thread counts considered by autotuning.
+ *  Halves max_threads until one thread, e.g. 16, 8, 4, 2, 1.
+ */
+std::vector<int> get_autotune_thread_counts(int max_threads);
+
+/** @brief Set the number of OpenMP threads within a scope.
+ *
+ *  Restores the previous number of threads on destruction. A
+ *  non-positive thread count leaves the number of threads unchanged.
+ */
+class omp_num_threads_guard {
+public:
+  omp_num_threads_guard(int num_threads);
+  ~omp_num_threads_guard();
+private:
+  int m_prev_num_threads;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_AUTOTUNE_HPP_INCLUDED
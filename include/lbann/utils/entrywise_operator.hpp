@@ -29,9 +29,189 @@
 
 #include "lbann/base.hpp"
 #include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
 namespace lbann {
 
+/** Maximum number of entries passed to a vectorized operator.
+ *
+ *  Operators may provide whole-vector variants of their entry-wise
+ *  functions:
+ *    - Unary: <tt>void apply_vector(const DataType* x, DataType* y,
+ *      El::Int size) const</tt>
+ *    - Binary: <tt>void apply_vector(const DataType* x1,
+ *      const DataType* x2, DataType* y, El::Int size) const</tt>
+ *
+ *  If provided, the entry-wise operator templates apply them to
+ *  contiguous blocks of at most this many entries instead of calling
+ *  the scalar operator on each entry. Operators can use stack
+ *  workspaces of this size.
+ */
+constexpr El::Int entrywise_block_size = 512;
+
+namespace entrywise_operator_details {
+
+/** Whether an operator provides a vectorized unary variant. */
+template <typename Op>
+class has_unary_vector_operator {
+  template <typename T>
+  static auto check(int)
+    -> decltype(std::declval<const T&>().apply_vector(
+                  std::declval<const DataType*>(),
+                  std::declval<DataType*>(),
+                  std::declval<El::Int>()),
+                std::true_type());
+  template <typename T> static std::false_type check(...);
+public:
+  static constexpr bool value = decltype(check<Op>(0))::value;
+};
+
+/** Whether an operator provides a vectorized binary variant. */
+template <typename Op>
+class has_binary_vector_operator {
+  template <typename T>
+  static auto check(int)
+    -> decltype(std::declval<const T&>().apply_vector(
+                  std::declval<const DataType*>(),
+                  std::declval<const DataType*>(),
+                  std::declval<DataType*>(),
+                  std::declval<El::Int>()),
+                std::true_type());
+  template <typename T> static std::false_type check(...);
+public:
+  static constexpr bool value = decltype(check<Op>(0))::value;
+};
+
+/** Apply a scalar unary operator to each entry. */
+template <typename UnaryOperator>
+void apply_unary_operator(const AbsMat& input,
+                          AbsMat& output,
+                          std::false_type) {
+  if (input.Contiguous() && output.Contiguous()) {
+    const auto* input_buffer = input.LockedBuffer();
+    auto* output_buffer = output.Buffer();
+    const size_t size = input.Height() * input.Width();
+    LBANN_OMP_PARALLEL_FOR
+    for (size_t i = 0; i < size; ++i) {
+      UnaryOperator op;
+      output_buffer[i] = op(input_buffer[i]);
+    }
+  } else {
+    auto const width = input.Width();
+    auto const height = input.Height();
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        UnaryOperator op;
+        output(row, col) = op(input(row, col));
+      }
+    }
+  }
+}
+
+/** Apply a vectorized unary operator to blocks of entries.
+ *  Blocks do not straddle matrix columns unless the matrices are
+ *  contiguous.
+ */
+template <typename UnaryOperator>
+void apply_unary_operator(const AbsMat& input,
+                          AbsMat& output,
+                          std::true_type) {
+  const bool contiguous = input.Contiguous() && output.Contiguous();
+  const El::Int col_size = (contiguous ?
+                            input.Height() * input.Width() :
+                            input.Height());
+  const El::Int num_cols = contiguous ? 1 : input.Width();
+  const El::Int num_blocks = ((col_size + entrywise_block_size - 1)
+                              / entrywise_block_size);
+  const auto* input_buffer = input.LockedBuffer();
+  auto* output_buffer = output.Buffer();
+  const El::Int input_ldim = input.LDim();
+  const El::Int output_ldim = output.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < num_cols; ++col) {
+    for (El::Int block = 0; block < num_blocks; ++block) {
+      const El::Int begin = block * entrywise_block_size;
+      const El::Int end = std::min(begin + entrywise_block_size, col_size);
+      UnaryOperator op;
+      op.apply_vector(&input_buffer[begin + col * input_ldim],
+                      &output_buffer[begin + col * output_ldim],
+                      end - begin);
+    }
+  }
+}
+
+/** Apply a scalar binary operator to each entry. */
+template <typename BinaryOperator>
+void apply_binary_operator(const AbsMat& input1,
+                           const AbsMat& input2,
+                           AbsMat& output,
+                           std::false_type) {
+  if (input1.Contiguous() && input2.Contiguous()
+      && output.Contiguous()) {
+    const auto* input1_buffer = input1.LockedBuffer();
+    const auto* input2_buffer = input2.LockedBuffer();
+    auto* output_buffer = output.Buffer();
+    const size_t size = input1.Height() * input1.Width();
+    LBANN_OMP_PARALLEL_FOR
+    for (size_t i = 0; i < size; ++i) {
+      BinaryOperator op;
+      output_buffer[i] = op(input1_buffer[i], input2_buffer[i]);
+    }
+  } else {
+    auto const width = input1.Width();
+    auto const height = input1.Height();
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        BinaryOperator op;
+        output(row, col) = op(input1(row, col), input2(row, col));
+      }
+    }
+  }
+}
+
+/** Apply a vectorized binary operator to blocks of entries.
+ *  Blocks do not straddle matrix columns unless the matrices are
+ *  contiguous.
+ */
+template <typename BinaryOperator>
+void apply_binary_operator(const AbsMat& input1,
+                           const AbsMat& input2,
+                           AbsMat& output,
+                           std::true_type) {
+  const bool contiguous = (input1.Contiguous() && input2.Contiguous()
+                           && output.Contiguous());
+  const El::Int col_size = (contiguous ?
+                            input1.Height() * input1.Width() :
+                            input1.Height());
+  const El::Int num_cols = contiguous ? 1 : input1.Width();
+  const El::Int num_blocks = ((col_size + entrywise_block_size - 1)
+                              / entrywise_block_size);
+  const auto* input1_buffer = input1.LockedBuffer();
+  const auto* input2_buffer = input2.LockedBuffer();
+  auto* output_buffer = output.Buffer();
+  const El::Int input1_ldim = input1.LDim();
+  const El::Int input2_ldim = input2.LDim();
+  const El::Int output_ldim = output.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < num_cols; ++col) {
+    for (El::Int block = 0; block < num_blocks; ++block) {
+      const El::Int begin = block * entrywise_block_size;
+      const El::Int end = std::min(begin + entrywise_block_size, col_size);
+      BinaryOperator op;
+      op.apply_vector(&input1_buffer[begin + col * input1_ldim],
+                      &input2_buffer[begin + col * input2_ldim],
+                      &output_buffer[begin + col * output_ldim],
+                      end - begin);
+    }
+  }
+}
+
+} // namespace entrywise_operator_details
+
 /** Apply an entry-wise unary operator to CPU data.
  *  The input and output data must be on CPU and must have the same
  *  dimensions.
@@ -56,26 +236,11 @@ void apply_entrywise_unary_operator(const AbsMat& input,
   }
 
   // Apply unary operator
-  if (input.Contiguous() && output.Contiguous()) {
-    const auto* input_buffer = input.LockedBuffer();
-    auto* output_buffer = output.Buffer();
-    const size_t size = input.Height() * input.Width();
-    LBANN_OMP_PARALLEL_FOR
-    for (size_t i = 0; i < size; ++i) {
-      UnaryOperator op;
-      output_buffer[i] = op(input_buffer[i]);
-    }
-  } else {
-    auto const width = input.Width();
-    auto const height = input.Height();
-    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-    for (El::Int col = 0; col < width; ++col) {
-      for (El::Int row = 0; row < height; ++row) {
-        UnaryOperator op;
-        output(row, col) = op(input(row, col));
-      }
-    }
-  }
+  using has_vector_operator
+    = entrywise_operator_details::has_unary_vector_operator<UnaryOperator>;
+  entrywise_operator_details::apply_unary_operator<UnaryOperator>(
+    input, output,
+    std::integral_constant<bool, has_vector_operator::value>());
 
 }
 
@@ -108,28 +273,11 @@ void apply_entrywise_binary_operator(const AbsMat& input1,
   }
 
   // Apply binary operator
-  if (input1.Contiguous() && input2.Contiguous()
-      && output.Contiguous()) {
-    const auto* input1_buffer = input1.LockedBuffer();
-    const auto* input2_buffer = input2.LockedBuffer();
-    auto* output_buffer = output.Buffer();
-    const size_t size = input1.Height() * input1.Width();
-    LBANN_OMP_PARALLEL_FOR
-    for (size_t i = 0; i < size; ++i) {
-      BinaryOperator op;
-      output_buffer[i] = op(input1_buffer[i], input2_buffer[i]);
-    }
-  } else {
-    auto const width = input1.Width();
-    auto const height = input1.Height();
-    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-    for (El::Int col = 0; col < width; ++col) {
-      for (El::Int row = 0; row < height; ++row) {
-        BinaryOperator op;
-        output(row, col) = op(input1(row, col), input2(row, col));
-      }
-    }
-  }
+  using has_vector_operator
+    = entrywise_operator_details::has_binary_vector_operator<BinaryOperator>;
+  entrywise_operator_details::apply_binary_operator<BinaryOperator>(
+    input1, input2, output,
+    std::integral_constant<bool, has_vector_operator::value>());
 
 }
 
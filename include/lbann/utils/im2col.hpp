@@ -28,6 +28,7 @@
 #define LBANN_UTILS_IM2COL_HPP
 
 #include "lbann/base.hpp"
+#include <algorithm>
 
 namespace lbann {
 
@@ -163,5 +164,115 @@ void col2im_2d(const DataType *__restrict__ input_buffer,
                int offset_stride_x,
                int offset_stride_y);
 
+/** Maximum number of entries in a 3D im2col workspace.
+ *  3D convolutions build the im2col matrix for a slab of window
+ *  shifts along the depth dimension at a time, so that memory use
+ *  does not scale with the full volume. A slab is never thinner than
+ *  one shift.
+ */
+constexpr El::Int im2col_3d_max_workspace_size = El::Int(1) << 24;
+
+/** Number of depth slices of window shifts in a 3D im2col slab.
+ *  @param window_size  Number of entries in a window, including
+ *                      channels.
+ *  @param slice_size   Number of window shifts in a depth slice.
+ */
+inline int im2col_3d_slab_depth(El::Int window_size, El::Int slice_size) {
+  const El::Int slice_entries = std::max(window_size * slice_size, El::Int(1));
+  return static_cast<int>(std::max(im2col_3d_max_workspace_size / slice_entries,
+                                   El::Int(1)));
+}
+
+/// Rearrange 3D image blocks into a transposed col matrix
+/** Produces rows [offset_z_begin*offset_num_y*offset_num_x,
+ *  offset_z_end*offset_num_y*offset_num_x) of the transpose of the
+ *  im2col col matrix, i.e. each row corresponds to a window shift
+ *  and each column to a window position. In this layout, a window
+ *  position and a row of window shifts read a strided (or, with unit
+ *  stride, contiguous) run of input entries and write a contiguous
+ *  run of output entries, so there is no per-entry index
+ *  arithmetic. Dimensions are ordered as (z, y, x), with x
+ *  contiguous.
+ *  @param output_ldim      Leading dimension of output matrix.
+ */
+void im2col_transposed_3d(const DataType *__restrict__ input_buffer,
+                          DataType *__restrict__ output_buffer,
+                          int output_ldim,
+                          int input_dim_x,
+                          int input_dim_y,
+                          int input_dim_z,
+                          int input_pad_x,
+                          int input_pad_y,
+                          int input_pad_z,
+                          int num_channels,
+                          int window_dim_x,
+                          int window_dim_y,
+                          int window_dim_z,
+                          int offset_stride_x,
+                          int offset_stride_y,
+                          int offset_stride_z,
+                          int offset_z_begin,
+                          int offset_z_end);
+
+/// Accumulate a transposed col matrix into 3D image blocks
+/** This is the adjoint of im2col_transposed_3d. Contributions from
+ *  rows [offset_z_begin*offset_num_y*offset_num_x,
+ *  offset_z_end*offset_num_y*offset_num_x) of the transposed col
+ *  matrix are added to the output tensor, which must be initialized
+ *  by the caller. Each thread owns a depth slice of one channel, so
+ *  no atomics are needed.
+ *  @param input_ldim       Leading dimension of input matrix.
+ */
+void col2im_transposed_3d(const DataType *__restrict__ input_buffer,
+                          int input_ldim,
+                          DataType *__restrict__ output_buffer,
+                          int output_dim_x,
+                          int output_dim_y,
+                          int output_dim_z,
+                          int output_pad_x,
+                          int output_pad_y,
+                          int output_pad_z,
+                          int num_channels,
+                          int window_dim_x,
+                          int window_dim_y,
+                          int window_dim_z,
+                          int offset_stride_x,
+                          int offset_stride_y,
+                          int offset_stride_z,
+                          int offset_z_begin,
+                          int offset_z_end);
+
+/** Default number of entries in a batched im2col workspace.
+ *  Convolutions build im2col matrices for as many samples as fit in
+ *  the workspace and apply them with a single GEMM. If a single
+ *  sample does not fit, samples are processed one at a time.
+ */
+constexpr El::Int default_im2col_workspace_size = El::Int(1) << 24;
+
+/// Stack channel-major samples along the rows of a matrix
+/** Sample j of the input has num_channels contiguous channels, each
+ *  with channel_size entries. Channel c of sample j is written to
+ *  rows [j*channel_size, (j+1)*channel_size) of column c of the
+ *  output, so a block of samples can be used as one GEMM operand.
+ *  @param input_ldim   Distance between input samples.
+ *  @param output_ldim  Leading dimension of output matrix.
+ */
+void stack_samples(const DataType *__restrict__ input_buffer,
+                   El::Int input_ldim,
+                   DataType *__restrict__ output_buffer,
+                   El::Int output_ldim,
+                   El::Int num_samples,
+                   El::Int channel_size,
+                   int num_channels);
+
+/// Inverse of stack_samples
+void unstack_samples(const DataType *__restrict__ input_buffer,
+                     El::Int input_ldim,
+                     DataType *__restrict__ output_buffer,
+                     El::Int output_ldim,
+                     El::Int num_samples,
+                     El::Int channel_size,
+                     int num_channels);
+
 } // end namespace
 #endif // LBANN_UTILS_IM2COL_HPP
@@ -51,6 +51,64 @@ void load_image(const std::string& filename, El::Matrix<uint8_t>& dst,
 void decode_image(El::Matrix<uint8_t>& src, El::Matrix<uint8_t>& dst,
                   std::vector<size_t>& dims);
 
+/**
+ * @brief Load an encoded image from filename without decoding it.
+ * @param filename The path to the image to load.
+ * @param dst Will contain the encoded image data.
+ */
+void load_encoded_image(const std::string& filename, El::Matrix<uint8_t>& dst);
+
+/**
+ * @brief Get the dimensions of an encoded image from its header.
+ * This only supports JPEG and PNG images and does not decode the image.
+ * @param src A buffer containing image data.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ * @returns Whether the dimensions could be determined.
+ */
+bool get_encoded_image_dims(const El::Matrix<uint8_t>& src,
+                            std::vector<size_t>& dims);
+
+/**
+ * @brief Check whether an encoded image is a JPEG.
+ * Only JPEG images can be decoded at reduced resolution.
+ * @param src A buffer containing image data.
+ */
+bool is_jpeg_image(const El::Matrix<uint8_t>& src);
+
+/**
+ * @brief Decode an image from buf at reduced resolution.
+ * JPEG images are downscaled in the DCT domain while decoding, which skips
+ * most of the inverse DCT and color conversion work. Each dimension is
+ * divided by scale and rounded up. Other formats are decoded at full
+ * resolution.
+ * @param src A buffer containing image data to be decoded.
+ * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ * @param scale Downscaling factor (1, 2, 4, or 8).
+ */
+void decode_image(El::Matrix<uint8_t>& src, El::Matrix<uint8_t>& dst,
+                  std::vector<size_t>& dims, size_t scale);
+
+/**
+ * @brief Crop an image and resize the crop with bilinear interpolation.
+ * @param src The image to crop, in OpenCV format.
+ * @param dims The dimensions of src.
+ * @param x Column of the crop's top-left corner.
+ * @param y Row of the crop's top-left corner.
+ * @param h Height of the crop.
+ * @param w Width of the crop.
+ * @param dst Will contain the resized crop, in OpenCV format.
+ * @param out_h Height of dst.
+ * @param out_w Width of dst.
+ */
+void crop_and_resize(El::Matrix<uint8_t>& src,
+                     const std::vector<size_t>& dims,
+                     size_t x, size_t y, size_t h, size_t w,
+                     El::Matrix<uint8_t>& dst,
+                     size_t out_h, size_t out_w);
+
 /**
  * @brief Save an image to filename.
  * @param filename The path to the image to write.
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_KEY_INDEX_SORT_HPP_INCLUDED
+#define LBANN_UTILS_KEY_INDEX_SORT_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+namespace key_index_sort_details {
+
+/** @brief Unsigned integer type with the same width as a float type. */
+template <typename T> struct radix_key;
+template <> struct radix_key<float>  { using type = std::uint32_t; };
+template <> struct radix_key<double> { using type = std::uint64_t; };
+
+/** @brief Map a floating-point value to an unsigned integer that
+ *  preserves ordering.
+ *
+ *  Negative values have all bits flipped and positive values have
+ *  their sign bit flipped, so that unsigned integer comparison
+ *  matches floating-point comparison (-0 orders before +0). For
+ *  descending order, all bits are flipped once more.
+ */
+template <typename T>
+inline typename radix_key<T>::type to_radix_key(T value, bool descending) {
+  using key_t = typename radix_key<T>::type;
+  constexpr int sign_shift = 8 * sizeof(key_t) - 1;
+  key_t bits;
+  std::memcpy(&bits, &value, sizeof(key_t));
+  const key_t sign_mask = key_t(1) << sign_shift;
+  const key_t flip = (bits >> sign_shift) ? ~key_t(0) : sign_mask;
+  const key_t desc_flip = descending ? ~key_t(0) : key_t(0);
+  return (bits ^ flip) ^ desc_flip;
+}
+
+} // namespace key_index_sort_details
+
+/** @brief Sort engine for (value, index) pairs.
+ *
+ *  Sorts a contiguous array of values and produces the permutation
+ *  that sorts it. Values are converted into order-preserving unsigned
+ *  integer keys and sorted with a stable least-significant-digit
+ *  radix sort on contiguous key and index arrays. The key conversion
+ *  and histogram loops are branch-free so that they vectorize; digits
+ *  that are identical across all keys are skipped, which makes most
+ *  realistic inputs cost two or three scatter passes. Short arrays
+ *  fall back to a comparison sort.
+ *
+ *  A partial (top-k) mode only guarantees that the first k outputs
+ *  are sorted. The remaining outputs hold the other entries in
+ *  unspecified order, so the output is still a permutation of the
+ *  input and the indices remain valid for backprop.
+ *
+ *  Ties are broken by input position, so results are deterministic.
+ *
+ *  Each object owns its workspace and is not thread-safe. Use one
+ *  object per thread and reuse it across calls to avoid allocations.
+ */
+template <typename T, typename IndexType>
+class key_index_sorter {
+  static_assert(std::is_floating_point<T>::value,
+                "key_index_sorter requires a floating-point value type");
+public:
+  using key_type = typename key_index_sort_details::radix_key<T>::type;
+
+  /** Arrays shorter than this are sorted with a comparison sort. */
+  static constexpr IndexType comparison_sort_threshold = 256;
+  /** Partial sorts are used if k is at most this fraction of the
+   *  array size. */
+  static constexpr IndexType partial_sort_ratio = 8;
+
+  /** @brief Sort values.
+   *
+   *  @param values          Input values (contiguous, length size).
+   *  @param size            Number of entries.
+   *  @param descending      Whether to sort in descending order.
+   *  @param sorted_values   Output values (contiguous, length size).
+   *  @param sorted_indices  Input positions of output values
+   *                         (contiguous, length size).
+   *  @param k               If positive and less than size, only the
+   *                         first k outputs are guaranteed to be
+   *                         sorted.
+   */
+  void sort(const T* values,
+            IndexType size,
+            bool descending,
+            T* sorted_values,
+            IndexType* sorted_indices,
+            IndexType k = 0) {
+    if (size <= 0) { return; }
+    if (k <= 0 || k > size) { k = size; }
+
+    // Convert values to order-preserving integer keys
+    m_keys.resize(size);
+    auto* __restrict__ keys = m_keys.data();
+    for (IndexType i = 0; i < size; ++i) {
+      keys[i] = key_index_sort_details::to_radix_key(values[i], descending);
+    }
+
+    // Sort keys and indices
+    if (k < size && k <= size / partial_sort_ratio) {
+      comparison_sort(size, k, sorted_indices);
+    } else if (size < comparison_sort_threshold) {
+      comparison_sort(size, size, sorted_indices);
+    } else {
+      radix_sort(size, sorted_indices);
+    }
+
+    // Gather values in sorted order
+    for (IndexType i = 0; i < size; ++i) {
+      sorted_values[i] = values[sorted_indices[i]];
+    }
+
+  }
+
+private:
+
+  /** Number of bits per radix digit. */
+  static constexpr int digit_bits = 8;
+  /** Number of buckets per radix digit. */
+  static constexpr int num_buckets = 1 << digit_bits;
+  /** Number of radix digits per key. */
+  static constexpr int num_digits = 8 * sizeof(key_type) / digit_bits;
+
+  /** Keys for entries. */
+  std::vector<key_type> m_keys;
+  /** Scratch space for keys. */
+  std::vector<key_type> m_keys_tmp;
+  /** Scratch space for indices. */
+  std::vector<IndexType> m_indices_tmp;
+  /** Scratch space for (key, index) pairs. */
+  std::vector<std::pair<key_type, IndexType>> m_pairs;
+  /** Histogram of each radix digit. */
+  std::vector<IndexType> m_histograms;
+
+  /** Stable LSD radix sort on m_keys. */
+  void radix_sort(IndexType size, IndexType* sorted_indices) {
+
+    // Histogram all digits in a single pass
+    m_histograms.assign(num_digits * num_buckets, 0);
+    auto* hist = m_histograms.data();
+    const auto* keys = m_keys.data();
+    for (IndexType i = 0; i < size; ++i) {
+      const auto& key = keys[i];
+      for (int d = 0; d < num_digits; ++d) {
+        const auto bucket = (key >> (d * digit_bits)) & (num_buckets - 1);
+        hist[d * num_buckets + bucket]++;
+      }
+    }
+
+    // Initialize permutation
+    m_keys_tmp.resize(size);
+    m_indices_tmp.resize(size);
+    for (IndexType i = 0; i < size; ++i) {
+      m_indices_tmp[i] = i;
+    }
+    key_type* src_keys = m_keys.data();
+    key_type* dst_keys = m_keys_tmp.data();
+    IndexType* src_inds = m_indices_tmp.data();
+    IndexType* dst_inds = sorted_indices;
+
+    // Scatter pass for each digit
+    for (int d = 0; d < num_digits; ++d) {
+      auto* digit_hist = &hist[d * num_buckets];
+      const auto first_bucket = (src_keys[0] >> (d * digit_bits)) & (num_buckets - 1);
+      if (digit_hist[first_bucket] == size) {
+        // All keys share this digit
+        continue;
+      }
+      IndexType offset = 0;
+      for (int b = 0; b < num_buckets; ++b) {
+        const auto count = digit_hist[b];
+        digit_hist[b] = offset;
+        offset += count;
+      }
+      for (IndexType i = 0; i < size; ++i) {
+        const auto& key = src_keys[i];
+        const auto bucket = (key >> (d * digit_bits)) & (num_buckets - 1);
+        const auto pos = digit_hist[bucket]++;
+        dst_keys[pos] = key;
+        dst_inds[pos] = src_inds[i];
+      }
+      std::swap(src_keys, dst_keys);
+      std::swap(src_inds, dst_inds);
+    }
+
+    // Make sure indices end up in output buffer
+    if (src_inds != sorted_indices) {
+      std::copy(src_inds, src_inds + size, sorted_indices);
+    }
+
+  }
+
+  /** Comparison sort on m_keys for short arrays or partial sorts. */
+  void comparison_sort(IndexType size, IndexType k, IndexType* sorted_indices) {
+    m_pairs.resize(size);
+    for (IndexType i = 0; i < size; ++i) {
+      m_pairs[i].first = m_keys[i];
+      m_pairs[i].second = i;
+    }
+    if (k < size) {
+      std::nth_element(m_pairs.begin(), m_pairs.begin() + (k - 1), m_pairs.end());
+      std::sort(m_pairs.begin(), m_pairs.begin() + k);
+    } else {
+      std::sort(m_pairs.begin(), m_pairs.end());
+    }
+    for (IndexType i = 0; i < size; ++i) {
+      sorted_indices[i] = m_pairs[i].second;
+    }
+  }
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_KEY_INDEX_SORT_HPP_INCLUDED
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_MAPPED_FILE_HPP_INCLUDED
+#define LBANN_UTILS_MAPPED_FILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+namespace lbann {
+
+/** @brief Read-only memory mapping of a file.
+ *
+ *  The file's contents are paged in on demand and shared through
+ *  the page cache with every other process on the node that maps
+ *  the same file.
+ */
+class mapped_file {
+public:
+  mapped_file() = default;
+  /** Map the file at path. */
+  explicit mapped_file(const std::string& path);
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+  mapped_file(mapped_file&& other) noexcept;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+  ~mapped_file();
+
+  /** Map the file at path, unmapping the current file. */
+  void open(const std::string& path);
+  /** Unmap the file. */
+  void close();
+
+  /** Whether a file is mapped. */
+  bool is_open() const { return !m_path.empty(); }
+  /** Contents of the file (null if the file is empty). */
+  const char* data() const { return m_data; }
+  /** Size of the file in bytes. */
+  size_t size() const { return m_size; }
+  /** Path of the mapped file. */
+  const std::string& path() const { return m_path; }
+
+  /** Hint that the file will be read sequentially. */
+  void advise_sequential() const;
+  /** Hint that the file will be read in random order. */
+  void advise_random() const;
+  /** Hint that a byte range will be read soon. */
+  void prefetch(size_t offset, size_t length) const;
+  /** Drop this process's resident pages.
+   *  The pages stay in the page cache and are faulted back in if
+   *  they are read again.
+   */
+  void evict() const;
+
+private:
+  /** Start of the mapping. */
+  const char* m_data = nullptr;
+  /** Size of the mapping. */
+  size_t m_size = 0;
+  /** Path of the mapped file. */
+  std::string m_path;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_MAPPED_FILE_HPP_INCLUDED
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_MAPPED_NPY_HPP_INCLUDED
+#define LBANN_UTILS_MAPPED_NPY_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/mapped_file.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Numpy array accessed through a memory mapping.
+ *
+ *  Unlike cnpy::npy_load and cnpy::npz_load, which read every array
+ *  into memory, only the pages of the file that are actually read
+ *  become resident. Arrays in .npy files and uncompressed members of
+ *  .npz files (np.savez, not np.savez_compressed) are supported.
+ *  Arrays must be little-endian and in C order.
+ *
+ *  Copies share the mapping.
+ */
+class mapped_npy_array {
+public:
+
+  /** Map the array in a .npy file. */
+  void open_npy(const std::string& path);
+  /** Map an array in a .npz file.
+   *  @returns False if the file has no member named key or if the
+   *  member is compressed.
+   */
+  bool open_npz(const std::string& path, const std::string& key);
+  /** Unmap the array. */
+  void close();
+
+  /** Whether an array is mapped. */
+  bool is_open() const { return m_file != nullptr; }
+  /** Numpy type kind ('f', 'i', 'u', or 'b'). */
+  char get_type() const { return m_type; }
+  /** Size of an array entry in bytes. */
+  size_t get_word_size() const { return m_word_size; }
+  /** Array dimensions. */
+  const std::vector<size_t>& get_shape() const { return m_shape; }
+  /** Number of entries along the zero'th axis. */
+  size_t get_num_rows() const { return m_shape.empty() ? 1 : m_shape[0]; }
+  /** Number of entries in each row. */
+  size_t get_row_size() const { return m_row_size; }
+
+  /** @brief Convert entries of a row to DataType.
+   *  @param row    Row index.
+   *  @param first  Index of first entry within the row.
+   *  @param count  Number of entries to convert.
+   *  @param out    Output buffer with count entries.
+   *  @param scale  Factor applied to integer entries.
+   */
+  void copy_row(size_t row,
+                size_t first,
+                size_t count,
+                DataType* out,
+                DataType scale = DataType(1)) const;
+  /** Get an entry of a row as DataType. */
+  DataType get_value(size_t row, size_t col) const {
+    DataType value;
+    copy_row(row, col, 1, &value);
+    return value;
+  }
+
+  /** Hint that the rows in indices will be read soon.
+   *  Runs of consecutive rows are prefetched together.
+   */
+  void prefetch_rows(const std::vector<int>& indices) const;
+  /** Drop this process's resident pages. */
+  void evict() const { if (m_file != nullptr) { m_file->evict(); } }
+
+private:
+
+  /** Memory-mapped file. */
+  std::shared_ptr<const mapped_file> m_file;
+  /** Offset of the array's data in the file. */
+  size_t m_data_offset = 0;
+  /** Numpy type kind. */
+  char m_type = 0;
+  /** Size of an array entry in bytes. */
+  size_t m_word_size = 0;
+  /** Array dimensions. */
+  std::vector<size_t> m_shape;
+  /** Number of entries in each row. */
+  size_t m_row_size = 0;
+
+  /** Parse the .npy header at offset in m_file. */
+  void parse_header(size_t offset);
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_MAPPED_NPY_HPP_INCLUDED
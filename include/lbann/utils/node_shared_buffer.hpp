@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_NODE_SHARED_BUFFER_HPP_INCLUDED
+#define LBANN_UTILS_NODE_SHARED_BUFFER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <mpi.h>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Memory shared by the processes of a node.
+ *
+ *  The processes of a communicator that run on the same compute
+ *  node map a single buffer through an MPI-3 shared-memory window.
+ *  The buffer is either filled by the first process on each node or
+ *  split into one segment per process, each filled by its own
+ *  process. Writes become visible to the other processes after
+ *  barrier.
+ */
+class node_shared_buffer {
+public:
+  node_shared_buffer() = default;
+  node_shared_buffer(const node_shared_buffer&) = delete;
+  node_shared_buffer& operator=(const node_shared_buffer&) = delete;
+  ~node_shared_buffer();
+
+  /** Allocate size bytes. Collective over c. */
+  void allocate(const El::mpi::Comm& c, size_t size);
+  /** Allocate a segment of local_size bytes for each process, laid
+   *  out contiguously in node rank order. Collective over c. */
+  void allocate_segments(const El::mpi::Comm& c, size_t local_size);
+  /** Release the buffer. Collective over the processes that share it. */
+  void free();
+
+  /** Whether this is the process that fills the buffer. */
+  bool is_node_root() const { return m_rank_in_node == 0; }
+  /** Start of the buffer. */
+  char* data() const { return m_data; }
+  /** Size of the buffer in bytes. */
+  size_t size() const { return m_size; }
+  /** Rank of this process among the processes sharing the buffer. */
+  int get_rank_in_node() const { return m_rank_in_node; }
+  /** Number of processes sharing the buffer. */
+  int get_procs_in_node() const { return m_segment_offsets.size() - 1; }
+  /** Start of a process's segment. */
+  char* segment(int rank_in_node) const {
+    return m_data + m_segment_offsets[rank_in_node];
+  }
+  /** Size of a process's segment in bytes. */
+  size_t segment_size(int rank_in_node) const {
+    return m_segment_offsets[rank_in_node + 1] - m_segment_offsets[rank_in_node];
+  }
+  /** Wait until every process on the node reaches the barrier,
+   *  making writes to the buffer visible to all of them. */
+  void barrier() const;
+
+private:
+  /** Processes of the communicator that share this node. */
+  MPI_Comm m_node_comm = MPI_COMM_NULL;
+  /** Shared-memory window. */
+  MPI_Win m_win = MPI_WIN_NULL;
+  /** Rank in m_node_comm. */
+  int m_rank_in_node = 0;
+  /** Start of the buffer. */
+  char* m_data = nullptr;
+  /** Size of the buffer in bytes. */
+  size_t m_size = 0;
+  /** Offsets of the process segments, followed by the buffer size.
+   *  With allocate, the node root owns the whole buffer. */
+  std::vector<size_t> m_segment_offsets;
+
+  /** Create the communicator of the processes of c on this node. */
+  void split_node_comm(const El::mpi::Comm& c);
+  /** Create the window with a segment of the given size per process. */
+  void create_window(const std::vector<size_t>& segment_sizes);
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_NODE_SHARED_BUFFER_HPP_INCLUDED
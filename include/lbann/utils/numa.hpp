@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_NUMA_HPP_INCLUDED
+#define LBANN_UTILS_NUMA_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Processor and memory topology of a compute node.
+ *
+ *  Vectors are indexed by CPU (i.e. hardware thread) id. Absent or
+ *  offline CPUs have negative entries.
+ */
+struct cpu_topology {
+  /** Socket of each CPU. */
+  std::vector<int> cpu_sockets;
+  /** Physical core of each CPU, numbered across the node. */
+  std::vector<int> cpu_cores;
+  /** NUMA node of each CPU. */
+  std::vector<int> cpu_numa_nodes;
+
+  /** Number of CPU ids. */
+  int get_num_cpus() const { return cpu_sockets.size(); }
+  /** Number of sockets. */
+  int get_num_sockets() const;
+  /** Number of physical cores. */
+  int get_num_cores() const;
+  /** Number of NUMA nodes with CPUs. */
+  int get_num_numa_nodes() const;
+  /** NUMA node of a CPU, or -1 if unknown. */
+  int get_numa_node(int cpu) const {
+    return (cpu >= 0 && cpu < get_num_cpus() ? cpu_numa_nodes[cpu] : -1);
+  }
+};
+
+/** Parse a Linux CPU list, e.g. "0-3,8,10-11". */
+std::vector<int> parse_cpu_list(const std::string& list);
+
+/** Read topology from sysfs.
+ *  If sysfs entries are missing, each online CPU is treated as a
+ *  separate core on socket 0 and NUMA node 0.
+ *  @param sysfs_root   Mount point of sysfs.
+ */
+cpu_topology detect_cpu_topology(const std::string& sysfs_root = "/sys");
+
+/** Topology of this node.
+ *  Detected on first call.
+ */
+const cpu_topology& get_cpu_topology();
+
+/** CPUs that the calling thread may run on. */
+std::vector<int> get_allowed_cpus();
+
+/** @brief Assignment of CPUs to the threads of a process. */
+struct thread_placement {
+  /** CPU for each compute (OpenMP) thread. */
+  std::vector<int> compute_cpus;
+  /** CPUs for I/O threads. Disjoint from compute_cpus. */
+  std::vector<int> io_cpus;
+};
+
+/** Assign CPUs to compute and I/O threads.
+ *
+ *  Compute threads get one hardware thread on each of the first
+ *  physical cores, with cores spread evenly over the NUMA nodes in
+ *  allowed_cpus. I/O threads get CPUs on the remaining cores, and
+ *  only use hyperthread siblings of compute cores if there are no
+ *  free cores. If there are fewer allowed CPUs than compute threads,
+ *  compute CPUs are reused and io_cpus is empty.
+ */
+thread_placement make_thread_placement(const cpu_topology& topo,
+                                       const std::vector<int>& allowed_cpus,
+                                       int num_compute_threads,
+                                       int num_io_threads);
+
+/** Bind OpenMP threads to compute CPUs.
+ *
+ *  OpenMP thread i may run on any compute CPU in the NUMA node of
+ *  compute_cpus[i]. Binding to a NUMA node rather than a single CPU
+ *  keeps nested thread teams, which inherit their creator's
+ *  affinity, from sharing one CPU. Must be called outside of a
+ *  parallel region.
+ */
+void bind_compute_threads(const cpu_topology& topo,
+                          const std::vector<int>& compute_cpus);
+
+/** Zero a matrix with the OpenMP schedule of entry-wise kernels.
+ *  Pages are placed on the NUMA node of the first thread that writes
+ *  them, so this puts each page near the thread that will compute
+ *  it. Does nothing for views and GPU matrices.
+ */
+void first_touch(AbsMat& m);
+
+/** NUMA node of each OpenMP thread. */
+std::vector<int> get_omp_thread_numa_nodes(const cpu_topology& topo);
+
+/** Count pages of a buffer that are remote to the OpenMP threads
+ *  that process them.
+ *
+ *  Entries are assigned to threads with a static schedule over the
+ *  whole buffer, as in entry-wise kernels. A page is remote if it is
+ *  on a different NUMA node than its thread. Pages that have not
+ *  been touched are not counted.
+ *  @param thread_nodes     NUMA node of each OpenMP thread.
+ *  @param num_pages        Incremented by number of resident pages.
+ *  @param num_remote_pages Incremented by number of remote pages.
+ */
+void count_remote_pages(const void* buffer,
+                        size_t size,
+                        const std::vector<int>& thread_nodes,
+                        size_t& num_pages,
+                        size_t& num_remote_pages);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_NUMA_HPP_INCLUDED
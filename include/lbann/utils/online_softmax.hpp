@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_ONLINE_SOFTMAX_HPP_INCLUDED
+#define LBANN_UTILS_ONLINE_SOFTMAX_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <cmath>
+
+namespace lbann {
+
+/** @brief Compute softmax statistics of a vector in a single pass.
+ *
+ *  Computes @f$ m = \max_i x_i @f$ and
+ *  @f$ s = \sum_i e^{x_i - m} @f$ without a separate pass for the
+ *  maximum. The input is processed in short blocks: each block's
+ *  maximum is found and the running sum is rescaled if it increases,
+ *  then the block's exponentials are accumulated. See Milakov and
+ *  Gimelshein, "Online normalizer calculation for softmax" (2018).
+ *
+ *  An empty vector produces the identity of
+ *  combine_softmax_stats, i.e. m is the lowest finite value and s
+ *  is zero.
+ */
+void online_softmax_stats(const DataType* x,
+                          El::Int size,
+                          DataType& max,
+                          DataType& sum);
+
+/** @brief Combine two sets of softmax statistics.
+ *  Updates (max, sum) so that it describes the concatenation of the
+ *  vectors described by (max, sum) and (other_max, other_sum).
+ */
+inline void combine_softmax_stats(DataType& max,
+                                  DataType& sum,
+                                  DataType other_max,
+                                  DataType other_sum) {
+  if (other_max > max) {
+    sum = sum * std::exp(max - other_max) + other_sum;
+    max = other_max;
+  } else {
+    sum = sum + other_sum * std::exp(other_max - max);
+  }
+}
+
+/** @brief MPI reduction operation for packed softmax statistics.
+ *
+ *  Entries are tuples whose size is deduced from the MPI datatype.
+ *  The first two entries of each tuple are (max, sum) softmax
+ *  statistics and are combined with combine_softmax_stats. Any
+ *  remaining entries are summed. This lets max and sum be reduced
+ *  with a single message (see lbann_comm::allreduce_softmax_stats).
+ */
+void softmax_stats_op(void* in, void* inout, int* len, MPI_Datatype* type);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_ONLINE_SOFTMAX_HPP_INCLUDED
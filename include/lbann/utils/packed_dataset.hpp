@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_PACKED_DATASET_HPP_INCLUDED
+#define LBANN_UTILS_PACKED_DATASET_HPP_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Location of a sample in a packed dataset. */
+struct packed_sample {
+  /** Byte offset of the sample in its shard. */
+  uint64_t offset;
+  /** Size of the sample in bytes. */
+  uint32_t size;
+  /** Index of the shard that contains the sample. */
+  uint32_t shard;
+  /** Sample label. */
+  int32_t label;
+  /** Unused. */
+  uint32_t reserved;
+};
+
+/** @brief Dataset of encoded samples packed into a few large files.
+ *
+ *  Opening one file per sample makes metadata operations the
+ *  bottleneck on parallel file systems. A packed dataset instead
+ *  concatenates encoded samples (e.g. JPEGs) into shard files, and
+ *  an index file records each sample's shard, offset, size, and
+ *  label.
+ *
+ *  The index file starts with a packed_dataset::header, followed by
+ *  the shard file names (a 32-bit length and the characters of each,
+ *  relative to the index file's directory) and a packed_sample for
+ *  each sample. Integers are stored in host byte order.
+ *
+ *  Samples for a mini-batch are read with prefetch, which sorts them
+ *  by location and coalesces neighbors into large aligned reads.
+ *  Shard files stay open, so reads cost no metadata operations.
+ *  Reads may optionally bypass the page cache with O_DIRECT, or hint
+ *  the kernel to read ahead.
+ */
+class packed_dataset {
+public:
+
+  /** @brief Beginning of the index file. */
+  struct header {
+    /** File type identifier (see index_magic). */
+    char magic[8];
+    /** Format version. */
+    uint32_t version;
+    /** Number of shard files. */
+    uint32_t num_shards;
+    /** Number of samples. */
+    uint64_t num_samples;
+  };
+
+  /** File type identifier of index files. */
+  static constexpr char index_magic[8] = "LBPACK";
+  /** Current format version. */
+  static constexpr uint32_t format_version = 1;
+  /** Alignment of reads. */
+  static constexpr size_t read_alignment = 4096;
+
+  /** Check whether path is a packed dataset index file. */
+  static bool is_index_file(const std::string& path);
+
+  /** Write an index file. */
+  static void write_index(const std::string& path,
+                          const std::vector<std::string>& shards,
+                          const std::vector<packed_sample>& samples);
+
+  /** Open a packed dataset.
+   *  @param index_path  Index file.
+   *  @param direct_io   Whether to read shards with O_DIRECT.
+   *  @param readahead   Whether to ask the kernel to read ahead
+   *                     prefetched ranges. Ignored with direct_io.
+   */
+  packed_dataset(const std::string& index_path,
+                 bool direct_io = false,
+                 bool readahead = true);
+  /** Copies share the index but open their own shard files. */
+  packed_dataset(const packed_dataset& other);
+  packed_dataset& operator=(const packed_dataset& other) = delete;
+  ~packed_dataset();
+
+  /** Number of samples. */
+  size_t get_num_samples() const { return m_index->samples.size(); }
+  /** Location and label of a sample. */
+  const packed_sample& get_sample(size_t index) const {
+    return m_index->samples[index];
+  }
+
+  /** @brief Read samples with large sequential reads.
+   *
+   *  Samples are sorted by shard and offset. Samples in the same
+   *  shard that are separated by at most max_gap bytes are read with
+   *  one aligned read of at most max_read_size bytes. Data for
+   *  previously prefetched samples is released.
+   */
+  void prefetch(const std::vector<size_t>& samples);
+
+  /** @brief Get a prefetched sample.
+   *  @returns Pointer to the sample's data, which is valid until the
+   *  next call to prefetch, or a null pointer if the sample was not
+   *  prefetched.
+   */
+  uint8_t* get_prefetched(size_t index) const;
+
+  /** @brief Read a sample into buf.
+   *  This is safe to call concurrently from multiple threads.
+   */
+  void read_sample(size_t index, uint8_t* buf) const;
+
+  /** Bytes between samples that are read rather than skipped. */
+  size_t max_gap = 1 << 20;
+  /** Maximum size of a single read. */
+  size_t max_read_size = 64 << 20;
+
+private:
+
+  /** Contents of the index file. */
+  struct index {
+    /** Directory containing the index file. */
+    std::string dir;
+    /** Shard file names. */
+    std::vector<std::string> shards;
+    /** Sample locations. */
+    std::vector<packed_sample> samples;
+  };
+
+  /** Aligned memory for reads. */
+  struct aligned_buffer {
+    std::unique_ptr<uint8_t, void(*)(void*)> data{nullptr, std::free};
+    size_t size = 0;
+    void resize(size_t size);
+  };
+
+  /** Shared index. */
+  std::shared_ptr<const index> m_index;
+  /** Whether shards are read with O_DIRECT. */
+  bool m_direct_io;
+  /** Whether to ask the kernel to read ahead. */
+  bool m_readahead;
+  /** File descriptors of shard files (-1 if not open). */
+  mutable std::vector<int> m_fds;
+  /** Protects m_fds. */
+  mutable std::mutex m_fds_mutex;
+  /** Data for prefetched samples. */
+  aligned_buffer m_buffer;
+  /** Positions of prefetched samples in m_buffer. */
+  std::unordered_map<size_t, size_t> m_prefetched;
+
+  /** Get a file descriptor for a shard, opening it if needed. */
+  int get_fd(uint32_t shard) const;
+  /** Read [offset, offset+size) of a shard into buf, which must be
+   *  aligned if using direct I/O. offset and size must be aligned if
+   *  using direct I/O. Returns the number of bytes read, which is
+   *  only less than size at the end of the file.
+   */
+  size_t read_range(uint32_t shard, uint64_t offset, size_t size,
+                    uint8_t* buf) const;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_PACKED_DATASET_HPP_INCLUDED
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_SAMPLE_LIST_INDEX_HPP_INCLUDED
+#define LBANN_UTILS_SAMPLE_LIST_INDEX_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Read-only view of a binary, indexed sample list.
+ *
+ *  The index holds a table of data files, a table of samples and a
+ *  pool of names. Tables have fixed-size records, so any sample can
+ *  be looked up in constant time without parsing the rest of the
+ *  list, and a process can read just its own range of samples. The
+ *  view does not own its buffer, which may be a memory-mapped file
+ *  or memory shared by the processes of a node. Ids are checked
+ *  against the tables, so a corrupt index raises an error instead of
+ *  reading past them.
+ *
+ *  Layout (native byte order): a header, the file table
+ *  (name and total number of samples in the file), the sample table
+ *  (file id and name), and the name pool.
+ */
+class sample_list_index {
+public:
+  sample_list_index() = default;
+
+  /** Attach to an index stored in buf. path is only used in error
+   *  messages. The buffer must outlive the view.
+   */
+  void attach(const char* buf, size_t size, const std::string& path = "");
+  /** Whether the view is attached to an index. */
+  bool is_attached() const { return m_buf != nullptr; }
+
+  /** Number of data files. */
+  size_t get_num_files() const { return m_num_files; }
+  /** Number of samples. */
+  size_t get_num_samples() const { return m_num_samples; }
+  /** Root directory of the data files. */
+  std::string get_file_dir() const;
+  /** Name of a data file, relative to the root directory. */
+  std::string get_file_name(size_t file_id) const;
+  /** Total number of samples in a data file, including the ones
+   *  that are not in the list. */
+  size_t get_file_num_samples(size_t file_id) const;
+  /** Id of the data file that holds a sample. */
+  size_t get_sample_file_id(size_t i) const;
+  /** Name of a sample within its data file. */
+  std::string get_sample_name(size_t i) const;
+
+  /** Whether the file at path starts with the index signature. */
+  static bool is_index_file(const std::string& path);
+
+  /** Range [begin, end) of samples assigned to slice of
+   *  num_slices equal, contiguous slices. */
+  static void get_slice(size_t num_samples, size_t num_slices, size_t slice,
+                        size_t& begin, size_t& end);
+
+private:
+  /** Start of the index. */
+  const char* m_buf = nullptr;
+  /** Size of the index in bytes. */
+  size_t m_size = 0;
+  size_t m_num_files = 0;
+  size_t m_num_samples = 0;
+  /** Start of the file table. */
+  const char* m_files = nullptr;
+  /** Start of the sample table. */
+  const char* m_samples = nullptr;
+  /** Start of the name pool. */
+  const char* m_names = nullptr;
+  /** Size of the name pool in bytes. */
+  size_t m_names_size = 0;
+  /** Offset of the root directory in the name pool. */
+  uint64_t m_file_dir_offset = 0;
+  /** Length of the root directory. */
+  uint64_t m_file_dir_length = 0;
+  /** Path of the index, for error messages. */
+  std::string m_path;
+
+  /** Get a string from the name pool. */
+  std::string get_name(uint64_t offset, uint64_t length) const;
+  /** Throw if file_id is not in the file table. */
+  void check_file_id(size_t file_id) const;
+  /** Throw if i is not in the sample table. */
+  void check_sample_index(size_t i) const;
+};
+
+/** @brief Write a binary, indexed sample list.
+ *
+ *  Files and samples are written in the order they are added.
+ *  Adding the samples of each file together keeps every contiguous
+ *  range of samples within a few files.
+ */
+class sample_list_index_writer {
+public:
+  /** @param file_dir  Root directory of the data files. */
+  explicit sample_list_index_writer(const std::string& file_dir);
+
+  /** Add a data file and return its id.
+   *  @param name         File name, relative to the root directory.
+   *  @param num_samples  Total number of samples in the file.
+   */
+  size_t add_file(const std::string& name, size_t num_samples);
+  /** Add a sample of a data file that was already added. */
+  void add_sample(size_t file_id, const std::string& name);
+
+  /** Write the index to path.
+   *  The index is written to a temporary file that is renamed once
+   *  complete, so readers never see a partial index.
+   */
+  void write(const std::string& path) const;
+
+private:
+  /** File table records. */
+  std::vector<char> m_files;
+  /** Sample table records. */
+  std::vector<char> m_samples;
+  /** Name pool. */
+  std::string m_names;
+  size_t m_num_files = 0;
+  size_t m_num_samples = 0;
+  /** Length of the root directory, which starts the name pool. */
+  size_t m_file_dir_length;
+
+  /** Append a string to the name pool and return its offset. */
+  uint64_t add_name(const std::string& name);
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_SAMPLE_LIST_INDEX_HPP_INCLUDED
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_SIMD_MATH_HPP_INCLUDED
+#define LBANN_UTILS_SIMD_MATH_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/** @file
+ *  @brief Vectorized transcendental functions.
+ *
+ *  Each function applies a math function entry-wise to a contiguous
+ *  array. Single-precision arrays are processed with AVX-512, AVX2
+ *  (with FMA) or NEON, depending on the instruction sets enabled at
+ *  compile time, and leftover entries are processed with a scalar
+ *  version of the same algorithm, so results do not depend on
+ *  array alignment or length. Double-precision arrays fall back to
+ *  the standard library.
+ *
+ *  The single-precision functions are accurate to within a few
+ *  ULPs of the correctly rounded result (see
+ *  src/utils/unit_test/simd_math_test.cpp for the bounds that are
+ *  checked). Special values follow the standard library: NaNs
+ *  propagate, overflow produces infinities and log(0) is negative
+ *  infinity. Input and output arrays may be identical, but must not
+ *  otherwise overlap.
+ */
+
+/** Name of the instruction set used by the vectorized functions. */
+const char* simd_math_instruction_set();
+
+/** @brief @f$ y = e^x @f$ */
+void vector_exp(const float* x, float* y, El::Int size);
+void vector_exp(const double* x, double* y, El::Int size);
+
+/** @brief @f$ y = \log x @f$ */
+void vector_log(const float* x, float* y, El::Int size);
+void vector_log(const double* x, double* y, El::Int size);
+
+/** @brief @f$ y = \tanh x @f$ */
+void vector_tanh(const float* x, float* y, El::Int size);
+void vector_tanh(const double* x, double* y, El::Int size);
+
+/** @brief @f$ y = 1 / (1 + e^{-x}) @f$ */
+void vector_sigmoid(const float* x, float* y, El::Int size);
+void vector_sigmoid(const double* x, double* y, El::Int size);
+
+/** @brief @f$ y = \log (1 + e^x) @f$ */
+void vector_softplus(const float* x, float* y, El::Int size);
+void vector_softplus(const double* x, double* y, El::Int size);
+
+/** @brief @f$ y = \operatorname{erf} x @f$ */
+void vector_erf(const float* x, float* y, El::Int size);
+void vector_erf(const double* x, double* y, El::Int size);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_SIMD_MATH_HPP_INCLUDED
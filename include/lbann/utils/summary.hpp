@@ -29,6 +29,7 @@
 #ifndef LBANN_SUMMARY_HPP_INCLUDED
 #define LBANN_SUMMARY_HPP_INCLUDED
 
+#include <future>
 #include <string>
 #include <vector>
 #include "lbann/base.hpp"
@@ -54,6 +55,11 @@ namespace lbann {
  * Distributed matrices should be distributed by model.
  * This class automatically prepends "modelN/" to each tag. The tag is only
  * relevant at the world master process.
+ * Local statistics are computed in a single parallel pass when a summary is
+ * requested. At flush time, all pending reductions within a trainer are
+ * packed into one sum and one min reduction, and the results of every
+ * trainer are collected with one gather. Optionally, the world master writes
+ * the event file on a background thread so training can continue.
  *
  * @note WHEN YOU UPDATE THE PUBLIC API HERE, REMEMBER TO UPDATE THE KLUDGE FOR
  * NON-TENSORBOARD BUILDS BELOW!
@@ -65,8 +71,10 @@ class lbann_summary {
    * Create a new summary manager.
    * @param logdir The directory to output events to.
    * @param comm Communicator to use.
+   * @param async_write Whether to write events on a background thread.
    */
-  lbann_summary(std::string logdir, lbann_comm *comm);
+  lbann_summary(std::string logdir, lbann_comm *comm,
+                bool async_write = false);
   ~lbann_summary();
 
   /** Report the mean of mat. */
@@ -88,16 +96,16 @@ class lbann_summary {
   /** Report the (squared) 2-norm of mat. */
   void reduce_2norm(const std::string tag, const AbsDistMat& mat, int step);
 
-  /**
-   * Write all summaries out.
-   * @todo This can be made faster by combining collective operations element-
-   * wise for each type of summary.
-   */
+  /** Write all summaries out. */
   void flush();
 
  private:
   lbann_comm *m_comm;
   TBinf::SummaryWriter *m_sw;
+  /** Whether events are written on a background thread. */
+  bool m_async_write;
+  /** Pending background write of events. */
+  std::future<void> m_write_future;
 
   /** Represent a pending summary operation. */
   struct pending_op {
@@ -160,23 +168,46 @@ class lbann_summary {
   /** Currently-pending reduce_histograms. */
   std::vector<pending_histogram> m_pending_histograms;
 
-  /** Execute all pending mean operations. */
-  void flush_means();
-  /** Execute all pending min operations. */
-  void flush_mins();
-  /** Execute all pending max operations. */
-  void flush_maxes();
-  /** Execute all pending stdev operations. */
-  void flush_stdevs();
-  /** Execute all pending scalar operations. */
-  void flush_scalars();
-  /** Execute all pending sum-scalar operations. */
-  void flush_sum_scalars();
-  /** Execute all pending scalar-all operations. */
-  void flush_scalar_alls();
-  /** Execute all pending histogram operations. */
-  void flush_histograms();
+  /** A scalar summary ready to be written out. */
+  struct scalar_event {
+    std::string tag;
+    DataType value;
+    int step;
+  };
+  /** A histogram summary ready to be written out. */
+  struct histogram_event {
+    std::string tag;
+    std::vector<float> buckets;
+    DataType min;
+    DataType max;
+    DataType num;
+    DataType sum;
+    DataType sqsum;
+    int step;
+  };
 
+  /** Execute all pending trainer-level operations.
+   *  Means, mins, maxes, stdevs, scalars, sum-scalars, and histograms
+   *  are reduced together and gathered to the world master.
+   */
+  void flush_trainer_ops(std::vector<scalar_event>& scalars,
+                         std::vector<histogram_event>& histograms);
+  /** Execute all pending scalar-all operations. */
+  void flush_scalar_alls(std::vector<scalar_event>& scalars);
+  /** Write events with the summary writer (world master only). */
+  void write_events(const std::vector<scalar_event>& scalars,
+                    const std::vector<histogram_event>& histograms);
+
+  /** Compute sum, squared sum, min, max, and histogram buckets of
+   *  mat in a single parallel pass.
+   *  @param buckets  Histogram bucket counts, using
+   *                  m_histogram_buckets as the limits. Ignored if
+   *                  null.
+   */
+  void local_statistics(const Mat& mat,
+                        DataType& sum, DataType& sqsum,
+                        DataType& min, DataType& max,
+                        float* buckets) const;
   /** Compute the sum of elements in mat. */
   DataType local_sum(const Mat& mat) const;
   /** Compute the sum of square of elements in mat. */
@@ -189,11 +220,6 @@ class lbann_summary {
   DataType local_2norm(const Mat& mat) const;
   /** Prepend "model<model>/" to tag. */
   std::string prepend_model(const std::string tag, int model) const;
-  /** Gather and write out a scalar summary for each model. */
-  void gather_scalar_summary(const std::string tag, DataType s, int step);
-  /** Gather and write out a scalar summary for each entry in a vector. */
-  void gather_scalar_summary(const std::vector<pending_op>& ops,
-                             std::vector<DataType>& scalars);
 };
 
 #else
@@ -201,7 +227,8 @@ class lbann_summary {
 /** Dummy class when TBinf is not present. */
 class lbann_summary {
  public:
-  lbann_summary(std::string logdir, lbann_comm *comm) {}
+  lbann_summary(std::string logdir, lbann_comm *comm,
+                bool async_write = false) {}
 
   void reduce_mean(const std::string tag, const AbsDistMat& mat, int step) {}
   void reduce_min(const std::string tag, const AbsDistMat& mat, int step) {}
@@ -53,6 +53,8 @@ public:
   void launch_threads(size_type num_threads);
   /** @brief Launch the threads and pin them to the Hyperthreaded cores */
   void launch_pinned_threads(size_type num_threads, int cpu_offset);
+  /** @brief Launch the threads and pin thread i to cpus[i % cpus.size()] */
+  void launch_pinned_threads(size_type num_threads, const std::vector<int>& cpus);
   /** Wake and terminate all threads in the pool */
   void reap_threads();
   /** Reap all threads in the pool and relaunch pinned threads */
@@ -135,6 +137,9 @@ private:
 
   int m_threads_offset;
 
+  /** @brief CPUs for pinned threads, if given explicitly */
+  std::vector<int> m_pinned_cpus;
+
 };// class thread_pool
 
 }// namespace lbann
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_TOP_K_HPP_INCLUDED
+#define LBANN_UTILS_TOP_K_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <limits>
+#include <vector>
+
+namespace lbann {
+
+class lbann_comm;
+
+/** @brief Sparse vector entry used in top-k selection. */
+struct top_k_entry {
+
+  /** Vector entry value. */
+  DataType value = min_value;
+  /** Vector entry index. */
+  El::Int index = max_index;
+
+  /** Minimum possible value. */
+  static constexpr DataType min_value = -std::numeric_limits<DataType>::infinity();
+  /** Maximum possible index. */
+  static constexpr El::Int max_index = std::numeric_limits<El::Int>::max();
+
+  /** Comparison operation to sort vector entries.
+   *  Entries are sorted by value in decreasing order, with ties
+   *  broken in favor of entries with smaller indices.
+   */
+  static bool compare(const top_k_entry& a, const top_k_entry& b) {
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+  }
+
+};
+
+/** @brief Find the k largest entries of a vector.
+ *
+ *  Entries are kept in a size-k heap. Values are scanned in blocks
+ *  and a block is only inspected entry-by-entry if one of its values
+ *  can displace the current k-th largest entry, so most of the scan
+ *  is a branch-free comparison against a threshold.
+ *
+ *  @param values        Input vector (contiguous).
+ *  @param size          Number of entries in input vector.
+ *  @param k             Number of entries to select.
+ *  @param index_offset  Index of first input entry.
+ *  @param index_stride  Index increment between input entries.
+ *  @param top_entries   Output buffer with k entries, sorted with
+ *                       top_k_entry::compare. If size < k, trailing
+ *                       entries are default-constructed.
+ */
+void select_top_k(const DataType* values,
+                  El::Int size,
+                  El::Int k,
+                  El::Int index_offset,
+                  El::Int index_stride,
+                  top_k_entry* top_entries);
+
+/** @brief Merge two sorted lists of k entries.
+ *  The k best entries from a and b are written to out. out must not
+ *  alias a or b.
+ */
+void merge_top_k(const top_k_entry* a,
+                 const top_k_entry* b,
+                 El::Int k,
+                 top_k_entry* out);
+
+/** @brief Combine per-column top-k lists across a communicator.
+ *
+ *  top_entries holds num_cols sorted lists of k entries (column
+ *  j occupies entries [j*k, (j+1)*k)). Instead of gathering every
+ *  rank's candidates, lists are merged pairwise: a recursive-halving
+ *  reduce-scatter over column blocks, followed by a
+ *  recursive-doubling all-gather (if root is negative) or a binomial
+ *  gather to root. Each rank sends and receives O(num_cols*k)
+ *  entries in O(log P) messages, independent of the number of ranks.
+ *
+ *  @param comm         LBANN communicator.
+ *  @param c            Communicator to reduce over.
+ *  @param k            Number of entries per column.
+ *  @param num_cols     Number of columns.
+ *  @param top_entries  Local top-k lists (num_cols*k entries). On
+ *                      exit, holds the global top-k lists on every
+ *                      rank (if root < 0) or on root (otherwise).
+ *                      Contents on other ranks are unspecified.
+ *  @param root         Rank in c that receives the result, or a
+ *                      negative value to reduce to all ranks.
+ */
+void reduce_top_k(lbann_comm& comm,
+                  const El::mpi::Comm& c,
+                  El::Int k,
+                  El::Int num_cols,
+                  top_k_entry* top_entries,
+                  int root = -1);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_TOP_K_HPP_INCLUDED
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_TRACE_HPP_INCLUDED
+#define LBANN_UTILS_TRACE_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+class lbann_comm;
+
+/** @brief Kind of traced activity. */
+enum class trace_category : std::uint16_t {
+  forward_prop,
+  backward_prop,
+  optimize,
+  comm,
+  io,
+  data_store,
+  other
+};
+
+/** @brief Human-readable name of a trace category. */
+const char* trace_category_name(trace_category category);
+
+/** @brief Compact binary trace event.
+ *  Times are in nanoseconds on the recording rank's steady clock.
+ */
+struct trace_event {
+  /** Start time. */
+  std::uint64_t start;
+  /** End time. */
+  std::uint64_t end;
+  /** Interned name (see tracer::intern). */
+  std::uint32_t name;
+  /** Event category. */
+  std::uint16_t category;
+  /** Index of recording thread within the rank. */
+  std::uint16_t thread;
+};
+
+/** @brief Low-overhead event tracer.
+ *
+ *  Each thread records events into its own fixed-size ring buffer
+ *  without locking. Event names are interned once and events refer
+ *  to them by index. While tracing is active, a background thread
+ *  periodically drains the ring buffers and streams them to a binary
+ *  file, so memory use does not grow with run length. If a ring
+ *  buffer fills up before it is drained, new events are dropped and
+ *  counted.
+ *
+ *  When tracing starts, each rank estimates the offset between its
+ *  clock and the world master's clock so that traces from different
+ *  nodes can be placed on a common timeline. Trace files are
+ *  converted to Chrome trace JSON with the lbann_trace2chrome tool.
+ *
+ *  Trace file layout (native byte order): a trace_file_header,
+ *  followed by records that each start with a trace_record_header.
+ *  Name records are followed by a uint32 name index and the name's
+ *  characters, event records by an array of trace_events, and the
+ *  final record holds the number of dropped events in its count.
+ *
+ *  The writer thread and its state live in the source file, so this
+ *  header stays cheap to include in communication code.
+ */
+class tracer {
+public:
+
+  /** Get the process-wide tracer. */
+  static tracer& get();
+
+  ~tracer();
+
+  /** Whether events are currently being recorded. */
+  bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+  /** Current time on the trace clock (ns). */
+  static std::uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /** Get the index of an event name.
+   *  This takes a lock, so callers should cache the result.
+   */
+  std::uint32_t intern(const std::string& name);
+
+  /** Record an event on the calling thread.
+   *  Does nothing if tracing is not enabled.
+   */
+  void record(trace_category category,
+              std::uint32_t name,
+              std::uint64_t start,
+              std::uint64_t end);
+
+  /** Start tracing to a file.
+   *  This is collective over the world communicator since clocks are
+   *  aligned to the world master. If tracing is already active, this
+   *  only adds a user of the current trace and the arguments are
+   *  ignored. Tracing stops once every start is matched by a stop.
+   *  @param path            Output file.
+   *  @param comm            LBANN communicator.
+   *  @param flush_interval  Time between streaming writes (seconds).
+   *  @param buffer_size     Events per thread ring buffer (rounded up
+   *                         to a power of two).
+   */
+  void start(const std::string& path,
+             lbann_comm& comm,
+             double flush_interval = 1.0,
+             std::size_t buffer_size = 65536);
+
+  /** Stop tracing and write remaining events.
+   *  Errors raised in the background writer are rethrown here.
+   */
+  void stop();
+
+private:
+
+  /** Per-thread single-producer/single-consumer ring buffer. */
+  struct ring_buffer;
+  /** Names, ring buffers, output file, and background writer. */
+  struct state;
+
+  tracer();
+  tracer(const tracer&) = delete;
+  tracer& operator=(const tracer&) = delete;
+
+  /** Get the calling thread's ring buffer. */
+  ring_buffer& get_thread_buffer();
+  /** Estimate offset from local clock to world master clock (ns). */
+  static std::int64_t align_clocks(lbann_comm& comm);
+  /** Write new names and buffered events to file. */
+  void drain();
+  /** Main loop for background writer thread. */
+  void writer_loop();
+
+  /** Whether events are being recorded. */
+  std::atomic<bool> m_enabled;
+  /** Number of events dropped due to full ring buffers. */
+  std::atomic<std::uint64_t> m_dropped;
+  /** Number of start calls not yet matched by stop. */
+  int m_num_users = 0;
+  std::unique_ptr<state> m_state;
+
+};
+
+/** @brief Header at start of trace files. */
+struct trace_file_header {
+  /** Identifies trace files ("LBTRACE"). */
+  char magic[8];
+  std::uint32_t version;
+  /** Rank in world communicator. */
+  std::int32_t rank;
+  /** Trainer index. */
+  std::int32_t trainer;
+  std::int32_t reserved;
+  /** Add to event times to get world master clock times (ns). */
+  std::int64_t clock_offset;
+};
+
+/** @brief Header for records in trace files. */
+struct trace_record_header {
+  enum record_type : std::uint32_t { name = 1, events = 2, dropped = 3 };
+  std::uint32_t type;
+  /** Name length, number of events, or number of dropped events. */
+  std::uint32_t count;
+};
+
+/** @brief Trace file contents. */
+struct trace_file_data {
+  trace_file_header header;
+  std::vector<std::string> names;
+  std::vector<trace_event> events;
+  std::uint64_t dropped = 0;
+};
+
+/** @brief Read a trace file written by tracer. */
+trace_file_data read_trace_file(const std::string& path);
+
+/** @brief RAII helper that records an event over its lifetime. */
+class trace_scope {
+public:
+  trace_scope(trace_category category, std::uint32_t name)
+    : m_category(category), m_name(name),
+      m_start(tracer::get().enabled() ? tracer::now() : 0) {}
+  ~trace_scope() {
+    if (m_start != 0) {
+      tracer::get().record(m_category, m_name, m_start, tracer::now());
+    }
+  }
+private:
+  trace_category m_category;
+  std::uint32_t m_name;
+  std::uint64_t m_start;
+};
+
+} // namespace lbann
+
+#define LBANN_TRACE_CONCAT_HELPER(a, b) a##b
+#define LBANN_TRACE_CONCAT(a, b) LBANN_TRACE_CONCAT_HELPER(a, b)
+
+/** Trace the enclosing scope. The name is interned on first use. */
+#define LBANN_TRACE_SCOPE(category, name)                               \
+  static const std::uint32_t LBANN_TRACE_CONCAT(lbann_trace_name_, __LINE__) \
+    = ::lbann::tracer::get().intern(name);                              \
+  ::lbann::trace_scope LBANN_TRACE_CONCAT(lbann_trace_scope_, __LINE__)( \
+    category, LBANN_TRACE_CONCAT(lbann_trace_name_, __LINE__))
+
+#endif // LBANN_UTILS_TRACE_HPP_INCLUDED
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_WORKSPACE_HPP_INCLUDED
+#define LBANN_UTILS_WORKSPACE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+namespace lbann {
+
+/** @brief Pre-allocated scratch memory for layer temporaries.
+ *
+ *  Layers declare the size of their largest temporary buffer during
+ *  setup. The manager then reserves one arena with a number of
+ *  slots, each large enough for the largest declared buffer, so
+ *  kernels can borrow scratch memory during forward and backward
+ *  prop without allocating. Slots are 64-byte aligned and are
+ *  zeroed by all OpenMP threads when the arena is allocated, so
+ *  pages are first touched on the NUMA nodes of the threads that
+ *  use them.
+ *
+ *  Borrowing is thread-safe. If no slot is free or a request is
+ *  larger than a slot, the buffer falls back to a heap allocation.
+ */
+class workspace_manager {
+public:
+
+  /** Alignment of workspace buffers, in bytes. */
+  static constexpr size_t alignment = 64;
+
+  /** @brief Scratch buffer borrowed from a workspace.
+   *  The buffer is returned to the workspace when it is destroyed.
+   */
+  class buffer {
+  public:
+    buffer() = default;
+    buffer(buffer&& other);
+    buffer& operator=(buffer&& other);
+    buffer(const buffer&) = delete;
+    buffer& operator=(const buffer&) = delete;
+    ~buffer();
+
+    /** Pointer to buffer, offset by a number of bytes. */
+    template <typename T>
+    T* get(size_t offset = 0) const {
+      return reinterpret_cast<T*>(m_data + offset);
+    }
+    /** Buffer size in bytes. */
+    size_t size() const { return m_size; }
+
+  private:
+    friend class workspace_manager;
+    /** Release slot or heap allocation. */
+    void release();
+    /** Workspace that owns the slot, if any. */
+    workspace_manager* m_workspace = nullptr;
+    /** Workspace slot, or -1 for a heap allocation. */
+    int m_slot = -1;
+    unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+  };
+
+  workspace_manager() = default;
+  /** Copies declared sizes and allocates a new arena if needed. */
+  workspace_manager(const workspace_manager& other);
+  workspace_manager& operator=(const workspace_manager& other);
+  ~workspace_manager() = default;
+
+  /** Declare a temporary buffer, in bytes.
+   *  Must be called before setup.
+   */
+  void declare(size_t size);
+  /** Allocate the arena.
+   *  @param num_slots  Number of buffers that may be borrowed at the
+   *                    same time, e.g. by concurrent layers.
+   */
+  void setup(int num_slots = 1);
+
+  /** Borrow a scratch buffer with at least size bytes.
+   *  Contents are unspecified.
+   */
+  buffer borrow(size_t size);
+
+  /** Size of each slot, in bytes. */
+  size_t get_slot_size() const { return m_slot_size; }
+  /** Number of slots. */
+  int get_num_slots() const { return m_num_slots; }
+  /** Size of arena, in bytes. */
+  size_t get_total_size() const { return m_slot_size * m_num_slots; }
+  /** Number of buffers served from the arena, i.e. allocations
+   *  avoided, since the last reset.
+   */
+  size_t get_num_borrows() const { return m_num_borrows; }
+  /** Number of buffers allocated from the heap since the last reset. */
+  size_t get_num_fallbacks() const { return m_num_fallbacks; }
+  /** Reset buffer counts. */
+  void reset_counters();
+
+  /** Round a size up to a multiple of the alignment. */
+  static size_t align(size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+private:
+
+  /** Frees aligned allocations. */
+  struct free_deleter {
+    void operator()(void* ptr) const { std::free(ptr); }
+  };
+
+  /** Largest declared buffer, rounded to the alignment. */
+  size_t m_slot_size = 0;
+  /** Number of slots. */
+  int m_num_slots = 0;
+  /** Arena with m_num_slots slots of m_slot_size bytes. */
+  std::unique_ptr<unsigned char, free_deleter> m_arena;
+  /** Whether each slot is borrowed. */
+  std::unique_ptr<std::atomic<bool>[]> m_slot_in_use;
+
+  /** Number of buffers served from the arena. */
+  std::atomic<size_t> m_num_borrows{0};
+  /** Number of buffers allocated from the heap. */
+  std::atomic<size_t> m_num_fallbacks{0};
+
+  /** Allocate aligned memory. */
+  static unsigned char* allocate(size_t size);
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_WORKSPACE_HPP_INCLUDED
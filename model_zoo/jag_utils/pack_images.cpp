@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "lbann/lbann.hpp"
+#include "lbann/utils/packed_dataset.hpp"
+
+using namespace lbann;
+
+namespace {
+
+/** Read a file into buf. */
+void read_file(const std::string& path, std::vector<char>& buf) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    LBANN_ERROR("failed to open " + path + " for reading");
+  }
+  buf.resize(in.tellg());
+  in.seekg(0, std::ios::beg);
+  if (!in.read(buf.data(), buf.size())) {
+    LBANN_ERROR("failed to read " + path);
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+  const bool master = comm->am_world_master();
+
+  try {
+    options *opts = options::get();
+    opts->init(argc, argv);
+
+    if (!(opts->has_string("image_list") && opts->has_string("output"))) {
+      if (master) {
+        std::cout << "usage: " << argv[0] << " --image_list=<string> --output=<string>\n"
+          "         [--image_dir=<string>] [--num_shards=<int>]\n"
+          "where: image_list contains lines of the form '<path> <label>',\n"
+          "       as used by the imagenet data reader;\n"
+          "       image_dir / <path> should fully specify an image file;\n"
+          "       num_shards is the number of shard files (default: 256)\n"
+          "function: packs the images into <output>.<shard>.pack and\n"
+          "          writes an index to <output>.index, which may be used\n"
+          "          as the data_filename of the imagenet data reader\n";
+      }
+      return EXIT_SUCCESS;
+    }
+    const std::string image_list = opts->get_string("image_list");
+    const std::string output = opts->get_string("output");
+    const std::string image_dir = opts->get_string("image_dir", "");
+    const int num_shards = opts->get_int("num_shards", 256);
+    if (num_shards < 1) {
+      LBANN_ERROR("num_shards must be positive");
+    }
+
+    // Read image list
+    std::vector<std::pair<std::string, int>> images;
+    std::ifstream in(image_list);
+    if (!in) {
+      LBANN_ERROR("failed to open " + image_list + " for reading");
+    }
+    std::string path;
+    int label;
+    while (in >> path >> label) {
+      images.emplace_back(path, label);
+    }
+    const size_t num_samples = images.size();
+
+    // Shard j holds a contiguous range of samples
+    auto shard_begin = [&](size_t j) { return j * num_samples / num_shards; };
+    std::vector<std::string> shards;
+    const auto slash = output.find_last_of('/');
+    const std::string output_name = (slash == std::string::npos ?
+                                     output : output.substr(slash + 1));
+    for (int j = 0; j < num_shards; ++j) {
+      shards.push_back(output_name + "." + std::to_string(j) + ".pack");
+    }
+
+    // Write shards, distributed cyclically over ranks
+    const int rank = comm->get_rank_in_world();
+    const int np = comm->get_procs_in_world();
+    std::vector<El::Int> sizes(num_samples, 0);
+    std::vector<char> buf;
+    for (int j = rank; j < num_shards; j += np) {
+      const std::string shard_path = output + "." + std::to_string(j) + ".pack";
+      std::unique_ptr<std::FILE, int(*)(std::FILE*)> f(
+        std::fopen(shard_path.c_str(), "wb"), std::fclose);
+      if (f == nullptr) {
+        LBANN_ERROR("failed to open " + shard_path + " for writing");
+      }
+      for (size_t i = shard_begin(j); i < shard_begin(j+1); ++i) {
+        read_file(image_dir + images[i].first, buf);
+        if (std::fwrite(buf.data(), 1, buf.size(), f.get()) != buf.size()) {
+          LBANN_ERROR("failed to write " + shard_path);
+        }
+        sizes[i] = buf.size();
+      }
+      if (std::fclose(f.release()) != 0) {
+        LBANN_ERROR("failed to write " + shard_path);
+      }
+      std::cout << rank << " :: wrote " << shard_path << std::endl;
+    }
+
+    // Write index
+    comm->allreduce(sizes.data(), sizes.size(), comm->get_world_comm());
+    if (master) {
+      std::vector<packed_sample> samples(num_samples);
+      for (int j = 0; j < num_shards; ++j) {
+        uint64_t offset = 0;
+        for (size_t i = shard_begin(j); i < shard_begin(j+1); ++i) {
+          if (sizes[i] > std::numeric_limits<uint32_t>::max()) {
+            LBANN_ERROR(images[i].first + " is too large");
+          }
+          samples[i].offset = offset;
+          samples[i].size = sizes[i];
+          samples[i].shard = j;
+          samples[i].label = images[i].second;
+          samples[i].reserved = 0;
+          offset += sizes[i];
+        }
+      }
+      packed_dataset::write_index(output + ".index", shards, samples);
+      std::cout << "wrote " << num_samples << " samples in " << num_shards
+                << " shards; index: " << output << ".index" << std::endl;
+    }
+
+  } catch (std::exception const &e) {
+    std::cerr << "caught exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+//
+// lbann_trace2chrome.cpp - Convert timeline traces to Chrome trace format
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/trace.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+/** Escape a string for use in JSON. */
+std::string json_escape(const std::string& str) {
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (const auto& c : str) {
+    switch (c) {
+    case '"':  escaped += "\\\""; break;
+    case '\\': escaped += "\\\\"; break;
+    case '\n': escaped += "\\n";  break;
+    case '\t': escaped += "\\t";  break;
+    default:
+      if (static_cast<unsigned char>(c) >= 0x20) { escaped += c; }
+    }
+  }
+  return escaped;
+}
+
+} // namespace
+
+/** Combine trace files written by the timeline callback into a
+ *  single Chrome trace (viewable in chrome://tracing or Perfetto).
+ *  Each rank is shown as a process and each recording thread as a
+ *  thread. Event times are shifted onto the world master's clock.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0]
+              << " <output.json> <trace file> [<trace file> ...]\n";
+    return EXIT_FAILURE;
+  }
+  const std::string output_path = argv[1];
+  const std::vector<std::string> input_paths(argv + 2, argv + argc);
+
+  try {
+
+    // Find earliest event so that output times start near zero
+    // Note: Trace files are read twice to avoid holding every rank's
+    // events in memory.
+    auto first_time = std::numeric_limits<std::int64_t>::max();
+    for (const auto& path : input_paths) {
+      const auto data = read_trace_file(path);
+      for (const auto& e : data.events) {
+        const auto start = (static_cast<std::int64_t>(e.start)
+                            + data.header.clock_offset);
+        first_time = std::min(first_time, start);
+      }
+    }
+
+    // Write events
+    std::ofstream out(output_path);
+    if (!out) {
+      LBANN_ERROR("could not open " + output_path);
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first_event = true;
+    auto write_separator = [&] () {
+      if (!first_event) { out << ",\n"; }
+      first_event = false;
+    };
+    for (const auto& path : input_paths) {
+      const auto data = read_trace_file(path);
+      const auto& header = data.header;
+      write_separator();
+      out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << header.rank
+          << ",\"args\":{\"name\":\"rank " << header.rank
+          << " (trainer " << header.trainer << ")\"}}";
+      write_separator();
+      out << "{\"ph\":\"M\",\"name\":\"process_sort_index\",\"pid\":" << header.rank
+          << ",\"args\":{\"sort_index\":" << header.rank << "}}";
+      for (const auto& e : data.events) {
+        const auto start = (static_cast<std::int64_t>(e.start)
+                            + header.clock_offset - first_time);
+        const auto duration = static_cast<std::int64_t>(e.end - e.start);
+        const std::string name = (e.name < data.names.size() ?
+                                  data.names[e.name] :
+                                  "unknown");
+        write_separator();
+        out << "{\"ph\":\"X\""
+            << ",\"name\":\"" << json_escape(name) << "\""
+            << ",\"cat\":\""
+            << trace_category_name(static_cast<trace_category>(e.category))
+            << "\""
+            << ",\"pid\":" << header.rank
+            << ",\"tid\":" << e.thread
+            << ",\"ts\":" << start / 1e3
+            << ",\"dur\":" << duration / 1e3 << "}";
+      }
+      if (data.dropped > 0) {
+        std::cerr << "warning: " << path << " dropped " << data.dropped
+                  << " events (consider a larger buffer_size)\n";
+      }
+    }
+    out << "\n]}\n";
+
+  } catch (std::exception& e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+//
+// conv3d_benchmark.cpp - Benchmarks 3D im2col convolution on CosmoFlow layers
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "lbann/lbann.hpp"
+#include "lbann/utils/im2col.hpp"
+#include "lbann/utils/timer.hpp"
+
+using namespace lbann;
+
+namespace {
+
+/** 3D convolution layer shape. Dimensions are ordered as (z, y, x). */
+struct conv3d_shape {
+  std::string name;
+  int input_channels;
+  int input_dim;
+  int output_channels;
+  int window_dim;
+  int stride;
+  int output_dim() const { return (input_dim - window_dim) / stride + 1; }
+  int input_spatial_size() const { return input_dim * input_dim * input_dim; }
+  int output_spatial_size() const { return output_dim() * output_dim() * output_dim(); }
+  int window_size() const { return input_channels * window_dim * window_dim * window_dim; }
+};
+
+/** Convolution layers in model_zoo/models/cosmoflow for 128^3 inputs. */
+std::vector<conv3d_shape> cosmoflow_shapes() {
+  return {
+    {"conv1",   4, 128,  16, 3, 1},
+    {"conv2",  16,  63,  32, 4, 1},
+    {"conv3",  32,  30,  64, 4, 1},
+    {"conv4",  64,  13, 128, 3, 2},
+    {"conv5", 128,   6, 256, 3, 1},
+    {"conv6", 256,   4, 256, 2, 1},
+    {"conv7", 256,   3, 256, 2, 1},
+  };
+}
+
+/** Forward prop with the generic N-d im2col. */
+void forward_generic(const conv3d_shape& s, const CPUMat& x,
+                     const CPUMat& kernel, CPUMat& y) {
+  const std::vector<int> dims(3, s.input_dim), pads(3, 0);
+  const std::vector<int> windows(3, s.window_dim), strides(3, s.stride);
+  const int m = s.output_spatial_size(), k = s.window_size();
+  CPUMat col(k, m);
+  im2col(x, col, s.input_channels, 3,
+         dims.data(), pads.data(), windows.data(), strides.data());
+  CPUMat y_mat(m, s.output_channels, y.Buffer(), m);
+  El::Gemm(El::TRANSPOSE, El::NORMAL, DataType(1), col, kernel,
+           DataType(0), y_mat);
+}
+
+/** Backward prop w.r.t. input with the generic N-d col2im. */
+void backward_data_generic(const conv3d_shape& s, const CPUMat& dy,
+                           const CPUMat& kernel, CPUMat& dx) {
+  const std::vector<int> dims(3, s.input_dim), pads(3, 0);
+  const std::vector<int> windows(3, s.window_dim), strides(3, s.stride);
+  const int n = s.output_spatial_size(), m = s.window_size();
+  CPUMat col(m, n);
+  const CPUMat dy_mat(n, s.output_channels, dy.LockedBuffer(), n);
+  El::Gemm(El::NORMAL, El::TRANSPOSE, DataType(1), kernel, dy_mat,
+           DataType(0), col);
+  col2im(col, dx, s.input_channels, 3,
+         dims.data(), pads.data(), windows.data(), strides.data());
+}
+
+/** Backward prop w.r.t. kernel with the generic N-d im2col. */
+void backward_filter_generic(const conv3d_shape& s, const CPUMat& x,
+                             const CPUMat& dy, CPUMat& dkernel) {
+  const std::vector<int> dims(3, s.input_dim), pads(3, 0);
+  const std::vector<int> windows(3, s.window_dim), strides(3, s.stride);
+  const int k = s.output_spatial_size(), m = s.window_size();
+  CPUMat col(m, k);
+  im2col(x, col, s.input_channels, 3,
+         dims.data(), pads.data(), windows.data(), strides.data());
+  const CPUMat dy_mat(k, s.output_channels, dy.LockedBuffer(), k);
+  El::Gemm(El::NORMAL, El::NORMAL, DataType(1), col, dy_mat,
+           DataType(0), dkernel);
+}
+
+/** Forward prop with the slab-wise transposed 3D im2col. */
+void forward_3d(const conv3d_shape& s, const CPUMat& x,
+                const CPUMat& kernel, CPUMat& y) {
+  const int num_slices = s.output_dim();
+  const int slice_size = s.output_spatial_size() / num_slices;
+  const int m = s.output_spatial_size(), k = s.window_size();
+  const int slab_depth = im2col_3d_slab_depth(k, slice_size);
+  CPUMat col(std::min(slab_depth, num_slices) * slice_size, k);
+  for (int begin = 0; begin < num_slices; begin += slab_depth) {
+    const int end = std::min(begin + slab_depth, num_slices);
+    const int size = (end - begin) * slice_size;
+    im2col_transposed_3d(x.LockedBuffer(), col.Buffer(), size,
+                         s.input_dim, s.input_dim, s.input_dim, 0, 0, 0,
+                         s.input_channels,
+                         s.window_dim, s.window_dim, s.window_dim,
+                         s.stride, s.stride, s.stride,
+                         begin, end);
+    const CPUMat col_slab(size, k, col.LockedBuffer(), size);
+    CPUMat y_slab(size, s.output_channels, y.Buffer(begin * slice_size, 0), m);
+    El::Gemm(El::NORMAL, El::NORMAL, DataType(1), col_slab, kernel,
+             DataType(0), y_slab);
+  }
+}
+
+/** Backward prop w.r.t. input with the slab-wise transposed 3D col2im. */
+void backward_data_3d(const conv3d_shape& s, const CPUMat& dy,
+                      const CPUMat& kernel, CPUMat& dx) {
+  const int num_slices = s.output_dim();
+  const int slice_size = s.output_spatial_size() / num_slices;
+  const int n = s.output_spatial_size(), m = s.window_size();
+  const int slab_depth = im2col_3d_slab_depth(m, slice_size);
+  CPUMat col(std::min(slab_depth, num_slices) * slice_size, m);
+  El::Zero(dx);
+  for (int begin = 0; begin < num_slices; begin += slab_depth) {
+    const int end = std::min(begin + slab_depth, num_slices);
+    const int size = (end - begin) * slice_size;
+    const CPUMat dy_slab(size, s.output_channels,
+                         dy.LockedBuffer(begin * slice_size, 0), n);
+    CPUMat col_slab(size, m, col.Buffer(), size);
+    El::Gemm(El::NORMAL, El::TRANSPOSE, DataType(1), dy_slab, kernel,
+             DataType(0), col_slab);
+    col2im_transposed_3d(col_slab.LockedBuffer(), size, dx.Buffer(),
+                         s.input_dim, s.input_dim, s.input_dim, 0, 0, 0,
+                         s.input_channels,
+                         s.window_dim, s.window_dim, s.window_dim,
+                         s.stride, s.stride, s.stride,
+                         begin, end);
+  }
+}
+
+/** Backward prop w.r.t. kernel with the slab-wise transposed 3D im2col. */
+void backward_filter_3d(const conv3d_shape& s, const CPUMat& x,
+                        const CPUMat& dy, CPUMat& dkernel) {
+  const int num_slices = s.output_dim();
+  const int slice_size = s.output_spatial_size() / num_slices;
+  const int k = s.output_spatial_size(), m = s.window_size();
+  const int slab_depth = im2col_3d_slab_depth(m, slice_size);
+  CPUMat col(std::min(slab_depth, num_slices) * slice_size, m);
+  El::Zero(dkernel);
+  for (int begin = 0; begin < num_slices; begin += slab_depth) {
+    const int end = std::min(begin + slab_depth, num_slices);
+    const int size = (end - begin) * slice_size;
+    im2col_transposed_3d(x.LockedBuffer(), col.Buffer(), size,
+                         s.input_dim, s.input_dim, s.input_dim, 0, 0, 0,
+                         s.input_channels,
+                         s.window_dim, s.window_dim, s.window_dim,
+                         s.stride, s.stride, s.stride,
+                         begin, end);
+    const CPUMat col_slab(size, m, col.LockedBuffer(), size);
+    const CPUMat dy_slab(size, s.output_channels,
+                         dy.LockedBuffer(begin * slice_size, 0), k);
+    El::Gemm(El::TRANSPOSE, El::NORMAL, DataType(1), col_slab, dy_slab,
+             DataType(1), dkernel);
+  }
+}
+
+/** Maximum entry-wise difference relative to the largest entry. */
+double relative_difference(const CPUMat& a, const CPUMat& b) {
+  double max_diff = 0, max_abs = 0;
+  for (El::Int j = 0; j < a.Width(); ++j) {
+    for (El::Int i = 0; i < a.Height(); ++i) {
+      max_diff = std::max(max_diff, double(std::fabs(a(i, j) - b(i, j))));
+      max_abs = std::max(max_abs, double(std::fabs(a(i, j))));
+    }
+  }
+  return max_abs > 0 ? max_diff / max_abs : max_diff;
+}
+
+/** Average run time of a function. */
+template <typename Function>
+double time_function(Function f, int iters) {
+  f();  // Warm up
+  const double start = get_time();
+  for (int iter = 0; iter < iters; ++iter) { f(); }
+  return (get_time() - start) / iters;
+}
+
+} // namespace
+
+/** Benchmark 3D convolution on CosmoFlow layer shapes.
+ *
+ *  Compares the generic N-d im2col and col2im formerly used for
+ *  3D convolutions against the slab-wise transposed 3D im2col used
+ *  by base_convolution_layer, for forward prop, backward prop w.r.t.
+ *  input, and backward prop w.r.t. kernel. Times are per sample.
+ *
+ *  usage: conv3d_benchmark [--iters=<int>] [--layer=<name>]
+ */
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+  const bool master = comm->am_world_master();
+
+  options *opts = options::get();
+  opts->init(argc, argv);
+  const int iters = opts->get_int("iters", 3);
+  const std::string layer = opts->get_string("layer", "");
+
+  if (master) {
+    std::cout << "layer,pass,generic_s,im2col_3d_s,speedup,"
+              << "generic_workspace_mb,im2col_3d_workspace_mb,rel_diff"
+              << std::endl;
+  }
+
+  std::mt19937 gen(20190803);
+  std::uniform_real_distribution<DataType> dist(-1, 1);
+  auto randomize = [&] (CPUMat& mat) {
+    for (El::Int j = 0; j < mat.Width(); ++j) {
+      for (El::Int i = 0; i < mat.Height(); ++i) {
+        mat(i, j) = dist(gen);
+      }
+    }
+  };
+
+  for (const auto& s : cosmoflow_shapes()) {
+    if (!layer.empty() && layer != s.name) { continue; }
+    const int input_size = s.input_channels * s.input_spatial_size();
+    const int output_size = s.output_channels * s.output_spatial_size();
+    CPUMat x(input_size, 1), dy(output_size, 1);
+    CPUMat kernel(s.window_size(), s.output_channels);
+    randomize(x);
+    randomize(dy);
+    randomize(kernel);
+    const double generic_mb = double(s.window_size()) * s.output_spatial_size()
+      * sizeof(DataType) / 1e6;
+    const int slice_size = s.output_spatial_size() / s.output_dim();
+    const double im2col_3d_mb = (double(std::min(im2col_3d_slab_depth(s.window_size(), slice_size),
+                                                 s.output_dim()))
+                                 * slice_size * s.window_size()
+                                 * sizeof(DataType) / 1e6);
+
+    // Output matrices
+    CPUMat y_generic(output_size, 1), y_3d(output_size, 1);
+    CPUMat dx_generic(input_size, 1), dx_3d(input_size, 1);
+    CPUMat dkernel_generic(s.window_size(), s.output_channels);
+    CPUMat dkernel_3d(s.window_size(), s.output_channels);
+
+    struct pass {
+      std::string name;
+      std::function<void()> generic;
+      std::function<void()> im2col_3d;
+      const CPUMat* generic_output;
+      const CPUMat* im2col_3d_output;
+    };
+    const std::vector<pass> passes = {
+      {"forward",
+       [&] { forward_generic(s, x, kernel, y_generic); },
+       [&] { forward_3d(s, x, kernel, y_3d); },
+       &y_generic, &y_3d},
+      {"backward_data",
+       [&] { backward_data_generic(s, dy, kernel, dx_generic); },
+       [&] { backward_data_3d(s, dy, kernel, dx_3d); },
+       &dx_generic, &dx_3d},
+      {"backward_filter",
+       [&] { backward_filter_generic(s, x, dy, dkernel_generic); },
+       [&] { backward_filter_3d(s, x, dy, dkernel_3d); },
+       &dkernel_generic, &dkernel_3d},
+    };
+
+    for (const auto& p : passes) {
+      const double generic_time = time_function(p.generic, iters);
+      const double im2col_3d_time = time_function(p.im2col_3d, iters);
+      if (master) {
+        std::cout << s.name << "," << p.name << ","
+                  << generic_time << ","
+                  << im2col_3d_time << ","
+                  << generic_time / im2col_3d_time << ","
+                  << generic_mb << ","
+                  << im2col_3d_mb << ","
+                  << relative_difference(*p.generic_output,
+                                         *p.im2col_3d_output)
+                  << std::endl;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+//
+// simd_math_benchmark.cpp - Benchmarks vectorized math functions
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include "lbann/lbann.hpp"
+#include "lbann/utils/simd_math.hpp"
+#include "lbann/utils/timer.hpp"
+
+using namespace lbann;
+
+namespace {
+
+/** Number of representable floats between a and b. */
+std::int64_t ulp_distance(float a, float b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return (std::isnan(a) && std::isnan(b)) ? 0 : -1;
+  }
+  auto to_ordered = [] (float x) {
+    std::int32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    return (i < 0 ?
+            std::int64_t(std::numeric_limits<std::int32_t>::min()) - i :
+            std::int64_t(i));
+  };
+  return std::abs(to_ordered(a) - to_ordered(b));
+}
+
+/** Math function benchmark case. */
+struct math_function {
+  std::string name;
+  /** Inputs are drawn uniformly from [min_input, max_input]. */
+  float min_input, max_input;
+  std::function<void(const float*, float*, El::Int)> scalar;
+  std::function<void(const float*, float*, El::Int)> vector;
+  std::function<double(double)> reference;
+};
+
+std::vector<math_function> make_functions() {
+  std::vector<math_function> functions;
+  functions.push_back(
+    {"exp", -80.f, 80.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) { y[i] = std::exp(x[i]); }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_exp(x, y, n); },
+     [] (double x) { return std::exp(x); }});
+  functions.push_back(
+    {"log", 0.f, 1000.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) { y[i] = std::log(x[i]); }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_log(x, y, n); },
+     [] (double x) { return std::log(x); }});
+  functions.push_back(
+    {"tanh", -10.f, 10.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) { y[i] = std::tanh(x[i]); }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_tanh(x, y, n); },
+     [] (double x) { return std::tanh(x); }});
+  functions.push_back(
+    {"sigmoid", -20.f, 20.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) { y[i] = 1 / (1 + std::exp(-x[i])); }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_sigmoid(x, y, n); },
+     [] (double x) { return 1 / (1 + std::exp(-x)); }});
+  functions.push_back(
+    {"softplus", -20.f, 20.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) {
+         y[i] = std::max(x[i], 0.f) + std::log1p(std::exp(-std::fabs(x[i])));
+       }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_softplus(x, y, n); },
+     [] (double x) {
+       return std::max(x, 0.) + std::log1p(std::exp(-std::fabs(x)));
+     }});
+  functions.push_back(
+    {"erf", -5.f, 5.f,
+     [] (const float* x, float* y, El::Int n) {
+       for (El::Int i = 0; i < n; ++i) { y[i] = std::erf(x[i]); }
+     },
+     [] (const float* x, float* y, El::Int n) { vector_erf(x, y, n); },
+     [] (double x) { return std::erf(x); }});
+  return functions;
+}
+
+} // namespace
+
+/** Benchmark vectorized math functions.
+ *
+ *  For each function used by entry-wise layers, compares the
+ *  throughput of a scalar standard library loop against the
+ *  vectorized implementation in simd_math.hpp, and reports the
+ *  maximum error of both relative to a double-precision reference.
+ *  Both versions run on one thread.
+ *
+ *  usage: simd_math_benchmark [--size=<int>] [--iters=<int>]
+ */
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+  const bool master = comm->am_world_master();
+
+  options *opts = options::get();
+  opts->init(argc, argv);
+  const El::Int size = opts->get_int("size", 1 << 20);
+  const int iters = opts->get_int("iters", 20);
+
+  if (master) {
+    std::cout << "instruction set: " << simd_math_instruction_set() << "\n"
+              << "function,scalar_gentries_per_s,vector_gentries_per_s,"
+              << "speedup,scalar_max_ulps,vector_max_ulps"
+              << std::endl;
+  }
+
+  std::vector<float> x(size), y_scalar(size), y_vector(size);
+  for (const auto& f : make_functions()) {
+    std::mt19937 gen(20190801);
+    std::uniform_real_distribution<float> dist(f.min_input, f.max_input);
+    for (auto& v : x) { v = dist(gen); }
+
+    // Time scalar and vector versions
+    double scalar_time = 0, vector_time = 0;
+    for (int iter = 0; iter < iters; ++iter) {
+      double start = get_time();
+      f.scalar(x.data(), y_scalar.data(), size);
+      scalar_time += get_time() - start;
+      start = get_time();
+      f.vector(x.data(), y_vector.data(), size);
+      vector_time += get_time() - start;
+    }
+
+    // Measure error relative to double-precision reference
+    std::int64_t scalar_ulps = 0, vector_ulps = 0;
+    for (El::Int i = 0; i < size; ++i) {
+      const auto y_ref = static_cast<float>(f.reference(x[i]));
+      scalar_ulps = std::max(scalar_ulps, ulp_distance(y_scalar[i], y_ref));
+      vector_ulps = std::max(vector_ulps, ulp_distance(y_vector[i], y_ref));
+    }
+
+    if (master) {
+      const double entries = static_cast<double>(size) * iters;
+      std::cout << f.name << ","
+                << entries / scalar_time / 1e9 << ","
+                << entries / vector_time / 1e9 << ","
+                << scalar_time / vector_time << ","
+                << scalar_ulps << ","
+                << vector_ulps << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
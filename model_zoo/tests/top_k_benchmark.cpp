@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// comm_test.cpp - Tests lbann_comm
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "lbann/lbann.hpp"
+#include "lbann/proto/factories.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/utils/top_k.hpp"
+
+using namespace lbann;
+
+namespace {
+
+/** Top-k selection with all-gather of candidate lists. */
+void all_gather_top_k(lbann_comm& comm,
+                      const El::mpi::Comm& c,
+                      El::Int k,
+                      El::Int num_cols,
+                      std::vector<top_k_entry>& top_entries) {
+  const int size = El::mpi::Size(c);
+  std::vector<top_k_entry> global_top_entries(size * num_cols * k);
+  comm.all_gather(reinterpret_cast<El::byte*>(top_entries.data()),
+                  top_entries.size() * sizeof(top_k_entry),
+                  reinterpret_cast<El::byte*>(global_top_entries.data()),
+                  top_entries.size() * sizeof(top_k_entry),
+                  c);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < num_cols; ++col) {
+    std::vector<top_k_entry> col_entries(size * k);
+    for (El::Int rank = 0; rank < size; ++rank) {
+      const auto* start = &global_top_entries[rank*num_cols*k+col*k];
+      std::copy(start, start + k, &col_entries[rank*k]);
+    }
+    std::partial_sort_copy(col_entries.begin(),
+                           col_entries.end(),
+                           &top_entries[col*k],
+                           &top_entries[col*k] + k,
+                           top_k_entry::compare);
+  }
+}
+
+} // namespace
+
+/** Benchmark distributed top-k selection.
+ *
+ *  Compares the all-gather approach formerly used by the in_top_k
+ *  and top_k_categorical_accuracy layers against the pairwise tree
+ *  merge in reduce_top_k. Classes are distributed cyclically over
+ *  the trainer's ranks. Run with different process counts to scale
+ *  ranks.
+ *
+ *  usage: top_k_benchmark [--classes=<list>] [--k=<list>]
+ *                         [--mini_batch_size=<int>] [--iters=<int>]
+ */
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+  const bool master = comm->am_world_master();
+
+  options *opts = options::get();
+  opts->init(argc, argv);
+  const auto& class_list = parse_list<El::Int>(opts->get_string("classes", "1000 10000 100000"));
+  const auto& k_list = parse_list<El::Int>(opts->get_string("k", "1 5 100"));
+  const El::Int width = opts->get_int("mini_batch_size", 128);
+  const int iters = opts->get_int("iters", 20);
+
+  const auto& c = comm->get_trainer_comm();
+  const int rank = El::mpi::Rank(c);
+  const int size = El::mpi::Size(c);
+  if (master) {
+    std::cout << "ranks,classes,k,local_select_s,all_gather_s,tree_merge_s"
+              << std::endl;
+  }
+
+  for (const auto& num_classes : class_list) {
+    const El::Int local_height = (num_classes - rank + size - 1) / size;
+    std::vector<DataType> local_values(local_height * width);
+    std::mt19937 gen(rank);
+    std::uniform_real_distribution<DataType> dist(0, 1);
+    for (auto& v : local_values) { v = dist(gen); }
+
+    for (const auto& k : k_list) {
+      std::vector<top_k_entry> local_entries(width * k), top_entries;
+      double select_time = 0, gather_time = 0, tree_time = 0;
+      for (int iter = 0; iter < iters; ++iter) {
+        double start = get_time();
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int col = 0; col < width; ++col) {
+          select_top_k(&local_values[col*local_height], local_height, k,
+                       rank, size, &local_entries[col*k]);
+        }
+        select_time += get_time() - start;
+
+        top_entries = local_entries;
+        comm->barrier(c);
+        start = get_time();
+        all_gather_top_k(*comm, c, k, width, top_entries);
+        gather_time += get_time() - start;
+        const auto reference = top_entries;
+
+        top_entries = local_entries;
+        comm->barrier(c);
+        start = get_time();
+        reduce_top_k(*comm, c, k, width, top_entries.data());
+        tree_time += get_time() - start;
+
+        for (size_t i = 0; i < top_entries.size(); ++i) {
+          if (top_entries[i].index != reference[i].index) {
+            LBANN_ERROR("tree merge result does not match all-gather result");
+          }
+        }
+      }
+      comm->allreduce(&select_time, 1, c, El::mpi::MAX);
+      comm->allreduce(&gather_time, 1, c, El::mpi::MAX);
+      comm->allreduce(&tree_time, 1, c, El::mpi::MAX);
+      if (master) {
+        std::cout << size << "," << num_classes << "," << k << ","
+                  << select_time / iters << ","
+                  << gather_time / iters << ","
+                  << tree_time / iters << std::endl;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
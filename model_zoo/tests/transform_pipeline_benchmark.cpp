@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// comm_test.cpp - Tests lbann_comm
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include "lbann/lbann.hpp"
+#include "lbann/transforms/transform_pipeline.hpp"
+#include "lbann/transforms/normalize.hpp"
+#include "lbann/transforms/vision/color_jitter.hpp"
+#include "lbann/transforms/vision/horizontal_flip.hpp"
+#include "lbann/transforms/vision/normalize_to_lbann_layout.hpp"
+#include "lbann/transforms/vision/random_resized_crop.hpp"
+#include "lbann/transforms/vision/resized_center_crop.hpp"
+#include "lbann/transforms/vision/to_lbann_layout.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/timer.hpp"
+
+using namespace lbann;
+
+namespace {
+
+/** ImageNet-style transform pipelines. */
+std::vector<std::pair<std::string, transform::transform_pipeline>>
+make_pipelines(size_t size) {
+  const std::vector<float> means = {0.406f, 0.456f, 0.485f};
+  const std::vector<float> stds = {0.225f, 0.224f, 0.229f};
+  std::vector<std::pair<std::string, transform::transform_pipeline>> pipelines;
+
+  // Training augmentation
+  transform::transform_pipeline train;
+  train.add_transform(make_unique<transform::random_resized_crop>(size, size));
+  train.add_transform(make_unique<transform::horizontal_flip>(0.5f));
+  train.add_transform(
+    make_unique<transform::normalize_to_lbann_layout>(means, stds));
+  pipelines.emplace_back("random_resized_crop+flip+normalize", train);
+
+  // Training augmentation with color jitter
+  transform::transform_pipeline jitter;
+  jitter.add_transform(make_unique<transform::random_resized_crop>(size, size));
+  jitter.add_transform(make_unique<transform::horizontal_flip>(0.5f));
+  jitter.add_transform(
+    make_unique<transform::color_jitter>(0.6f, 1.4f, 0.6f, 1.4f, 0.6f, 1.4f));
+  jitter.add_transform(make_unique<transform::to_lbann_layout>());
+  jitter.add_transform(make_unique<transform::normalize>(means, stds));
+  pipelines.emplace_back("random_resized_crop+flip+jitter+normalize", jitter);
+
+  // Validation
+  transform::transform_pipeline val;
+  val.add_transform(make_unique<transform::resized_center_crop>(
+                      size * 8 / 7, size * 8 / 7, size, size));
+  val.add_transform(
+    make_unique<transform::normalize_to_lbann_layout>(means, stds));
+  pipelines.emplace_back("resized_center_crop+normalize", val);
+
+  return pipelines;
+}
+
+} // namespace
+
+/** Benchmark fused vision transform pipelines.
+ *
+ *  Applies common ImageNet transform pipelines to a mini-batch of
+ *  random decoded images, with and without fusing the transforms
+ *  into a single kernel (see transform_pipeline). Images are
+ *  transformed in parallel straight into mini-batch columns, as in
+ *  the image data readers.
+ *
+ *  usage: transform_pipeline_benchmark [--height=<int>] [--width=<int>]
+ *                                      [--size=<int>]
+ *                                      [--mini_batch_size=<int>]
+ *                                      [--iters=<int>]
+ */
+int main(int argc, char *argv[]) {
+  world_comm_ptr comm = initialize(argc, argv, lbann_default_random_seed);
+  const bool master = comm->am_world_master();
+
+  options *opts = options::get();
+  opts->init(argc, argv);
+  const size_t height = opts->get_int("height", 375);
+  const size_t width = opts->get_int("width", 500);
+  const size_t size = opts->get_int("size", 224);
+  const El::Int mini_batch_size = opts->get_int("mini_batch_size", 256);
+  const int iters = opts->get_int("iters", 10);
+
+  // Random images
+  std::vector<El::Matrix<uint8_t>> images(mini_batch_size);
+  std::mt19937 gen(comm->get_rank_in_world());
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto& image : images) {
+    image.Resize(3 * height * width, 1);
+    for (El::Int i = 0; i < image.Height(); ++i) {
+      image.Buffer()[i] = dist(gen);
+    }
+  }
+  CPUMat X(3 * size * size, mini_batch_size);
+
+  if (master) {
+    std::cout << "pipeline,unfused_s,fused_s,speedup" << std::endl;
+  }
+  for (auto& named_pipeline : make_pipelines(size)) {
+    auto& pipeline = named_pipeline.second;
+    if (!pipeline.is_fused()) {
+      LBANN_ERROR("pipeline " + named_pipeline.first + " is not fused");
+    }
+    double times[2] = {0, 0};
+    for (int fuse = 0; fuse < 2; ++fuse) {
+      pipeline.set_fusion(fuse);
+      for (int iter = 0; iter < iters; ++iter) {
+        const double start = get_time();
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int mb_idx = 0; mb_idx < mini_batch_size; ++mb_idx) {
+          El::Matrix<uint8_t> image(images[mb_idx]);
+          std::vector<size_t> dims = {3, height, width};
+          auto X_v = El::View(X, El::ALL, El::IR(mb_idx, mb_idx + 1));
+          pipeline.apply(image, X_v, dims);
+        }
+        times[fuse] += get_time() - start;
+      }
+    }
+    if (master) {
+      std::cout << named_pipeline.first << ","
+                << times[0] / iters << ","
+                << times[1] / iters << ","
+                << times[0] / times[1] << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -41,13 +41,15 @@ class L2WeightRegularization(ObjectiveFunctionTerm):
 class ObjectiveFunction:
     """Objective function for optimization algorithm."""
 
-    def __init__(self, terms=[]):
+    def __init__(self, terms=[], loss_scaling=None):
         """Create an objective function with layer terms and regularization.
 
         `terms` should be a sequence of `ObjectiveFunctionTerm`s and
-        `Layer`s.
+        `Layer`s. `loss_scaling` may be a `lbann_pb2.LossScaling`
+        message to enable dynamic loss scaling.
 
         """
+        self.loss_scaling = loss_scaling
         self.terms = []
         for t in make_iterable(terms):
             self.add_term(t)
@@ -72,4 +74,6 @@ class ObjectiveFunction:
                 proto.layer_term.extend([term_message])
             elif type(term) is L2WeightRegularization:
                 proto.l2_weight_regularization.extend([term_message])
+        if self.loss_scaling is not None:
+            proto.loss_scaling.CopyFrom(self.loss_scaling)
         return proto
@@ -24,9 +24,10 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <tuple>
+#include <cstring>
 #include "lbann/callbacks/callback_ltfb.hpp"
 #include "lbann/callbacks/callback_imcomm.hpp"
+#include "lbann/layers/io/input/generic_input_layer.hpp"
 #include "lbann/utils/random.hpp"
 #include "lbann/optimizers/sgd.hpp"
 #include "lbann/optimizers/adam.hpp"
@@ -35,6 +36,16 @@ namespace lbann {
 
 namespace {
 
+/** MPI tag for asynchronous model exchanges on the world communicator.
+ *  Keeps the exchange from matching other point-to-point messages.
+ */
+constexpr int exchange_tag = 7401;
+
+/** Maximum number of bytes per exchange message.
+ *  MPI counts are ints, so larger models are sent in chunks.
+ */
+constexpr size_t max_exchange_chunk_size = size_t(1) << 30;
+
 /** Generate partner trainer assignments.
  *
  *  Requires a scatter from the world master process. If there are an
@@ -86,236 +97,167 @@ El::Int get_partner_trainer(lbann_comm& comm,
   }
 }
 
-/** Exchange weights values with partner trainer.
+/** Whether weights are exchanged with the partner trainer.
  *
  *  @param weights_names    Names of weights to exchange. If empty,
  *                          then all weights are exchanged.
- *  @param send_weights     Weights values sent to partner.
- *  @param recv_weights     Weights values recieved from partner.
  */
-void exchange_models__sendrecv_weights(lbann_comm& comm,
-                                       El::Int partner_trainer,
-                                       const std::set<std::string>& weights_names,
-                                       const std::vector<weights*>& send_weights,
-                                       std::vector<weights*>& recv_weights,
-                                       bool exchange_hyperparameters) {
-
-  // Get partner process
-  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
-  const El::Int procs_per_trainer = comm.get_procs_per_trainer();
-  const El::Int partner_rank_in_world = (partner_trainer * procs_per_trainer
-                                         + rank_in_trainer);
-
-  // Exchange weights with partner
-  for (size_t i = 0; i < send_weights.size(); ++i) {
-    const auto& send = *send_weights[i];
-    auto& recv = *recv_weights[i];
-    if (weights_names.empty()
-        || (std::find(weights_names.begin(), weights_names.end(),
-                      send.get_name())
-            != weights_names.end())) {
-
-      // Exchange weights values
-      El::SendRecv(send.get_values().LockedMatrix(),
-                   recv.get_values().Matrix(),
-                   comm.get_world_comm(),
-                   partner_rank_in_world,
-                   partner_rank_in_world);
-
-      // Exchange optimizer state
-      const auto* send_opt = send.get_optimizer();
-      auto* recv_opt = recv.get_optimizer();
-      const auto* send_sgd = dynamic_cast<const sgd*>(send_opt);
-      auto* recv_sgd = dynamic_cast<sgd*>(recv_opt);
-      if (send_sgd != nullptr && recv_sgd != nullptr) {
-        if(exchange_hyperparameters) {
-          using hyperparameters_type = std::tuple<DataType, DataType, bool>;
-          hyperparameters_type hyperparameters(send_sgd->get_learning_rate(),
-                                             send_sgd->get_momentum(),
-                                             send_sgd->using_nesterov());
-          El::mpi::SendRecv(reinterpret_cast<El::byte*>(&hyperparameters),
-                          sizeof(hyperparameters_type),
-                          partner_rank_in_world,
-                          partner_rank_in_world,
-                          comm.get_world_comm(),
-                          El::SyncInfo<El::Device::CPU>{});
-          recv_sgd->set_learning_rate(std::get<0>(hyperparameters));
-          recv_sgd->set_momentum(std::get<1>(hyperparameters));
-          recv_sgd->set_nesterov(std::get<2>(hyperparameters));
-        }
-        El::SendRecv(send_sgd->get_velocity().LockedMatrix(),
-                     recv_sgd->get_velocity().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
-      }
-      const auto* send_adam = dynamic_cast<const adam*>(send_opt);
-      auto* recv_adam = dynamic_cast<adam*>(recv_opt);
-      if (send_adam != nullptr && recv_adam != nullptr) {
-        if(exchange_hyperparameters) {
-          using hyperparameters_type = std::tuple<DataType, DataType, DataType, DataType, DataType, DataType>;
-          hyperparameters_type hyperparameters(send_adam->get_learning_rate(),
-                                             send_adam->get_beta1(),
-                                             send_adam->get_beta2(),
-                                             send_adam->get_eps(),
-                                             send_adam->get_current_beta1(),
-                                             send_adam->get_current_beta2());
-          El::mpi::SendRecv(reinterpret_cast<El::byte*>(&hyperparameters),
-                          sizeof(hyperparameters_type),
-                          partner_rank_in_world,
-                          partner_rank_in_world,
-                          comm.get_world_comm(),
-                          El::SyncInfo<El::Device::CPU>{});
-          recv_adam->set_learning_rate(std::get<0>(hyperparameters));
-          recv_adam->set_beta1(std::get<1>(hyperparameters));
-          recv_adam->set_beta2(std::get<2>(hyperparameters));
-          recv_adam->set_eps(std::get<3>(hyperparameters));
-          recv_adam->set_current_beta1(std::get<4>(hyperparameters));
-          recv_adam->set_current_beta2(std::get<5>(hyperparameters));
-          El::SendRecv(send_adam->get_moment1().LockedMatrix(),
-                     recv_adam->get_moment1().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
-        }
-        El::SendRecv(send_adam->get_moment2().LockedMatrix(),
-                     recv_adam->get_moment2().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
-      }
-
-    }
-  }
+bool is_exchanged(const weights& w,
+                  const std::set<std::string>& weights_names) {
+  return (weights_names.empty()
+          || weights_names.count(w.get_name()) > 0);
+}
 
+/** Append a value to a wire buffer. */
+template <typename T>
+void pack_value(std::vector<El::byte>& buffer, const T& value) {
+  const auto offset = buffer.size();
+  buffer.resize(offset + sizeof(T));
+  std::memcpy(&buffer[offset], &value, sizeof(T));
 }
 
-void exchange_models__checkpoint_file(lbann_comm& comm,
-                                      El::Int partner_trainer,
-                                      model& m,
-                                      const std::set<std::string>& weights_names,
-                                      const std::vector<weights*>& local_weights) {
-
-  // Checkpoint directories
-  const auto local_trainer = comm.get_trainer_rank();
-  const auto step = m.get_step();
-  const std::string send_dir = (m.get_name()
-                                + "_trainer" + std::to_string(local_trainer)
-                                + "_step" + std::to_string(step));
-  const std::string recv_dir = (m.get_name()
-                                + "_trainer" + std::to_string(partner_trainer)
-                                + "_step" + std::to_string(step));
-
-  // Save model checkpoint
-  persist p;
-  p.set_cb_type(callback_type::batch);
-  if (comm.am_trainer_master()) {
-    p.open_checkpoint(send_dir.c_str());
-  } else {
-    std::strcpy(p.m_checkpoint_dir, send_dir.c_str());
-  }
-  m.save_to_checkpoint_shared(p);
-  p.close_checkpoint();
+/** Read a value from a wire buffer and advance the read position. */
+template <typename T>
+T unpack_value(const El::byte*& pos) {
+  T value;
+  std::memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return value;
+}
 
-  // Synchronize with partner trainer
-  {
-    const auto rank_in_trainer = comm.get_rank_in_trainer();
-    DataType send = false, recv = false;
-    comm.sendrecv(&send, 1, partner_trainer, rank_in_trainer,
-                  &recv, 1, partner_trainer, rank_in_trainer,
-                  El::SyncInfo<El::Device::CPU>{});
+/** Append local matrix entries to a wire buffer.
+ *
+ *  Entries are copied through a contiguous CPU matrix, so the
+ *  matrix may have any leading dimension and device.
+ */
+void pack_matrix(std::vector<El::byte>& buffer, const AbsMat& mat) {
+  El::Matrix<DataType, El::Device::CPU> mat_cpu;
+  El::Copy(mat, mat_cpu);
+  const auto size = mat_cpu.Height() * mat_cpu.Width() * sizeof(DataType);
+  const auto offset = buffer.size();
+  buffer.resize(offset + size);
+  if (size > 0) {
+    std::memcpy(&buffer[offset], mat_cpu.LockedBuffer(), size);
   }
+}
 
-  // Load model checkpoint from partner trainer
-  p.set_cb_type(callback_type::batch);
-  if (comm.am_trainer_master()) {
-    p.open_restart(recv_dir.c_str());
-  } else {
-    std::strcpy(p.m_checkpoint_dir, recv_dir.c_str());
-  }
-  m.load_from_checkpoint_shared(p);
-  if (comm.am_trainer_master()) {
-    p.close_restart();
+/** Read local matrix entries from a wire buffer and advance the read
+ *  position.
+ *
+ *  The matrix must already have the sender's local dimensions.
+ */
+void unpack_matrix(const El::byte*& pos, AbsMat& mat) {
+  El::Matrix<DataType, El::Device::CPU> mat_cpu(mat.Height(), mat.Width());
+  const auto size = mat_cpu.Height() * mat_cpu.Width() * sizeof(DataType);
+  if (size > 0) {
+    std::memcpy(mat_cpu.Buffer(), pos, size);
   }
+  pos += size;
+  El::Copy(mat_cpu, mat);
+}
 
-  // Restore weights that shouldn't be exchanged
-  if (!weights_names.empty()) {
-    const auto& model_weights = m.get_weights();
-    for (size_t i = 0; i < model_weights.size(); ++i) {
-      if (std::find(weights_names.begin(),
-                    weights_names.end(),
-                    model_weights[i]->get_name())
-          == weights_names.end()) {
-        *model_weights[i] = *local_weights[i];
+/** Pack local model data into the LTFB wire format.
+ *
+ *  The buffer contains the model's score, followed by the local
+ *  portions of the values and optimizer state of each exchanged
+ *  weights. Optimizer hyperparameters are included if requested.
+ *  Corresponding ranks in identical models produce buffers with the
+ *  same size.
+ */
+void pack_model(std::vector<El::byte>& buffer,
+                EvalType score,
+                const std::vector<weights*>& model_weights,
+                const std::set<std::string>& weights_names,
+                bool pack_hyperparameters) {
+  buffer.clear();
+  pack_value(buffer, score);
+  for (const auto* w : model_weights) {
+    if (!is_exchanged(*w, weights_names)) { continue; }
+    pack_matrix(buffer, w->get_values().LockedMatrix());
+    const auto* opt = w->get_optimizer();
+    const auto* sgd_opt = dynamic_cast<const sgd*>(opt);
+    const auto* adam_opt = dynamic_cast<const adam*>(opt);
+    if (sgd_opt != nullptr) {
+      if (pack_hyperparameters) {
+        pack_value(buffer, sgd_opt->get_learning_rate());
+        pack_value(buffer, sgd_opt->get_momentum());
+        pack_value(buffer, sgd_opt->using_nesterov());
+      }
+      pack_matrix(buffer, sgd_opt->get_velocity().LockedMatrix());
+    } else if (adam_opt != nullptr) {
+      if (pack_hyperparameters) {
+        pack_value(buffer, adam_opt->get_learning_rate());
+        pack_value(buffer, adam_opt->get_beta1());
+        pack_value(buffer, adam_opt->get_beta2());
+        pack_value(buffer, adam_opt->get_eps());
+        pack_value(buffer, adam_opt->get_current_beta1());
+        pack_value(buffer, adam_opt->get_current_beta2());
       }
+      pack_matrix(buffer, adam_opt->get_moment1().LockedMatrix());
+      pack_matrix(buffer, adam_opt->get_moment2().LockedMatrix());
+    } else if (opt != nullptr && pack_hyperparameters) {
+      pack_value(buffer, opt->get_learning_rate());
     }
   }
-
 }
 
-void restore_local_model__checkpoint_file(lbann_comm& comm, model& m) {
-
-  // Checkpoint directories
-  const auto local_trainer = comm.get_trainer_rank();
-  const auto step = m.get_step();
-  const std::string checkpoint_dir = (m.get_name()
-                                      + "_trainer" + std::to_string(local_trainer)
-                                      + "_step" + std::to_string(step));
-
-  // Load local model checkpoint
-  persist p;
-  p.set_cb_type(callback_type::batch);
-  if (comm.am_trainer_master()) {
-    p.open_restart(checkpoint_dir.c_str());
-  } else {
-    std::strcpy(p.m_checkpoint_dir, checkpoint_dir.c_str());
+/** Unpack model data in the LTFB wire format.
+ *
+ *  Values and optimizer state of exchanged weights are overwritten.
+ *  Returns the score that was packed with the model data.
+ */
+EvalType unpack_model(const std::vector<El::byte>& buffer,
+                      const std::vector<weights*>& model_weights,
+                      const std::set<std::string>& weights_names,
+                      bool unpack_hyperparameters) {
+  const El::byte* pos = buffer.data();
+  const auto score = unpack_value<EvalType>(pos);
+  for (auto* w : model_weights) {
+    if (!is_exchanged(*w, weights_names)) { continue; }
+    unpack_matrix(pos, w->get_values().Matrix());
+    auto* opt = w->get_optimizer();
+    auto* sgd_opt = dynamic_cast<sgd*>(opt);
+    auto* adam_opt = dynamic_cast<adam*>(opt);
+    if (sgd_opt != nullptr) {
+      if (unpack_hyperparameters) {
+        sgd_opt->set_learning_rate(unpack_value<DataType>(pos));
+        sgd_opt->set_momentum(unpack_value<DataType>(pos));
+        sgd_opt->set_nesterov(unpack_value<bool>(pos));
+      }
+      unpack_matrix(pos, sgd_opt->get_velocity().Matrix());
+    } else if (adam_opt != nullptr) {
+      if (unpack_hyperparameters) {
+        adam_opt->set_learning_rate(unpack_value<DataType>(pos));
+        adam_opt->set_beta1(unpack_value<DataType>(pos));
+        adam_opt->set_beta2(unpack_value<DataType>(pos));
+        adam_opt->set_eps(unpack_value<DataType>(pos));
+        adam_opt->set_current_beta1(unpack_value<DataType>(pos));
+        adam_opt->set_current_beta2(unpack_value<DataType>(pos));
+      }
+      unpack_matrix(pos, adam_opt->get_moment1().Matrix());
+      unpack_matrix(pos, adam_opt->get_moment2().Matrix());
+    } else if (opt != nullptr && unpack_hyperparameters) {
+      opt->set_learning_rate(unpack_value<DataType>(pos));
+    }
   }
-  m.load_from_checkpoint_shared(p);
-  if (comm.am_trainer_master()) {
-    p.close_restart();
+  if (pos != buffer.data() + buffer.size()) {
+    LBANN_ERROR("LTFB received model data that does not match local model");
   }
-
+  return score;
 }
 
 /** Get mean metric value with validation set. */
-EvalType evaluate(model& m, const std::string& metric_name) {
-
-  // Make sure data readers finish asynchronous work
-  const auto original_mode = m.get_execution_mode();
-  m.collect_background_data_fetch(original_mode);
-
-  // Mark the data store as loading - Note that this is a temporary fix
-  // for the current use of the tournament
-  m.mark_data_store_explicitly_loading(execution_mode::validation);
-
-  // Evaluate model on validation set
-  m.evaluate(execution_mode::validation);
-
-  // Get metric value
-  bool found_metric = false;
-  EvalType metric_value = 0;
+EvalType get_metric_value(model& m, const std::string& metric_name) {
   for (const auto& met : m.get_metrics()) {
     if (met->name() == metric_name) {
-      found_metric = true;
-      metric_value = met->get_mean_value(execution_mode::validation);
-      break;
+      return met->get_mean_value(execution_mode::validation);
     }
   }
-  if (!found_metric) {
-    std::stringstream err;
-    err << "could not find metric \"" << metric_name << "\""
-        << "in model \"" << m.get_name() << "\"";
-    LBANN_ERROR(err.str());
-  }
-
-  // Mark the data store as loaded - Note that this is a temporary fix
-  // for the current use of the tournament
-  m.make_data_store_preloaded(execution_mode::validation);
-
-  // Clean up and return metric value
-  m.set_execution_mode(original_mode);
-  return metric_value;
-
+  std::stringstream err;
+  err << "could not find metric \"" << metric_name << "\""
+      << "in model \"" << m.get_name() << "\"";
+  LBANN_ERROR(err.str());
+  return EvalType(0);
 }
 
 } // namespace
@@ -326,13 +268,19 @@ lbann_callback_ltfb::lbann_callback_ltfb(El::Int batch_interval,
                                          bool low_score_wins,
                                          communication_algorithm comm_algo,
                                          bool exchange_hyperparameters,
+                                         El::Int eval_subset_batches,
+                                         bool reuse_partner_score,
+                                         bool async_exchange,
                                          lbann_summary *summarizer)
   : lbann_callback(batch_interval, summarizer),
     m_metric_name(std::move(metric_name)),
     m_weights_names(std::move(weights_names)),
     m_low_score_wins(low_score_wins),
     m_comm_algo(comm_algo),
-    m_exchange_hyperparameters(exchange_hyperparameters) {}
+    m_exchange_hyperparameters(exchange_hyperparameters),
+    m_eval_subset_batches(eval_subset_batches),
+    m_reuse_partner_score(reuse_partner_score),
+    m_async_exchange(async_exchange) {}
 
 lbann_callback_ltfb::lbann_callback_ltfb(const lbann_callback_ltfb& other) :
   lbann_callback(other),
@@ -340,7 +288,11 @@ lbann_callback_ltfb::lbann_callback_ltfb(const lbann_callback_ltfb& other) :
   m_weights_names(other.m_weights_names),
   m_low_score_wins(other.m_low_score_wins),
   m_comm_algo(other.m_comm_algo),
-  m_exchange_hyperparameters(other.m_exchange_hyperparameters) {
+  m_exchange_hyperparameters(other.m_exchange_hyperparameters),
+  m_eval_subset_batches(other.m_eval_subset_batches),
+  m_reuse_partner_score(other.m_reuse_partner_score),
+  m_async_exchange(other.m_async_exchange),
+  m_eval_subset_indices(other.m_eval_subset_indices) {
 
   // Deep copy
   m_workspace_weights.clear();
@@ -355,11 +307,16 @@ lbann_callback_ltfb& lbann_callback_ltfb::operator=(const lbann_callback_ltfb& o
   lbann_callback::operator=(other);
 
   // Shallow copies
+  // Note: Outstanding model exchanges are not copied.
   m_metric_name = other.m_metric_name;
   m_weights_names = other.m_weights_names;
   m_low_score_wins = other.m_low_score_wins;
   m_comm_algo = other.m_comm_algo;
   m_exchange_hyperparameters = other.m_exchange_hyperparameters;
+  m_eval_subset_batches = other.m_eval_subset_batches;
+  m_reuse_partner_score = other.m_reuse_partner_score;
+  m_async_exchange = other.m_async_exchange;
+  m_eval_subset_indices = other.m_eval_subset_indices;
 
   // Deep copy
   m_workspace_weights.clear();
@@ -418,12 +375,17 @@ void lbann_callback_ltfb::on_batch_begin(model *m) {
                                + "model \"" + m->get_name() + "\", "
                                + "step " + std::to_string(step)
                                + "): ");
+
+  // Finish tournament from previous round
+  if (m_exchange_pending) {
+    finish_exchange(*m, message_prefix);
+  }
+
   if (comm.am_world_master()) {
     std::cout << message_prefix + "starting tournament...\n";
   }
 
   // Determine partner model for tournament
-  const El::Int local_trainer = comm.get_trainer_rank();
   const El::Int partner_trainer
     = get_partner_trainer(comm, message_prefix);
 
@@ -431,45 +393,120 @@ void lbann_callback_ltfb::on_batch_begin(model *m) {
   if (comm.am_world_master()) {
     std::cout << message_prefix + "evaluating local model...\n";
   }
-  const auto local_score = evaluate(*m, m_metric_name);
-
-  // Store local model data
-  auto&& model_weights = m->get_weights();
-  std::vector<weights*> local_weights;
-  for (size_t i = 0; i < model_weights.size(); ++i) {
-    local_weights.push_back(m_workspace_weights[i].get());
-    *local_weights[i] = *model_weights[i];
-  }
+  const auto local_score = evaluate(*m);
 
   // Exchange model data with partner trainer
   if (comm.am_world_master()) {
     std::cout << message_prefix + "exchanging model data...\n";
   }
+  start_exchange(*m, partner_trainer, local_score);
+  if (!m_async_exchange) {
+    finish_exchange(*m, message_prefix);
+  }
+
+}
+
+void lbann_callback_ltfb::on_train_end(model *m) {
+  if (m_exchange_pending) {
+    const auto message_prefix = (std::string{} + "LTFB ("
+                                 + "model \"" + m->get_name() + "\", "
+                                 + "step " + std::to_string(m->get_step())
+                                 + "): ");
+    finish_exchange(*m, message_prefix);
+  }
+}
+
+void lbann_callback_ltfb::start_exchange(model& m,
+                                         El::Int partner_trainer,
+                                         EvalType local_score) {
+  auto&& comm = *m.get_comm();
+  const bool exchange_hyperparameters
+    = (m_comm_algo == communication_algorithm::checkpoint_file
+       || m_exchange_hyperparameters);
+
+  // Pack local model data
   switch (m_comm_algo) {
   case communication_algorithm::sendrecv_weights:
-    exchange_models__sendrecv_weights(comm,
-                                      partner_trainer,
-                                      m_weights_names,
-                                      local_weights,
-                                      model_weights,
-                                      m_exchange_hyperparameters);
-    break;
   case communication_algorithm::checkpoint_file:
-    exchange_models__checkpoint_file(comm,
-                                     partner_trainer,
-                                     *m,
-                                     m_weights_names,
-                                     local_weights);
+    pack_model(m_send_buffer, local_score, m.get_weights(),
+               m_weights_names, exchange_hyperparameters);
     break;
   default:
     LBANN_ERROR("invalid LTFB communication algorithm");
   }
 
+  // Exchange model data with corresponding rank in partner trainer
+  // Note: Partner models are identical aside from their weights
+  // values, so the partner buffer has the same size as the local one.
+  const size_t size = m_send_buffer.size();
+  m_recv_buffer.resize(size);
+  const auto rank_in_trainer = comm.get_rank_in_trainer();
+  const auto partner_rank = comm.get_world_rank(partner_trainer,
+                                                rank_in_trainer);
+  m_exchange_requests.clear();
+  for (size_t offset = 0; offset < size; offset += max_exchange_chunk_size) {
+    const int chunk_size = std::min(size - offset, max_exchange_chunk_size);
+    if (m_async_exchange) {
+      m_exchange_requests.emplace_back();
+      comm.nb_tagged_recv(&m_recv_buffer[offset], chunk_size,
+                          partner_rank, exchange_tag,
+                          m_exchange_requests.back(),
+                          comm.get_world_comm());
+      m_exchange_requests.emplace_back();
+      comm.nb_tagged_send(&m_send_buffer[offset], chunk_size,
+                          partner_rank, exchange_tag,
+                          m_exchange_requests.back(),
+                          comm.get_world_comm());
+    } else {
+      comm.sendrecv(&m_send_buffer[offset], chunk_size,
+                    partner_trainer, rank_in_trainer,
+                    &m_recv_buffer[offset], chunk_size,
+                    partner_trainer, rank_in_trainer,
+                    El::SyncInfo<El::Device::CPU>{});
+    }
+  }
+  m_exchange_pending = true;
+  m_pending_partner_trainer = partner_trainer;
+  m_pending_local_score = local_score;
+
+}
+
+void lbann_callback_ltfb::finish_exchange(model& m,
+                                          const std::string& message_prefix) {
+  auto&& comm = *m.get_comm();
+  const El::Int local_trainer = comm.get_trainer_rank();
+  const El::Int partner_trainer = m_pending_partner_trainer;
+  const auto local_score = m_pending_local_score;
+  const bool exchange_hyperparameters
+    = (m_comm_algo == communication_algorithm::checkpoint_file
+       || m_exchange_hyperparameters);
+
+  // Wait for model data from partner trainer
+  if (!m_exchange_requests.empty()) {
+    comm.wait_all(m_exchange_requests);
+    m_exchange_requests.clear();
+  }
+  m_exchange_pending = false;
+
+  // Store local model data
+  auto&& model_weights = m.get_weights();
+  for (size_t i = 0; i < model_weights.size(); ++i) {
+    *m_workspace_weights[i] = *model_weights[i];
+  }
+
+  // Load partner model data
+  auto partner_score = unpack_model(m_recv_buffer,
+                                    model_weights,
+                                    m_weights_names,
+                                    exchange_hyperparameters);
+
   // Evaluate partner model
-  if (comm.am_world_master()) {
-    std::cout << message_prefix + "evaluating partner model...\n";
+  if (!m_reuse_partner_score) {
+    if (comm.am_world_master()) {
+      std::cout << message_prefix + "evaluating partner model...\n";
+    }
+    partner_score = evaluate(m);
   }
-  const auto& partner_score = evaluate(*m, m_metric_name);
 
   // Choose tournament winner
   // Note: restore local model data if it got a better score.
@@ -477,17 +514,8 @@ void lbann_callback_ltfb::on_batch_begin(model *m) {
   if ((m_low_score_wins && local_score <= partner_score) ||
       (!m_low_score_wins && local_score >= partner_score)) {
     tournament_winner = local_trainer;
-    switch (m_comm_algo) {
-    case communication_algorithm::sendrecv_weights:
-      for (size_t i = 0; i < model_weights.size(); ++i) {
-        *model_weights[i] = *local_weights[i];
-      }
-      break;
-    case communication_algorithm::checkpoint_file:
-      restore_local_model__checkpoint_file(comm, *m);
-      break;
-    default:
-      LBANN_ERROR("invalid LTFB communication algorithm");
+    for (size_t i = 0; i < model_weights.size(); ++i) {
+      *model_weights[i] = *m_workspace_weights[i];
     }
   }
 
@@ -506,6 +534,86 @@ void lbann_callback_ltfb::on_batch_begin(model *m) {
 
 }
 
+EvalType lbann_callback_ltfb::evaluate(model& m) {
+
+  // Make sure data readers finish asynchronous work
+  const auto original_mode = m.get_execution_mode();
+  m.collect_background_data_fetch(original_mode);
+
+  // Find validation data readers for subset evaluation
+  // Note: A subset is only used if it is smaller than the validation
+  // set. The data store expects complete passes over the data, so it
+  // is not supported.
+  std::vector<generic_input_layer*> input_layers;
+  El::Int num_batches = m_eval_subset_batches;
+  if (num_batches > 0) {
+    for (auto* l : m.get_layers()) {
+      auto* input = dynamic_cast<generic_input_layer*>(l);
+      if (input == nullptr) { continue; }
+      const auto* reader = input->get_data_reader(execution_mode::validation);
+      if (reader == nullptr) { continue; }
+      if (reader->get_data_store_ptr() != nullptr) {
+        LBANN_ERROR("LTFB evaluation with a validation subset "
+                    "does not support the data store");
+      }
+      if (num_batches >= reader->get_num_iterations_per_epoch()) {
+        num_batches = 0;
+      }
+      input_layers.push_back(input);
+    }
+    if (num_batches == 0) { input_layers.clear(); }
+  }
+
+  // Rewind validation data to a fixed ordering
+  // Note: The ordering is captured at the first tournament so that
+  // all tournaments use the same samples.
+  if (!input_layers.empty() && m_eval_subset_indices.empty()) {
+    for (auto* input : input_layers) {
+      const auto* reader = input->get_data_reader(execution_mode::validation);
+      m_eval_subset_indices.push_back(reader->get_shuffled_indices());
+    }
+  }
+  std::vector<std::vector<int>> original_indices;
+  for (size_t i = 0; i < input_layers.size(); ++i) {
+    auto* reader = input_layers[i]->get_data_reader(execution_mode::validation);
+    original_indices.push_back(reader->get_shuffled_indices());
+    reader->set_shuffled_indices(m_eval_subset_indices[i]);
+    input_layers[i]->reset_data_set(execution_mode::validation);
+  }
+
+  // Evaluate model on validation set
+  EvalType metric_value = 0;
+  if (num_batches > 0) {
+    m.evaluate(execution_mode::validation, num_batches);
+    metric_value = get_metric_value(m, m_metric_name);
+  } else {
+
+    // Mark the data store as loading - Note that this is a temporary fix
+    // for the current use of the tournament
+    m.mark_data_store_explicitly_loading(execution_mode::validation);
+
+    m.evaluate(execution_mode::validation);
+    metric_value = get_metric_value(m, m_metric_name);
+
+    // Mark the data store as loaded - Note that this is a temporary fix
+    // for the current use of the tournament
+    m.make_data_store_preloaded(execution_mode::validation);
+
+  }
+
+  // Restore validation data ordering
+  for (size_t i = 0; i < input_layers.size(); ++i) {
+    auto* reader = input_layers[i]->get_data_reader(execution_mode::validation);
+    input_layers[i]->reset_data_set(execution_mode::validation);
+    reader->set_shuffled_indices(original_indices[i]);
+  }
+
+  // Clean up and return metric value
+  m.set_execution_mode(original_mode);
+  return metric_value;
+
+}
+
 lbann_callback_ltfb::communication_algorithm
 lbann_callback_ltfb::string_to_comm_algo(const std::string& str) {
   if (str.empty() || str == "sendrecv_weights") {
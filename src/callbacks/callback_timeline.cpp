@@ -26,76 +26,76 @@
 // callback_timeline .hpp .cpp - Callback hooks to record a timeline of runtime
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <fstream>
 #include "lbann/callbacks/callback_timeline.hpp"
-#include "lbann/utils/timer.hpp"
 
 namespace lbann {
 
 void lbann_callback_timeline::on_train_begin(model *m) {
-  // Set up layers and weights.
+  // Intern layer and weights names up front.
   for (const auto& l : m->get_layers()) {
-    m_fp_times.emplace(l->get_name(), std::vector<std::pair<EvalType,EvalType>>());
-    m_bp_times.emplace(l->get_name(), std::vector<std::pair<EvalType,EvalType>>());
+    get_name_id(l->get_name());
   }
   for (const auto& w : m->get_weights()) {
-    m_opt_times.emplace(w->get_name(), std::vector<std::pair<EvalType,EvalType>>());
+    get_name_id(w->get_name());
   }
-  // Ensure the model is synchronized at the start.
-  m->get_comm()->trainer_barrier();
-  m_start_time = get_time();
+  // Clocks are aligned across ranks when tracing starts.
+  auto& comm = *m->get_comm();
+  const std::string path = m_outdir + "/timeline.m" +
+    std::to_string(comm.get_trainer_rank()) + "." +
+    std::to_string(comm.get_rank_in_trainer()) + ".trace";
+  tracer::get().start(path, comm, m_flush_interval, m_buffer_size);
 }
 
 void lbann_callback_timeline::on_train_end(model *m) {
-  const std::string path = m_outdir + "/timeline.m" +
-    std::to_string(m->get_comm()->get_trainer_rank()) + "." +
-    std::to_string(m->get_comm()->get_rank_in_trainer()) + ".txt";
-  std::ofstream f(path);
-  for (const auto& kv : m_fp_times) {
-    const std::string layer_name = "fp-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << layer_name << ":" << time.first << ":" << time.second << '\n';
-    }
-  }
-  for (const auto& kv : m_bp_times) {
-    const std::string layer_name = "bp-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << layer_name << ":" << time.first << ":" << time.second << '\n';
-    }
-  }
-  for (const auto& kv : m_opt_times) {
-    const std::string weights_name = "opt-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << weights_name << ":" << time.first << ":" << time.second << '\n';
-    }
+  tracer::get().stop();
+}
+
+std::uint32_t lbann_callback_timeline::get_name_id(const std::string& name) {
+  auto it = m_name_ids.find(name);
+  if (it == m_name_ids.end()) {
+    it = m_name_ids.emplace(name, tracer::get().intern(name)).first;
   }
+  return it->second;
 }
 
 void lbann_callback_timeline::on_forward_prop_begin(model *m, Layer *l) {
-  m_fp_start_time = get_rel_time();
+  m_fp_start_time = tracer::now();
 }
 
 void lbann_callback_timeline::on_forward_prop_end(model *m, Layer *l) {
-  EvalType end = get_rel_time();
-  m_fp_times[l->get_name()].emplace_back(m_fp_start_time, end);
+  tracer::get().record(trace_category::forward_prop,
+                       get_name_id(l->get_name()),
+                       m_fp_start_time, tracer::now());
 }
 
 void lbann_callback_timeline::on_backward_prop_begin(model *m, Layer *l) {
-  m_bp_start_time = get_rel_time();
+  m_bp_start_time = tracer::now();
 }
 
 void lbann_callback_timeline::on_backward_prop_end(model *m, Layer *l) {
-  EvalType end = get_rel_time();
-  m_bp_times[l->get_name()].emplace_back(m_bp_start_time, end);
+  tracer::get().record(trace_category::backward_prop,
+                       get_name_id(l->get_name()),
+                       m_bp_start_time, tracer::now());
 }
 
 void lbann_callback_timeline::on_optimize_begin(model *m, weights *w) {
-  m_opt_start_time = get_rel_time();
+  m_opt_start_time = tracer::now();
 }
 
 void lbann_callback_timeline::on_optimize_end(model *m, weights *w) {
-  EvalType end = get_rel_time();
-  m_opt_times[w->get_name()].emplace_back(m_opt_start_time, end);
+  tracer::get().record(trace_category::optimize,
+                       get_name_id(w->get_name()),
+                       m_opt_start_time, tracer::now());
+}
+
+void lbann_callback_timeline::on_evaluate_forward_prop_begin(model *m, Layer *l) {
+  m_fp_start_time = tracer::now();
+}
+
+void lbann_callback_timeline::on_evaluate_forward_prop_end(model *m, Layer *l) {
+  tracer::get().record(trace_category::forward_prop,
+                       get_name_id(l->get_name()),
+                       m_fp_start_time, tracer::now());
 }
 
 }  // namespace lbann
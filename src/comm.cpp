@@ -30,6 +30,7 @@
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/cuda.hpp"
+#include "lbann/utils/online_softmax.hpp"
 #include "mpi.h"
 #include "omp.h"
 #include <sstream>
@@ -74,6 +75,9 @@ lbann_comm::lbann_comm(int ppm, El::mpi::Comm world) :
 
   // Setup threads
   setup_threads();
+
+  // Create custom reduction operations
+  MPI_Op_create(&softmax_stats_op, 1, &softmax_stats_mpi_op);
 }
 
 lbann_comm::~lbann_comm() {
@@ -81,6 +85,7 @@ lbann_comm::~lbann_comm() {
   El::mpi::Free(trainer_comm);
   El::mpi::Free(intertrainer_comm);
   El::mpi::Free(node_comm);
+  MPI_Op_free(&softmax_stats_mpi_op);
 #ifdef LBANN_HAS_ALUMINUM
   ::Al::Finalize();
 #endif
@@ -137,6 +142,7 @@ void lbann_comm::intertrainer_sum_matrix(AbsDistMat& mat) {
 void lbann_comm::allreduce(AbsMat& m,
                            const El::mpi::Comm& c,
                            El::mpi::Op op) {
+  LBANN_TRACE_SCOPE(trace_category::comm, "allreduce");
   if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
     return;
   }
@@ -220,10 +226,43 @@ void lbann_comm::allreduce(AbsDistMat& m,
   allreduce(m.Matrix(), c, op);
 }
 
+void lbann_comm::allreduce_softmax_stats(AbsMat& stats,
+                                         const El::mpi::Comm& c) {
+  LBANN_TRACE_SCOPE(trace_category::comm, "allreduce_softmax_stats");
+  if (El::mpi::Size(c) == 1 || stats.Height() < 1 || stats.Width() < 1) {
+    return;
+  }
+  if (stats.GetDevice() != El::Device::CPU) {
+    LBANN_ERROR("softmax statistics must be on CPU");
+  }
+  if (stats.Height() < 2) {
+    LBANN_ERROR("softmax statistics tuples need at least two entries");
+  }
+  if (stats.Width() > 1 && stats.Height() != stats.LDim()) {
+    std::stringstream err;
+    err << "softmax statistics are not contiguous "
+        << "(height=" << stats.Height() << ", "
+        << "width=" << stats.Width() << ", "
+        << "leading dim=" << stats.LDim() << ")";
+    LBANN_ERROR(err.str());
+  }
+  const int local_size = stats.Height() * stats.Width();
+  bytes_sent += sizeof(DataType) * local_size;
+  MPI_Datatype type;
+  checkMPI(MPI_Type_contiguous(stats.Height() * sizeof(DataType),
+                               MPI_BYTE, &type));
+  checkMPI(MPI_Type_commit(&type));
+  checkMPI(MPI_Allreduce(MPI_IN_PLACE, stats.Buffer(), stats.Width(), type,
+                         softmax_stats_mpi_op, c.GetMPIComm()));
+  checkMPI(MPI_Type_free(&type));
+  bytes_received += sizeof(DataType) * local_size * (El::mpi::Size(c) - 1);
+}
+
 void lbann_comm::nb_allreduce(AbsMat& m,
                               const El::mpi::Comm& c,
                               Al::request& req,
                               El::mpi::Op op) {
+  LBANN_TRACE_SCOPE(trace_category::comm, "nb_allreduce");
   if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
     return;
   }
@@ -313,6 +352,7 @@ void lbann_comm::nb_allreduce(AbsDistMat& m,
 }
 
 void lbann_comm::wait(Al::request& req) {
+  LBANN_TRACE_SCOPE(trace_category::comm, "allreduce_wait");
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     ::Al::Wait<::Al::MPIBackend>(req.mpi_req);
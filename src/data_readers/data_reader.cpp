@@ -350,6 +350,17 @@ int generic_data_reader::get_next_position() const {
   }
 }
 
+std::vector<int> generic_data_reader::get_next_mini_batch_indices() const {
+  std::vector<int> indices;
+  const int next_pos = get_next_position();
+  const int end_pos = std::min(static_cast<size_t>(next_pos + get_loaded_mini_batch_size()),
+                               m_shuffled_indices.size());
+  for (int n = next_pos; n < end_pos; n += m_sample_stride) {
+    indices.push_back(m_shuffled_indices[n]);
+  }
+  return indices;
+}
+
 void generic_data_reader::select_subset_of_data_partitioned() {
 
   //sanity checks
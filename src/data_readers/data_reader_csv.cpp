@@ -29,10 +29,124 @@
 #include <unordered_set>
 #include "lbann/data_readers/data_reader_csv.hpp"
 #include "lbann/utils/options.hpp"
+#include "lbann/utils/omp_pragma.hpp"
 #include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
 
 namespace lbann {
 
+namespace {
+
+/** Exact powers of ten that can be represented by a double. */
+constexpr double exact_powers_of_ten[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * Parse a number in [begin, end) the way std::stod does.
+ * Plain decimal numbers (optional sign, up to 19 significant digits with an
+ * optional decimal point, optional exponent) whose value can be computed
+ * exactly from a double mantissa and power of ten are parsed directly.
+ * Anything else (e.g. "nan", hex floats, very long mantissas, or trailing
+ * text) falls back to strtod.
+ * @returns False if no number could be parsed.
+ */
+bool parse_number(const char* begin, const char* end, double& value) {
+  const char* p = begin;
+  while (p < end && (*p == ' ' || *p == '\t')) { ++p; }
+  const bool negative = (p < end && *p == '-');
+  if (p < end && (*p == '-' || *p == '+')) { ++p; }
+  uint64_t mantissa = 0;
+  int num_digits = 0, exponent = 0;
+  const char* digits_begin = p;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+    mantissa = 10 * mantissa + (*p - '0');
+    num_digits += (mantissa != 0);
+  }
+  bool has_digits = (p != digits_begin);
+  if (p < end && *p == '.') {
+    const char* frac_begin = ++p;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      mantissa = 10 * mantissa + (*p - '0');
+      num_digits += (mantissa != 0);
+    }
+    exponent -= p - frac_begin;
+    has_digits = has_digits || (p != frac_begin);
+  }
+  if (has_digits && p < end && (*p == 'e' || *p == 'E')) {
+    const char* exp_begin = p++;
+    const bool exp_negative = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) { ++p; }
+    int exp_value = 0;
+    const char* exp_digits = p;
+    for (; p < end && *p >= '0' && *p <= '9' && exp_value < 100000; ++p) {
+      exp_value = 10 * exp_value + (*p - '0');
+    }
+    if (p == exp_digits) {
+      p = exp_begin;
+    } else {
+      exponent += exp_negative ? -exp_value : exp_value;
+    }
+  }
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) { ++p; }
+  if (has_digits && p == end && num_digits <= 19
+      && mantissa <= (uint64_t(1) << 53)
+      && exponent >= -22 && exponent <= 22) {
+    value = static_cast<double>(mantissa);
+    value = (exponent < 0 ?
+             value / exact_powers_of_ten[-exponent] :
+             value * exact_powers_of_ten[exponent]);
+    value = negative ? -value : value;
+    return true;
+  }
+  // Fall back to strtod
+  const std::string str(begin, end);
+  char* str_end;
+  value = std::strtod(str.c_str(), &str_end);
+  return str_end != str.c_str();
+}
+
+/** Find the end of a field in [begin, end). */
+inline const char* find_field_end(const char* begin, const char* end,
+                                  char separator) {
+  const void* p = std::memchr(begin, separator, end - begin);
+  return p == nullptr ? end : static_cast<const char*>(p);
+}
+
+/** Beginning of the binary cache file. */
+struct csv_cache_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t data_type_size;
+  uint64_t num_samples;
+  uint64_t num_features;
+  uint64_t source_size;
+  int64_t source_mtime;
+  int64_t sample_count;
+  int32_t num_cols;
+  int32_t skip_cols;
+  int32_t skip_rows;
+  int32_t label_col;
+  int32_t response_col;
+  int32_t num_labels;
+  char separator;
+  uint8_t has_header;
+  uint8_t has_labels;
+  uint8_t has_responses;
+};
+
+constexpr char csv_cache_magic[8] = "LBCSVC";
+constexpr uint32_t csv_cache_version = 1;
+/** Offset of parsed data in the binary cache. */
+constexpr size_t csv_cache_data_offset = 128;
+static_assert(sizeof(csv_cache_header) <= csv_cache_data_offset,
+              "CSV cache header is too large");
+
+} // namespace
+
 csv_reader::csv_reader(bool shuffle)
   : generic_data_reader(shuffle) {}
 
@@ -54,7 +168,13 @@ csv_reader::csv_reader(const csv_reader& other) :
   m_responses(other.m_responses),
   m_col_transforms(other.m_col_transforms),
   m_label_transform(other.m_label_transform),
-  m_response_transform(other.m_response_transform) {
+  m_response_transform(other.m_response_transform),
+  m_mmap(other.m_mmap),
+  m_binary_cache(other.m_binary_cache),
+  m_binary_cache_dir(other.m_binary_cache_dir),
+  m_file(other.m_file),
+  m_cache(other.m_cache),
+  m_cache_data(other.m_cache_data) {
   if (!other.m_ifstreams.empty()) {
     // Need to set these up again manually.
     setup_ifstreams();
@@ -80,6 +200,12 @@ csv_reader& csv_reader::operator=(const csv_reader& other) {
   m_col_transforms = other.m_col_transforms;
   m_label_transform = other.m_label_transform;
   m_response_transform = other.m_response_transform;
+  m_mmap = other.m_mmap;
+  m_binary_cache = other.m_binary_cache;
+  m_binary_cache_dir = other.m_binary_cache_dir;
+  m_file = other.m_file;
+  m_cache = other.m_cache;
+  m_cache_data = other.m_cache_data;
   if (!other.m_ifstreams.empty()) {
     // Possibly free our current ifstreams, set them up again.
     for (std::ifstream* ifs : m_ifstreams) {
@@ -97,6 +223,10 @@ csv_reader::~csv_reader() {
 }
 
 void csv_reader::load() {
+  if (m_mmap || m_binary_cache) {
+    load_mapped();
+    return;
+  }
   bool master = m_comm->am_world_master();
   setup_ifstreams();
   std::ifstream& ifs = *m_ifstreams[0];
@@ -268,7 +398,416 @@ void csv_reader::load() {
   select_subset_of_data();
 }
 
+void csv_reader::load_mapped() {
+  const std::string path = get_file_dir() + get_data_filename();
+  m_file.reset();
+  m_cache.reset();
+  m_cache_data = nullptr;
+  m_index.clear();
+  m_labels.clear();
+  m_responses.clear();
+
+  if (m_binary_cache) {
+    // The world master builds the cache if it is missing or stale.
+    const std::string cache_path = get_binary_cache_filename();
+    if (m_comm->am_world_master() && !open_binary_cache(cache_path)) {
+      index_mapped_file(path);
+      write_binary_cache(cache_path);
+    }
+    m_comm->global_barrier();
+    if (!open_binary_cache(cache_path)) {
+      throw lbann_exception(
+        "csv_reader: failed to open binary cache " + cache_path);
+    }
+    m_file.reset();
+    m_index.clear();
+  } else {
+    // Only the world master builds the index; all ranks map the file.
+    if (m_comm->am_world_master()) {
+      index_mapped_file(path);
+    } else {
+      auto file = std::make_shared<mapped_file>(path);
+      file->advise_random();
+      m_file = file;
+    }
+    const El::mpi::Comm& world_comm = m_comm->get_world_comm();
+    m_comm->broadcast<int>(0, m_num_cols, world_comm);
+    m_comm->broadcast<int>(0, m_label_col, world_comm);
+    m_comm->broadcast<int>(0, m_response_col, world_comm);
+    m_comm->broadcast<int>(0, m_num_labels, world_comm);
+    std::vector<long long> index(m_index.begin(), m_index.end());
+    m_comm->world_broadcast<long long>(0, index);
+    m_index.assign(index.begin(), index.end());
+    if (!m_disable_labels) {
+      m_comm->world_broadcast<int>(0, m_labels);
+    }
+    if (!m_disable_responses) {
+      m_comm->world_broadcast<DataType>(0, m_responses);
+    }
+    m_num_samples = m_index.size() - 1;
+  }
+  if (m_master) std::cerr << "num samples: " << m_num_samples << "\n";
+
+  // Reset indices.
+  m_shuffled_indices.resize(m_num_samples);
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  select_subset_of_data();
+}
+
+void csv_reader::index_mapped_file(const std::string& path) {
+  auto file = std::make_shared<mapped_file>(path);
+  file->advise_sequential();
+  const char* data = file->data();
+  const size_t size = file->size();
+  auto next_line = [&] (size_t pos) -> size_t {
+    const void* p = (pos < size ?
+                     std::memchr(data + pos, '\n', size - pos) :
+                     nullptr);
+    return p == nullptr ? size : static_cast<const char*>(p) - data + 1;
+  };
+
+  // Skip rows and parse the header.
+  size_t header_start = 0;
+  for (int i = 0; i < m_skip_rows; ++i) {
+    if (header_start >= size) {
+      throw lbann_exception("csv_reader: error on skipping rows");
+    }
+    header_start = next_line(header_start);
+  }
+  if (header_start >= size) {
+    throw lbann_exception(
+      "csv_reader: failed to read header in " + get_data_filename());
+  }
+  const size_t header_end = next_line(header_start);
+  m_num_cols = std::count(data + header_start, data + header_end,
+                          m_separator) + 1;
+  if (m_skip_cols >= m_num_cols) {
+    throw lbann_exception(
+      "csv_reader: asked to skip more columns than are present");
+  }
+  if (!m_disable_labels) {
+    if (m_label_col < 0) {
+      // Last column becomes the label column.
+      m_label_col = m_num_cols - 1;
+    }
+    if (m_label_col >= m_num_cols) {
+      throw lbann_exception(
+        "csv_reader: label column" + std::to_string(m_label_col) +
+        " is not present");
+    }
+  }
+  if (!m_disable_responses) {
+    if (m_response_col < 0) {
+      // Last column becomes the response column.
+      m_response_col = m_num_cols - 1;
+    }
+    if (m_response_col >= m_num_cols) {
+      throw lbann_exception(
+        "csv_reader: response column" + std::to_string(m_response_col) +
+        " is not present");
+    }
+  }
+  const size_t data_start = m_has_header ? header_end : header_start;
+  if (data_start >= size) {
+    throw lbann_exception(
+      "csv_reader: reached EOF after reading header");
+  }
+
+  // Find line starts, with each thread scanning one chunk of the file.
+  const int num_chunks = omp_get_max_threads();
+  const size_t chunk_size = (size - data_start + num_chunks - 1) / num_chunks;
+  std::vector<std::vector<std::streampos>> chunk_index(num_chunks);
+  LBANN_OMP_PARALLEL_FOR
+  for (int chunk = 0; chunk < num_chunks; ++chunk) {
+    const size_t begin = std::min(data_start + chunk * chunk_size, size);
+    const size_t end = std::min(begin + chunk_size, size);
+    auto& index = chunk_index[chunk];
+    const char* p = data + begin;
+    while (p < data + end) {
+      p = static_cast<const char*>(std::memchr(p, '\n', data + end - p));
+      if (p == nullptr) { break; }
+      index.push_back(++p - data);
+    }
+  }
+  m_index.assign(1, data_start);
+  for (const auto& index : chunk_index) {
+    m_index.insert(m_index.end(), index.begin(), index.end());
+  }
+  if (data[size-1] != '\n') {
+    // Pretend the last line ends with a newline.
+    m_index.push_back(size + 1);
+  }
+  int num_samples_to_use = get_absolute_sample_count();
+  if (num_samples_to_use > 0 && num_samples_to_use < (int) m_index.size() - 1) {
+    m_index.resize(num_samples_to_use + 1);
+  }
+  m_num_samples = m_index.size() - 1;
+
+  // Verify lines and extract labels and responses.
+  if (!m_disable_labels) { m_labels.resize(m_num_samples); }
+  if (!m_disable_responses) { m_responses.resize(m_num_samples); }
+  int bad_line = m_num_samples;
+  std::string error;
+  LBANN_OMP_PARALLEL_FOR
+  for (int i = 0; i < m_num_samples; ++i) {
+    const char* begin = data + m_index[i];
+    const char* end = data + m_index[i+1] - 1;
+    try {
+      if (std::count(begin, end, m_separator) + 1 != m_num_cols) {
+        throw lbann_exception(
+          "csv_reader: line " + std::to_string(i+1) +
+          " does not have right number of entries");
+      }
+      const char* field_begin = begin;
+      for (int col = 0; col < m_num_cols; ++col) {
+        const char* field_end = find_field_end(field_begin, end, m_separator);
+        if (!m_disable_labels && col == m_label_col) {
+          m_labels[i] = m_label_transform(std::string(field_begin, field_end));
+        }
+        if (!m_disable_responses && col == m_response_col) {
+          m_responses[i] = m_response_transform(
+            std::string(field_begin, field_end));
+        }
+        field_begin = field_end + 1;
+      }
+    } catch (std::exception& e) {
+      OMP_CRITICAL
+      {
+        if (i < bad_line) {
+          bad_line = i;
+          error = e.what();
+        }
+      }
+    }
+  }
+  if (bad_line < m_num_samples) {
+    throw lbann_exception(error);
+  }
+  if (!m_disable_labels) {
+    // Do some simple validation checks on the classes.
+    // Ensure the elements begin with 0, and there are no gaps.
+    std::unordered_set<int> label_classes(m_labels.begin(), m_labels.end());
+    auto minmax = std::minmax_element(label_classes.begin(), label_classes.end());
+    if (*minmax.first != 0) {
+      throw lbann_exception(
+        "csv_reader: classes are not indexed from 0");
+    }
+    if (*minmax.second != (int) label_classes.size() - 1) {
+      throw lbann_exception(
+        "csv_reader: label classes are not contiguous");
+    }
+    m_num_labels = label_classes.size();
+  }
+  file->advise_random();
+  m_file = file;
+}
+
+void csv_reader::parse_mapped_line(int data_id, DataType* out) {
+  // Note: load already verified that every line is properly formatted.
+  const char* field_begin = m_file->data() + m_index[data_id];
+  const char* end = m_file->data() + m_index[data_id+1] - 1;
+  for (int col = 0; col < m_num_cols; ++col) {
+    const char* field_end = find_field_end(field_begin, end, m_separator);
+    // Skip the label, response, and any columns if needed.
+    if ((!m_disable_labels && col == m_label_col) ||
+        (!m_disable_responses && col == m_response_col) ||
+        col < m_skip_cols) {
+      field_begin = field_end + 1;
+      continue;
+    }
+    const auto transform = m_col_transforms.find(col);
+    if (transform != m_col_transforms.end()) {
+      *out = transform->second(std::string(field_begin, field_end));
+    } else {
+      double val;
+      if (!parse_number(field_begin, field_end, val)) {
+        throw lbann_exception(
+          "csv_reader: could not convert '"
+          + std::string(field_begin, field_end) + "'");
+      }
+      *out = val;
+    }
+    ++out;
+    field_begin = field_end + 1;
+  }
+}
+
+std::string csv_reader::get_binary_cache_filename() const {
+  if (m_binary_cache_dir.empty()) {
+    return get_file_dir() + get_data_filename() + ".lbcache";
+  }
+  std::string name = get_data_filename();
+  const size_t slash = name.find_last_of('/');
+  if (slash != std::string::npos) {
+    name = name.substr(slash + 1);
+  }
+  return m_binary_cache_dir + "/" + name + ".lbcache";
+}
+
+bool csv_reader::open_binary_cache(const std::string& path) {
+  struct stat cache_stat, source_stat;
+  const std::string source = get_file_dir() + get_data_filename();
+  if (stat(path.c_str(), &cache_stat) != 0
+      || stat(source.c_str(), &source_stat) != 0
+      || (size_t) cache_stat.st_size < csv_cache_data_offset) {
+    return false;
+  }
+  auto cache = std::make_shared<mapped_file>(path);
+  csv_cache_header header;
+  std::memcpy(&header, cache->data(), sizeof(header));
+
+  // Check that the cache matches the CSV file and parsing options.
+  if (std::memcmp(header.magic, csv_cache_magic, sizeof(csv_cache_magic)) != 0
+      || header.version != csv_cache_version
+      || header.data_type_size != sizeof(DataType)
+      || header.source_size != (uint64_t) source_stat.st_size
+      || header.source_mtime != (int64_t) source_stat.st_mtime
+      || header.sample_count != get_absolute_sample_count()
+      || header.skip_cols != m_skip_cols
+      || header.skip_rows != m_skip_rows
+      || header.separator != m_separator
+      || header.has_header != m_has_header
+      || header.has_labels != !m_disable_labels
+      || header.has_responses != !m_disable_responses
+      || (!m_disable_labels && m_label_col >= 0
+          && header.label_col != m_label_col)
+      || (!m_disable_responses && m_response_col >= 0
+          && header.response_col != m_response_col)) {
+    return false;
+  }
+  const size_t num_samples = header.num_samples;
+  const size_t num_features = header.num_features;
+  const size_t labels_offset = (csv_cache_data_offset
+                                + num_samples * num_features * sizeof(DataType));
+  const size_t responses_offset = (labels_offset
+                                   + (m_disable_labels ? 0 : num_samples)
+                                   * sizeof(int32_t));
+  const size_t cache_size = (responses_offset
+                             + (m_disable_responses ? 0 : num_samples)
+                             * sizeof(DataType));
+  if (cache->size() != cache_size) {
+    return false;
+  }
+
+  const int num_data_cols = get_num_data_cols(
+    header.num_cols, header.skip_cols,
+    header.has_labels ? header.label_col : -1,
+    header.has_responses ? header.response_col : -1);
+  if ((size_t) num_data_cols != num_features) {
+    return false;
+  }
+
+  m_num_cols = header.num_cols;
+  m_label_col = header.label_col;
+  m_response_col = header.response_col;
+  m_num_labels = header.num_labels;
+  m_num_samples = num_samples;
+  if (!m_disable_labels) {
+    const int32_t* labels = reinterpret_cast<const int32_t*>(
+      cache->data() + labels_offset);
+    m_labels.assign(labels, labels + num_samples);
+  }
+  if (!m_disable_responses) {
+    const DataType* responses = reinterpret_cast<const DataType*>(
+      cache->data() + responses_offset);
+    m_responses.assign(responses, responses + num_samples);
+  }
+  cache->advise_random();
+  m_cache_data = reinterpret_cast<const DataType*>(
+    cache->data() + csv_cache_data_offset);
+  m_cache = cache;
+  return true;
+}
+
+void csv_reader::write_binary_cache(const std::string& path) {
+  struct stat source_stat;
+  if (stat(m_file->path().c_str(), &source_stat) != 0) {
+    throw lbann_exception(
+      "csv_reader: failed to stat " + m_file->path());
+  }
+  csv_cache_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, csv_cache_magic, sizeof(csv_cache_magic));
+  header.version = csv_cache_version;
+  header.data_type_size = sizeof(DataType);
+  header.num_samples = m_num_samples;
+  header.num_features = get_linearized_data_size();
+  header.source_size = source_stat.st_size;
+  header.source_mtime = source_stat.st_mtime;
+  header.sample_count = get_absolute_sample_count();
+  header.num_cols = m_num_cols;
+  header.skip_cols = m_skip_cols;
+  header.skip_rows = m_skip_rows;
+  header.label_col = m_label_col;
+  header.response_col = m_response_col;
+  header.num_labels = m_num_labels;
+  header.separator = m_separator;
+  header.has_header = m_has_header;
+  header.has_labels = !m_disable_labels;
+  header.has_responses = !m_disable_responses;
+
+  // Write to a temporary file so readers never see a partial cache.
+  const std::string tmp_path = path + ".tmp";
+  std::ofstream ofs(tmp_path, std::ios::out | std::ios::binary);
+  if (!ofs) {
+    throw lbann_exception(
+      "csv_reader: failed to open " + tmp_path);
+  }
+  std::vector<char> header_buf(csv_cache_data_offset, 0);
+  std::memcpy(header_buf.data(), &header, sizeof(header));
+  ofs.write(header_buf.data(), header_buf.size());
+
+  // Parse blocks of lines in parallel.
+  const int block_size = 4096;
+  const size_t num_features = header.num_features;
+  std::vector<DataType> block(block_size * num_features);
+  std::string error;
+  m_file->advise_sequential();
+  for (int start = 0; start < m_num_samples; start += block_size) {
+    const int end = std::min(start + block_size, m_num_samples);
+    LBANN_OMP_PARALLEL_FOR
+    for (int i = start; i < end; ++i) {
+      try {
+        parse_mapped_line(i, &block[(i - start) * num_features]);
+      } catch (std::exception& e) {
+        OMP_CRITICAL
+        error = e.what();
+      }
+    }
+    if (!error.empty()) {
+      ofs.close();
+      std::remove(tmp_path.c_str());
+      throw lbann_exception(error);
+    }
+    ofs.write(reinterpret_cast<const char*>(block.data()),
+              (end - start) * num_features * sizeof(DataType));
+  }
+  if (!m_disable_labels) {
+    std::vector<int32_t> labels(m_labels.begin(), m_labels.end());
+    ofs.write(reinterpret_cast<const char*>(labels.data()),
+              labels.size() * sizeof(int32_t));
+  }
+  if (!m_disable_responses) {
+    ofs.write(reinterpret_cast<const char*>(m_responses.data()),
+              m_responses.size() * sizeof(DataType));
+  }
+  ofs.close();
+  if (!ofs || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    throw lbann_exception(
+      "csv_reader: failed to write binary cache " + path);
+  }
+}
+
 bool csv_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
+  if (m_cache_data != nullptr) {
+    const El::Int num_features = get_linearized_data_size();
+    const DataType* src = &m_cache_data[data_id * num_features];
+    std::copy(src, src + num_features, X.Buffer(0, mb_idx));
+    return true;
+  } else if (m_file != nullptr) {
+    parse_mapped_line(data_id, X.Buffer(0, mb_idx));
+    return true;
+  }
   auto line = fetch_line_label_response(data_id);
   // TODO: Avoid unneeded copies.
   for (size_t i = 0; i < line.size(); ++i) {
@@ -317,6 +856,16 @@ std::vector<DataType> csv_reader::fetch_line(int data_id) {
 
 std::vector<DataType> csv_reader::fetch_line_label_response(
   int data_id) {
+  if (m_cache_data != nullptr || m_file != nullptr) {
+    std::vector<DataType> parsed_line(get_linearized_data_size());
+    if (m_cache_data != nullptr) {
+      const DataType* src = &m_cache_data[data_id * parsed_line.size()];
+      std::copy(src, src + parsed_line.size(), parsed_line.begin());
+    } else {
+      parse_mapped_line(data_id, parsed_line.data());
+    }
+    return parsed_line;
+  }
   std::string line = fetch_raw_line(data_id);
   std::vector<DataType> parsed_line;
   // Note: load already verified that every line is properly formatted.
@@ -352,6 +901,13 @@ std::vector<DataType> csv_reader::fetch_line_label_response(
 }
 
 std::string csv_reader::fetch_raw_line(int data_id) {
+  if (m_file != nullptr) {
+    return std::string(m_file->data() + m_index[data_id],
+                       m_index[data_id+1] - m_index[data_id] - 1);
+  } else if (m_cache != nullptr) {
+    throw lbann_exception(
+      "csv_reader: raw lines are not available with a binary cache");
+  }
 static int n = 0;
   std::ifstream& ifs = *m_ifstreams[omp_get_thread_num()];
   // Seek to the start of this datum's line.
@@ -68,6 +68,11 @@ image_data_reader& image_data_reader::operator=(const image_data_reader& rhs) {
   m_image_num_channels = rhs.m_image_num_channels;
   m_image_linearized_size = rhs.m_image_linearized_size;
   m_num_labels = rhs.m_num_labels;
+  m_packed_direct_io = rhs.m_packed_direct_io;
+  m_packed_readahead = rhs.m_packed_readahead;
+  m_packed_dataset.reset(rhs.m_packed_dataset != nullptr ?
+                         new packed_dataset(*rhs.m_packed_dataset) :
+                         nullptr);
 
   return (*this);
 }
@@ -90,6 +95,11 @@ void image_data_reader::copy_members(const image_data_reader &rhs, const std::ve
   m_image_num_channels = rhs.m_image_num_channels;
   m_image_linearized_size = rhs.m_image_linearized_size;
   m_num_labels = rhs.m_num_labels;
+  m_packed_direct_io = rhs.m_packed_direct_io;
+  m_packed_readahead = rhs.m_packed_readahead;
+  if (rhs.m_packed_dataset != nullptr) {
+    m_packed_dataset.reset(new packed_dataset(*rhs.m_packed_dataset));
+  }
   //m_thread_cv_buffer = rhs.m_thread_cv_buffer
 }
 
@@ -145,24 +155,38 @@ void image_data_reader::load() {
   options *opts = options::get();
 
   m_image_list.clear();
+  m_packed_dataset.reset();
+
+  if (packed_dataset::is_index_file(imageListFile)) {
+    // load packed dataset index
+    m_packed_dataset.reset(new packed_dataset(imageListFile,
+                                              m_packed_direct_io,
+                                              m_packed_readahead));
+    const size_t num_samples = m_packed_dataset->get_num_samples();
+    m_image_list.reserve(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+      m_image_list.emplace_back(img_src_t(),
+                                m_packed_dataset->get_sample(i).label);
+    }
+  } else {
+    // load image list
+    FILE *fplist = fopen(imageListFile.c_str(), "rt");
+    if (!fplist) {
+      throw lbann_exception(
+        std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
+        " :: failed to open: " + imageListFile);
+    }
 
-  // load image list
-  FILE *fplist = fopen(imageListFile.c_str(), "rt");
-  if (!fplist) {
-    throw lbann_exception(
-      std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
-      " :: failed to open: " + imageListFile);
-  }
-
-  while (!feof(fplist)) {
-    char imagepath[512];
-    label_t imagelabel;
-    if (fscanf(fplist, "%s%d", imagepath, &imagelabel) <= 1) {
-      break;
+    while (!feof(fplist)) {
+      char imagepath[512];
+      label_t imagelabel;
+      if (fscanf(fplist, "%s%d", imagepath, &imagelabel) <= 1) {
+        break;
+      }
+      m_image_list.emplace_back(imagepath, imagelabel);
     }
-    m_image_list.emplace_back(imagepath, imagelabel);
+    fclose(fplist);
   }
-  fclose(fplist);
 
   // TODO: this will probably need to change after sample_list class
   //       is modified
@@ -229,6 +253,39 @@ void image_data_reader::preload_data_store() {
   }  
 }
 
+int image_data_reader::fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) {
+  // Read the mini-batch's samples from a packed dataset with a few
+  // large reads, in file order
+  if (m_packed_dataset != nullptr && m_data_store == nullptr
+      && position_valid()) {
+    const int end_pos = std::min(static_cast<size_t>(m_current_pos + get_loaded_mini_batch_size()),
+                                 m_shuffled_indices.size());
+    std::vector<size_t> samples;
+    for (int n = m_current_pos; n < end_pos; n += m_sample_stride) {
+      samples.push_back(m_shuffled_indices[n]);
+      if (static_cast<El::Int>(samples.size()) == X.Width()) { break; }
+    }
+    m_packed_dataset->prefetch(samples);
+  }
+  return generic_data_reader::fetch_data(X, indices_fetched);
+}
+
+void image_data_reader::load_encoded_sample(int data_id,
+                                            El::Matrix<uint8_t>& encoded) {
+  if (m_packed_dataset == nullptr) {
+    load_encoded_image(get_file_dir() + m_image_list[data_id].first, encoded);
+    return;
+  }
+  const El::Int size = m_packed_dataset->get_sample(data_id).size;
+  uint8_t* buf = m_packed_dataset->get_prefetched(data_id);
+  if (buf != nullptr) {
+    encoded.Attach(size, 1, buf, size);
+  } else {
+    encoded.Resize(size, 1);
+    m_packed_dataset->read_sample(data_id, encoded.Buffer());
+  }
+}
+
 void image_data_reader::setup(int num_io_threads, std::shared_ptr<thread_pool> io_thread_pool) {
   generic_data_reader::setup(num_io_threads, io_thread_pool);
    m_transform_pipeline.set_expected_out_dims(
@@ -245,11 +302,17 @@ std::vector<image_data_reader::sample_t> image_data_reader::get_image_list_of_cu
 
 void image_data_reader::load_conduit_node_from_file(int data_id, conduit::Node &node) {
   node.reset();
-  const std::string filename = get_file_dir() + m_image_list[data_id].first;
   int label = m_image_list[data_id].second;
   //std::vector<conduit::uint8> data;
   std::vector<char> data;
-  read_raw_data(filename, data);
+  if (m_packed_dataset != nullptr) {
+    data.resize(m_packed_dataset->get_sample(data_id).size);
+    m_packed_dataset->read_sample(data_id,
+                                  reinterpret_cast<uint8_t*>(data.data()));
+  } else {
+    const std::string filename = get_file_dir() + m_image_list[data_id].first;
+    read_raw_data(filename, data);
+  }
   node[LBANN_DATA_ID_STR(data_id) + "/label"].set(label);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer"].set(data);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer"].set_char_ptr(data.data(), data.size());
@@ -58,13 +58,13 @@ CPUMat imagenet_reader::create_datum_view(CPUMat& X, const int mb_idx) const {
 }
 
 bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
-  El::Matrix<uint8_t> image;
+  El::Matrix<uint8_t> encoded_image;
   std::vector<size_t> dims;
-  const std::string image_path = get_file_dir() + m_image_list[data_id].first;
+  // Note: encoded_image may refer to memory owned by node.
+  conduit::Node node;
 
   if (m_data_store != nullptr) {
     bool have_node = true;
-    conduit::Node node;
     if (m_data_store->is_local_cache()) {
       if (m_data_store->has_conduit_node(data_id)) {
         const conduit::Node& ds_node = m_data_store->get_conduit_node(data_id);
@@ -89,23 +89,23 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx) {
         }
         m_issue_warning = false;
       }
-      load_image(image_path, image, dims);
+      load_encoded_sample(data_id, encoded_image);
       have_node = false;
     }
 
     if (have_node) {
       char *buf = node[LBANN_DATA_ID_STR(data_id) + "/buffer"].value();
       size_t size = node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"].value();
-      El::Matrix<uint8_t> encoded_image(size, 1, reinterpret_cast<uint8_t*>(buf), size);
-      decode_image(encoded_image, image, dims);
+      encoded_image.Attach(size, 1, reinterpret_cast<uint8_t*>(buf), size);
     }
   } else {
     // Data store is not being used.
-    load_image(image_path, image, dims);
+    load_encoded_sample(data_id, encoded_image);
   }
 
   auto X_v = create_datum_view(X, mb_idx);
-  m_transform_pipeline.apply(image, X_v, dims);
+  // Decoding is deferred so the decoder can use the transforms' crop.
+  m_transform_pipeline.apply_encoded(encoded_image, X_v, dims);
 
   return true;
 }
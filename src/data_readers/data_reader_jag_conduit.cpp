@@ -32,8 +32,6 @@
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/image.hpp"
 #include "lbann/utils/opencv.hpp"
-#include "lbann/transforms/repack_HWC_to_CHW_layout.hpp"
-#include "lbann/transforms/scale_and_translate.hpp"
 
 #include "lbann/utils/file_utils.hpp" // for add_delimiter() in load()
 #include <limits>     // numeric_limits
@@ -111,7 +109,22 @@ void data_reader_jag_conduit::shuffle_indices(rng_gen& gen) {
     m_shuffled_indices = m_leading_reader->get_shuffled_indices();
     return;
   }
-  generic_data_reader::shuffle_indices(gen);
+  if (m_shuffle && m_locality_shuffle_window > 0u) {
+    m_sample_list.shuffle_with_file_locality(m_shuffled_indices, m_locality_shuffle_window, gen);
+  } else {
+    generic_data_reader::shuffle_indices(gen);
+  }
+
+  /// Record the file opens of the epoch that just finished
+  const size_t num_file_opens = m_sample_list.get_num_file_opens();
+  if (num_file_opens > 0u) {
+    m_file_opens_per_epoch.push_back(num_file_opens);
+    if (m_comm->am_trainer_master()) {
+      std::cout << get_type() << " (" << get_role() << "): opened "
+                << num_file_opens << " sample files in epoch "
+                << m_file_opens_per_epoch.size() << " on trainer master" << std::endl;
+    }
+  }
   m_sample_list.compute_epochs_file_usage(get_shuffled_indices(), get_mini_batch_size(), *m_comm);
 }
 
@@ -149,6 +162,7 @@ void data_reader_jag_conduit::copy_members(const data_reader_jag_conduit& rhs, c
   m_split_channels = rhs.m_split_channels;
   set_linearized_image_size();
   m_is_data_loaded = rhs.m_is_data_loaded;
+  m_first_local_sample = rhs.m_first_local_sample;
   m_emi_image_keys = rhs.m_emi_image_keys;
   m_scalar_keys = rhs.m_scalar_keys;
   m_input_keys = rhs.m_input_keys;
@@ -182,6 +196,8 @@ void data_reader_jag_conduit::copy_members(const data_reader_jag_conduit& rhs, c
   m_sample_list.copy(rhs.m_sample_list);
   m_list_per_trainer = rhs.m_list_per_trainer;
   m_list_per_model = rhs.m_list_per_model;
+  m_locality_shuffle_window = rhs.m_locality_shuffle_window;
+  m_file_opens_per_epoch = rhs.m_file_opens_per_epoch;
 
   if(rhs.m_data_store != nullptr) {
     if(ds_sample_move_list.size() == 0) {
@@ -235,6 +251,7 @@ void data_reader_jag_conduit::set_defaults() {
   m_num_img_srcs = 1u;
   m_split_channels = false;
   m_is_data_loaded = false;
+  m_first_local_sample = 0u;
   m_num_labels = 0;
   m_emi_image_keys.clear();
   m_scalar_keys.clear();
@@ -261,6 +278,8 @@ void data_reader_jag_conduit::set_defaults() {
   //m_sample_list.clear();
   m_list_per_trainer = false;
   m_list_per_model = false;
+  m_locality_shuffle_window = 0u;
+  m_file_opens_per_epoch.clear();
 }
 
 void data_reader_jag_conduit::setup(int num_io_threads, std::shared_ptr<thread_pool> io_thread_pool) {
@@ -493,11 +512,11 @@ void data_reader_jag_conduit::set_scalar_choices(const std::vector<std::string>&
 }
 
 void data_reader_jag_conduit::set_all_scalar_choices() {
-  if (m_sample_list.empty()) {
+  if (m_first_local_sample >= m_sample_list.size()) {
     return;
   }
   conduit::Node n_scalar;
-  load_conduit_node(0, m_output_scalar_prefix, n_scalar);
+  load_conduit_node(m_first_local_sample, m_output_scalar_prefix, n_scalar);
   m_scalar_keys.reserve(n_scalar.number_of_children());
   const std::vector<std::string>& child_names = n_scalar.child_names();
   for (const auto& key: child_names) {
@@ -528,12 +547,12 @@ void data_reader_jag_conduit::set_all_input_choices() {
     return;
   }
 
-  if (m_sample_list.empty()) {
+  if (m_first_local_sample >= m_sample_list.size()) {
     return;
   }
 
   conduit::Node n_input;
-  load_conduit_node(0, "/inputs", n_input);
+  load_conduit_node(m_first_local_sample, "/inputs", n_input);
   m_input_keys.reserve(n_input.number_of_children());
   const std::vector<std::string>& child_names = n_input.child_names();
   for (const auto& key: child_names) {
@@ -560,11 +579,11 @@ void data_reader_jag_conduit::check_image_data() {
     return;
   }
 
-  if (m_sample_list.empty()) {
+  if (m_first_local_sample >= m_sample_list.size()) {
     return;
   }
 
-  size_t first_idx = (m_sample_list[0]).first;
+  const size_t first_idx = m_first_local_sample;
   if (!has_conduit_path(first_idx, "")) {
     LBANN_ERROR(_CN_ + ":: check_image_data() : no sample by " + m_sample_list[first_idx].second);
     return;
@@ -631,7 +650,7 @@ void data_reader_jag_conduit::check_scalar_keys() {
   if (!m_is_data_loaded) {
     return;
   }
-  if (m_sample_list.empty()) {
+  if (m_first_local_sample >= m_sample_list.size()) {
     //m_scalar_keys.clear();
     return;
   }
@@ -643,8 +662,7 @@ void data_reader_jag_conduit::check_scalar_keys() {
   std::set<std::string> keys_conduit;
 
   conduit::Node n_scalar;
-  size_t first_idx = (m_sample_list[0]).first;
-  load_conduit_node(first_idx, m_output_scalar_prefix, n_scalar);
+  load_conduit_node(m_first_local_sample, m_output_scalar_prefix, n_scalar);
   const std::vector<std::string>& child_names = n_scalar.child_names();
   for (const auto& key: child_names) {
     keys_conduit.insert(key);
@@ -697,7 +715,7 @@ void data_reader_jag_conduit::check_input_keys() {
   if (!m_is_data_loaded) {
     return;
   }
-  if (m_sample_list.empty()) {
+  if (m_first_local_sample >= m_sample_list.size()) {
     //m_input_keys.clear();
     return;
   }
@@ -709,8 +727,7 @@ void data_reader_jag_conduit::check_input_keys() {
   std::map<std::string, TypeID> keys_conduit;
 
   conduit::Node n_input;
-  size_t first_idx = (m_sample_list[0]).first;
-  load_conduit_node(first_idx, "/inputs", n_input);
+  load_conduit_node(m_first_local_sample, "/inputs", n_input);
   conduit::NodeConstIterator itr = n_input.children();
 
   while (itr.has_next()) {
@@ -787,17 +804,38 @@ void data_reader_jag_conduit::load() {
   /// The use of these flags need to be updated to properly separate
   /// how index lists are used between trainers and models
   /// @todo m_list_per_trainer || m_list_per_model
-  load_list_of_samples(sample_list_file, m_comm->get_procs_per_trainer(), m_comm->get_rank_in_trainer());
+  const bool shared_index = sample_list_index::is_index_file(sample_list_file);
+  m_first_local_sample = 0u;
+  std::vector<int> local_list_sizes(m_comm->get_procs_per_trainer());
+  if (shared_index) {
+    /// Every rank on a node looks samples up in one shared copy of the
+    /// index and each rank owns a contiguous slice of it
+    double tm1 = get_time();
+    m_sample_list.share_index(sample_list_file, *m_comm);
+    if (is_master()) {
+      std::cout << "Time to share sample list index: " << get_time() - tm1 << std::endl;
+    }
+    for (int r = 0; r < m_comm->get_procs_per_trainer(); ++r) {
+      size_t begin, end;
+      sample_list_index::get_slice(m_sample_list.size(), local_list_sizes.size(), r, begin, end);
+      local_list_sizes[r] = end - begin;
+      if (r == m_comm->get_rank_in_trainer()) {
+        m_first_local_sample = begin;
+      }
+    }
+  } else {
+    load_list_of_samples(sample_list_file, m_comm->get_procs_per_trainer(), m_comm->get_rank_in_trainer());
+  }
   if(is_master()) {
     std::cout << "Finished sample list, check data" << std::endl;
   }
 
   /// Check the data that each rank loaded
-  if (!m_is_data_loaded && !m_sample_list.empty()) {
+  if (!m_is_data_loaded && m_first_local_sample < m_sample_list.size()) {
     m_is_data_loaded = true;
 
     /// Open the first sample to make sure that all of the fields are correct
-    m_sample_list.open_samples_file_handle(0, true);
+    m_sample_list.open_samples_file_handle(m_first_local_sample, true);
 
     if (m_scalar_keys.size() == 0u) {
       set_all_scalar_choices(); // use all by default if none is specified
@@ -811,7 +849,7 @@ void data_reader_jag_conduit::load() {
 
     check_image_data();
 
-    m_sample_list.close_if_done_samples_file_handle(0);
+    m_sample_list.close_if_done_samples_file_handle(m_first_local_sample);
   }
   if(is_master()) {
     std::cout << "Done with data checking" << std::endl;
@@ -820,9 +858,10 @@ void data_reader_jag_conduit::load() {
 
   // need to resize and init shuffled indices here, since it's needed in
   // preload_data_store, which must be called before merging the sample lists
-  int sz = m_sample_list.size();
-  std::vector<int> local_list_sizes(m_comm->get_procs_per_trainer());
-  m_comm->trainer_all_gather(sz, local_list_sizes);
+  if (!shared_index) {
+    int sz = m_sample_list.size();
+    m_comm->trainer_all_gather(sz, local_list_sizes);
+  }
 
   if(is_master()) {
     std::cout << "We now have the proper size" << std::endl;
@@ -839,6 +878,12 @@ void data_reader_jag_conduit::load() {
     s << basename << "." << ext;
     m_sample_list.write(s.str());
   }
+  if (opts->has_string("write_sample_list_index") && m_comm->am_trainer_master()) {
+    const std::string index_file = opts->get_string("write_sample_list_index");
+    const std::string msg = " writing sample list index " + index_file;
+    log_msg(msg.c_str());
+    m_sample_list.write_index(index_file);
+  }
   m_shuffled_indices.resize(m_sample_list.size());
   std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
 
@@ -904,7 +949,11 @@ void data_reader_jag_conduit::preload_data_store() {
 void data_reader_jag_conduit::load_list_of_samples(const std::string sample_list_file, size_t stride, size_t offset) {
   // load the sample list
   double tm1 = get_time();
-  m_sample_list.load(sample_list_file, stride, offset);
+  if (sample_list_index::is_index_file(sample_list_file)) {
+    m_sample_list.load_index(sample_list_file, stride, offset);
+  } else {
+    m_sample_list.load(sample_list_file, stride, offset);
+  }
   double tm2 = get_time();
 
   if (is_master()) {
@@ -1189,30 +1238,34 @@ bool data_reader_jag_conduit::check_non_numeric(const std::string key) {
 }
 
 
+conduit::Node& data_reader_jag_conduit::get_conduit_leaf(const size_t sample_id, conduit::Node& sample, const std::string& conduit_field) const {
+  const std::string conduit_obj = '/' + LBANN_DATA_ID_STR(sample_id) + '/' + conduit_field;
+  if(sample[conduit_obj].schema().dtype().is_empty()) {
+    if (data_store_active()) {
+      LBANN_ERROR("Unable to find field " + conduit_obj
+                  + " in conduit node: " + std::to_string(sample_id));
+    }
+    conduit::Node n_leaf;
+    bool from_file = load_conduit_node(sample_id, conduit_field, n_leaf);
+    if (from_file) {
+      sample[conduit_obj].set(n_leaf);
+    } else {
+      sample = n_leaf;
+    }
+  }
+  return sample[conduit_obj];
+}
+
 std::vector< std::vector<DataType> >
 data_reader_jag_conduit::get_image_data(const size_t sample_id, conduit::Node& sample) const {
   std::vector< std::vector<DataType> > image_ptrs;
   image_ptrs.reserve(m_emi_image_keys.size());
 
   for (const auto& emi_tag : m_emi_image_keys) {
-    const std::string conduit_field = m_output_image_prefix + emi_tag;
-    const std::string conduit_obj = '/' + LBANN_DATA_ID_STR(sample_id) + '/' + conduit_field;
-    if(sample[conduit_obj].schema().dtype().is_empty()) {
-      if (data_store_active()) {
-        LBANN_ERROR("Unable to find field " + conduit_obj
-                    + " in conduit node: " + std::to_string(sample_id));
-      }
-      conduit::Node n_image;
-      bool from_file = load_conduit_node(sample_id, conduit_field, n_image);
-      if (from_file) {
-        sample[conduit_obj].set(n_image);
-      } else {
-        sample = n_image;
-      }
-    }
-    conduit_ch_t emi = sample[conduit_obj].value();
+    conduit::Node& n_image = get_conduit_leaf(sample_id, sample, m_output_image_prefix + emi_tag);
+    conduit_ch_t emi = n_image.value();
     const size_t num_vals = emi.number_of_elements();
-    const ch_t* emi_data = sample[conduit_obj].value();
+    const ch_t* emi_data = n_image.value();
     // Note that data will be cast from ch_t to DataType format
     image_ptrs.emplace_back(emi_data, emi_data + num_vals);
   }
@@ -1227,22 +1280,8 @@ std::vector<data_reader_jag_conduit::scalar_t> data_reader_jag_conduit::get_scal
   auto tr = m_scalar_normalization_params.cbegin();
 
   for(const auto key: m_scalar_keys) {
-    std::string conduit_field = m_output_scalar_prefix + key;
-    std::string conduit_obj = '/' + LBANN_DATA_ID_STR(sample_id) + '/' + conduit_field;
-    if(sample[conduit_obj].schema().dtype().is_empty()) {
-      if (data_store_active()) {
-        LBANN_ERROR("Unable to find field " + conduit_obj
-                    + " in conduit node: " + std::to_string(sample_id));
-      }
-      conduit::Node n_scalar;
-      bool from_file = load_conduit_node(sample_id, conduit_field, n_scalar);
-      if (from_file) {
-        sample[conduit_obj].set(n_scalar);
-      } else {
-        sample = n_scalar;
-      }
-    }
-    const scalar_t val_raw = static_cast<scalar_t>(sample[conduit_obj].to_value());
+    const conduit::Node& n_scalar = get_conduit_leaf(sample_id, sample, m_output_scalar_prefix + key);
+    const scalar_t val_raw = static_cast<scalar_t>(n_scalar.to_value());
     const scalar_t val = static_cast<scalar_t>(val_raw * tr->first + tr->second);
     scalars.push_back(val);
     tr ++;
@@ -1262,44 +1301,16 @@ std::vector<data_reader_jag_conduit::input_t> data_reader_jag_conduit::get_input
   if (m_uniform_input_type) {
     // avoid some overhead by taking advantage of the fact that all the variables are of the same type
     for(const auto key: m_input_keys) {
-      const std::string conduit_field = m_input_prefix + key;
-      const std::string conduit_obj = '/' + LBANN_DATA_ID_STR(sample_id) + '/' + conduit_field;
-      if(sample[conduit_obj].schema().dtype().is_empty()) {
-        if (data_store_active()) {
-          LBANN_ERROR("Unable to find field " + conduit_obj
-                      + " in conduit node: " + std::to_string(sample_id));
-        }
-        conduit::Node n_input;
-        bool from_file = load_conduit_node(sample_id, conduit_field, n_input);
-        if (from_file) {
-          sample[conduit_obj].set(n_input);
-        } else {
-          sample = n_input;
-        }
-      }
-      const input_t val_raw = static_cast<input_t>(sample[conduit_obj].value());
+      const conduit::Node& n_input = get_conduit_leaf(sample_id, sample, m_input_prefix + key);
+      const input_t val_raw = static_cast<input_t>(n_input.value());
       const input_t val = static_cast<input_t>(val_raw * tr->first + tr->second);
       inputs.push_back(val);
       tr ++;
     }
   } else {
     for(const auto key: m_input_keys) {
-      const std::string conduit_field = m_input_prefix + key;
-      const std::string conduit_obj = '/' + LBANN_DATA_ID_STR(sample_id) + '/' + conduit_field;
-      if(sample[conduit_obj].schema().dtype().is_empty()) {
-        if (data_store_active()) {
-          LBANN_ERROR("Unable to find field " + conduit_obj
-                      + " in conduit node: " + std::to_string(sample_id));
-        }
-        conduit::Node n_input;
-        bool from_file = load_conduit_node(sample_id, conduit_field, n_input);
-        if (from_file) {
-          sample[conduit_obj].set(n_input);
-        } else {
-          sample = n_input;
-        }
-      }
-      add_val(key, sample[conduit_obj], inputs); // more overhead but general
+      const conduit::Node& n_input = get_conduit_leaf(sample_id, sample, m_input_prefix + key);
+      add_val(key, n_input, inputs); // more overhead but general
       input_t& val = inputs.back();
       val = static_cast<input_t>(val * tr->first + tr->second);
       tr ++;
@@ -1309,6 +1320,38 @@ std::vector<data_reader_jag_conduit::input_t> data_reader_jag_conduit::get_input
   return inputs;
 }
 
+namespace {
+
+/** Repack an HWC image into CHW layout and normalize each channel.
+ *  This does the work of repack_HWC_to_CHW_layout followed by a
+ *  scale_and_translate per channel in a single pass, and the loops
+ *  vectorize for the common single-channel case.
+ */
+template <typename T>
+void repack_and_normalize_image(const T* __restrict__ src,
+                                size_t num_pixels,
+                                size_t num_channels,
+                                const DataType* scale,
+                                const DataType* bias,
+                                DataType* __restrict__ dst) {
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    const DataType s = scale[ch];
+    const DataType b = bias[ch];
+    DataType* __restrict__ dst_ch = dst + ch * num_pixels;
+    if (num_channels == 1) {
+      for (size_t i = 0; i < num_pixels; ++i) {
+        dst_ch[i] = s * static_cast<DataType>(src[i]) + b;
+      }
+    } else {
+      for (size_t i = 0; i < num_pixels; ++i) {
+        dst_ch[i] = s * static_cast<DataType>(src[i * num_channels + ch]) + b;
+      }
+    }
+  }
+}
+
+} // namespace
+
 std::vector<CPUMat>
 data_reader_jag_conduit::create_datum_views(CPUMat& X, const std::vector<size_t>& sizes, const int mb_idx) const {
   std::vector<CPUMat> X_v(sizes.size());
@@ -1329,47 +1372,73 @@ bool data_reader_jag_conduit::fetch(CPUMat& X, int data_id, conduit::Node& sampl
       const size_t num_images = get_num_img_srcs();
       const size_t num_channels = m_image_num_channels;
       const size_t image_size = get_linearized_image_size();
-      const std::vector<size_t> sizes(num_images, image_size);
-      std::vector<CPUMat> X_v = create_datum_views(X, sizes, mb_idx);
-      std::vector< std::vector<DataType> > img_data(get_image_data(data_id, sample));
+      const size_t num_pixels = m_image_height * m_image_width;
 
-      if (img_data.size() != num_images) {
+      if (m_emi_image_keys.size() != num_images) {
         LBANN_ERROR(_CN_ + ":: fetch() : the number of images is not as expected " \
-                    + std::to_string(img_data.size()) + "!=" + std::to_string(num_images));
+                    + std::to_string(m_emi_image_keys.size()) + "!=" + std::to_string(num_images));
       }
       if (!m_split_channels && m_image_num_channels != 1) {
         LBANN_ERROR(_CN_ + ":: fetch() : transform pipeline now requires single channel images: num_channels=" \
                     + std::to_string(m_image_num_channels) + " split_channel=" + std::to_string(m_split_channels));
       }
 
-      std::vector<size_t> dims = {num_channels, static_cast<size_t>(m_image_height), static_cast<size_t>(m_image_width)};
-      std::vector<size_t> ch_dims = {static_cast<size_t>(m_image_height), static_cast<size_t>(m_image_width)};
-      auto tll = lbann::transform::repack_HWC_to_CHW_layout();
+      std::vector<DataType> scale(num_channels), bias(num_channels);
+      for(size_t ch = 0; ch < num_channels; ch++) {
+        const auto& tr = m_image_normalization_params.at(ch);
+        scale[ch] = static_cast<float>(tr.first);
+        bias[ch] = static_cast<float>(tr.second);
+      }
 
+      // Read each image in place from its conduit leaf and write it
+      // straight into the mini-batch matrix
+      DataType* X_buf = X.Buffer(0, mb_idx);
       for(size_t i=0u; i < num_images; ++i) {
-        CPUMat img_mat = CPUMat(utils::get_linearized_size(dims), 1, img_data[i].data(), utils::get_linearized_size(dims));
-        utils::type_erased_matrix te_img(std::move(img_mat));
-        CPUMat tgt_mat = CPUMat(utils::get_linearized_size(dims), 1);
-        tll.apply(te_img, X_v[i], dims);
-        const std::vector<size_t> ch_sizes(num_channels, m_image_height * m_image_width);
-        std::vector<CPUMat> X_ch_v = create_datum_views(X_v[i], ch_sizes, mb_idx);
-        for(size_t ch = 0; ch < num_channels; ch++) {
-          const auto& tr = m_image_normalization_params.at(ch);
-          auto s = lbann::transform::scale_and_translate(tr.first, tr.second);
-          utils::type_erased_matrix te_img_plane(std::move(X_ch_v[ch]));
-          s.apply(te_img_plane, ch_dims);
+        conduit::Node& n_image = get_conduit_leaf(data_id, sample, m_output_image_prefix + m_emi_image_keys[i]);
+        if (static_cast<size_t>(n_image.dtype().number_of_elements()) < image_size) {
+          LBANN_ERROR(_CN_ + ":: fetch() : image " + m_emi_image_keys[i] + " has "
+                      + std::to_string(n_image.dtype().number_of_elements())
+                      + " entries, but expected " + std::to_string(image_size));
+        }
+        conduit::Node n_converted;
+        const ch_t* emi_data = nullptr;
+        if (n_image.dtype().is_float32() && n_image.dtype().is_compact()) {
+          emi_data = n_image.as_float32_ptr();
+        } else {
+          n_image.to_float32_array(n_converted);
+          emi_data = n_converted.as_float32_ptr();
         }
+        repack_and_normalize_image(emi_data, num_pixels, num_channels,
+                                   scale.data(), bias.data(),
+                                   X_buf + i * image_size);
       }
       break;
     }
     case JAG_Scalar: {
-      const std::vector<scalar_t> scalars(get_scalars(data_id, sample));
-      set_minibatch_item<scalar_t>(X, mb_idx, scalars.data(), get_linearized_scalar_size());
+      DataType* X_buf = X.Buffer(0, mb_idx);
+      auto tr = m_scalar_normalization_params.cbegin();
+      for(const auto& key: m_scalar_keys) {
+        const conduit::Node& n_scalar = get_conduit_leaf(data_id, sample, m_output_scalar_prefix + key);
+        const scalar_t val_raw = static_cast<scalar_t>(n_scalar.to_value());
+        *X_buf++ = static_cast<DataType>(val_raw * tr->first + tr->second);
+        tr ++;
+      }
       break;
     }
     case JAG_Input: {
-      const std::vector<input_t> inputs(get_inputs(data_id, sample));
-      set_minibatch_item<input_t>(X, mb_idx, inputs.data(), get_linearized_input_size());
+      if (m_uniform_input_type) {
+        DataType* X_buf = X.Buffer(0, mb_idx);
+        auto tr = m_input_normalization_params.cbegin();
+        for(const auto& key: m_input_keys) {
+          const conduit::Node& n_input = get_conduit_leaf(data_id, sample, m_input_prefix + key);
+          const input_t val_raw = static_cast<input_t>(n_input.value());
+          *X_buf++ = static_cast<DataType>(val_raw * tr->first + tr->second);
+          tr ++;
+        }
+      } else {
+        const std::vector<input_t> inputs(get_inputs(data_id, sample));
+        set_minibatch_item<input_t>(X, mb_idx, inputs.data(), get_linearized_input_size());
+      }
       break;
     }
     default: { // includes Undefined case
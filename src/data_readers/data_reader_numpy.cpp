@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_numpy.hpp"
+#include "lbann/utils/omp_pragma.hpp"
 #include <cstdio>
 #include <string>
 #include <unordered_set>
@@ -45,7 +46,9 @@ numpy_reader::numpy_reader(const numpy_reader& other) :
   m_num_labels(other.m_num_labels),
   m_has_labels(other.m_has_labels),
   m_has_responses(other.m_has_responses),
-  m_data(other.m_data) {}
+  m_data(other.m_data),
+  m_mmap(other.m_mmap),
+  m_mapped(other.m_mapped) {}
 
 numpy_reader& numpy_reader::operator=(const numpy_reader& other) {
   generic_data_reader::operator=(other);
@@ -55,6 +58,8 @@ numpy_reader& numpy_reader::operator=(const numpy_reader& other) {
   m_has_labels = other.m_has_labels;
   m_has_responses = other.m_has_responses;
   m_data = other.m_data;
+  m_mmap = other.m_mmap;
+  m_mapped = other.m_mapped;
   return *this;
 }
 
@@ -69,6 +74,11 @@ void numpy_reader::load() {
   }
   ifs.close();
 
+  if (m_mmap) {
+    load_mapped();
+    return;
+  }
+
   m_data = cnpy::npy_load(infile);
   m_num_samples = m_data.shape[0];
   m_num_features = std::accumulate(
@@ -100,10 +110,10 @@ void numpy_reader::load() {
     for (int i = 0; i < m_num_samples; ++i) {
       if (m_data.word_size == 4) {
         float *data = m_data.data<float>() + i*(m_num_features+1);
-        label_classes.insert((int) data[m_num_features+1]);
+        label_classes.insert((int) data[m_num_features]);
       } else if (m_data.word_size == 8) {
         double *data = m_data.data<double>() + i*(m_num_features+1);
-        label_classes.insert((int) data[m_num_features+1]);
+        label_classes.insert((int) data[m_num_features]);
       }
     }
     // Sanity checks.
@@ -130,7 +140,64 @@ void numpy_reader::load() {
   select_subset_of_data();
 }
 
+void numpy_reader::load_mapped() {
+  m_mapped.open_npy(get_data_filename());
+  m_num_samples = m_mapped.get_num_rows();
+  m_num_features = m_mapped.get_row_size();
+
+  // Don't currently support both labels and responses.
+  if (m_has_labels && m_has_responses) {
+    throw lbann_exception(
+      "numpy_reader: labels and responses not supported at same time");
+  }
+  if (m_has_labels || m_has_responses) {
+    // Last feature becomes the label or response.
+    m_num_features -= 1;
+  }
+
+  if (m_has_labels) {
+    // Determine number of label classes.
+    std::vector<int> labels(m_num_samples);
+    LBANN_OMP_PARALLEL_FOR
+    for (int i = 0; i < m_num_samples; ++i) {
+      labels[i] = (int) m_mapped.get_value(i, m_num_features);
+    }
+    std::unordered_set<int> label_classes(labels.begin(), labels.end());
+    // Sanity checks.
+    auto minmax = std::minmax_element(label_classes.begin(), label_classes.end());
+    if (*minmax.first != 0) {
+      throw lbann_exception(
+        "numpy_reader: classes are not indexed from 0");
+    }
+    if (*minmax.second != (int) label_classes.size() - 1) {
+      throw lbann_exception(
+        "numpy_reader: label classes are not contiguous");
+    }
+    m_num_labels = label_classes.size();
+    // The scan touched every row, but this reader only needs some.
+    m_mapped.evict();
+  }
+
+  // Reset indices.
+  m_shuffled_indices.clear();
+  m_shuffled_indices.resize(m_num_samples);
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  select_subset_of_data();
+}
+
+int numpy_reader::fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) {
+  // Read ahead this rank's rows of the next mini-batch
+  if (m_mapped.is_open()) {
+    m_mapped.prefetch_rows(get_next_mini_batch_indices());
+  }
+  return generic_data_reader::fetch_data(X, indices_fetched);
+}
+
 bool numpy_reader::fetch_datum(Mat& X, int data_id, int mb_idx) {
+  if (m_mapped.is_open()) {
+    m_mapped.copy_row(data_id, 0, m_num_features, X.Buffer(0, mb_idx));
+    return true;
+  }
   int features_size = m_num_features;
   if (m_has_labels || m_has_responses) {
     features_size += 1;
@@ -154,12 +221,14 @@ bool numpy_reader::fetch_label(Mat& Y, int data_id, int mb_idx) {
     throw lbann_exception("numpy_reader: do not have labels");
   }
   int label = 0;
-  if (m_data.word_size == 4) {
+  if (m_mapped.is_open()) {
+    label = (int) m_mapped.get_value(data_id, m_num_features);
+  } else if (m_data.word_size == 4) {
     float *data = m_data.data<float>() + data_id*(m_num_features+1);
-    label = (int) data[m_num_features+1];
+    label = (int) data[m_num_features];
   } else if (m_data.word_size == 8) {
     double *data = m_data.data<double>() + data_id*(m_num_features+1);
-    label = (int) data[m_num_features+1];
+    label = (int) data[m_num_features];
   }
   Y(label, mb_idx) = 1;
   return true;
@@ -170,12 +239,14 @@ bool numpy_reader::fetch_response(Mat& Y, int data_id, int mb_idx) {
     throw lbann_exception("numpy_reader: do not have responses");
   }
   auto response = DataType(0);
-  if (m_data.word_size == 4) {
+  if (m_mapped.is_open()) {
+    response = m_mapped.get_value(data_id, m_num_features);
+  } else if (m_data.word_size == 4) {
     float *data = m_data.data<float>() + data_id*(m_num_features+1);
-    response = (DataType) data[m_num_features+1];
+    response = (DataType) data[m_num_features];
   } else if (m_data.word_size == 8) {
     double *data = m_data.data<double>() + data_id*(m_num_features+1);
-    response = (DataType) data[m_num_features+1];
+    response = (DataType) data[m_num_features];
   }
   Y(0, mb_idx) = response;
   return true;
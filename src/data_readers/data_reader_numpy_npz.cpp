@@ -54,7 +54,11 @@ namespace lbann {
     m_data(other.m_data),
     m_labels(other.m_labels),
     m_responses(other.m_responses),
-    m_scaling_factor_int16(other.m_scaling_factor_int16) {}
+    m_scaling_factor_int16(other.m_scaling_factor_int16),
+    m_mmap(other.m_mmap),
+    m_mapped_data(other.m_mapped_data),
+    m_mapped_labels(other.m_mapped_labels),
+    m_mapped_responses(other.m_mapped_responses) {}
 
   numpy_npz_reader& numpy_npz_reader::operator=(const numpy_npz_reader& other) {
     generic_data_reader::operator=(other);
@@ -68,6 +72,10 @@ namespace lbann {
     m_labels = other.m_labels;
     m_responses = other.m_responses;
     m_scaling_factor_int16 = other.m_scaling_factor_int16;
+    m_mmap = other.m_mmap;
+    m_mapped_data = other.m_mapped_data;
+    m_mapped_labels = other.m_mapped_labels;
+    m_mapped_responses = other.m_mapped_responses;
     return *this;
   }
 
@@ -81,6 +89,10 @@ namespace lbann {
     }
     ifs.close();
 
+    if (m_mmap && load_mapped()) {
+      return;
+    }
+
     const cnpy::npz_t npz = cnpy::npz_load(infile);
 
     std::vector<std::tuple<const bool, const std::string, cnpy::NpyArray &> > npyLoadList;
@@ -160,7 +172,88 @@ namespace lbann {
     select_subset_of_data();
   }
 
+  bool numpy_npz_reader::load_mapped() {
+    const std::string infile = get_data_filename();
+    std::vector<std::tuple<const bool, const std::string, mapped_npy_array &> > mapList;
+    mapList.push_back(std::forward_as_tuple(true,            NPZ_KEY_DATA,      m_mapped_data));
+    mapList.push_back(std::forward_as_tuple(m_has_labels,    NPZ_KEY_LABELS,    m_mapped_labels));
+    mapList.push_back(std::forward_as_tuple(m_has_responses, NPZ_KEY_RESPONSES, m_mapped_responses));
+    for(const auto& map : mapList) {
+      mapped_npy_array &ary = std::get<2>(map);
+      if(std::get<0>(map) && !ary.open_npz(infile, std::get<1>(map))) {
+        // Fall back to loading the whole file with cnpy.
+        m_mapped_data.close();
+        m_mapped_labels.close();
+        m_mapped_responses.close();
+        return false;
+      }
+    }
+
+    // Check whether the labels/responses has the same number of samples.
+    m_num_samples = m_mapped_data.get_num_rows();
+    for(const auto& map : mapList) {
+      const mapped_npy_array &ary = std::get<2>(map);
+      if(ary.is_open() && (int) ary.get_num_rows() != m_num_samples) {
+        throw lbann_exception(std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
+                              " numpy_npz_reader::load() - the number of samples of data and " + std::get<1>(map) + " do not match : "
+                              + std::to_string(m_num_samples) + " vs. " + std::to_string(ary.get_num_rows()));
+      }
+    }
+    m_num_features = m_mapped_data.get_row_size();
+    if(m_has_responses) {
+      m_num_response_features = m_mapped_responses.get_row_size();
+    }
+
+    if (m_has_labels) {
+      // Determine number of label classes.
+      if (m_mapped_labels.get_type() != 'i' || m_mapped_labels.get_word_size() != 4) {
+        throw lbann_exception("numpy_npz_reader: label numpy array should be in int32");
+      }
+      std::vector<DataType> labels(m_num_samples);
+      for (int i = 0; i < m_num_samples; ++i) {
+        m_mapped_labels.copy_row(i, 0, 1, &labels[i]);
+      }
+      std::unordered_set<int> label_classes(labels.begin(), labels.end());
+
+      // Sanity checks.
+      auto minmax = std::minmax_element(label_classes.begin(), label_classes.end());
+      if (*minmax.first != 0) {
+        throw lbann_exception("numpy_reader: classes are not indexed from 0");
+      }
+      if (*minmax.second != (int) label_classes.size() - 1) {
+        throw lbann_exception("numpy_reader: label classes are not contiguous");
+      }
+      m_num_labels = label_classes.size();
+    }
+
+    // Reset indices.
+    m_shuffled_indices.clear();
+    m_shuffled_indices.resize(m_num_samples);
+    std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+    select_subset_of_data();
+    return true;
+  }
+
+  int numpy_npz_reader::fetch_data(CPUMat& X, El::Matrix<El::Int>& indices_fetched) {
+    // Read ahead this rank's rows of the next mini-batch
+    if (m_mapped_data.is_open()) {
+      const auto indices = get_next_mini_batch_indices();
+      m_mapped_data.prefetch_rows(indices);
+      m_mapped_labels.prefetch_rows(indices);
+      m_mapped_responses.prefetch_rows(indices);
+    }
+    return generic_data_reader::fetch_data(X, indices_fetched);
+  }
+
   bool numpy_npz_reader::fetch_datum(Mat& X, int data_id, int mb_idx) {
+    if (m_mapped_data.is_open()) {
+      // Only int16 data is scaled, as with cnpy arrays.
+      const bool is_int16 = (m_mapped_data.get_type() == 'i'
+                             && m_mapped_data.get_word_size() == 2);
+      m_mapped_data.copy_row(data_id, 0, m_num_features, X.Buffer(0, mb_idx),
+                             is_int16 ? m_scaling_factor_int16 : DataType(1));
+      return true;
+    }
     Mat X_v = El::View(X, El::IR(0, X.Height()), El::IR(mb_idx, mb_idx+1));
 
     if (m_data.word_size == 2) {
@@ -189,7 +282,9 @@ namespace lbann {
     if (!m_has_labels) {
       throw lbann_exception("numpy_npz_reader: do not have labels");
     }
-    const int label = m_labels.data<int>()[data_id];
+    const int label = (m_mapped_labels.is_open() ?
+                       (int) m_mapped_labels.get_value(data_id, 0) :
+                       m_labels.data<int>()[data_id]);
     Y(label, mb_idx) = 1;
     return true;
   }
@@ -198,6 +293,11 @@ namespace lbann {
     if (!m_has_responses) {
       throw lbann_exception("numpy_npz_reader: do not have responses");
     }
+    if (m_mapped_responses.is_open()) {
+      m_mapped_responses.copy_row(data_id, 0, m_num_response_features,
+                                  Y.Buffer(0, mb_idx));
+      return true;
+    }
     void *responses = NULL;
     if (m_responses.word_size == 4) {
       responses = (void *) (m_responses.data<float>()
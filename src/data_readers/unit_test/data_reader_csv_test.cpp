@@ -0,0 +1,38 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/data_readers/data_reader_csv.hpp>
+
+TEST_CASE("Testing CSV data columns", "[data_reader][csv]") {
+  using lbann::csv_reader;
+
+  SECTION("Label in last column") {
+    CHECK(csv_reader::get_num_data_cols(10, 0, 9, -1) == 9);
+    CHECK(csv_reader::get_num_data_cols(10, 2, 9, -1) == 7);
+  }
+
+  SECTION("Responses only") {
+    CHECK(csv_reader::get_num_data_cols(10, 0, -1, 9) == 9);
+    CHECK(csv_reader::get_num_data_cols(10, 1, -1, 0) == 9);
+  }
+
+  SECTION("Label and response in different columns") {
+    CHECK(csv_reader::get_num_data_cols(10, 0, 0, 9) == 8);
+    CHECK(csv_reader::get_num_data_cols(10, 1, 3, 5) == 7);
+  }
+
+  SECTION("Label and response in the same column") {
+    CHECK(csv_reader::get_num_data_cols(10, 0, 9, 9) == 9);
+  }
+
+  SECTION("No labels or responses") {
+    CHECK(csv_reader::get_num_data_cols(10, 0, -1, -1) == 10);
+    CHECK(csv_reader::get_num_data_cols(10, 3, -1, -1) == 7);
+  }
+
+  SECTION("Label within skipped columns") {
+    CHECK(csv_reader::get_num_data_cols(10, 2, 1, -1) == 8);
+  }
+
+}
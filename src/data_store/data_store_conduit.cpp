@@ -31,10 +31,47 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/timer.hpp"
+#include <cstring>
 #include <unordered_set>
+#ifdef LBANN_GNU_LINUX
+#include <malloc.h>
+#endif // LBANN_GNU_LINUX
 
 namespace lbann {
 
+namespace {
+
+/** Bytes copied into node-shared memory between heap trims. */
+constexpr size_t node_local_release_chunk_size = 64 * 1024 * 1024;
+
+/** Return freed heap pages to the system. */
+void release_free_heap_pages() {
+#ifdef LBANN_GNU_LINUX
+  malloc_trim(0);
+#endif // LBANN_GNU_LINUX
+}
+
+/** Point node at the data of a sample packed by build_node_for_sending. */
+void set_external_from_packed(const conduit::uint8 *buf, conduit::Node &node) {
+  conduit::uint8 *n_buff_ptr = const_cast<conduit::uint8*>(buf);
+  conduit::Node n_msg;
+  n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
+  n_buff_ptr +=8;
+  n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
+  conduit::Schema rcv_schema;
+  conduit::Generator gen(n_msg["schema"].as_char8_str());
+  gen.walk(rcv_schema);
+  n_buff_ptr += n_msg["schema"].total_bytes_compact();
+  node.set_external(rcv_schema, n_buff_ptr);
+}
+
+/** Round a size in bytes up to a multiple of 8. */
+size_t pad_to_word(size_t n) {
+  return (n + 7) / 8 * 8;
+}
+
+} // namespace
+
 data_store_conduit::data_store_conduit(
   generic_data_reader *reader) :
   m_n(0),
@@ -47,7 +84,8 @@ data_store_conduit::data_store_conduit(
   m_compacted_sample_size(0),
   m_is_local_cache(false), 
   m_node_sizes_vary(false),
-  m_have_sample_sizes(false) {
+  m_have_sample_sizes(false),
+  m_node_local(false) {
   m_comm = m_reader->get_comm();
   if (m_comm == nullptr) {
     LBANN_ERROR(" m_comm is nullptr");
@@ -72,9 +110,16 @@ data_store_conduit::data_store_conduit(
     LBANN_ERROR("you cannot use both of these options: --data_store_cache --preload_data_store");
   }
 
+  m_node_local = opts->get_bool("node_local_data_store");
+  if (m_node_local && (!opts->get_bool("preload_data_store") || m_super_node)) {
+    LBANN_ERROR("--node_local_data_store requires --preload_data_store and cannot be used with --super_node");
+  }
+
   if (m_world_master) {
     if (m_is_local_cache) {
       std::cout << "data_store_conduit is running in local_cache mode\n";
+    } else if (m_node_local) {
+      std::cout << "data_store_conduit is running in node_local mode\n";
     } else if (m_super_node) {
       std::cout << "data_store_conduit is running in super_node mode\n";
     } else {
@@ -133,6 +178,11 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs, const std::
   m_is_local_cache = rhs.m_is_local_cache;
   m_node_sizes_vary = rhs.m_node_sizes_vary;
   m_sample_sizes = rhs.m_sample_sizes;
+  m_have_sample_sizes = rhs.m_have_sample_sizes;
+  m_node_local = rhs.m_node_local;
+  m_node_local_buffer = rhs.m_node_local_buffer;
+  m_node_local_data = rhs.m_node_local_data;
+  m_is_rank_node_local = rhs.m_is_rank_node_local;
 
   /// This block needed when carving a validation set from the training set
   if (options::get()->get_bool("debug") && !m_output) {
@@ -531,6 +581,12 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
     LBANN_ERROR("setup(mb_size) has not been called");
   }
 
+  /// move the preloaded samples into node-shared memory before the
+  /// first exchange
+  if (m_node_local && m_node_local_buffer == nullptr) {
+    build_node_local_store();
+  }
+
   /// exchange sample sizes if they are non-uniform (imagenet);
   /// this will only be called once, during the first call to 
   /// exchange_data_by_sample at the beginning of the 2nd epoch,
@@ -635,22 +691,92 @@ void data_store_conduit::exchange_data_by_sample(size_t current_pos, size_t mb_s
   //========================================================================
   //part 3: construct the Nodes needed by me for the current minibatch
 
-  conduit::Node nd;
   m_minibatch_data.clear();
   for (size_t j=0; j < m_recv_buffer.size(); j++) {
-    conduit::uint8 *n_buff_ptr = (conduit::uint8*)m_recv_buffer[j].data_ptr();
-    conduit::Node n_msg;
-    n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
-    n_buff_ptr +=8;
-    n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
-    conduit::Schema rcv_schema;
-    conduit::Generator gen(n_msg["schema"].as_char8_str());
-    gen.walk(rcv_schema);
-    n_buff_ptr += n_msg["schema"].total_bytes_compact();
-    n_msg["data"].set_external(rcv_schema,n_buff_ptr);
-
+    const conduit::uint8 *n_buff_ptr = (const conduit::uint8*)m_recv_buffer[j].data_ptr();
     int data_id = m_recv_data_ids[j];
-    m_minibatch_data[data_id].set_external(n_msg["data"]);
+    set_external_from_packed(n_buff_ptr, m_minibatch_data[data_id]);
+  }
+
+  // samples owned by ranks on this node are read in place
+  if (m_node_local) {
+    for (int i = current_pos; i < (int)(current_pos + mb_size); ++i) {
+      auto index = (*m_shuffled_indices)[i];
+      if ((i % m_owner_map_mb_size) % m_np_in_trainer == m_rank_in_trainer
+          && is_node_local(m_owner[index])) {
+        std::unordered_map<int, const conduit::uint8*>::const_iterator t = m_node_local_data.find(index);
+        if (t == m_node_local_data.end()) {
+          LBANN_ERROR("failed to find data_id: " + std::to_string(index) + " in the node-local data store");
+        }
+        set_external_from_packed(t->second, m_minibatch_data[index]);
+      }
+    }
+  }
+}
+
+void data_store_conduit::build_node_local_store() {
+  double tm1 = get_time();
+  m_is_rank_node_local.resize(m_np_in_trainer);
+  for (int p=0; p<m_np_in_trainer; p++) {
+    m_is_rank_node_local[p] = m_comm->is_rank_node_local(p, m_comm->get_trainer_comm());
+  }
+
+  // my segment holds the number of samples, a (data_id, size) pair for
+  // each sample, and then the packed samples on 8-byte boundaries
+  const size_t dir_size = sizeof(int64_t) * (1 + 2 * m_data.size());
+  size_t segment_size = dir_size;
+  for (const auto &t : m_data) {
+    segment_size += pad_to_word(t.second.total_bytes_compact());
+  }
+  m_node_local_buffer = std::make_shared<node_shared_buffer>();
+  m_node_local_buffer->allocate_segments(m_comm->get_trainer_comm(), segment_size);
+
+  // copy my samples into shared memory, freeing each private copy
+  // once it is copied
+  // Note: Samples are small heap allocations, so the freed pages are
+  // handed back to the system every chunk. Otherwise the rank would
+  // hold its samples twice until the end of the copy.
+  char *segment = m_node_local_buffer->segment(m_node_local_buffer->get_rank_in_node());
+  int64_t *dir = reinterpret_cast<int64_t*>(segment);
+  char *out = segment + dir_size;
+  dir[0] = m_data.size();
+  size_t j = 1;
+  size_t bytes_since_release = 0;
+  for (auto &t : m_data) {
+    const size_t sz = t.second.total_bytes_compact();
+    dir[j++] = t.first;
+    dir[j++] = sz;
+    std::memcpy(out, t.second.data_ptr(), sz);
+    // set_external releases the node's own buffer
+    conduit::Schema schema = t.second.schema();
+    t.second.set_external(schema, out);
+    out += pad_to_word(sz);
+    bytes_since_release += sz;
+    if (bytes_since_release >= node_local_release_chunk_size) {
+      release_free_heap_pages();
+      bytes_since_release = 0;
+    }
+  }
+  release_free_heap_pages();
+  m_node_local_buffer->barrier();
+
+  // index the samples of every rank on this node
+  m_node_local_data.clear();
+  for (int r = 0; r < m_node_local_buffer->get_procs_in_node(); ++r) {
+    const char *seg = m_node_local_buffer->segment(r);
+    const int64_t *seg_dir = reinterpret_cast<const int64_t*>(seg);
+    const int64_t count = seg_dir[0];
+    const conduit::uint8 *in = reinterpret_cast<const conduit::uint8*>(seg) + sizeof(int64_t) * (1 + 2 * count);
+    for (int64_t k = 0; k < count; ++k) {
+      m_node_local_data[seg_dir[1 + 2*k]] = in;
+      in += pad_to_word(seg_dir[2 + 2*k]);
+    }
+  }
+
+  if (m_world_master) {
+    std::cout << "TIME for data_store_conduit node-local store: " << get_time() - tm1
+              << "; samples on node: " << m_node_local_data.size()
+              << "; bytes on node: " << m_node_local_buffer->size() << "\n";
   }
 }
 
@@ -662,6 +788,9 @@ int data_store_conduit::build_indices_i_will_recv(int current_pos, int mb_size)
     auto index = (*m_shuffled_indices)[i];
     if ((i % m_owner_map_mb_size) % m_np_in_trainer == m_rank_in_trainer) {
       int owner = m_owner[index];
+      if (is_node_local(owner)) {
+        continue;
+      }
       m_indices_to_recv[owner].insert(index);
       k++;
     }
@@ -680,7 +809,11 @@ int data_store_conduit::build_indices_i_will_send(int current_pos, int mb_size)
     auto index = (*m_shuffled_indices)[i];
     /// If this rank owns the index send it to the (i%m_np)'th rank
     if (m_data.find(index) != m_data.end()) {
-      m_indices_to_send[(i % m_owner_map_mb_size) % m_np_in_trainer].insert(index);
+      const int dest = (i % m_owner_map_mb_size) % m_np_in_trainer;
+      if (is_node_local(dest)) {
+        continue;
+      }
+      m_indices_to_send[dest].insert(index);
 
       // Sanity check
       if (m_owner[index] != m_rank_in_trainer) {
@@ -169,6 +169,11 @@ int lbann::partitioned_io_buffer::num_samples_ready(execution_mode mode) {
   return buf->m_num_samples_fetched;
 }
 
+void lbann::partitioned_io_buffer::discard_fetched_data(execution_mode mode) {
+  data_buffer *buf = get_data_buffer(mode);
+  buf->m_num_samples_fetched = 0;
+}
+
 void lbann::partitioned_io_buffer::set_data_fetch_future(std::future<void> future, execution_mode mode) {
   data_buffer *buf = get_data_buffer(mode);
   buf->m_data_fetch_future = std::move(future);
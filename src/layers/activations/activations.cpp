@@ -26,6 +26,7 @@
 
 #include "lbann/layers/activations/activations.hpp"
 #include "lbann/utils/entrywise_operator.hpp"
+#include "lbann/utils/simd_math.hpp"
 
 namespace lbann {
 
@@ -56,6 +57,19 @@ struct log_sigmoid_op {
   inline DataType operator()(const DataType& x, const DataType& dy) const {
     return dy / (one + std::exp(x));
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    // log_sigmoid(x) = -softplus(-x)
+    for (El::Int i = 0; i < size; ++i) { y[i] = -x[i]; }
+    vector_softplus(y, y, size);
+    for (El::Int i = 0; i < size; ++i) { y[i] = -y[i]; }
+  }
+  inline void apply_vector(const DataType* x, const DataType* dy,
+                           DataType* dx, El::Int size) const {
+    DataType y[entrywise_block_size];
+    for (El::Int i = 0; i < size; ++i) { y[i] = -x[i]; }
+    vector_sigmoid(y, y, size);
+    for (El::Int i = 0; i < size; ++i) { dx[i] = dy[i] * y[i]; }
+  }
 };
 
 /** ReLU operator. */
@@ -102,6 +116,25 @@ struct sigmoid_op {
 #endif // LBANN_ENABLE_SIGMOID_CUTOFF
     return dy * y * (one - y);
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    vector_sigmoid(x, y, size);
+#ifdef LBANN_ENABLE_SIGMOID_CUTOFF
+    for (El::Int i = 0; i < size; ++i) {
+      y[i] = std::min(std::max(y[i], eps), one - eps);
+    }
+#endif // LBANN_ENABLE_SIGMOID_CUTOFF
+  }
+  inline void apply_vector(const DataType* x, const DataType* dy,
+                           DataType* dx, El::Int size) const {
+    DataType y[entrywise_block_size];
+    vector_sigmoid(x, y, size);
+    for (El::Int i = 0; i < size; ++i) {
+#ifdef LBANN_ENABLE_SIGMOID_CUTOFF
+      if (y[i] <= eps || y[i] >= one - eps) { dx[i] = zero; continue; }
+#endif // LBANN_ENABLE_SIGMOID_CUTOFF
+      dx[i] = dy[i] * y[i] * (one - y[i]);
+    }
+  }
 };
 
 /** Softplus operator. */
@@ -116,6 +149,15 @@ struct softplus_op {
   inline DataType operator()(const DataType& x, const DataType& dy) const {
     return dy / (one + std::exp(-x));
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    vector_softplus(x, y, size);
+  }
+  inline void apply_vector(const DataType* x, const DataType* dy,
+                           DataType* dx, El::Int size) const {
+    DataType y[entrywise_block_size];
+    vector_sigmoid(x, y, size);
+    for (El::Int i = 0; i < size; ++i) { dx[i] = dy[i] * y[i]; }
+  }
 };
 
 /** Softsign operator. */
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/activations/softmax.hpp"
+#include "lbann/utils/online_softmax.hpp"
 
 namespace lbann {
 
@@ -49,43 +50,33 @@ void fp(lbann_comm& comm,
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
 
-  // Find column-wise maximum entries
-  El::Fill(workspace, std::numeric_limits<DataType>::lowest());
+  // Compute column-wise maximum entries and normalizers in a
+  // single pass and combine them with a single allreduce
+  // Note: Workspace column holds (max, sum) pairs.
+  if (local_width > 1 && local_workspace.LDim() != 2) {
+    LBANN_ERROR("softmax workspace is not contiguous");
+  }
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    auto& max_entry = local_workspace(0, col);
-    for (El::Int row = 0; row < local_height; ++row) {
-      max_entry = std::max(max_entry, local_input(row, col));
-    }
+    online_softmax_stats(local_input.LockedBuffer(0, col),
+                         local_height,
+                         local_workspace(0, col),
+                         local_workspace(1, col));
   }
-  comm.allreduce(workspace, workspace.RedundantComm(), El::mpi::MAX);
+  comm.allreduce_softmax_stats(local_workspace, workspace.RedundantComm());
 
-  // Exponentiate outputs and compute column sums
+  // Compute outputs
   // Note: Subtracting by the column max prevents output from blowing
-  // up. Large negative values underflow to 0.
+  // up. Large negative values underflow to 0. Small values can be
+  // rounded to minimum output value to avoid denormalized floats.
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto shift = local_workspace(0, col);
-    DataType sum = 0;
+    const auto& shift = local_workspace(0, col);
+    const auto& scale = 1 / local_workspace(1, col);
     for (El::Int row = 0; row < local_height; ++row) {
       const auto& x = local_input(row, col);
       auto& y = local_output(row, col);
-      y = std::exp(x - shift);
-      sum += y;
-    }
-    local_workspace(0, col) = sum;
-  }
-  comm.allreduce(workspace, workspace.RedundantComm());
-
-  // Divide outputs by column sums
-  // Note: Small values can be rounded to minimum output value to
-  // avoid denormalized floats.
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    const auto& scale = 1 / local_workspace(0, col);
-    for (El::Int row = 0; row < local_height; ++row) {
-      auto& y = local_output(row, col);
-      y = std::max(scale * y, min_output);
+      y = std::max(scale * std::exp(x - shift), min_output);
     }
   }
 
@@ -106,22 +97,28 @@ void bp(lbann_comm& comm,
   const auto& local_width = local_output.Width();
 
   // Compute dot products between output and gradient w.r.t. output
-  El::Zero(local_workspace);
+  // Note: Dot products are packed contiguously at the start of the
+  // workspace so that only one row is reduced.
+  if (local_width > 1 && local_workspace.LDim() != 2) {
+    LBANN_ERROR("softmax workspace is not contiguous");
+  }
+  CPUMat local_dots(1, local_width, local_workspace.Buffer(), 1);
+  El::Zero(local_dots);
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    auto& y_dot_dy = local_workspace(0, col);
+    auto& y_dot_dy = local_dots(0, col);
     for (El::Int row = 0; row < local_height; ++row) {
       const auto& y = local_output(row, col);
       const auto& dy = local_gradient_wrt_output(row, col);
       y_dot_dy += y * dy;
     }
   }
-  comm.allreduce(workspace, workspace.RedundantComm());
+  comm.allreduce(local_dots, workspace.RedundantComm());
 
   // Compute gradient w.r.t. input
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto& y_dot_dy = local_workspace(0, col);
+    const auto& y_dot_dy = local_dots(0, col);
     for (El::Int row = 0; row < local_height; ++row) {
       const auto& y = local_output(row, col);
       const auto& dy = local_gradient_wrt_output(row, col);
@@ -29,6 +29,9 @@
 #include "lbann/models/model.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
+#include "lbann/utils/autotune.hpp"
+#include "lbann/utils/numa.hpp"
+#include "lbann/utils/options.hpp"
 #include <string>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -65,6 +68,7 @@ Layer::Layer(const Layer& other) :
   m_expected_num_child_layers(other.m_expected_num_child_layers),
   m_model(other.m_model),
   m_frozen(other.m_frozen),
+  m_num_threads(other.m_num_threads),
   m_fp_time(other.m_fp_time),
   m_fp_compute_time(other.m_fp_compute_time),
   m_bp_time(other.m_bp_time),
@@ -105,6 +109,7 @@ Layer& Layer::operator=(const Layer& other) {
   m_expected_num_child_layers = other.m_expected_num_child_layers;
   m_model = other.m_model;
   m_frozen = other.m_frozen;
+  m_num_threads = other.m_num_threads;
   m_fp_time = other.m_fp_time;
   m_fp_compute_time = other.m_fp_compute_time;
   m_bp_time = other.m_bp_time;
@@ -246,12 +251,20 @@ description Layer::get_description() const {
 }
 
 void Layer::forward_prop() {
-  const auto fp_start = get_time();
+  forward_prop_setup();
+  forward_prop_compute();
+}
 
-  // Setup tensors
+void Layer::forward_prop_setup() {
+  const auto fp_start = get_time();
   const auto& mini_batch_size = m_model->get_current_mini_batch_size();
   fp_setup_inputs(mini_batch_size);
   fp_setup_outputs(mini_batch_size);
+  m_fp_time += get_time() - fp_start;
+}
+
+void Layer::forward_prop_compute() {
+  const auto fp_start = get_time();
 
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
@@ -260,7 +273,11 @@ void Layer::forward_prop() {
 
   // Apply layer's compute function
   const auto fp_compute_start = get_time();
-  fp_compute();
+  {
+    omp_num_threads_guard threads_guard(std::min(m_num_threads,
+                                                 omp_get_max_threads()));
+    fp_compute();
+  }
   m_fp_compute_time += get_time() - fp_compute_start;
 
   // Add this layer as a gradient source for weight optimizers
@@ -278,12 +295,20 @@ void Layer::forward_prop() {
 }
 
 void Layer::back_prop() {
-  const auto bp_start = get_time();
+  back_prop_setup();
+  back_prop_compute();
+}
 
-  // Setup tensors
+void Layer::back_prop_setup() {
+  const auto bp_start = get_time();
   const auto& mini_batch_size = m_model->get_current_mini_batch_size();
   bp_setup_gradient_wrt_outputs(mini_batch_size);
   bp_setup_gradient_wrt_inputs(mini_batch_size);
+  m_bp_time += get_time() - bp_start;
+}
+
+void Layer::back_prop_compute() {
+  const auto bp_start = get_time();
 
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
@@ -292,7 +317,11 @@ void Layer::back_prop() {
 
   // Backprop the compute function.
   const auto bp_compute_start = get_time();
-  bp_compute();
+  {
+    omp_num_threads_guard threads_guard(std::min(m_num_threads,
+                                                 omp_get_max_threads()));
+    bp_compute();
+  }
   m_bp_compute_time += get_time() - bp_compute_start;
 
   // Remove this layer as a gradient source for weight optimizers
@@ -605,6 +634,123 @@ bool Layer::is_frozen() const {
   return m_frozen;
 }
 
+void Layer::autotune(autotune_cache& cache, int num_trials) {
+  const auto& algorithms = get_cpu_algorithms();
+  if (using_gpus() || algorithms.empty()) { return; }
+
+  // Look for cached choice
+  // Note: Ranks only skip tuning if they all have a cached choice, so
+  // that any communication in the compute function stays matched.
+  const int max_threads = omp_get_max_threads();
+  std::stringstream ss;
+  ss << get_autotune_key() << ";"
+     << "threads=" << max_threads << ";"
+     << "cpu=" << get_cpu_model_name();
+  const auto key = ss.str();
+  autotune_choice choice;
+  int cached = cache.find(key, choice) ? 1 : 0;
+  if (std::find(algorithms.begin(), algorithms.end(), choice.algorithm)
+      == algorithms.end()) {
+    cached = 0;
+  }
+  cached = m_comm->trainer_allreduce(cached, El::mpi::MIN);
+
+  if (!cached) {
+
+    // Setup synthetic mini-batch
+    // Note: Random number generators are not used so that tuning does
+    // not change the results of training.
+    const El::Int mini_batch_size = m_model->get_max_mini_batch_size();
+    for (int i = 0; i < get_num_parents(); ++i) {
+      auto& input = *m_inputs[i];
+      input.Empty();
+      input.Resize(get_input_size(i), mini_batch_size);
+      El::Fill(input, DataType(1));
+    }
+    fp_setup_outputs(mini_batch_size);
+
+    // Time forward prop with each algorithm and thread count
+    std::vector<autotune_choice> candidates;
+    for (const auto& algo : algorithms) {
+      for (const auto& num_threads : get_autotune_thread_counts(max_threads)) {
+        candidates.emplace_back();
+        candidates.back().algorithm = algo;
+        candidates.back().num_threads = num_threads;
+      }
+    }
+    std::vector<double> times(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      set_cpu_algorithm(candidates[i].algorithm);
+      omp_num_threads_guard threads_guard(candidates[i].num_threads);
+      fp_compute(); // Warm-up
+      const auto start = get_time();
+      for (int trial = 0; trial < num_trials; ++trial) {
+        fp_compute();
+      }
+      times[i] = get_time() - start;
+    }
+
+    // Choose fastest candidate on slowest rank
+    m_comm->allreduce(times.data(), times.size(),
+                      m_comm->get_trainer_comm(), El::mpi::MAX);
+    const auto& best = std::min_element(times.begin(), times.end());
+    choice = candidates[std::distance(times.begin(), best)];
+    cache.insert(key, choice);
+
+    // Free synthetic mini-batch
+    for (int i = 0; i < get_num_parents(); ++i) {
+      m_inputs[i]->Empty();
+    }
+
+  }
+
+  set_cpu_algorithm(choice.algorithm);
+  m_num_threads = (choice.num_threads == max_threads ?
+                   0 : choice.num_threads);
+
+}
+
+std::string Layer::get_autotune_key() const {
+  std::stringstream ss;
+  ss << get_type() << ";"
+     << get_data_layout_string(get_data_layout()) << ";";
+  ss << "inputs=";
+  for (int i = 0; i < get_num_parents(); ++i) {
+    const auto& dims = get_input_dims(i);
+    ss << (i > 0 ? "," : "");
+    for (size_t j = 0; j < dims.size(); ++j) {
+      ss << (j > 0 ? "x" : "") << dims[j];
+    }
+  }
+  ss << ";outputs=";
+  for (int i = 0; i < get_num_children(); ++i) {
+    const auto& dims = get_output_dims(i);
+    ss << (i > 0 ? "," : "");
+    for (size_t j = 0; j < dims.size(); ++j) {
+      ss << (j > 0 ? "x" : "") << dims[j];
+    }
+  }
+  ss << ";weights=";
+  for (size_t i = 0; i < m_weights.size(); ++i) {
+    const auto& dims = m_weights[i]->get_dims();
+    ss << (i > 0 ? "," : "");
+    for (size_t j = 0; j < dims.size(); ++j) {
+      ss << (j > 0 ? "x" : "") << dims[j];
+    }
+  }
+  ss << ";mini_batch_size=" << m_model->get_max_mini_batch_size()
+     << ";procs=" << m_comm->get_procs_per_trainer();
+  return ss.str();
+}
+
+void Layer::declare_workspace(size_t size) {
+  m_model->get_workspace().declare(size);
+}
+
+workspace_manager::buffer Layer::get_workspace(size_t size) {
+  return m_model->get_workspace().borrow(size);
+}
+
 void Layer::setup() {
   setup_pointers();
   setup_dims();
@@ -803,6 +949,17 @@ void Layer::setup_data() {
   // Initialize gradient w.r.t. input tensors
   bp_setup_gradient_wrt_inputs(mini_batch_size);
 
+  // Place CPU tensors near the threads that compute them
+  if (get_device_allocation() == El::Device::CPU
+      && options::get()->get_bool("numa_placement", false)) {
+    for (int i = 0; i < get_num_children(); ++i) {
+      first_touch(get_local_activations(i));
+    }
+    for (int i = 0; i < get_num_parents(); ++i) {
+      first_touch(get_local_error_signals(i));
+    }
+  }
+
 }
 
 void Layer::bp_compute() {
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/online_softmax.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace lbann {
+
+namespace {
+
+/** Number of entries processed per block in forward prop. */
+constexpr El::Int block_size = 64;
+
+void local_fp_cpu(const AbsMat& local_input,
+                  const AbsMat& local_ground_truth,
+                  AbsMat& local_statistics) {
+
+  // Useful constants
+  const DataType zero = DataType(0);
+  const El::Int local_height = local_input.Height();
+  const El::Int local_width = local_input.Width();
+
+  // Compute softmax statistics, dot(x, y_hat), and sum(y_hat) while
+  // reading each input entry once
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const auto* x = local_input.LockedBuffer(0, col);
+    const auto* xhat = local_ground_truth.LockedBuffer(0, col);
+    DataType max = std::numeric_limits<DataType>::lowest();
+    DataType sum = zero, dot = zero, sum_xhat = zero;
+    for (El::Int start = 0; start < local_height; start += block_size) {
+      const El::Int size = std::min(block_size, local_height - start);
+      DataType block_max, block_sum;
+      online_softmax_stats(&x[start], size, block_max, block_sum);
+      combine_softmax_stats(max, sum, block_max, block_sum);
+      for (El::Int i = start; i < start + size; ++i) {
+        dot += (xhat[i] != zero) ? xhat[i] * x[i] : zero;
+        sum_xhat += xhat[i];
+      }
+    }
+    local_statistics(0, col) = max;
+    local_statistics(1, col) = sum;
+    local_statistics(2, col) = dot;
+    local_statistics(3, col) = sum_xhat;
+  }
+
+}
+
+void allreduce_statistics_cpu(lbann_comm& comm,
+                              const El::mpi::Comm& c,
+                              AbsMat& local_statistics) {
+  if (local_statistics.Width() > 1
+      && local_statistics.Height() != local_statistics.LDim()) {
+    LBANN_ERROR("softmax cross entropy statistics are not contiguous");
+  }
+  comm.allreduce_softmax_stats(local_statistics, c);
+}
+
+void local_loss_cpu(const AbsMat& local_statistics,
+                    AbsMat& local_loss) {
+  const El::Int local_width = local_statistics.Width();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const auto& max = local_statistics(0, col);
+    const auto& sum = local_statistics(1, col);
+    const auto& dot = local_statistics(2, col);
+    const auto& sum_xhat = local_statistics(3, col);
+    local_loss(0, col) = sum_xhat * (max + std::log(sum)) - dot;
+  }
+}
+
+void local_bp_cpu(const AbsMat& local_input,
+                  const AbsMat& local_ground_truth,
+                  const AbsMat& local_statistics,
+                  const AbsMat& local_gradient_wrt_output,
+                  AbsMat& local_gradient_wrt_input,
+                  AbsMat& local_gradient_wrt_ground_truth) {
+
+  // Useful constants
+  const El::Int local_height = local_input.Height();
+  const El::Int local_width = local_input.Width();
+
+  // Compute gradients
+  // Note: dx = dy * (softmax(x) * sum(y_hat) - y_hat) and
+  // dy_hat = - dy * log(softmax(x))
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    const auto& max = local_statistics(0, col);
+    const auto& sum = local_statistics(1, col);
+    const auto& sum_xhat = local_statistics(3, col);
+    const auto& dy = local_gradient_wrt_output(0, col);
+    const auto log_sum = std::log(sum);
+    const auto scale = sum_xhat / sum;
+    for (El::Int row = 0; row < local_height; ++row) {
+      const auto& x = local_input(row, col);
+      const auto& xhat = local_ground_truth(row, col);
+      auto& dx = local_gradient_wrt_input(row, col);
+      auto& dxhat = local_gradient_wrt_ground_truth(row, col);
+      dx = dy * (scale * std::exp(x - max) - xhat);
+      dxhat = - dy * (x - max - log_sum);
+    }
+  }
+
+}
+
+} // namespace
+
+#define INSTANTIATE(layout)                                             \
+  template <>                                                           \
+  void softmax_cross_entropy_layer<layout, El::Device::CPU>             \
+       ::local_fp_compute(const AbsMat& local_input,                    \
+                          const AbsMat& local_ground_truth,             \
+                          AbsMat& local_statistics) {                   \
+    local_fp_cpu(local_input, local_ground_truth, local_statistics);    \
+  }                                                                     \
+  template <>                                                           \
+  void softmax_cross_entropy_layer<layout, El::Device::CPU>             \
+       ::allreduce_statistics(lbann_comm& comm,                         \
+                              const El::mpi::Comm& c,                   \
+                              AbsMat& local_statistics) {               \
+    allreduce_statistics_cpu(comm, c, local_statistics);                \
+  }                                                                     \
+  template <>                                                           \
+  void softmax_cross_entropy_layer<layout, El::Device::CPU>             \
+       ::local_loss_compute(const AbsMat& local_statistics,             \
+                            AbsMat& local_loss) {                       \
+    local_loss_cpu(local_statistics, local_loss);                       \
+  }                                                                     \
+  template <>                                                           \
+  void softmax_cross_entropy_layer<layout, El::Device::CPU>             \
+       ::local_bp_compute(const AbsMat& local_input,                    \
+                          const AbsMat& local_ground_truth,             \
+                          const AbsMat& local_statistics,               \
+                          const AbsMat& local_gradient_wrt_output,      \
+                          AbsMat& local_gradient_wrt_input,             \
+                          AbsMat& local_gradient_wrt_ground_truth) {    \
+    local_bp_cpu(local_input,                                           \
+                 local_ground_truth,                                    \
+                 local_statistics,                                      \
+                 local_gradient_wrt_output,                             \
+                 local_gradient_wrt_input,                              \
+                 local_gradient_wrt_ground_truth);                      \
+  }
+INSTANTIATE(data_layout::DATA_PARALLEL)
+INSTANTIATE(data_layout::MODEL_PARALLEL)
+#undef INSTANTIATE
+
+} // namespace lbann
@@ -25,43 +25,20 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/loss/top_k_categorical_accuracy.hpp"
+#include "lbann/utils/top_k.hpp"
 #include <algorithm>
-#include <limits>
-
 
 namespace lbann {
 
 namespace {
 
-/** Sparse vector entry. */
-struct entry {
-
-  /** Vector entry value. */
-  DataType value = min_value;
-  /** Vector entry index. */
-  El::Int index = max_index;
-
-  /** Minimum possible value. */
-  static constexpr DataType min_value = -std::numeric_limits<DataType>::infinity();
-  /** Maximum possible index. */
-  static constexpr El::Int max_index = std::numeric_limits<El::Int>::max();
-
-  /** Comparison operation to sort vector entries.
-   *  Entries are sorted by value in decreasing order, with ties
-   *  broken in favor of entries with smaller indices.
-   */
-  static bool compare(const entry& a, const entry& b) {
-    return a.value > b.value || (a.value == b.value && a.index < b.index);
-  }
-
-};
-
 /** CPU implementation of top-k categorical accuracy layer forward prop. */
 void fp_cpu(lbann_comm& comm,
             El::Int k,
             const AbsDistMat& predictions,
             const AbsDistMat& labels,
-            AbsDistMat& loss) {
+            AbsDistMat& loss,
+            workspace_manager::buffer& workspace) {
 
   // Local matrices
   const auto& local_predictions = predictions.LockedMatrix();
@@ -91,7 +68,8 @@ void fp_cpu(lbann_comm& comm,
   // Get label indices
   // Note: This may have race conditions if columns of labels matrix
   // are not one-hot vectors.
-  std::vector<El::Int> label_indices(local_width, height);
+  auto* label_indices = workspace.get<El::Int>();
+  std::fill(label_indices, label_indices + local_width, height);
   Al::request req;
   LBANN_OMP_PARALLEL_FOR_COLLAPSE2
   for (El::Int col = 0; col < local_width; ++col) {
@@ -101,56 +79,28 @@ void fp_cpu(lbann_comm& comm,
       }
     }
   }
-  comm.nb_allreduce(label_indices.data(),
-                    label_indices.size(),
+  comm.nb_allreduce(label_indices,
+                    local_width,
                     col_comm,
                     req,
                     El::mpi::MIN);
 
   // Find top-k entries in each column of local prediction matrix
-  std::vector<entry> top_entries(local_width * k);
+  auto* top_entries = workspace.get<top_k_entry>(
+    workspace_manager::align(local_width * sizeof(El::Int)));
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    std::vector<entry> local_entries(std::max(local_height, k));
-    for (El::Int row = 0; row < local_height; ++row) {
-      local_entries[row].value = local_predictions(row, col);
-      local_entries[row].index = predictions.GlobalRow(row);
-    }
-    std::partial_sort_copy(local_entries.begin(),
-                           local_entries.end(),
-                           &top_entries[col*k],
-                           &top_entries[col*k] + k,
-                           entry::compare);
+    select_top_k(local_predictions.LockedBuffer(0, col),
+                 local_height,
+                 k,
+                 predictions.ColShift(),
+                 predictions.ColStride(),
+                 &top_entries[col*k]);
   }
 
   // Find top-k entries in each column of global prediction matrix
   if (col_comm_size > 1) {
-    if (col_comm_rank != col_comm_root) {
-      comm.gather(reinterpret_cast<El::byte*>(top_entries.data()),
-                  top_entries.size() * sizeof(entry),
-                  col_comm_root,
-                  col_comm, El::SyncInfo<El::Device::CPU>{});
-    } else {
-      std::vector<entry> global_top_entries(col_comm_size * local_width * k);
-      comm.gather(reinterpret_cast<El::byte*>(top_entries.data()),
-                  top_entries.size() * sizeof(entry),
-                  reinterpret_cast<El::byte*>(global_top_entries.data()),
-                  col_comm, El::SyncInfo<El::Device::CPU>{});
-      LBANN_OMP_PARALLEL_FOR
-      for (El::Int col = 0; col < local_width; ++col) {
-        std::vector<entry> col_entries(col_comm_size * k);
-        for (El::Int rank = 0; rank < col_comm_size; ++rank) {
-          const auto* start = &global_top_entries[rank*local_width*k+col*k];
-          std::copy(start, start + k, &col_entries[rank*k]);
-        }
-        std::partial_sort_copy(col_entries.begin(),
-                               col_entries.end(),
-                               &top_entries[col*k],
-                               &top_entries[col*k] + k,
-                               entry::compare);
-      }
-    }
-
+    reduce_top_k(comm, col_comm, k, local_width, top_entries, col_comm_root);
   }
 
   // Compute categorical accuracy
@@ -176,20 +126,26 @@ void fp_cpu(lbann_comm& comm,
 template <>
 void top_k_categorical_accuracy_layer<data_layout::MODEL_PARALLEL, El::Device::CPU>
      ::fp_compute() {
+  auto workspace = get_workspace(
+    get_workspace_size(get_local_prev_activations(0).Width()));
   fp_cpu(*get_comm(),
          m_k,
          get_prev_activations(0),
          get_prev_activations(1),
-         get_activations());
+         get_activations(),
+         workspace);
 }
 template <>
 void top_k_categorical_accuracy_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
      ::fp_compute() {
+  auto workspace = get_workspace(
+    get_workspace_size(get_local_prev_activations(0).Width()));
   fp_cpu(*get_comm(),
          m_k,
          get_prev_activations(0),
          get_prev_activations(1),
-         get_activations());
+         get_activations(),
+         workspace);
 }
 
 } // namespace lbann
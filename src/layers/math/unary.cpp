@@ -26,6 +26,7 @@
 
 #include "lbann/layers/math/unary.hpp"
 #include "lbann/utils/entrywise_operator.hpp"
+#include "lbann/utils/simd_math.hpp"
 
 namespace lbann {
 
@@ -186,6 +187,17 @@ struct exp_op {
   inline DataType operator()(const DataType& x, const DataType& dy) const {
     return dy * std::exp(x);
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    vector_exp(x, y, size);
+  }
+  inline void apply_vector(const DataType* x, const DataType* dy,
+                           DataType* dx, El::Int size) const {
+    DataType y[entrywise_block_size];
+    vector_exp(x, y, size);
+    for (El::Int i = 0; i < size; ++i) {
+      dx[i] = dy[i] * y[i];
+    }
+  }
 };
 
 /** Exponential minus one operator. */
@@ -206,6 +218,9 @@ struct log_op {
   inline DataType operator()(const DataType& x, const DataType& dy) const {
     return dy / x;
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    vector_log(x, y, size);
+  }
 };
 
 /** Natural logarithm one plus operator. */
@@ -308,6 +323,9 @@ struct tanh_op {
     const auto& c = std::cosh(x);
     return dy / (c*c);
   }
+  inline void apply_vector(const DataType* x, DataType* y, El::Int size) const {
+    vector_tanh(x, y, size);
+  }
 };
 
 /** Hyperbolic arccosine operator. */
@@ -25,37 +25,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/transform/in_top_k.hpp"
-#include <algorithm>
-#include <limits>
+#include "lbann/utils/top_k.hpp"
 
 
 namespace lbann {
 
 namespace {
 
-/** Sparse vector entry. */
-struct entry {
-
-  /** Vector entry value. */
-  DataType value = min_value;
-  /** Vector entry index. */
-  El::Int index = max_index;
-
-  /** Minimum possible value. */
-  static constexpr DataType min_value = -std::numeric_limits<DataType>::infinity();
-  /** Maximum possible index. */
-  static constexpr El::Int max_index = std::numeric_limits<El::Int>::max();
-
-  /** Comparison operation to sort vector entries.
-   *  Entries are sorted by value in decreasing order, with ties
-   *  broken in favor of entries with smaller indices.
-   */
-  static bool compare(const entry& a, const entry& b) {
-    return a.value > b.value || (a.value == b.value && a.index < b.index);
-  }
-
-};
-
 /** CPU implementation of in_top_k layer forward prop. */
 void fp_cpu(lbann_comm& comm,
             El::Int k,
@@ -85,42 +61,20 @@ void fp_cpu(lbann_comm& comm,
   const auto& col_comm_size = El::mpi::Size(col_comm);
 
   // Find top-k entries in each column of local input matrix
-  std::vector<entry> top_entries(local_width * k);
+  std::vector<top_k_entry> top_entries(local_width * k);
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    std::vector<entry> local_entries(std::max(local_height, k));
-    for (El::Int row = 0; row < local_height; ++row) {
-      local_entries[row].value = local_input(row, col);
-      local_entries[row].index = input.GlobalRow(row);
-    }
-    std::partial_sort_copy(local_entries.begin(),
-                           local_entries.end(),
-                           &top_entries[col*k],
-                           &top_entries[col*k] + k,
-                           entry::compare);
+    select_top_k(local_input.LockedBuffer(0, col),
+                 local_height,
+                 k,
+                 input.ColShift(),
+                 input.ColStride(),
+                 &top_entries[col*k]);
   }
 
   // Find top-k entries in each column of global input matrix
   if (col_comm_size > 1) {
-    std::vector<entry> global_top_entries(col_comm_size * local_width * k);
-    comm.all_gather(reinterpret_cast<El::byte*>(top_entries.data()),
-                    top_entries.size() * sizeof(entry),
-                    reinterpret_cast<El::byte*>(global_top_entries.data()),
-                    top_entries.size() * sizeof(entry),
-                    col_comm);
-    LBANN_OMP_PARALLEL_FOR
-    for (El::Int col = 0; col < local_width; ++col) {
-      std::vector<entry> col_entries(col_comm_size * k);
-      for (El::Int rank = 0; rank < col_comm_size; ++rank) {
-        const auto* start = &global_top_entries[rank*local_width*k+col*k];
-        std::copy(start, start + k, &col_entries[rank*k]);
-      }
-      std::partial_sort_copy(col_entries.begin(),
-                             col_entries.end(),
-                             &top_entries[col*k],
-                             &top_entries[col*k] + k,
-                             entry::compare);
-    }
+    reduce_top_k(comm, col_comm, k, local_width, top_entries.data());
   }
 
   // Indicate output entries corresponding to top-k input entries
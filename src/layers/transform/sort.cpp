@@ -39,26 +39,22 @@ void sort_layer<data_layout::DATA_PARALLEL, El::Device::CPU>
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
 
+  // Make sure each thread has a sort workspace
+  const size_t num_threads = omp_get_max_threads();
+  if (m_sorters.size() < num_threads) {
+    m_sorters.resize(num_threads);
+  }
+
   // Sort each matrix column
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    std::multimap<DataType, El::Int> sorted_list;
-    for (El::Int row = 0; row < local_height; ++row) {
-      sorted_list.emplace(local_input(row, col), row);
-    }
-    if (m_descending) {
-      auto&& it = sorted_list.rbegin();
-      for (El::Int row = 0; row < local_height; ++row, ++it) {
-        local_output(row, col) = it->first;
-        local_indices(row, col) = it->second;
-      }
-    } else {
-      auto&& it = sorted_list.begin();
-      for (El::Int row = 0; row < local_height; ++row, ++it) {
-        local_output(row, col) = it->first;
-        local_indices(row, col) = it->second;
-      }
-    }
+    auto& sorter = m_sorters[omp_get_thread_num()];
+    sorter.sort(local_input.LockedBuffer(0, col),
+                local_height,
+                m_descending,
+                local_output.Buffer(0, col),
+                local_indices.Buffer(0, col),
+                m_k);
   }
 
 }
@@ -25,7 +25,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/models/directed_acyclic_graph.hpp"
+#include "lbann/utils/autotune.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/summary.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/weights.hpp"
+#include <algorithm>
+#include <exception>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lbann {
 
@@ -65,4 +73,320 @@ void directed_acyclic_graph_model::setup_layer_execution_order() {
 
 }
 
+void directed_acyclic_graph_model::setup_layers() {
+  model::setup_layers();
+  const El::Int num_layers = get_num_layers();
+
+  // Dependencies from parent/child pointers
+  std::unordered_map<const Layer*,El::Int> layer_indices;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    layer_indices[&get_layer(i)] = i;
+  }
+  m_layer_parents.assign(num_layers, {});
+  m_layer_children.assign(num_layers, {});
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    for (const auto* parent : l.get_parent_layers()) {
+      m_layer_parents[i].push_back(layer_indices.at(parent));
+    }
+    for (const auto* child : l.get_child_layers()) {
+      m_layer_children[i].push_back(layer_indices.at(child));
+    }
+  }
+
+  // Group layers into stages
+  m_fp_stages = make_stages(true);
+  m_bp_stages = make_stages(false);
+  m_layer_times.assign(num_layers, EvalType(0));
+
+}
+
+void directed_acyclic_graph_model::setup_workspace() {
+  int num_slots = 1;
+  if (m_concurrent_layers) {
+    for (const auto* stages : {&m_fp_stages, &m_bp_stages}) {
+      for (const auto& stage : *stages) {
+        num_slots = std::max(num_slots, static_cast<int>(stage.concurrent.size()));
+      }
+    }
+  }
+  get_workspace().setup(num_slots);
+}
+
+std::vector<directed_acyclic_graph_model::layer_stage>
+directed_acyclic_graph_model::make_stages(bool forward) const {
+  const El::Int num_layers = get_num_layers();
+  const auto& depends_on = forward ? m_layer_parents : m_layer_children;
+
+  // Each layer is one stage after its latest dependency
+  // Note: Parents come before a layer in the execution order and
+  // children come after it.
+  std::vector<El::Int> layer_stages(num_layers, 0);
+  El::Int num_stages = 0;
+  for (El::Int j = 0; j < num_layers; ++j) {
+    const El::Int i = forward ? j : num_layers - 1 - j;
+    for (const auto& dep : depends_on[i]) {
+      layer_stages[i] = std::max(layer_stages[i], layer_stages[dep] + 1);
+    }
+    num_stages = std::max(num_stages, layer_stages[i] + 1);
+  }
+
+  // Layers can run concurrently if they only do rank-local work on
+  // CPU and their weights are not used by another concurrent layer
+  auto is_local = [] (const Layer& l) {
+    return (l.get_device_allocation() == El::Device::CPU
+            && l.get_data_layout() == data_layout::DATA_PARALLEL);
+  };
+  std::vector<layer_stage> stages(num_stages);
+  std::vector<std::unordered_set<const weights*>> stage_weights(num_stages);
+  for (El::Int j = 0; j < num_layers; ++j) {
+    const El::Int i = forward ? j : num_layers - 1 - j;
+    const auto& l = get_layer(i);
+    auto& stage = stages[layer_stages[i]];
+    auto& used_weights = stage_weights[layer_stages[i]];
+    bool concurrent = l.supports_concurrent_execution() && is_local(l);
+    for (const auto* neighbor : l.get_parent_layers()) {
+      concurrent = concurrent && is_local(*neighbor);
+    }
+    for (const auto* neighbor : l.get_child_layers()) {
+      concurrent = concurrent && is_local(*neighbor);
+    }
+    for (const auto* w : l.get_weights()) {
+      concurrent = concurrent && used_weights.count(w) == 0;
+    }
+    if (concurrent) {
+      stage.concurrent.push_back(i);
+      used_weights.insert(l.get_weights().begin(), l.get_weights().end());
+    } else {
+      stage.serial.push_back(i);
+    }
+  }
+
+  // Stages with one concurrent layer are run serially
+  for (auto& stage : stages) {
+    if (stage.concurrent.size() == 1) {
+      stage.serial.insert(stage.serial.begin(), stage.concurrent.front());
+      stage.concurrent.clear();
+    }
+  }
+
+  return stages;
+}
+
+void directed_acyclic_graph_model::forward_prop(execution_mode mode) {
+  if (!m_concurrent_layers) {
+    model::forward_prop(mode);
+    return;
+  }
+  do_model_forward_prop_begin_cbs(mode);
+  for (const auto& stage : m_fp_stages) {
+    run_stage(stage, mode, true);
+  }
+  record_critical_path(true);
+  ++m_num_timed_steps;
+  do_model_forward_prop_end_cbs(mode);
+}
+
+void directed_acyclic_graph_model::backward_prop() {
+  if (!m_concurrent_layers) {
+    model::backward_prop();
+    return;
+  }
+  do_model_backward_prop_begin_cbs();
+  for (const auto& stage : m_bp_stages) {
+    run_stage(stage, get_execution_mode(), false);
+
+    // Terminate early if all gradients have been computed
+    bool all_gradients_computed = true;
+    for (auto&& w : get_weights()) {
+      auto&& opt = w->get_optimizer();
+      if (opt != nullptr && opt->get_num_gradient_sources() != 0) {
+        all_gradients_computed = false;
+        break;
+      }
+    }
+    if (all_gradients_computed) { break; }
+
+  }
+  record_critical_path(false);
+  do_model_backward_prop_end_cbs();
+}
+
+void directed_acyclic_graph_model::run_stage(const layer_stage& stage,
+                                             execution_mode mode,
+                                             bool forward) {
+
+  // Concurrent layers
+  // Note: Callbacks are not thread-safe, so they are called before
+  // and after all the layers run.
+  if (!stage.concurrent.empty()) {
+    for (const auto& i : stage.concurrent) {
+      auto* l = &get_layer(i);
+      if (forward) { do_layer_forward_prop_begin_cbs(mode, l); }
+      else         { do_layer_backward_prop_begin_cbs(l); }
+    }
+    run_concurrently(stage.concurrent, forward);
+    for (const auto& i : stage.concurrent) {
+      auto* l = &get_layer(i);
+      if (forward) { do_layer_forward_prop_end_cbs(mode, l); }
+      else         { do_layer_backward_prop_end_cbs(l); }
+    }
+  }
+
+  // Serial layers
+  for (const auto& i : stage.serial) {
+    auto& l = get_layer(i);
+    const auto start = get_time();
+    if (forward) {
+      do_layer_forward_prop_begin_cbs(mode, &l);
+      l.forward_prop();
+      do_layer_forward_prop_end_cbs(mode, &l);
+    } else {
+      do_layer_backward_prop_begin_cbs(&l);
+      l.back_prop();
+      do_layer_backward_prop_end_cbs(&l);
+    }
+    m_layer_times[i] = get_time() - start;
+  }
+
+}
+
+void directed_acyclic_graph_model::run_concurrently(const std::vector<El::Int>& layers,
+                                                    bool forward) {
+  const int num_layers = layers.size();
+
+  // Hold gradient allreduces until all layers are done
+  // Note: An optimizer starts its gradient allreduce when its last
+  // gradient source is removed. Adding the model as a source ensures
+  // that allreduces start in the same order on every rank.
+  std::vector<optimizer*> optimizers;
+  if (!forward) {
+    for (const auto& i : layers) {
+      for (auto* w : get_layer(i).get_weights()) {
+        auto* opt = w->get_optimizer();
+        if (opt != nullptr) {
+          opt->add_gradient_source(this);
+          optimizers.push_back(opt);
+        }
+      }
+    }
+  }
+
+  // Set up tensors one layer at a time
+  // Note: Tensor setup may allocate from Hydrogen's memory pools,
+  // which are not thread-safe.
+  for (const auto& i : layers) {
+    auto& l = get_layer(i);
+    const auto start = get_time();
+    if (forward) { l.forward_prop_setup(); }
+    else         { l.back_prop_setup(); }
+    m_layer_times[i] = get_time() - start;
+  }
+
+  // Run layer computations
+  // Note: Exceptions can't leave an OpenMP region, so they are
+  // rethrown afterward.
+  std::vector<std::exception_ptr> errors(num_layers);
+  auto compute = [&] (int j) {
+    const auto& i = layers[j];
+    auto& l = get_layer(i);
+    const auto start = get_time();
+    try {
+      if (forward) { l.forward_prop_compute(); }
+      else         { l.back_prop_compute(); }
+    } catch (...) {
+      errors[j] = std::current_exception();
+    }
+    m_layer_times[i] += get_time() - start;
+  };
+#if defined(LBANN_HAVE_OMP_TASKLOOP)
+  // Layer kernels are taskloops within the enclosing parallel
+  // region, so each layer is run as a task and the team's threads
+  // pick up work from all of them.
+  for (int j = 0; j < num_layers; ++j) {
+    #pragma omp task default(shared) firstprivate(j)
+    compute(j);
+  }
+  #pragma omp taskwait
+#else
+  if (omp_in_parallel()) {
+    if (!m_warned_serial_fallback && m_comm->am_world_master()) {
+      LBANN_WARNING("model is run within an OpenMP parallel region, "
+                    "so concurrent layers are run one at a time");
+    }
+    m_warned_serial_fallback = true;
+    for (int j = 0; j < num_layers; ++j) { compute(j); }
+  } else {
+    // Partition threads into a team for each layer
+    const int max_threads = omp_get_max_threads();
+    const int num_teams = std::min(num_layers, max_threads);
+    const int team_size = std::max(max_threads / num_teams, 1);
+    const int prev_max_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(std::max(prev_max_levels, 2));
+    LBANN_OMP_PARALLEL_ARGS(num_threads(num_teams))
+    {
+      omp_num_threads_guard threads_guard(team_size);
+      const int team = omp_get_thread_num();
+      const int actual_num_teams = omp_get_num_threads();
+      for (int j = team; j < num_layers; j += actual_num_teams) {
+        compute(j);
+      }
+    }
+    omp_set_max_active_levels(prev_max_levels);
+  }
+#endif // LBANN_HAVE_OMP_TASKLOOP
+  for (const auto& e : errors) {
+    if (e) { std::rethrow_exception(e); }
+  }
+
+  // Release gradient allreduces
+  for (auto* opt : optimizers) {
+    opt->remove_gradient_source(this);
+  }
+
+}
+
+void directed_acyclic_graph_model::record_critical_path(bool forward) {
+  const auto& depends_on = forward ? m_layer_parents : m_layer_children;
+  const auto& stages = forward ? m_fp_stages : m_bp_stages;
+
+  // Longest path through layer times
+  // Note: Stages are in dependency order. Layers that were not run
+  // have zero time.
+  std::vector<EvalType> finish_times(m_layer_times.size(), EvalType(0));
+  EvalType critical_path_time = 0;
+  for (const auto& stage : stages) {
+    for (const auto* layers : {&stage.concurrent, &stage.serial}) {
+      for (const auto& i : *layers) {
+        EvalType start = 0;
+        for (const auto& dep : depends_on[i]) {
+          start = std::max(start, finish_times[dep]);
+        }
+        finish_times[i] = start + m_layer_times[i];
+        critical_path_time = std::max(critical_path_time, finish_times[i]);
+      }
+    }
+  }
+  m_critical_path_time += critical_path_time;
+  for (const auto& t : m_layer_times) { m_total_layer_time += t; }
+  std::fill(m_layer_times.begin(), m_layer_times.end(), EvalType(0));
+
+}
+
+void directed_acyclic_graph_model::summarize_stats(lbann_summary& summarizer) {
+  model::summarize_stats(summarizer);
+  if (m_concurrent_layers && m_num_timed_steps > 0) {
+    const auto& step = get_step(execution_mode::training);
+    summarizer.reduce_scalar("critical_path_time",
+                             m_critical_path_time / m_num_timed_steps,
+                             step);
+    summarizer.reduce_scalar("total_layer_time",
+                             m_total_layer_time / m_num_timed_steps,
+                             step);
+  }
+  m_critical_path_time = 0;
+  m_total_layer_time = 0;
+  m_num_timed_steps = 0;
+}
+
 } // namespace lbann
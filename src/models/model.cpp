@@ -35,6 +35,9 @@
 #include "lbann/objective_functions/layer_term.hpp"
 #include "lbann/metrics/layer_metric.hpp"
 #include "lbann/utils/random.hpp"
+#include "lbann/utils/autotune.hpp"
+#include "lbann/utils/numa.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
@@ -81,7 +84,9 @@ model::model(const model& other) :
   m_current_mini_batch_size(other.m_current_mini_batch_size),
   m_max_mini_batch_size(other.m_max_mini_batch_size),
   m_effective_mini_batch_size(other.m_effective_mini_batch_size),
-  m_background_io_allowed(other.m_background_io_allowed) {
+  m_background_io_allowed(other.m_background_io_allowed),
+  m_workspace(other.m_workspace),
+  m_activation_pages_off_node(other.m_activation_pages_off_node) {
 
   // Deep copies
   m_default_optimizer = (other.m_default_optimizer ?
@@ -142,6 +147,8 @@ model& model::operator=(const model& other) {
   m_max_mini_batch_size = other.m_max_mini_batch_size;
   m_effective_mini_batch_size = other.m_effective_mini_batch_size;
   m_background_io_allowed = other.m_background_io_allowed;
+  m_workspace = other.m_workspace;
+  m_activation_pages_off_node = other.m_activation_pages_off_node;
 
   // Deep copies
   m_objective_function = other.m_objective_function;
@@ -603,6 +610,17 @@ void model::setup(std::shared_ptr<thread_pool> io_thread_pool) {
   // Setup weights
   setup_weights();
 
+  // Allocate layer temporaries
+  setup_workspace();
+
+  // Choose CPU algorithms
+  autotune_layers();
+
+  // Check placement of activations
+  if (options::get()->get_bool("numa_placement", false)) {
+    count_activation_pages_off_node();
+  }
+
   // Setup objective function
   m_objective_function->setup(*this);
 
@@ -749,6 +767,48 @@ void model::setup_weights() {
 
 }
 
+void model::setup_workspace() {
+  m_workspace.setup(1);
+}
+
+void model::autotune_layers() {
+  auto* opts = options::get();
+  if (!opts->get_bool("autotune", false)) { return; }
+  autotune_cache cache(opts->get_string("autotune_cache",
+                                        "lbann_autotune.cache"));
+  cache.load();
+  const auto num_cached = cache.size();
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    get_layer(i).autotune(cache);
+  }
+  if (m_comm->am_world_master() && cache.size() != num_cached) {
+    cache.save();
+  }
+}
+
+void model::count_activation_pages_off_node() {
+  const auto thread_nodes = get_omp_thread_numa_nodes(get_cpu_topology());
+  size_t num_pages = 0, num_off_node_pages = 0;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& l = get_layer(i);
+    if (l.get_device_allocation() != El::Device::CPU) { continue; }
+    for (int j = 0; j < l.get_num_children(); ++j) {
+      const auto& local_output = l.get_local_activations(j);
+      if (local_output.Viewing() || local_output.IsEmpty()) { continue; }
+      const size_t size = (local_output.LDim() * (local_output.Width() - 1)
+                           + local_output.Height());
+      count_remote_pages(local_output.LockedBuffer(),
+                         size * sizeof(DataType),
+                         thread_nodes,
+                         num_pages,
+                         num_off_node_pages);
+    }
+  }
+  m_activation_pages_off_node = (num_pages > 0 ?
+                                 EvalType(num_off_node_pages) / num_pages :
+                                 EvalType(0));
+}
+
 void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
                                   std::unordered_set<std::string>& layer_names) {
   std::stringstream err;
@@ -1117,7 +1177,11 @@ bool model::train_mini_batch() {
   }
 
   // Update step
-  update_weights();
+  // Note: The optimization step is skipped if loss scaling detects
+  // non-finite gradients.
+  if (m_objective_function->unscale_gradients(*m_comm, m_weights)) {
+    update_weights();
+  }
   finished = update_layers();
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
     }
@@ -1473,6 +1537,26 @@ void model::summarize_stats(lbann_summary& summarizer) {
     "metric_evaluation_time",
     total_metric_time,
     get_step(execution_mode::training));
+  summarizer.reduce_scalar(
+    "workspace_size",
+    m_workspace.get_total_size(),
+    get_step(execution_mode::training));
+  summarizer.reduce_scalar(
+    "workspace_allocations_avoided",
+    m_workspace.get_num_borrows(),
+    get_step(execution_mode::training));
+  summarizer.reduce_scalar(
+    "workspace_fallback_allocations",
+    m_workspace.get_num_fallbacks(),
+    get_step(execution_mode::training));
+  m_workspace.reset_counters();
+
+  if (options::get()->get_bool("numa_placement", false)) {
+    summarizer.reduce_scalar(
+      "activation_pages_off_node_at_setup",
+      m_activation_pages_off_node,
+      get_step(execution_mode::training));
+  }
 }
 
 void model::summarize_matrices(lbann_summary& summarizer) {
@@ -1517,6 +1601,7 @@ bool model::save_to_checkpoint_shared(persist& p) {
     for (weights *w : m_weights) {
       w->save_to_checkpoint_shared(p);
     }
+    m_objective_function->save_to_checkpoint_shared(p, *m_comm);
 
     for (El::Int i = 0; i < get_num_layers(); ++i) {
       if (!get_layer(i).save_to_checkpoint_shared(p)) {
@@ -1595,6 +1680,9 @@ bool model::load_from_checkpoint_shared(persist& p) {
   for (weights *w : m_weights) {
     w->load_from_checkpoint_shared(p);
   }
+  if (p.get_cb_type() != callback_type::validation) {
+    m_objective_function->load_from_checkpoint_shared(p, *m_comm);
+  }
 
   // read in each layer
   for (El::Int i = 0; i < get_num_layers(); ++i) {
@@ -1630,6 +1718,7 @@ bool model::save_to_checkpoint_distributed(persist& p){
     for (weights *w : m_weights) {
       w->save_to_checkpoint_distributed(p);
     }
+    m_objective_function->save_to_checkpoint_distributed(p);
 
     for (El::Int i = 0; i < get_num_layers(); ++i) {
       if (!get_layer(i).save_to_checkpoint_distributed(p)) {
@@ -1689,6 +1778,7 @@ bool model::load_from_checkpoint_distributed(persist& p){
   for (weights *w : m_weights) {
     w->load_from_checkpoint_distributed(p);
   }
+  m_objective_function->load_from_checkpoint_distributed(p);
 
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     if (!get_layer(i).load_from_checkpoint_distributed(p)) {
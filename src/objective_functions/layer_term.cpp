@@ -78,7 +78,7 @@ EvalType layer_term::finish_evaluation() {
 }
 
 void layer_term::differentiate() {
-  get_evaluation_layer().set_scale(m_scale_factor);
+  get_evaluation_layer().set_scale(m_scale_factor * m_loss_scale);
 }
 
 }  // namespace lbann
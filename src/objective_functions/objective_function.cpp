@@ -27,6 +27,7 @@
 #include "lbann/objective_functions/objective_function.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/profiling.hpp"
+#include <cmath>
 #include <numeric>
 
 namespace lbann {
@@ -34,7 +35,14 @@ namespace lbann {
 objective_function::objective_function(const objective_function& other)
   : m_statistics(other.m_statistics),
     m_evaluation_time(other.m_evaluation_time),
-    m_differentiation_time(other.m_differentiation_time) {
+    m_differentiation_time(other.m_differentiation_time),
+    m_loss_scaling(other.m_loss_scaling),
+    m_loss_scale(other.m_loss_scale),
+    m_loss_scale_growth_interval(other.m_loss_scale_growth_interval),
+    m_loss_scale_growth_factor(other.m_loss_scale_growth_factor),
+    m_loss_scale_backoff_factor(other.m_loss_scale_backoff_factor),
+    m_num_good_steps(other.m_num_good_steps),
+    m_num_skipped_steps(other.m_num_skipped_steps) {
   m_terms = other.m_terms;
   for (auto& term : m_terms) {
     term = term->copy();
@@ -52,6 +60,13 @@ objective_function& objective_function::operator=(const objective_function& othe
   m_statistics = other.m_statistics;
   m_evaluation_time = other.m_evaluation_time;
   m_differentiation_time = other.m_differentiation_time;
+  m_loss_scaling = other.m_loss_scaling;
+  m_loss_scale = other.m_loss_scale;
+  m_loss_scale_growth_interval = other.m_loss_scale_growth_interval;
+  m_loss_scale_growth_factor = other.m_loss_scale_growth_factor;
+  m_loss_scale_backoff_factor = other.m_loss_scale_backoff_factor;
+  m_num_good_steps = other.m_num_good_steps;
+  m_num_skipped_steps = other.m_num_skipped_steps;
   return *this;
 }
 
@@ -108,6 +123,7 @@ void objective_function::differentiate() {
   prof_region_begin("obj-differentiate", prof_colors[0], false);
   for (const auto& term : m_terms) {
     prof_region_begin(("obj-differentiate-" + term->name()).c_str(), prof_colors[1], false);
+    term->set_loss_scale(m_loss_scale);
     term->differentiate();
     prof_region_end(("obj-differentiate-" + term->name()).c_str(), false);
   }
@@ -120,6 +136,7 @@ void objective_function::compute_weight_regularization() {
   prof_region_begin("obj-weight-regularization", prof_colors[0], false);
   for (const auto& term : m_terms) {
     prof_region_begin(("obj-weight-regularization-" + term->name()).c_str(), prof_colors[1], false);
+    term->set_loss_scale(m_loss_scale);
     term->compute_weight_regularization();
     prof_region_end(("obj-weight-regularization-" + term->name()).c_str(), false);
   }
@@ -127,6 +144,116 @@ void objective_function::compute_weight_regularization() {
   m_differentiation_time += get_time() - start_time;
 }
 
+void objective_function::set_loss_scaling(EvalType initial_scale,
+                                          El::Int growth_interval,
+                                          EvalType growth_factor,
+                                          EvalType backoff_factor) {
+  if (initial_scale <= EvalType(0) || growth_interval < 1
+      || growth_factor < EvalType(1)
+      || backoff_factor <= EvalType(0) || backoff_factor >= EvalType(1)) {
+    std::stringstream err;
+    err << "invalid loss scaling parameters "
+        << "(initial scale " << initial_scale << ", "
+        << "growth interval " << growth_interval << ", "
+        << "growth factor " << growth_factor << ", "
+        << "backoff factor " << backoff_factor << ")";
+    LBANN_ERROR(err.str());
+  }
+  m_loss_scaling = true;
+  m_loss_scale = initial_scale;
+  m_loss_scale_growth_interval = growth_interval;
+  m_loss_scale_growth_factor = growth_factor;
+  m_loss_scale_backoff_factor = backoff_factor;
+  m_num_good_steps = 0;
+  m_num_skipped_steps = 0;
+}
+
+bool objective_function::unscale_gradients(lbann_comm& comm,
+                                           const std::vector<weights*>& weights_list) {
+  if (!m_loss_scaling) { return true; }
+  const auto start_time = get_time();
+
+  // Unscale gradients and check for non-finite values
+  const auto scale = DataType(EvalType(1) / m_loss_scale);
+  int overflow = 0;
+  for (auto&& w : weights_list) {
+    auto* opt = w->get_optimizer();
+    if (opt == nullptr) { continue; }
+    auto& gradient = opt->get_gradient();
+    El::Scale(scale, gradient);
+    if (overflow) { continue; }
+    AbsDistMatReadProxy<El::Device::CPU> proxy(gradient);
+    const auto& local_gradient = proxy.GetLocked().LockedMatrix();
+    const El::Int local_height = local_gradient.Height();
+    const El::Int local_width = local_gradient.Width();
+    for (El::Int col = 0; col < local_width && !overflow; ++col) {
+      const auto* buf = local_gradient.LockedBuffer(0, col);
+      for (El::Int row = 0; row < local_height; ++row) {
+        if (!std::isfinite(buf[row])) {
+          overflow = 1;
+          break;
+        }
+      }
+    }
+  }
+  overflow = comm.allreduce(overflow, comm.get_trainer_comm(), El::mpi::MAX);
+
+  // Update loss scale
+  bool do_step = true;
+  if (overflow) {
+    m_loss_scale *= m_loss_scale_backoff_factor;
+    m_num_good_steps = 0;
+    ++m_num_skipped_steps;
+    do_step = false;
+  } else if (++m_num_good_steps >= m_loss_scale_growth_interval) {
+    m_loss_scale *= m_loss_scale_growth_factor;
+    m_num_good_steps = 0;
+  }
+
+  m_differentiation_time += get_time() - start_time;
+  return do_step;
+}
+
+bool objective_function::save_to_checkpoint_shared(persist& p, lbann_comm& comm) {
+  if (!m_loss_scaling) { return true; }
+  if (comm.am_trainer_master()) {
+    save_to_checkpoint_distributed(p);
+  }
+  return true;
+}
+
+bool objective_function::load_from_checkpoint_shared(persist& p, lbann_comm& comm) {
+  if (!m_loss_scaling) { return true; }
+  if (comm.am_trainer_master()) {
+    load_from_checkpoint_distributed(p);
+  }
+  comm.trainer_broadcast(0, m_loss_scale);
+  comm.trainer_broadcast(0, m_num_good_steps);
+  comm.trainer_broadcast(0, m_num_skipped_steps);
+  return true;
+}
+
+bool objective_function::save_to_checkpoint_distributed(persist& p) {
+  if (!m_loss_scaling) { return true; }
+  p.write_double(persist_type::train, "loss_scale", (double) m_loss_scale);
+  p.write_uint64(persist_type::train, "loss_scale_good_steps", (uint64_t) m_num_good_steps);
+  p.write_uint64(persist_type::train, "loss_scale_skipped_steps", (uint64_t) m_num_skipped_steps);
+  return true;
+}
+
+bool objective_function::load_from_checkpoint_distributed(persist& p) {
+  if (!m_loss_scaling) { return true; }
+  double loss_scale;
+  uint64_t good_steps, skipped_steps;
+  p.read_double(persist_type::train, "loss_scale", &loss_scale);
+  p.read_uint64(persist_type::train, "loss_scale_good_steps", &good_steps);
+  p.read_uint64(persist_type::train, "loss_scale_skipped_steps", &skipped_steps);
+  m_loss_scale = (EvalType) loss_scale;
+  m_num_good_steps = (El::Int) good_steps;
+  m_num_skipped_steps = (El::Int) skipped_steps;
+  return true;
+}
+
 EvalType objective_function::get_mean_value(execution_mode mode) const {
   if (m_statistics.count(mode) == 0
       || m_statistics.at(mode).get_num_samples() == 0) {
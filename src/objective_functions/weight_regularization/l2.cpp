@@ -163,7 +163,7 @@ void l2_weight_regularization::compute_weight_regularization() {
   for (auto&& w : m_weights) {
     auto&& opt = w->get_optimizer();
     if (opt != nullptr) {
-      opt->add_to_gradient(w->get_values(), m_scale_factor);
+      opt->add_to_gradient(w->get_values(), m_scale_factor * m_loss_scale);
     }
   }
 }
@@ -105,6 +105,9 @@ lbann_callback* construct_callback(lbann_comm* comm,
                                    params.low_score_wins(),
                                    lbann_callback_ltfb::string_to_comm_algo(params.communication_algorithm()),
                                    params.exchange_hyperparameters(),
+                                   params.eval_subset_batches(),
+                                   params.reuse_partner_score(),
+                                   params.async_exchange(),
                                    summarizer);
   }
   /// @todo
@@ -283,6 +286,16 @@ lbann_callback* construct_callback(lbann_comm* comm,
                                       params.batch_interval(),
                                       params.mat_interval());
   }
+  if (proto_cb.has_timeline()) {
+    const auto& params = proto_cb.timeline();
+    const auto& flush_interval = params.flush_interval();
+    const auto& buffer_size = params.buffer_size();
+    return new lbann_callback_timeline(params.directory(),
+                                       (flush_interval > 0.0 ?
+                                        flush_interval : 1.0),
+                                       (buffer_size > 0 ?
+                                        buffer_size : 65536));
+  }
   if (proto_cb.has_profiler()) {
     return new lbann_callback_profiler(proto_cb.profiler().sync(),
                                        proto_cb.profiler().skip_init());
@@ -485,7 +498,7 @@ lbann_summary* construct_summarizer(lbann_comm* comm,
             "summary directory " + c.dir() + " does not exist");
         }
       }
-      summary = new lbann_summary(c.dir(), comm);
+      summary = new lbann_summary(c.dir(), comm, c.async_write());
     }
   }
   return summary;
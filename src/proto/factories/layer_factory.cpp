@@ -128,6 +128,8 @@ std::unique_ptr<Layer> construct_layer(
       LBANN_ERROR("convolution layer is only supported with "
                   "a data-parallel layout");
     }
+    using conv_layer_t = convolution_layer<data_layout::DATA_PARALLEL, Device>;
+    std::unique_ptr<conv_layer_t> layer;
     if (params.has_vectors()) {
       const auto& dims = parse_list<int>(params.conv_dims());
       const auto& pads = parse_list<int>(params.conv_pads());
@@ -136,9 +138,9 @@ std::unique_ptr<Layer> construct_layer(
       if (dilations.empty()) {
         dilations.resize(dims.size(), 1);
       }
-      return lbann::make_unique<convolution_layer<data_layout::DATA_PARALLEL, Device>>(
-               comm, dims.size(), num_output_channels,
-               dims, pads, strides, dilations, num_groups, bias);
+      layer = lbann::make_unique<conv_layer_t>(
+                comm, dims.size(), num_output_channels,
+                dims, pads, strides, dilations, num_groups, bias);
     } else {
       const auto& num_dims = params.num_dims();
       const auto& dim = params.conv_dims_i();
@@ -148,10 +150,14 @@ std::unique_ptr<Layer> construct_layer(
       if (dilation == 0) {
         dilation = 1;
       }
-      return lbann::make_unique<convolution_layer<data_layout::DATA_PARALLEL, Device>>(
-               comm, num_dims, num_output_channels,
-               dim, pad, stride, dilation, num_groups, bias);
+      layer = lbann::make_unique<conv_layer_t>(
+                comm, num_dims, num_output_channels,
+                dim, pad, stride, dilation, num_groups, bias);
     }
+    if (params.im2col_workspace_size() > 0) {
+      layer->set_im2col_workspace_size(params.im2col_workspace_size());
+    }
+    return std::move(layer);
   }
   if (proto_layer.has_deconvolution()) {
     const auto& params = proto_layer.deconvolution();
@@ -172,6 +178,8 @@ std::unique_ptr<Layer> construct_layer(
       LBANN_ERROR("deconvolution layer is only supported with "
                   "a data-parallel layout");
     }
+    using deconv_layer_t = deconvolution_layer<data_layout::DATA_PARALLEL, Device>;
+    std::unique_ptr<deconv_layer_t> layer;
     if (params.has_vectors()) {
       const auto& dims = parse_list<int>(params.conv_dims());
       const auto& pads = parse_list<int>(params.conv_pads());
@@ -180,9 +188,9 @@ std::unique_ptr<Layer> construct_layer(
       if (dilations.empty()) {
         dilations.resize(dims.size(), 1);
       }
-      return lbann::make_unique<deconvolution_layer<data_layout::DATA_PARALLEL, Device>>(
-               comm, dims.size(), num_output_channels,
-               dims, pads, strides, dilations, num_groups, bias);
+      layer = lbann::make_unique<deconv_layer_t>(
+                comm, dims.size(), num_output_channels,
+                dims, pads, strides, dilations, num_groups, bias);
     } else {
       const auto& num_dims = params.num_dims();
       const auto& dim = params.conv_dims_i();
@@ -192,10 +200,14 @@ std::unique_ptr<Layer> construct_layer(
       if (dilation == 0) {
         dilation = 1;
       }
-      return lbann::make_unique<deconvolution_layer<data_layout::DATA_PARALLEL, Device>>(
-               comm, num_dims, num_output_channels,
-               dim, pad, stride, dilation, num_groups, bias);
+      layer = lbann::make_unique<deconv_layer_t>(
+                comm, num_dims, num_output_channels,
+                dim, pad, stride, dilation, num_groups, bias);
+    }
+    if (params.im2col_workspace_size() > 0) {
+      layer->set_im2col_workspace_size(params.im2col_workspace_size());
     }
+    return std::move(layer);
   }
 
   // Transform layers
@@ -387,7 +399,8 @@ std::unique_ptr<Layer> construct_layer(
   if (proto_layer.has_sort()) {
     const auto& params = proto_layer.sort();
     if (Layout == data_layout::DATA_PARALLEL) {
-      return lbann::make_unique<sort_layer<data_layout::DATA_PARALLEL, Device>>(comm, params.descending());
+      return lbann::make_unique<sort_layer<data_layout::DATA_PARALLEL, Device>>(
+               comm, params.descending(), params.k());
     } else {
       LBANN_ERROR("sort layer is only supported with "
                   "a data-parallel layout");
@@ -569,6 +582,13 @@ std::unique_ptr<Layer> construct_layer(
   CONSTRUCT_LAYER(boolean_accuracy);
   CONSTRUCT_LAYER(boolean_false_negative);
   CONSTRUCT_LAYER(boolean_false_positive);
+  if (proto_layer.has_softmax_cross_entropy()) {
+    if (Device == El::Device::CPU) {
+      return lbann::make_unique<softmax_cross_entropy_layer<Layout, El::Device::CPU>>(comm);
+    } else {
+      LBANN_ERROR("softmax cross entropy layer is only supported on CPU");
+    }
+  }
 
   // Image layers
   if (proto_layer.has_bilinear_resize()) {
@@ -46,7 +46,9 @@ model* instantiate_model(lbann_comm* comm,
   const auto& type = proto_model.type();
   const auto& mini_batch_size = proto_model.mini_batch_size();
   if (type.empty() || type == "directed_acyclic_graph_model") {
-    return new directed_acyclic_graph_model(comm, mini_batch_size, obj, opt);
+    auto* m = new directed_acyclic_graph_model(comm, mini_batch_size, obj, opt);
+    m->set_concurrent_layers(proto_model.concurrent_layers());
+    return m;
   }
 
   // Throw error if model type is not supported
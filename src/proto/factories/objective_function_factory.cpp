@@ -46,6 +46,16 @@ objective_function* construct_objective_function(const lbann_data::ObjectiveFunc
     obj->add_term(new layer_term(params.scale_factor()));
   }
 
+  // Dynamic loss scaling
+  if (proto_obj.has_loss_scaling()) {
+    const auto& params = proto_obj.loss_scaling();
+    obj->set_loss_scaling(
+      params.initial_scale() > 0 ? params.initial_scale() : 65536,
+      params.growth_interval() > 0 ? params.growth_interval() : 2000,
+      params.growth_factor() > 0 ? params.growth_factor() : 2,
+      params.backoff_factor() > 0 ? params.backoff_factor() : 0.5);
+  }
+
   // Return objective function
   return obj;
 
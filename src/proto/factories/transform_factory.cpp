@@ -150,6 +150,7 @@ transform::transform_pipeline construct_transform_pipeline(
   for (int i = 0; i < data_reader.transforms_size(); ++i) {
     tp.add_transform(construct_transform(data_reader.transforms(i)));
   }
+  tp.set_reduced_resolution_decode(data_reader.reduced_resolution_decode());
   return tp;
 }
 
@@ -265,6 +265,9 @@ void init_image_data_reader(const lbann_data::Reader& pb_readme, const lbann_dat
   if (master) std::cout << reader->get_type() << " is set" << std::endl;
 
   image_data_reader_ptr->set_input_params(width, height, channels, n_labels);
+  image_data_reader_ptr->set_packed_dataset_io(
+    pb_readme.packed_direct_io(),
+    !pb_readme.packed_disable_readahead());
 }
 
 void init_org_image_data_reader(const lbann_data::Reader& pb_readme, const bool master, generic_data_reader* &reader) {
@@ -145,6 +145,7 @@ void init_data_readers(
       reader->set_data_index_list(readme.index_list());
       reader_jag_conduit->set_list_per_trainer(readme.index_list_per_trainer());
       reader_jag_conduit->set_list_per_model(readme.index_list_per_model());
+      reader_jag_conduit->set_locality_shuffle_window(readme.locality_shuffle_window());
 
       /// Allow the prototext to control if the data readers is
       /// shareable for each phase training, validation, or testing
@@ -187,6 +188,9 @@ void init_data_readers(
       reader_csv->set_skip_cols(readme.skip_cols());
       reader_csv->set_skip_rows(readme.skip_rows());
       reader_csv->set_has_header(readme.has_header());
+      reader_csv->set_mmap(readme.mmap());
+      reader_csv->set_binary_cache(readme.binary_cache(),
+                                   readme.binary_cache_dir());
       reader = reader_csv;
     } else if (name == "numpy_npz_conduit_reader") {
       auto *npz_conduit = new numpy_npz_conduit_reader(shuffle);
@@ -201,12 +205,14 @@ void init_data_readers(
       auto* reader_numpy = new numpy_reader(shuffle);
       reader_numpy->set_has_labels(!readme.disable_labels());
       reader_numpy->set_has_responses(!readme.disable_responses());
+      reader_numpy->set_mmap(readme.mmap());
       reader = reader_numpy;
     } else if (name == "numpy_npz") {
       auto* reader_numpy_npz = new numpy_npz_reader(shuffle);
       reader_numpy_npz->set_has_labels(!readme.disable_labels());
       reader_numpy_npz->set_has_responses(!readme.disable_responses());
       reader_numpy_npz->set_scaling_factor_int16(readme.scaling_factor_int16());
+      reader_numpy_npz->set_mmap(readme.mmap());
       reader = reader_numpy_npz;
     } else if (name == "pilot2_molecular_reader") {
       pilot2_molecular_reader* reader_pilot2_molecular = new pilot2_molecular_reader(readme.num_neighbors(), readme.max_neighborhood(), shuffle);
@@ -227,6 +233,7 @@ void init_data_readers(
           reader_numpy->set_data_filename(path);
           reader_numpy->set_has_labels(!readme.disable_labels());
           reader_numpy->set_has_responses(!readme.disable_responses());
+          reader_numpy->set_mmap(readme.mmap());
           npy_readers.push_back(reader_numpy);
         } else if (readme.format() == "numpy_npz") {
           auto* reader_numpy_npz = new numpy_npz_reader(false);
@@ -234,6 +241,7 @@ void init_data_readers(
           reader_numpy_npz->set_has_labels(!readme.disable_labels());
           reader_numpy_npz->set_has_responses(!readme.disable_responses());
           reader_numpy_npz->set_scaling_factor_int16(readme.scaling_factor_int16());
+          reader_numpy_npz->set_mmap(readme.mmap());
           npy_readers.push_back(reader_numpy_npz);
         } else if (readme.format() == "jag_conduit") {
           init_image_data_reader(readme, pb_metadata, master, reader);
@@ -254,6 +262,9 @@ void init_data_readers(
           reader_csv->set_skip_cols(readme.skip_cols());
           reader_csv->set_skip_rows(readme.skip_rows());
           reader_csv->set_has_header(readme.has_header());
+          reader_csv->set_mmap(readme.mmap());
+          reader_csv->set_binary_cache(readme.binary_cache(),
+                                       readme.binary_cache_dir());
           reader_csv->set_absolute_sample_count( readme.absolute_sample_count() );
           reader_csv->set_use_percent( readme.percent_of_data_to_use() );
           reader_csv->set_first_n( readme.first_n() );
@@ -793,6 +804,9 @@ void get_cmdline_overrides(const lbann_comm& comm, lbann_data::LbannPB& p)
   if (opts->has_int("random_seed")) {
     model->set_random_seed(opts->get_int("random_seed"));
   }
+  if(opts->get_bool("concurrent_layers")) {
+    model->set_concurrent_layers(opts->get_bool("concurrent_layers"));
+  }
   if(opts->get_bool("serialize_io")) {
     model->set_serialize_io(opts->get_bool("serialize_io"));
   }
@@ -817,6 +831,7 @@ void print_parameters(const lbann_comm& comm, lbann_data::LbannPB& p)
             << "  procs_per_trainer:       " << m.procs_per_trainer()  << std::endl
             << "  num_parallel_readers:    " << m.num_parallel_readers()  << std::endl
             << "  serialize_io:            " << m.serialize_io()  << std::endl
+            << "  concurrent_layers:       " << m.concurrent_layers()  << std::endl
             << "  disable_cuda:            " << m.disable_cuda()  << std::endl
             << "  random_seed:             " << m.random_seed() << std::endl
             << "  data_layout:             " << m.data_layout()  << std::endl
@@ -859,6 +874,8 @@ void print_help(std::ostream& os)
        "  --num_parallel_readers=<int>\n"
        "  --num_io_threads=<int>\n"
        "      # of threads used for I/O by the data readers\n"
+       "  --concurrent_layers=<bool>\n"
+       "      run independent layers at the same time on separate OpenMP thread teams\n"
        "  --serialize_io=<bool>\n"
        "      force data readers to use a single thread for I/O\n"
        "  --disable_background_io_activity=<bool>\n"
@@ -874,14 +891,27 @@ void print_help(std::ostream& os)
        "            that take DATA_PARALLEL or MODEL_PARALLEL as a template parameter\n"
        "  --print_affinity\n"
        "      display information on how OpenMP threads are provisioned\n"
+       "  --numa_placement\n"
+       "      bind compute and I/O threads to disjoint cores by NUMA node and\n"
+       "      report the fraction of activation pages on remote NUMA nodes\n"
+       "  --autotune\n"
+       "      time CPU algorithms and thread counts for each layer during setup\n"
+       "  --autotune_cache=<string>\n"
+       "      file where autotuning choices are cached (default: lbann_autotune.cache)\n"
        "  --use_data_store \n"
        "      Enables the data store in-memory structure\n"
        "  --preload_data_store \n"
        "      Preloads the data store in-memory structure during data reader load time\n"
+       "  --node_local_data_store \n"
+       "      With --preload_data_store, keeps the samples of all ranks on a node in\n"
+       "      shared memory so that only samples owned on other nodes are exchanged\n"
        "  --super_node \n"
        "      Enables the data store in-memory structure to use the supernode exchange structure\n"
        "  --write_sample_list \n"
        "      Writes out the sample list that was loaded into the current directory\n"
+       "  --write_sample_list_index=<string> \n"
+       "      Writes the sample list that was loaded as a binary index, which can\n"
+       "      be used in place of the text list and is shared by the ranks of a node\n"
        "  --ltfb_verbose \n"
        "      Increases number of per-trainer messages that are reported\n"
        "\n"
@@ -26,24 +26,135 @@
 
 #include "lbann/transforms/transform_pipeline.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/image.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace lbann {
 namespace transform {
 
+namespace {
+
+/** Sample positions and interpolation weights along one image axis. */
+struct sample_axis {
+  /** Pixels before and after each sample. */
+  std::vector<size_t> lo, hi;
+  /** Weight of the pixel after each sample. */
+  std::vector<DataType> weight;
+};
+
+/**
+ * Compute bilinear sample positions for resizing [offset, offset + in_size)
+ * to out_size pixels. This uses the same pixel-center convention and border
+ * clamping as cv::resize with INTER_LINEAR. If flip is true, samples are
+ * mirrored.
+ */
+void setup_sample_axis(size_t offset, size_t in_size, size_t out_size,
+                       bool flip, sample_axis& axis) {
+  axis.lo.resize(out_size);
+  axis.hi.resize(out_size);
+  axis.weight.resize(out_size);
+  const double ratio = static_cast<double>(in_size) / out_size;
+  for (size_t i = 0; i < out_size; ++i) {
+    const size_t j = flip ? out_size - 1 - i : i;
+    size_t pos = j;
+    double weight = 0.0;
+    if (in_size != out_size) {
+      const double x = (j + 0.5) * ratio - 0.5;
+      const double x_floor = std::floor(x);
+      if (x_floor < 0) {
+        pos = 0;
+      } else if (x_floor >= in_size - 1) {
+        pos = in_size - 1;
+      } else {
+        pos = static_cast<size_t>(x_floor);
+        weight = x - x_floor;
+      }
+    }
+    axis.lo[i] = offset + pos;
+    axis.hi[i] = offset + std::min(pos + 1, in_size - 1);
+    axis.weight[i] = weight;
+  }
+}
+
+/**
+ * Crop, resize, and flip an interleaved uint8 image, apply channel-wise
+ * affine maps, and write the result in LBANN's layout.
+ * The inner loop runs down a column of the output, so writes are contiguous
+ * and the loop is branch-free.
+ */
+void resample_to_lbann_layout(const uint8_t* __restrict__ src,
+                              const std::vector<size_t>& dims,
+                              const image_crop& crop,
+                              bool flip_horizontal,
+                              bool flip_vertical,
+                              const std::vector<DataType>& scale,
+                              const std::vector<DataType>& bias,
+                              DataType* __restrict__ dst) {
+  if (crop.h == 0 || crop.w == 0 || crop.out_h == 0 || crop.out_w == 0 ||
+      crop.x + crop.w > dims[2] || crop.y + crop.h > dims[1]) {
+    std::stringstream ss;
+    ss << "Bad crop dimensions for " << dims[1] << "x" << dims[2]
+       << ": " << crop.h << "x" << crop.w
+       << " at (" << crop.x << "," << crop.y << ")";
+    LBANN_ERROR(ss.str());
+  }
+  const size_t num_channels = dims[0];
+  const size_t src_ldim = dims[2] * num_channels;
+  sample_axis rows, cols;
+  setup_sample_axis(crop.y, crop.h, crop.out_h, flip_vertical, rows);
+  setup_sample_axis(crop.x, crop.w, crop.out_w, flip_horizontal, cols);
+  for (size_t row = 0; row < crop.out_h; ++row) {
+    rows.lo[row] *= src_ldim;
+    rows.hi[row] *= src_ldim;
+  }
+  const size_t* __restrict__ row_lo = rows.lo.data();
+  const size_t* __restrict__ row_hi = rows.hi.data();
+  const DataType* __restrict__ row_weight = rows.weight.data();
+  const size_t out_size = crop.out_h * crop.out_w;
+  for (size_t channel = 0; channel < num_channels; ++channel) {
+    const DataType a = scale[channel];
+    const DataType b = bias[channel];
+    for (size_t col = 0; col < crop.out_w; ++col) {
+      const size_t x0 = cols.lo[col] * num_channels + channel;
+      const size_t x1 = cols.hi[col] * num_channels + channel;
+      const DataType wx = cols.weight[col];
+      DataType* __restrict__ dst_col = &dst[channel*out_size + col*crop.out_h];
+      for (size_t row = 0; row < crop.out_h; ++row) {
+        const DataType p00 = src[row_lo[row] + x0];
+        const DataType p01 = src[row_lo[row] + x1];
+        const DataType p10 = src[row_hi[row] + x0];
+        const DataType p11 = src[row_hi[row] + x1];
+        const DataType top = p00 + wx * (p01 - p00);
+        const DataType bottom = p10 + wx * (p11 - p10);
+        dst_col[row] = a * (top + row_weight[row] * (bottom - top)) + b;
+      }
+    }
+  }
+}
+
+}  // namespace
+
 transform_pipeline::transform_pipeline(const transform_pipeline& other) :
-  m_expected_out_dims(other.m_expected_out_dims) {
+  m_expected_out_dims(other.m_expected_out_dims),
+  m_reduced_resolution_decode(other.m_reduced_resolution_decode),
+  m_fuse(other.m_fuse) {
   for (const auto& trans : other.m_transforms) {
     m_transforms.emplace_back(trans->copy());
   }
+  plan_fusion();
 }
 
 transform_pipeline& transform_pipeline::operator=(
   const transform_pipeline& other) {
   m_expected_out_dims = other.m_expected_out_dims;
+  m_reduced_resolution_decode = other.m_reduced_resolution_decode;
+  m_fuse = other.m_fuse;
   m_transforms.clear();
   for (const auto& trans : other.m_transforms) {
     m_transforms.emplace_back(trans->copy());
   }
+  plan_fusion();
   return *this;
 }
 
@@ -63,10 +174,72 @@ void transform_pipeline::apply(CPUMat& data, std::vector<size_t>& dims) {
 
 void transform_pipeline::apply(El::Matrix<uint8_t>& data, CPUMat& out_data,
                                std::vector<size_t>& dims) {
+  apply(data, out_data, dims, nullptr);
+}
+
+void transform_pipeline::apply_encoded(El::Matrix<uint8_t>& encoded,
+                                       CPUMat& out_data,
+                                       std::vector<size_t>& dims) {
+  El::Matrix<uint8_t> image;
+  std::vector<size_t> full_dims;
+  image_crop crop;
+  if (!m_reduced_resolution_decode
+      || m_transforms.empty()
+      || !get_encoded_image_dims(encoded, full_dims)
+      || !m_transforms[0]->plan_crop(full_dims, crop)) {
+    decode_image(encoded, image, dims);
+    apply(image, out_data, dims, nullptr);
+    return;
+  }
+
+  // Choose the coarsest scale that does not upsample the crop
+  // Note: Other formats are always decoded at full resolution. The
+  // crop has already been planned, so the decoded image must match
+  // the header to avoid drawing random numbers again.
+  size_t scale = is_jpeg_image(encoded) ? 8 : 1;
+  while (scale > 1
+         && (crop.h < scale * crop.out_h || crop.w < scale * crop.out_w)) {
+    scale /= 2;
+  }
+  decode_image(encoded, image, dims, scale);
+
+  // Map crop onto decoded image
+  // Note: The header may not describe the decoded image, e.g. if
+  // the image is rotated by its EXIF orientation. The first transform
+  // is applied as usual in that case.
+  const size_t expected_h = (full_dims[1] + scale - 1) / scale;
+  const size_t expected_w = (full_dims[2] + scale - 1) / scale;
+  if (dims[1] != expected_h || dims[2] != expected_w) {
+    apply(image, out_data, dims, nullptr);
+    return;
+  }
+  if (scale > 1) {
+    const size_t x_end = std::min((crop.x + crop.w + scale - 1) / scale, dims[2]);
+    const size_t y_end = std::min((crop.y + crop.h + scale - 1) / scale, dims[1]);
+    crop.x /= scale;
+    crop.y /= scale;
+    crop.w = x_end - crop.x;
+    crop.h = y_end - crop.y;
+  }
+  apply(image, out_data, dims, &crop);
+}
+
+void transform_pipeline::apply(El::Matrix<uint8_t>& data, CPUMat& out_data,
+                               std::vector<size_t>& dims,
+                               const image_crop* crop) {
+  if (is_fused() && apply_fused(data, out_data, dims, crop)) {
+    assert_expected_out_dims(dims);
+    return;
+  }
   utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
-  if (!m_transforms.empty()) {
+  size_t first = 0;
+  if (crop != nullptr) {
+    transform::apply_crop(m, dims, *crop);
+    first = 1;
+  }
+  if (first < m_transforms.size()) {
     bool applied_non_inplace = false;
-    size_t i = 0;
+    size_t i = first;
     for (; !applied_non_inplace && i < m_transforms.size(); ++i) {
       if (m_transforms[i]->supports_non_inplace()) {
         applied_non_inplace = true;
@@ -93,6 +266,116 @@ void transform_pipeline::apply(El::Matrix<uint8_t>& data, CPUMat& out_data,
   assert_expected_out_dims(dims);
 }
 
+bool transform_pipeline::apply_fused(El::Matrix<uint8_t>& data,
+                                     CPUMat& out_data,
+                                     std::vector<size_t>& dims,
+                                     const image_crop* crop) {
+  if (dims.size() != 3 || !out_data.Contiguous()) {
+    return false;
+  }
+
+  // Compose channel-wise affine maps
+  const size_t num_channels = dims[0];
+  std::vector<DataType> scale, bias, trans_scale, trans_bias;
+  if (!m_transforms[m_layout_index]->get_channel_affine(num_channels,
+                                                        scale, bias)) {
+    return false;
+  }
+  for (size_t i = m_layout_index + 1; i < m_transforms.size(); ++i) {
+    if (!m_transforms[i]->get_channel_affine(num_channels,
+                                             trans_scale, trans_bias)) {
+      return false;
+    }
+    for (size_t channel = 0; channel < num_channels; ++channel) {
+      scale[channel] *= trans_scale[channel];
+      bias[channel] = trans_scale[channel] * bias[channel] + trans_bias[channel];
+    }
+  }
+
+  // Plan crop
+  utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
+  image_crop planned_crop = {0, 0, dims[1], dims[2], dims[1], dims[2]};
+  size_t first = 0;
+  if (crop != nullptr) {
+    planned_crop = *crop;
+    first = 1;
+  } else if (m_transforms[0]->get_fusion_role() == fusion_role::crop) {
+    if (!m_transforms[0]->plan_crop(dims, planned_crop)) {
+      m_transforms[0]->apply(m, dims);
+      planned_crop = {0, 0, dims[1], dims[2], dims[1], dims[2]};
+    }
+    first = 1;
+  }
+
+  // Plan flips
+  // Note: Pixel-wise transforms commute with flips, so flips are
+  // always deferred to the fused kernel.
+  bool flip_horizontal = false, flip_vertical = false;
+  bool has_pixelwise = false;
+  for (size_t i = first; i < m_layout_index; ++i) {
+    if (m_transforms[i]->get_fusion_role() == fusion_role::flip) {
+      bool horizontal, vertical;
+      m_transforms[i]->plan_flip(horizontal, vertical);
+      flip_horizontal = flip_horizontal != horizontal;
+      flip_vertical = flip_vertical != vertical;
+    } else {
+      has_pixelwise = true;
+    }
+  }
+
+  // Pixel-wise transforms need the cropped image
+  if (has_pixelwise) {
+    if (planned_crop.h != dims[1] || planned_crop.w != dims[2]
+        || planned_crop.out_h != dims[1] || planned_crop.out_w != dims[2]) {
+      transform::apply_crop(m, dims, planned_crop);
+    }
+    for (size_t i = first; i < m_layout_index; ++i) {
+      if (m_transforms[i]->get_fusion_role() == fusion_role::pixelwise) {
+        m_transforms[i]->apply(m, dims);
+      }
+    }
+    planned_crop = {0, 0, dims[1], dims[2], dims[1], dims[2]};
+  }
+
+  const std::vector<size_t> out_dims = {num_channels,
+                                        planned_crop.out_h,
+                                        planned_crop.out_w};
+  if (static_cast<size_t>(out_data.Height() * out_data.Width())
+      != utils::get_linearized_size(out_dims)) {
+    LBANN_ERROR("Transform output does not have sufficient space.");
+  }
+  resample_to_lbann_layout(m.template get<uint8_t>().LockedBuffer(),
+                           dims, planned_crop,
+                           flip_horizontal, flip_vertical,
+                           scale, bias, out_data.Buffer());
+  dims = out_dims;
+  return true;
+}
+
+void transform_pipeline::plan_fusion() {
+  m_fusable = false;
+  size_t i = 0;
+  if (i < m_transforms.size()
+      && m_transforms[i]->get_fusion_role() == fusion_role::crop) {
+    ++i;
+  }
+  while (i < m_transforms.size()
+         && (m_transforms[i]->get_fusion_role() == fusion_role::flip
+             || m_transforms[i]->get_fusion_role() == fusion_role::pixelwise)) {
+    ++i;
+  }
+  if (i == m_transforms.size()
+      || m_transforms[i]->get_fusion_role() != fusion_role::to_lbann_layout) {
+    return;
+  }
+  m_layout_index = i++;
+  while (i < m_transforms.size()
+         && m_transforms[i]->get_fusion_role() == fusion_role::channel_affine) {
+    ++i;
+  }
+  m_fusable = (i == m_transforms.size());
+}
+
 void transform_pipeline::assert_expected_out_dims(
   const std::vector<size_t>& dims) {
   if (!m_expected_out_dims.empty() && dims != m_expected_out_dims) {
@@ -40,5 +40,10 @@ void horizontal_flip::apply(utils::type_erased_matrix& data, std::vector<size_t>
   }
 }
 
+void horizontal_flip::plan_flip(bool& horizontal, bool& vertical) const {
+  horizontal = transform::get_bool_random(m_p);
+  vertical = false;
+}
+
 }  // namespace transform
 }  // namespace lbann
@@ -90,5 +90,22 @@ void normalize_to_lbann_layout::apply(utils::type_erased_matrix& data,
   }
 }
 
+bool normalize_to_lbann_layout::get_channel_affine(
+  size_t num_channels,
+  std::vector<DataType>& scale,
+  std::vector<DataType>& bias) const {
+  if ((num_channels != 1 && num_channels != 3)
+      || m_means.size() != num_channels) {
+    return false;
+  }
+  scale.resize(num_channels);
+  bias.resize(num_channels);
+  for (size_t channel = 0; channel < num_channels; ++channel) {
+    scale[channel] = 1.0f / (255.0f * m_stds[channel]);
+    bias[channel] = -m_means[channel] / m_stds[channel];
+  }
+  return true;
+}
+
 }  // namespace transform
 }  // namespace lbann
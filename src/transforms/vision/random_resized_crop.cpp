@@ -24,7 +24,6 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <opencv2/imgproc.hpp>
 #include "lbann/transforms/vision/random_resized_crop.hpp"
 #include "lbann/utils/opencv.hpp"
 
@@ -33,10 +32,14 @@ namespace transform {
 
 void random_resized_crop::apply(utils::type_erased_matrix& data,
                                 std::vector<size_t>& dims) {
-  cv::Mat src = utils::get_opencv_mat(data, dims);
-  std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(utils::get_linearized_size(new_dims), 1);
-  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
+  utils::assert_is_image(data, dims);
+  image_crop crop;
+  plan_crop(dims, crop);
+  apply_crop(data, dims, crop);
+}
+
+bool random_resized_crop::plan_crop(const std::vector<size_t>& dims,
+                                    image_crop& crop) const {
   size_t x = 0, y = 0, h = 0, w = 0;
   const size_t area = dims[1]*dims[2];
   // There's a chance this can fail, so we only make ten attempts.
@@ -59,34 +62,15 @@ void random_resized_crop::apply(utils::type_erased_matrix& data,
     h = 0;
     w = 0;
   }
-  bool fallback = false;
   // Fallback.
   if (h == 0) {
-    fallback = true;
     w = std::min(dims[1], dims[2]);
     h = w;
     x = (dims[2] - w) / 2;
     y = (dims[1] - h) / 2;
   }
-  // Sanity check.
-  if (x >= static_cast<size_t>(src.cols) ||
-      y >= static_cast<size_t>(src.rows) ||
-      (x + w) > static_cast<size_t>(src.cols) ||
-      (y + h) > static_cast<size_t>(src.rows)) {
-    std::stringstream ss;
-    ss << "Bad crop dimensions for " << src.rows << "x" << src.cols << ": "
-       << h << "x" << w << " at (" << x << "," << y << ") fallback=" << fallback;
-    LBANN_ERROR(ss.str());
-  }
-  // This is just a view.
-  cv::Mat tmp = src(cv::Rect(x, y, w, h));
-  cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  // Sanity check.
-  if (dst.ptr() != dst_real.Buffer()) {
-    LBANN_ERROR("Did not resize into dst_real.");
-  }
-  data.emplace<uint8_t>(std::move(dst_real));
-  dims = new_dims;
+  crop = {x, y, h, w, m_h, m_w};
+  return true;
 }
 
 }  // namespace transform
@@ -24,7 +24,6 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <opencv2/imgproc.hpp>
 #include "lbann/transforms/vision/random_resized_crop_with_fixed_aspect_ratio.hpp"
 #include "lbann/utils/opencv.hpp"
 
@@ -33,13 +32,17 @@ namespace transform {
 
 void random_resized_crop_with_fixed_aspect_ratio::apply(
   utils::type_erased_matrix& data, std::vector<size_t>& dims) {
-  cv::Mat src = utils::get_opencv_mat(data, dims);
-  std::vector<size_t> new_dims = {dims[0], m_crop_h, m_crop_w};
-  auto dst_real = El::Matrix<uint8_t>(utils::get_linearized_size(new_dims), 1);
-  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
+  utils::assert_is_image(data, dims);
+  image_crop crop;
+  plan_crop(dims, crop);
+  apply_crop(data, dims, crop);
+}
+
+bool random_resized_crop_with_fixed_aspect_ratio::plan_crop(
+  const std::vector<size_t>& dims, image_crop& crop) const {
   // Compute the projected crop area in the original image, crop it, and resize.
-  const float zoom = std::min(float(src.rows) / float(m_h),
-                              float(src.cols) / float(m_w));
+  const float zoom = std::min(float(dims[1]) / float(m_h),
+                              float(dims[2]) / float(m_w));
   const size_t zoom_h = m_h*zoom;
   const size_t zoom_w = m_w*zoom;
   const size_t zoom_crop_h = m_crop_h*zoom;
@@ -50,21 +53,8 @@ void random_resized_crop_with_fixed_aspect_ratio::apply(
     0, 2*(zoom*m_h - zoom_crop_h) + 1);
   const size_t x = (dims[2] - zoom_w + dx + 1) / 2;
   const size_t y = (dims[1] - zoom_h + dy + 1) / 2;
-  // Sanity check.
-  if (x >= static_cast<size_t>(src.cols) ||
-      y >= static_cast<size_t>(src.rows) ||
-      (x + zoom_crop_w) > static_cast<size_t>(src.cols) ||
-      (y + zoom_crop_h) > static_cast<size_t>(src.rows)) {
-    std::stringstream ss;
-    ss << "Bad crop dimensions for " << src.rows << "x" << src.cols << ": "
-       << zoom_crop_h << "x" << zoom_crop_w << " at (" << x << "," << y << ")";
-    LBANN_ERROR(ss.str());
-  }
-  // The crop is just a view.
-  cv::Mat tmp = src(cv::Rect(x, y, zoom_crop_h, zoom_crop_w));
-  cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  data.emplace<uint8_t>(std::move(dst_real));
-  dims = new_dims;
+  crop = {x, y, zoom_crop_h, zoom_crop_w, m_crop_h, m_crop_w};
+  return true;
 }
 
 }  // namespace transform
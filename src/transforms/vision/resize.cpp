@@ -24,7 +24,6 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <opencv2/imgproc.hpp>
 #include "lbann/transforms/vision/resize.hpp"
 #include "lbann/utils/opencv.hpp"
 
@@ -32,13 +31,16 @@ namespace lbann {
 namespace transform {
 
 void resize::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) {
-  cv::Mat src = utils::get_opencv_mat(data, dims);
-  std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(utils::get_linearized_size(new_dims), 1);
-  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
-  cv::resize(src, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  data.emplace<uint8_t>(std::move(dst_real));
-  dims = new_dims;
+  utils::assert_is_image(data, dims);
+  image_crop crop;
+  plan_crop(dims, crop);
+  apply_crop(data, dims, crop);
+}
+
+bool resize::plan_crop(const std::vector<size_t>& dims,
+                       image_crop& crop) const {
+  crop = {0, 0, dims[1], dims[2], m_h, m_w};
+  return true;
 }
 
 }  // namespace transform
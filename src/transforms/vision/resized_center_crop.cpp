@@ -24,7 +24,6 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <opencv2/imgproc.hpp>
 #include "lbann/transforms/vision/resized_center_crop.hpp"
 #include "lbann/utils/opencv.hpp"
 
@@ -32,35 +31,26 @@ namespace lbann {
 namespace transform {
 
 void resized_center_crop::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims) {
-  cv::Mat src = utils::get_opencv_mat(data, dims);
-  std::vector<size_t> new_dims = {dims[0], m_crop_h, m_crop_w};
-  auto dst_real = El::Matrix<uint8_t>(utils::get_linearized_size(new_dims), 1);
-  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
+  utils::assert_is_image(data, dims);
+  image_crop crop;
+  plan_crop(dims, crop);
+  apply_crop(data, dims, crop);
+}
+
+bool resized_center_crop::plan_crop(const std::vector<size_t>& dims,
+                                    image_crop& crop) const {
   // This computes the projected crop area in the original image, crops it,
   // then resizes it.
   // Thus, we resize a smaller image, which is faster.
   // Method due to @JaeseungYeom.
-  const float zoom = std::min(float(src.rows) / float(m_h),
-                              float(src.cols) / float(m_w));
+  const float zoom = std::min(float(dims[1]) / float(m_h),
+                              float(dims[2]) / float(m_w));
   const size_t zoom_h = m_crop_h*zoom;
   const size_t zoom_w = m_crop_w*zoom;
-  const size_t x = std::round(float(src.cols - zoom_w) / 2.0f);
-  const size_t y = std::round(float(src.rows - zoom_h) / 2.0f);
-  // Sanity check.
-  if (x >= static_cast<size_t>(src.cols) ||
-      y >= static_cast<size_t>(src.rows) ||
-      (x + zoom_w) > static_cast<size_t>(src.cols) ||
-      (y + zoom_h) > static_cast<size_t>(src.rows)) {
-    std::stringstream ss;
-    ss << "Bad crop dimensions for " << src.rows << "x" << src.cols << ": "
-       << zoom_h << "x" << zoom_w << " at (" << x << "," << y << ")";
-    LBANN_ERROR(ss.str());
-  }
-  // The crop is just a view.
-  cv::Mat tmp = src(cv::Rect(x, y, zoom_h, zoom_w));
-  cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  data.emplace<uint8_t>(std::move(dst_real));
-  dims = new_dims;
+  const size_t x = std::round(float(dims[2] - zoom_w) / 2.0f);
+  const size_t y = std::round(float(dims[1] - zoom_h) / 2.0f);
+  crop = {x, y, zoom_h, zoom_w, m_crop_h, m_crop_w};
+  return true;
 }
 
 }  // namespace transform
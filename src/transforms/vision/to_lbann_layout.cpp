@@ -76,5 +76,16 @@ void to_lbann_layout::apply(utils::type_erased_matrix& data, CPUMat& out,
   }
 }
 
+bool to_lbann_layout::get_channel_affine(size_t num_channels,
+                                         std::vector<DataType>& scale,
+                                         std::vector<DataType>& bias) const {
+  if (num_channels != 1 && num_channels != 3) {
+    return false;
+  }
+  scale.assign(num_channels, DataType(1.0f / 255.0f));
+  bias.assign(num_channels, DataType(0));
+  return true;
+}
+
 }  // namespace transform
 }  // namespace lbann
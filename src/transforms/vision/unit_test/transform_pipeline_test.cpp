@@ -3,11 +3,21 @@
 
 // File being tested
 #include <lbann/transforms/transform_pipeline.hpp>
+#include <lbann/transforms/vision/resize.hpp>
 #include <lbann/transforms/vision/resized_center_crop.hpp>
+#include <lbann/transforms/vision/random_resized_crop.hpp>
 #include <lbann/transforms/vision/to_lbann_layout.hpp>
+#include <lbann/transforms/vision/normalize_to_lbann_layout.hpp>
+#include <lbann/transforms/vision/horizontal_flip.hpp>
+#include <lbann/transforms/vision/adjust_brightness.hpp>
+#include <lbann/transforms/sample_normalize.hpp>
 #include <lbann/transforms/scale.hpp>
 #include <lbann/transforms/normalize.hpp>
 #include <lbann/utils/memory.hpp>
+#include <lbann/utils/image.hpp>
+#include <lbann/utils/random.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <cmath>
 #include "helper.hpp"
 
 TEST_CASE("Testing vision transform pipeline", "[preproc]") {
@@ -43,3 +53,141 @@ TEST_CASE("Testing vision transform pipeline", "[preproc]") {
     }
   }
 }
+
+TEST_CASE("Testing vision transform pipeline with reduced decode", "[preproc]") {
+  // Smooth test image, encoded as a high-quality JPEG.
+  const El::Int height = 240, width = 320;
+  El::Matrix<uint8_t> image;
+  zeros(image, height, width, 3);
+  apply_elementwise(image, height, width, 3,
+                    [=](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+                      x = 128 + 100 * std::sin(0.02 * (row + channel * col));
+                    });
+  std::vector<uint8_t> encoded_buf;
+  cv::Mat cv_image(height, width, CV_8UC3, image.Buffer());
+  cv::imencode(".jpg", cv_image, encoded_buf, {cv::IMWRITE_JPEG_QUALITY, 95});
+  El::Matrix<uint8_t> encoded(encoded_buf.size(), 1,
+                              encoded_buf.data(), encoded_buf.size());
+
+  lbann::transform::transform_pipeline p;
+  p.add_transform(lbann::make_unique<lbann::transform::resize>(56, 56));
+  p.add_transform(lbann::make_unique<lbann::transform::to_lbann_layout>());
+
+  lbann::CPUMat full_out(3*56*56, 1), reduced_out(3*56*56, 1);
+  std::vector<size_t> full_dims, reduced_dims;
+  REQUIRE_NOTHROW(p.apply_encoded(encoded, full_out, full_dims));
+  p.set_reduced_resolution_decode(true);
+  REQUIRE_NOTHROW(p.apply_encoded(encoded, reduced_out, reduced_dims));
+
+  SECTION("reduced decode produces correct dims") {
+    REQUIRE(full_dims == std::vector<size_t>({3, 56, 56}));
+    REQUIRE(reduced_dims == full_dims);
+  }
+  SECTION("reduced decode is close to full decode") {
+    double diff = 0;
+    for (El::Int i = 0; i < full_out.Height(); ++i) {
+      diff += std::fabs(full_out(i, 0) - reduced_out(i, 0));
+    }
+    REQUIRE(diff / full_out.Height() < 0.02);
+  }
+}
+
+TEST_CASE("Testing reduced decode with non-JPEG images", "[preproc]") {
+  // PNG images are always decoded at full resolution, so the random
+  // crop must match the one from the normal path.
+  const El::Int height = 240, width = 320;
+  El::Matrix<uint8_t> image;
+  zeros(image, height, width, 3);
+  apply_elementwise(image, height, width, 3,
+                    [](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+                      x = (3*row + 5*col + 101*channel) % 256;
+                    });
+  std::vector<uint8_t> encoded_buf;
+  cv::Mat cv_image(height, width, CV_8UC3, image.Buffer());
+  cv::imencode(".png", cv_image, encoded_buf);
+  El::Matrix<uint8_t> encoded(encoded_buf.size(), 1,
+                              encoded_buf.data(), encoded_buf.size());
+  REQUIRE_FALSE(lbann::is_jpeg_image(encoded));
+
+  lbann::transform::transform_pipeline p;
+  p.add_transform(
+    lbann::make_unique<lbann::transform::random_resized_crop>(24, 24));
+  p.add_transform(lbann::make_unique<lbann::transform::to_lbann_layout>());
+
+  lbann::CPUMat full_out(3*24*24, 1), reduced_out(3*24*24, 1);
+  std::vector<size_t> full_dims, reduced_dims;
+  const auto gen_state = lbann::get_fast_io_generator();
+  REQUIRE_NOTHROW(p.apply_encoded(encoded, full_out, full_dims));
+  const auto full_gen_state = lbann::get_fast_io_generator();
+  lbann::get_fast_io_generator() = gen_state;
+  p.set_reduced_resolution_decode(true);
+  REQUIRE_NOTHROW(p.apply_encoded(encoded, reduced_out, reduced_dims));
+
+  SECTION("random numbers are drawn once") {
+    REQUIRE(lbann::get_fast_io_generator() == full_gen_state);
+  }
+  SECTION("output matches normal decode") {
+    REQUIRE(reduced_dims == full_dims);
+    for (El::Int i = 0; i < full_out.Height(); ++i) {
+      REQUIRE(reduced_out(i, 0) == full_out(i, 0));
+    }
+  }
+}
+
+TEST_CASE("Testing fused vision transform pipeline", "[preproc]") {
+  const El::Int height = 40, width = 50;
+  El::Matrix<uint8_t> image;
+  zeros(image, height, width, 3);
+  apply_elementwise(image, height, width, 3,
+                    [](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+                      x = (7*row + 13*col + 101*channel) % 256;
+                    });
+  const std::vector<float> means = {0.4f, 0.5f, 0.6f};
+  const std::vector<float> stds = {0.2f, 0.25f, 0.3f};
+
+  // Apply pipeline with and without fusion
+  auto compare = [&](lbann::transform::transform_pipeline& p,
+                     lbann::DataType tolerance) {
+    REQUIRE(p.is_fused());
+    lbann::CPUMat fused_out(3*24*32, 1), unfused_out(3*24*32, 1);
+    std::vector<size_t> fused_dims = {3, height, width};
+    std::vector<size_t> unfused_dims = fused_dims;
+    El::Matrix<uint8_t> fused_in(image), unfused_in(image);
+    REQUIRE_NOTHROW(p.apply(fused_in, fused_out, fused_dims));
+    p.set_fusion(false);
+    REQUIRE_FALSE(p.is_fused());
+    REQUIRE_NOTHROW(p.apply(unfused_in, unfused_out, unfused_dims));
+    REQUIRE(fused_dims == std::vector<size_t>({3, 24, 32}));
+    REQUIRE(unfused_dims == fused_dims);
+    for (El::Int i = 0; i < fused_out.Height(); ++i) {
+      REQUIRE(fused_out(i, 0) == Approx(unfused_out(i, 0)).margin(tolerance));
+    }
+  };
+
+  SECTION("crop, flip, and normalize") {
+    lbann::transform::transform_pipeline p;
+    p.add_transform(lbann::make_unique<lbann::transform::resize>(24, 32));
+    p.add_transform(lbann::make_unique<lbann::transform::horizontal_flip>(1.0f));
+    p.add_transform(
+      lbann::make_unique<lbann::transform::normalize_to_lbann_layout>(means, stds));
+    p.add_transform(lbann::make_unique<lbann::transform::scale>(2.0f));
+    // cv::resize rounds to uint8, so allow one intensity level of error.
+    compare(p, 2.0f / (255.0f * 0.2f));
+  }
+  SECTION("pixel-wise transforms") {
+    lbann::transform::transform_pipeline p;
+    p.add_transform(lbann::make_unique<lbann::transform::resize>(24, 32));
+    p.add_transform(lbann::make_unique<lbann::transform::horizontal_flip>(1.0f));
+    p.add_transform(lbann::make_unique<lbann::transform::adjust_brightness>(1.5f));
+    p.add_transform(lbann::make_unique<lbann::transform::to_lbann_layout>());
+    p.add_transform(lbann::make_unique<lbann::transform::normalize>(means, stds));
+    compare(p, 1e-4f);
+  }
+  SECTION("unsupported transforms are not fused") {
+    lbann::transform::transform_pipeline p;
+    p.add_transform(lbann::make_unique<lbann::transform::resize>(24, 32));
+    p.add_transform(lbann::make_unique<lbann::transform::to_lbann_layout>());
+    p.add_transform(lbann::make_unique<lbann::transform::sample_normalize>());
+    REQUIRE_FALSE(p.is_fused());
+  }
+}
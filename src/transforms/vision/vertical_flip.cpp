@@ -40,5 +40,10 @@ void vertical_flip::apply(utils::type_erased_matrix& data, std::vector<size_t>&
   }
 }
 
+void vertical_flip::plan_flip(bool& horizontal, bool& vertical) const {
+  horizontal = false;
+  vertical = transform::get_bool_random(m_p);
+}
+
 }  // namespace transform
 }  // namespace lbann
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/autotune.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <omp.h>
+
+namespace lbann {
+
+namespace {
+
+/** Replace characters that delimit cache entries. */
+std::string sanitize_key(std::string key) {
+  std::replace(key.begin(), key.end(), '\t', ' ');
+  std::replace(key.begin(), key.end(), '\n', ' ');
+  return key;
+}
+
+} // namespace
+
+autotune_cache::autotune_cache(std::string file_name)
+  : m_file_name(std::move(file_name)) {}
+
+void autotune_cache::load() {
+  if (m_file_name.empty()) { return; }
+  std::ifstream fs(m_file_name.c_str());
+  if (!fs.is_open()) { return; }
+  std::string line;
+  while (std::getline(fs, line)) {
+    const auto key_end = line.find('\t');
+    const auto algo_end = (key_end == std::string::npos ?
+                           std::string::npos :
+                           line.find('\t', key_end + 1));
+    if (algo_end == std::string::npos) { continue; }
+    autotune_choice choice;
+    choice.algorithm = line.substr(key_end + 1, algo_end - key_end - 1);
+    std::istringstream ss(line.substr(algo_end + 1));
+    if (!(ss >> choice.num_threads) || choice.algorithm.empty()) {
+      continue;
+    }
+    m_choices[line.substr(0, key_end)] = choice;
+  }
+}
+
+void autotune_cache::save() const {
+  if (m_file_name.empty()) { return; }
+
+  // Write to a temporary file and rename it so that concurrent jobs
+  // never read a partially written cache
+  const auto tmp_name = m_file_name + ".tmp";
+  std::ofstream fs(tmp_name.c_str());
+  if (!fs.is_open()) {
+    LBANN_ERROR("failed to open autotuning cache file "
+                "(" + tmp_name + ") for writing");
+  }
+  for (const auto& entry : m_choices) {
+    fs << entry.first << '\t'
+       << entry.second.algorithm << '\t'
+       << entry.second.num_threads << '\n';
+  }
+  fs.close();
+  if (std::rename(tmp_name.c_str(), m_file_name.c_str()) != 0) {
+    LBANN_ERROR("failed to write autotuning cache file "
+                "(" + m_file_name + ")");
+  }
+
+}
+
+bool autotune_cache::find(const std::string& key,
+                          autotune_choice& choice) const {
+  const auto& it = m_choices.find(sanitize_key(key));
+  if (it == m_choices.end()) { return false; }
+  choice = it->second;
+  return true;
+}
+
+void autotune_cache::insert(const std::string& key, autotune_choice choice) {
+  m_choices[sanitize_key(key)] = std::move(choice);
+}
+
+std::string get_cpu_model_name() {
+  std::ifstream fs("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(fs, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      const auto pos = line.find(':');
+      if (pos != std::string::npos) {
+        const auto begin = line.find_first_not_of(" \t", pos + 1);
+        if (begin != std::string::npos) { return line.substr(begin); }
+      }
+    }
+  }
+  return "unknown";
+}
+
+std::vector<int> get_autotune_thread_counts(int max_threads) {
+  std::vector<int> counts;
+  for (int n = std::max(max_threads, 1); n > 0; n /= 2) {
+    counts.push_back(n);
+  }
+  return counts;
+}
+
+omp_num_threads_guard::omp_num_threads_guard(int num_threads)
+  : m_prev_num_threads(omp_get_max_threads()) {
+  if (num_threads > 0 && num_threads != m_prev_num_threads) {
+    omp_set_num_threads(num_threads);
+  }
+}
+
+omp_num_threads_guard::~omp_num_threads_guard() {
+  if (omp_get_max_threads() != m_prev_num_threads) {
+    omp_set_num_threads(m_prev_num_threads);
+  }
+}
+
+} // namespace lbann
@@ -26,6 +26,7 @@
 
 #include "lbann/utils/im2col.hpp"
 #include "lbann/utils/exception.hpp"
+#include <algorithm>
 
 namespace lbann {
 
@@ -519,4 +520,229 @@ void col2im_2d(const DataType *__restrict__ input_buffer,
 
 }
 
+namespace {
+
+/** Range of window shifts along one dimension that read valid
+ *  (non-padding) entries for a given window position.
+ *  The range is [first, last], and is empty if first > last.
+ */
+inline void valid_offset_range(int window_pos,
+                               int input_dim,
+                               int input_pad,
+                               int offset_stride,
+                               int offset_num,
+                               int& first,
+                               int& last) {
+  const int lower = input_pad - window_pos;
+  const int upper = input_dim - 1 + input_pad - window_pos;
+  first = lower > 0 ? (lower + offset_stride - 1) / offset_stride : 0;
+  last = upper >= 0 ? std::min(upper / offset_stride, offset_num - 1) : -1;
+}
+
+} // namespace
+
+void im2col_transposed_3d(const DataType *__restrict__ input_buffer,
+                          DataType *__restrict__ output_buffer,
+                          const int output_ldim,
+                          const int input_dim_x,
+                          const int input_dim_y,
+                          const int input_dim_z,
+                          const int input_pad_x,
+                          const int input_pad_y,
+                          const int input_pad_z,
+                          const int num_channels,
+                          const int window_dim_x,
+                          const int window_dim_y,
+                          const int window_dim_z,
+                          const int offset_stride_x,
+                          const int offset_stride_y,
+                          const int offset_stride_z,
+                          const int offset_z_begin,
+                          const int offset_z_end) {
+
+  // im2col parameters
+  const int offset_num_x = (input_dim_x + 2 * input_pad_x - window_dim_x) / offset_stride_x + 1;
+  const int offset_num_y = (input_dim_y + 2 * input_pad_y - window_dim_y) / offset_stride_y + 1;
+  const int offset_num_z = (input_dim_z + 2 * input_pad_z - window_dim_z) / offset_stride_z + 1;
+  const El::Int input_slice_size = El::Int(input_dim_x) * input_dim_y;
+  const El::Int input_channel_size = input_slice_size * input_dim_z;
+
+  // Iterate through window positions (output matrix columns)
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE4
+  for (int channel = 0; channel < num_channels; ++channel) {
+    for (int window_pos_z = 0; window_pos_z < window_dim_z; ++window_pos_z) {
+      for (int window_pos_y = 0; window_pos_y < window_dim_y; ++window_pos_y) {
+        for (int window_pos_x = 0; window_pos_x < window_dim_x; ++window_pos_x) {
+          const El::Int output_col = (window_pos_x
+                                      + window_pos_y * window_dim_x
+                                      + window_pos_z * window_dim_x * window_dim_y
+                                      + channel * window_dim_x * window_dim_y * window_dim_z);
+          DataType* __restrict__ out = &output_buffer[output_col * output_ldim];
+          const DataType* __restrict__ in = &input_buffer[channel * input_channel_size];
+
+          // Window shifts that read valid entries
+          int first_x, last_x, first_y, last_y, first_z, last_z;
+          valid_offset_range(window_pos_x, input_dim_x, input_pad_x,
+                             offset_stride_x, offset_num_x, first_x, last_x);
+          valid_offset_range(window_pos_y, input_dim_y, input_pad_y,
+                             offset_stride_y, offset_num_y, first_y, last_y);
+          valid_offset_range(window_pos_z, input_dim_z, input_pad_z,
+                             offset_stride_z, offset_num_z, first_z, last_z);
+          const int valid_begin = std::min(first_x, offset_num_x);
+          const int valid_end = std::max(last_x + 1, valid_begin);
+          const int input_start_x = valid_begin * offset_stride_x - input_pad_x + window_pos_x;
+
+          // Copy one row of window shifts at a time
+          for (int offset_z = offset_z_begin; offset_z < offset_z_end; ++offset_z) {
+            const int input_pos_z = offset_z * offset_stride_z - input_pad_z + window_pos_z;
+            for (int offset_y = 0; offset_y < offset_num_y; ++offset_y) {
+              const int input_pos_y = offset_y * offset_stride_y - input_pad_y + window_pos_y;
+              DataType* __restrict__ out_row = out;
+              out += offset_num_x;
+              if (offset_z < first_z || offset_z > last_z
+                  || offset_y < first_y || offset_y > last_y) {
+                std::fill(out_row, out_row + offset_num_x, DataType(0));
+                continue;
+              }
+              const DataType* __restrict__ in_row = &in[input_pos_z * input_slice_size
+                                                        + input_pos_y * input_dim_x
+                                                        + input_start_x];
+              std::fill(out_row, out_row + valid_begin, DataType(0));
+              if (offset_stride_x == 1) {
+                std::copy(in_row, in_row + (valid_end - valid_begin),
+                          out_row + valid_begin);
+              } else {
+                for (int offset_x = valid_begin; offset_x < valid_end; ++offset_x) {
+                  out_row[offset_x] = in_row[(offset_x - valid_begin) * offset_stride_x];
+                }
+              }
+              std::fill(out_row + valid_end, out_row + offset_num_x, DataType(0));
+            }
+          }
+
+        }
+      }
+    }
+  }
+
+}
+
+void col2im_transposed_3d(const DataType *__restrict__ input_buffer,
+                          const int input_ldim,
+                          DataType *__restrict__ output_buffer,
+                          const int output_dim_x,
+                          const int output_dim_y,
+                          const int output_dim_z,
+                          const int output_pad_x,
+                          const int output_pad_y,
+                          const int output_pad_z,
+                          const int num_channels,
+                          const int window_dim_x,
+                          const int window_dim_y,
+                          const int window_dim_z,
+                          const int offset_stride_x,
+                          const int offset_stride_y,
+                          const int offset_stride_z,
+                          const int offset_z_begin,
+                          const int offset_z_end) {
+
+  // col2im parameters
+  const int offset_num_x = (output_dim_x + 2 * output_pad_x - window_dim_x) / offset_stride_x + 1;
+  const int offset_num_y = (output_dim_y + 2 * output_pad_y - window_dim_y) / offset_stride_y + 1;
+  const int offset_num_z = (output_dim_z + 2 * output_pad_z - window_dim_z) / offset_stride_z + 1;
+  const El::Int output_slice_size = El::Int(output_dim_x) * output_dim_y;
+  const El::Int offset_slice_size = El::Int(offset_num_x) * offset_num_y;
+
+  // Iterate through depth slices of output tensor
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (int channel = 0; channel < num_channels; ++channel) {
+    for (int output_pos_z = 0; output_pos_z < output_dim_z; ++output_pos_z) {
+      DataType* __restrict__ out = &output_buffer[(channel * El::Int(output_dim_z)
+                                                   + output_pos_z) * output_slice_size];
+
+      // Iterate through window shifts containing the depth slice
+      for (int window_pos_z = 0; window_pos_z < window_dim_z; ++window_pos_z) {
+        const int shifted_z = output_pos_z + output_pad_z - window_pos_z;
+        if (shifted_z < 0 || shifted_z % offset_stride_z != 0) { continue; }
+        const int offset_z = shifted_z / offset_stride_z;
+        if (offset_z < offset_z_begin || offset_z >= offset_z_end
+            || offset_z >= offset_num_z) { continue; }
+        for (int window_pos_y = 0; window_pos_y < window_dim_y; ++window_pos_y) {
+          for (int window_pos_x = 0; window_pos_x < window_dim_x; ++window_pos_x) {
+            const El::Int input_col = (window_pos_x
+                                       + window_pos_y * window_dim_x
+                                       + window_pos_z * window_dim_x * window_dim_y
+                                       + channel * window_dim_x * window_dim_y * window_dim_z);
+            const DataType* __restrict__ in = &input_buffer[input_col * input_ldim
+                                                            + (offset_z - offset_z_begin) * offset_slice_size];
+
+            // Window shifts that write valid entries
+            int first_x, last_x, first_y, last_y;
+            valid_offset_range(window_pos_x, output_dim_x, output_pad_x,
+                               offset_stride_x, offset_num_x, first_x, last_x);
+            valid_offset_range(window_pos_y, output_dim_y, output_pad_y,
+                               offset_stride_y, offset_num_y, first_y, last_y);
+            if (first_x > last_x) { continue; }
+            const int output_start_x = first_x * offset_stride_x - output_pad_x + window_pos_x;
+
+            // Add one row of window shifts at a time
+            for (int offset_y = first_y; offset_y <= last_y; ++offset_y) {
+              const int output_pos_y = offset_y * offset_stride_y - output_pad_y + window_pos_y;
+              const DataType* __restrict__ in_row = &in[offset_y * offset_num_x + first_x];
+              DataType* __restrict__ out_row = &out[output_pos_y * output_dim_x + output_start_x];
+              const int run_size = last_x - first_x + 1;
+              if (offset_stride_x == 1) {
+                for (int i = 0; i < run_size; ++i) {
+                  out_row[i] += in_row[i];
+                }
+              } else {
+                for (int i = 0; i < run_size; ++i) {
+                  out_row[i * offset_stride_x] += in_row[i];
+                }
+              }
+            }
+
+          }
+        }
+      }
+
+    }
+  }
+
+}
+
+void stack_samples(const DataType *__restrict__ input_buffer,
+                   const El::Int input_ldim,
+                   DataType *__restrict__ output_buffer,
+                   const El::Int output_ldim,
+                   const El::Int num_samples,
+                   const El::Int channel_size,
+                   const int num_channels) {
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int channel = 0; channel < num_channels; ++channel) {
+    for (El::Int sample = 0; sample < num_samples; ++sample) {
+      const auto* in = &input_buffer[sample * input_ldim + channel * channel_size];
+      auto* out = &output_buffer[sample * channel_size + channel * output_ldim];
+      std::copy(in, in + channel_size, out);
+    }
+  }
+}
+
+void unstack_samples(const DataType *__restrict__ input_buffer,
+                     const El::Int input_ldim,
+                     DataType *__restrict__ output_buffer,
+                     const El::Int output_ldim,
+                     const El::Int num_samples,
+                     const El::Int channel_size,
+                     const int num_channels) {
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto* in = &input_buffer[sample * channel_size + channel * input_ldim];
+      auto* out = &output_buffer[sample * output_ldim + channel * channel_size];
+      std::copy(in, in + channel_size, out);
+    }
+  }
+}
+
 }  // namespace lbann
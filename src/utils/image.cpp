@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <arpa/inet.h>
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <sstream>
 #include "lbann/utils/image.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -96,7 +98,8 @@ void guess_image_size(const El::Matrix<uint8_t>& buf_, size_t size,
           memcpy(h_w, &buf[cur_pos], 4);
           height = ntohs(h_w[0]);
           width = ntohs(h_w[1]);
-          channels = 3;  // Assume color.
+          // Number of components; anything but grayscale decodes to color.
+          channels = buf[cur_pos + 4] == 1 ? 1 : 3;
           return;
         } else {
           cur_pos += 2;
@@ -132,9 +135,30 @@ void guess_image_size(const El::Matrix<uint8_t>& buf_, size_t size,
   // Give up.
 }
 
+// Check whether buf holds a JPEG image.
+bool is_jpeg(const El::Matrix<uint8_t>& buf_, size_t size) {
+  const uint8_t* buf = buf_.LockedBuffer();
+  return size >= 2 && buf[0] == 0xFF && buf[1] == 0xD8;
+}
+
+// Get OpenCV flags to decode a JPEG at 1/scale resolution.
+int get_reduced_decode_flags(size_t scale, size_t channels) {
+  const bool gray = channels == 1;
+  switch (scale) {
+  case 2: return gray ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+  case 4: return gray ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+  case 8: return gray ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+  default:
+    LBANN_ERROR("Unsupported decode scale " + std::to_string(scale));
+  }
+  return 0;
+}
+
 // Decode an image from a buffer using OpenCV.
+// If scale is greater than 1, JPEGs are decoded at reduced resolution.
 void opencv_decode(El::Matrix<uint8_t>& buf, El::Matrix<uint8_t>& dst,
-                   std::vector<size_t>& dims, const std::string filename) {
+                   std::vector<size_t>& dims, const std::string filename,
+                   size_t scale = 1) {
   const size_t encoded_size = buf.Height() * buf.Width();
   std::vector<size_t> buf_dims = {1, encoded_size, 1};
   cv::Mat cv_encoded = utils::get_opencv_mat(buf, buf_dims);
@@ -142,15 +166,20 @@ void opencv_decode(El::Matrix<uint8_t>& buf, El::Matrix<uint8_t>& dst,
   // Warning: These may be wrong.
   size_t height, width, channels;
   guess_image_size(buf, encoded_size, height, width, channels);
+  int flags = cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH;
+  if (scale > 1 && is_jpeg(buf, encoded_size) && height != 0) {
+    // libjpeg scales in the DCT domain and rounds dimensions up.
+    flags = get_reduced_decode_flags(scale, channels);
+    height = (height + scale - 1) / scale;
+    width = (width + scale - 1) / scale;
+  }
   if (height != 0) {
     // We have a guess.
     dst.Resize(height*width*channels, 1);
     std::vector<size_t> guessed_dims = {channels, height, width};
     // Decode the image.
     cv::Mat cv_dst = utils::get_opencv_mat(dst, guessed_dims);
-    cv::Mat real_decoded = cv::imdecode(cv_encoded,
-                                        cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH,
-                                        &cv_dst);
+    cv::Mat real_decoded = cv::imdecode(cv_encoded, flags, &cv_dst);
     // For now we only support 8-bit 1- or 3-channel images.
     if (real_decoded.type() != CV_8UC1 && real_decoded.type() != CV_8UC3) {
       LBANN_ERROR("Only support 8-bit 1- or 3-channel images, cannot load " + filename);
@@ -165,8 +194,7 @@ void opencv_decode(El::Matrix<uint8_t>& buf, El::Matrix<uint8_t>& dst,
       real_decoded.copyTo(cv_dst);
     }
   } else {
-    cv::Mat decoded = cv::imdecode(cv_encoded,
-                                   cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH);
+    cv::Mat decoded = cv::imdecode(cv_encoded, flags);
     if (decoded.type() != CV_8UC1 && decoded.type() != CV_8UC3) {
       LBANN_ERROR("Only support 8-bit 1- or 3-channel images, cannot load " + filename);
     }
@@ -196,6 +224,60 @@ void decode_image(El::Matrix<uint8_t>& src, El::Matrix<uint8_t>& dst,
   opencv_decode(src, dst, dims, "encoded image");
 }
 
+void load_encoded_image(const std::string& filename, El::Matrix<uint8_t>& dst) {
+  size_t encoded_size;
+  read_file_to_buf(filename, dst, encoded_size);
+}
+
+bool get_encoded_image_dims(const El::Matrix<uint8_t>& src,
+                            std::vector<size_t>& dims) {
+  size_t height, width, channels;
+  guess_image_size(src, src.Height() * src.Width(), height, width, channels);
+  if (height == 0 || width == 0) {
+    return false;
+  }
+  dims = {channels, height, width};
+  return true;
+}
+
+bool is_jpeg_image(const El::Matrix<uint8_t>& src) {
+  return is_jpeg(src, src.Height() * src.Width());
+}
+
+void decode_image(El::Matrix<uint8_t>& src, El::Matrix<uint8_t>& dst,
+                  std::vector<size_t>& dims, size_t scale) {
+  opencv_decode(src, dst, dims, "encoded image", scale);
+}
+
+void crop_and_resize(El::Matrix<uint8_t>& src,
+                     const std::vector<size_t>& dims,
+                     size_t x, size_t y, size_t h, size_t w,
+                     El::Matrix<uint8_t>& dst,
+                     size_t out_h, size_t out_w) {
+  cv::Mat cv_src = utils::get_opencv_mat(src, dims);
+  // Sanity check.
+  if (h == 0 || w == 0 ||
+      x >= static_cast<size_t>(cv_src.cols) ||
+      y >= static_cast<size_t>(cv_src.rows) ||
+      (x + w) > static_cast<size_t>(cv_src.cols) ||
+      (y + h) > static_cast<size_t>(cv_src.rows)) {
+    std::stringstream ss;
+    ss << "Bad crop dimensions for " << cv_src.rows << "x" << cv_src.cols
+       << ": " << h << "x" << w << " at (" << x << "," << y << ")";
+    LBANN_ERROR(ss.str());
+  }
+  std::vector<size_t> new_dims = {dims[0], out_h, out_w};
+  dst.Resize(utils::get_linearized_size(new_dims), 1);
+  cv::Mat cv_dst = utils::get_opencv_mat(dst, new_dims);
+  // The crop is just a view.
+  cv::Mat tmp = cv_src(cv::Rect(x, y, w, h));
+  cv::resize(tmp, cv_dst, cv_dst.size(), 0, 0, cv::INTER_LINEAR);
+  // Sanity check.
+  if (cv_dst.ptr() != dst.Buffer()) {
+    LBANN_ERROR("Did not resize into dst.");
+  }
+}
+
 void save_image(const std::string& filename, El::Matrix<uint8_t>& src,
                 const std::vector<size_t>& dims) {
   cv::Mat cv_src = utils::get_opencv_mat(src, dims);
@@ -26,6 +26,7 @@
 
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/callbacks/callback_checkpoint.hpp"
+#include "lbann/utils/numa.hpp"
 
 namespace lbann {
 
@@ -43,12 +44,31 @@ std::unique_ptr<thread_pool> construct_io_thread_pool(lbann_comm *comm) {
 
   auto io_threads_offset = free_core_offset(comm);
 
+  // Bind compute and I/O threads to disjoint cores
+  std::vector<int> io_cpus;
+  std::string placement_info;
+  if(opts->get_bool("numa_placement", false)) {
+    const auto& topo = get_cpu_topology();
+    const auto placement = make_thread_placement(topo,
+                                                 get_allowed_cpus(),
+                                                 omp_get_max_threads(),
+                                                 num_io_threads);
+    bind_compute_threads(topo, placement.compute_cpus);
+    io_cpus = placement.io_cpus;
+    placement_info = ", NUMA placement on "
+      + std::to_string(topo.get_num_numa_nodes()) + " node(s)";
+  }
+
   if(comm->am_world_master()) {
     std::cout << "\tNum. I/O Threads: " << num_io_threads <<
-      " (Limited to # Unused Compute Cores or 1)" << std::endl;
+      " (Limited to # Unused Compute Cores or 1" << placement_info << ")" << std::endl;
   }
 
   auto io_thread_pool = make_unique<thread_pool>();
+  if(!io_cpus.empty()) {
+    io_thread_pool->launch_pinned_threads(num_io_threads, io_cpus);
+    return io_thread_pool;
+  }
   io_thread_pool->launch_pinned_threads(num_io_threads, io_threads_offset);
 
   return io_thread_pool;
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/mapped_file.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lbann {
+
+mapped_file::mapped_file(const std::string& path) {
+  open(path);
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+  : m_data(other.m_data),
+    m_size(other.m_size),
+    m_path(std::move(other.m_path)) {
+  other.m_data = nullptr;
+  other.m_size = 0;
+  other.m_path.clear();
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_path, other.m_path);
+  }
+  return *this;
+}
+
+mapped_file::~mapped_file() {
+  close();
+}
+
+void mapped_file::open(const std::string& path) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("could not open " + path + " (" + std::strerror(errno) + ")");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    LBANN_ERROR("could not stat " + path + " (" + std::strerror(errno) + ")");
+  }
+  m_size = st.st_size;
+  if (m_size > 0) {
+    void* ptr = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ::close(fd);
+      m_size = 0;
+      LBANN_ERROR("could not map " + path + " (" + std::strerror(errno) + ")");
+    }
+    m_data = static_cast<const char*>(ptr);
+  }
+  // The mapping stays valid after the file is closed
+  ::close(fd);
+  m_path = path;
+}
+
+void mapped_file::close() {
+  if (m_data != nullptr) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_path.clear();
+}
+
+void mapped_file::advise_sequential() const {
+  if (m_data != nullptr) {
+    madvise(const_cast<char*>(m_data), m_size, MADV_SEQUENTIAL);
+  }
+}
+
+void mapped_file::advise_random() const {
+  if (m_data != nullptr) {
+    madvise(const_cast<char*>(m_data), m_size, MADV_RANDOM);
+  }
+}
+
+void mapped_file::prefetch(size_t offset, size_t length) const {
+  if (m_data != nullptr && offset < m_size) {
+    // madvise requires a page-aligned address
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t begin = offset - offset % page_size;
+    const size_t end = std::min(offset + length, m_size);
+    madvise(const_cast<char*>(m_data) + begin, end - begin, MADV_WILLNEED);
+  }
+}
+
+void mapped_file::evict() const {
+  if (m_data != nullptr) {
+    madvise(const_cast<char*>(m_data), m_size, MADV_DONTNEED);
+  }
+}
+
+} // namespace lbann
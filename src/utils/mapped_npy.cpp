@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/mapped_npy.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace lbann {
+
+namespace {
+
+/** Read a little-endian integer. */
+template <typename T>
+T read_le(const char* p) {
+  T x;
+  std::memcpy(&x, p, sizeof(T));
+  return x;
+}
+
+/** Convert packed entries to DataType.
+ *  Entries are read with memcpy since .npz members are not
+ *  necessarily aligned. Compilers turn this into unaligned vector
+ *  loads.
+ */
+template <typename T>
+void convert(const char* __restrict__ src,
+             size_t count,
+             DataType scale,
+             DataType* __restrict__ dst) {
+  for (size_t i = 0; i < count; ++i) {
+    T x;
+    std::memcpy(&x, src + i * sizeof(T), sizeof(T));
+    dst[i] = static_cast<DataType>(x) * scale;
+  }
+}
+
+/** Convert packed floating-point entries to DataType. */
+template <typename T>
+void convert_float(const char* __restrict__ src,
+                   size_t count,
+                   DataType* __restrict__ dst) {
+  if (std::is_same<T, DataType>::value) {
+    std::memcpy(dst, src, count * sizeof(T));
+  } else {
+    convert<T>(src, count, DataType(1), dst);
+  }
+}
+
+/** Find the value of a key in a .npy header dictionary. */
+size_t find_header_value(const std::string& header,
+                         const std::string& key,
+                         const std::string& path) {
+  const size_t pos = header.find("'" + key + "'");
+  if (pos == std::string::npos) {
+    LBANN_ERROR("could not find " + key + " in .npy header of " + path);
+  }
+  const size_t colon = header.find(':', pos);
+  if (colon == std::string::npos) {
+    LBANN_ERROR("invalid .npy header in " + path);
+  }
+  return header.find_first_not_of(' ', colon + 1);
+}
+
+} // namespace
+
+void mapped_npy_array::open_npy(const std::string& path) {
+  close();
+  auto file = std::make_shared<mapped_file>(path);
+  file->advise_random();
+  m_file = file;
+  parse_header(0);
+}
+
+bool mapped_npy_array::open_npz(const std::string& path,
+                                const std::string& key) {
+  close();
+  auto file = std::make_shared<mapped_file>(path);
+  const char* data = file->data();
+  const size_t size = file->size();
+  const std::string error_prefix = "invalid .npz file " + path + " ";
+
+  // Find end of central directory record
+  constexpr size_t eocd_size = 22;
+  if (size < eocd_size) {
+    LBANN_ERROR(error_prefix + "(too small)");
+  }
+  size_t eocd = size - eocd_size;
+  const size_t eocd_min = (size > eocd_size + 65535 ?
+                           size - eocd_size - 65535 : 0);
+  while (read_le<uint32_t>(data + eocd) != 0x06054b50) {
+    if (eocd == eocd_min) {
+      LBANN_ERROR(error_prefix + "(no end of central directory)");
+    }
+    --eocd;
+  }
+  uint64_t num_entries = read_le<uint16_t>(data + eocd + 10);
+  uint64_t cd_offset = read_le<uint32_t>(data + eocd + 16);
+  if (eocd >= 20 && read_le<uint32_t>(data + eocd - 20) == 0x07064b50) {
+    // Zip64 end of central directory record
+    const uint64_t eocd64 = read_le<uint64_t>(data + eocd - 20 + 8);
+    if (eocd64 + 56 > size
+        || read_le<uint32_t>(data + eocd64) != 0x06064b50) {
+      LBANN_ERROR(error_prefix + "(bad zip64 record)");
+    }
+    num_entries = read_le<uint64_t>(data + eocd64 + 32);
+    cd_offset = read_le<uint64_t>(data + eocd64 + 48);
+  }
+
+  // Find member in central directory
+  const std::string name = key + ".npy";
+  size_t pos = cd_offset;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    if (pos + 46 > size || read_le<uint32_t>(data + pos) != 0x02014b50) {
+      LBANN_ERROR(error_prefix + "(bad central directory)");
+    }
+    const uint16_t method = read_le<uint16_t>(data + pos + 10);
+    const uint16_t name_len = read_le<uint16_t>(data + pos + 28);
+    const uint16_t extra_len = read_le<uint16_t>(data + pos + 30);
+    const uint16_t comment_len = read_le<uint16_t>(data + pos + 32);
+    const char* entry_name = data + pos + 46;
+    if (name_len == name.size()
+        && std::memcmp(entry_name, name.data(), name_len) == 0) {
+      if (method != 0) {
+        // Member is compressed
+        return false;
+      }
+      uint64_t local_offset = read_le<uint32_t>(data + pos + 42);
+      if (local_offset == 0xFFFFFFFF) {
+        // Offset is in zip64 extra field, after any 64-bit sizes
+        const char* extra = entry_name + name_len;
+        const char* extra_end = extra + extra_len;
+        while (extra + 4 <= extra_end
+               && read_le<uint16_t>(extra) != 0x0001) {
+          extra += 4 + read_le<uint16_t>(extra + 2);
+        }
+        if (extra + 4 > extra_end) {
+          LBANN_ERROR(error_prefix + "(missing zip64 offset)");
+        }
+        size_t field = 4;
+        if (read_le<uint32_t>(data + pos + 24) == 0xFFFFFFFF) { field += 8; }
+        if (read_le<uint32_t>(data + pos + 20) == 0xFFFFFFFF) { field += 8; }
+        local_offset = read_le<uint64_t>(extra + field);
+      }
+      if (local_offset + 30 > size
+          || read_le<uint32_t>(data + local_offset) != 0x04034b50) {
+        LBANN_ERROR(error_prefix + "(bad local header for " + name + ")");
+      }
+      const size_t data_offset = (local_offset + 30
+                                  + read_le<uint16_t>(data + local_offset + 26)
+                                  + read_le<uint16_t>(data + local_offset + 28));
+      file->advise_random();
+      m_file = file;
+      parse_header(data_offset);
+      return true;
+    }
+    pos += 46 + name_len + extra_len + comment_len;
+  }
+  return false;
+}
+
+void mapped_npy_array::close() {
+  m_file.reset();
+  m_data_offset = 0;
+  m_type = 0;
+  m_word_size = 0;
+  m_shape.clear();
+  m_row_size = 0;
+}
+
+void mapped_npy_array::parse_header(size_t offset) {
+  const char* data = m_file->data();
+  const size_t size = m_file->size();
+  const std::string& path = m_file->path();
+
+  // Magic string and version
+  if (offset + 10 > size || std::memcmp(data + offset, "\x93NUMPY", 6) != 0) {
+    LBANN_ERROR(path + " is not a .npy file");
+  }
+  const int major_version = data[offset + 6];
+  size_t header_offset, header_size;
+  if (major_version == 1) {
+    header_offset = offset + 10;
+    header_size = read_le<uint16_t>(data + offset + 8);
+  } else if (major_version == 2 || major_version == 3) {
+    header_offset = offset + 12;
+    header_size = (offset + 12 <= size ?
+                   read_le<uint32_t>(data + offset + 8) : size);
+  } else {
+    LBANN_ERROR("unsupported .npy version " + std::to_string(major_version)
+                + " in " + path);
+  }
+  if (header_offset + header_size > size) {
+    LBANN_ERROR("truncated .npy header in " + path);
+  }
+  const std::string header(data + header_offset, header_size);
+
+  // Data type
+  size_t pos = find_header_value(header, "descr", path);
+  if (pos == std::string::npos || pos + 4 > header.size()
+      || (header[pos] != '\'' && header[pos] != '"')) {
+    LBANN_ERROR("unsupported .npy data type in " + path);
+  }
+  const char byte_order = header[pos + 1];
+  m_type = header[pos + 2];
+  m_word_size = std::strtoul(header.c_str() + pos + 3, nullptr, 10);
+  if (byte_order == '>' && m_word_size > 1) {
+    LBANN_ERROR("big-endian .npy data in " + path + " is not supported");
+  }
+  const bool supported_type
+    = ((m_type == 'f' && (m_word_size == 4 || m_word_size == 8))
+       || ((m_type == 'i' || m_type == 'u')
+           && (m_word_size == 1 || m_word_size == 2
+               || m_word_size == 4 || m_word_size == 8))
+       || (m_type == 'b' && m_word_size == 1));
+  if (!supported_type) {
+    LBANN_ERROR("unsupported .npy data type "
+                + header.substr(pos, header.find(header[pos], pos + 1) - pos + 1)
+                + " in " + path);
+  }
+
+  // Memory order
+  pos = find_header_value(header, "fortran_order", path);
+  const bool fortran_order = header.compare(pos, 4, "True") == 0;
+
+  // Shape
+  pos = find_header_value(header, "shape", path);
+  const size_t shape_end = header.find(')', pos);
+  if (pos == std::string::npos || header[pos] != '('
+      || shape_end == std::string::npos) {
+    LBANN_ERROR("invalid .npy shape in " + path);
+  }
+  m_shape.clear();
+  for (++pos; pos < shape_end; ) {
+    char* end;
+    const unsigned long long dim = std::strtoull(header.c_str() + pos, &end, 10);
+    if (end == header.c_str() + pos) { break; }
+    m_shape.push_back(dim);
+    pos = header.find(',', end - header.c_str());
+    if (pos == std::string::npos || pos > shape_end) { break; }
+    ++pos;
+  }
+  if (fortran_order && m_shape.size() > 1) {
+    LBANN_ERROR("fortran order .npy data in " + path + " is not supported");
+  }
+  m_row_size = 1;
+  for (size_t i = 1; i < m_shape.size(); ++i) {
+    m_row_size *= m_shape[i];
+  }
+
+  // Make sure the data is in the file
+  m_data_offset = header_offset + header_size;
+  if (m_data_offset + get_num_rows() * m_row_size * m_word_size > size) {
+    LBANN_ERROR("truncated .npy data in " + path);
+  }
+
+}
+
+void mapped_npy_array::copy_row(size_t row,
+                                size_t first,
+                                size_t count,
+                                DataType* out,
+                                DataType scale) const {
+  if (m_file == nullptr) {
+    LBANN_ERROR("attempted to read from an unmapped numpy array");
+  }
+  if (row >= get_num_rows() || first + count > m_row_size) {
+    LBANN_ERROR("attempted to read entries " + std::to_string(first)
+                + "-" + std::to_string(first + count) + " of row "
+                + std::to_string(row) + " of " + m_file->path()
+                + ", which has " + std::to_string(get_num_rows())
+                + " rows of " + std::to_string(m_row_size) + " entries");
+  }
+  const char* src = (m_file->data() + m_data_offset
+                     + (row * m_row_size + first) * m_word_size);
+  switch (m_type) {
+  case 'f':
+    if (m_word_size == 4) { convert_float<float>(src, count, out); }
+    else                  { convert_float<double>(src, count, out); }
+    break;
+  case 'i':
+    switch (m_word_size) {
+    case 1: convert<int8_t>(src, count, scale, out);  break;
+    case 2: convert<int16_t>(src, count, scale, out); break;
+    case 4: convert<int32_t>(src, count, scale, out); break;
+    default: convert<int64_t>(src, count, scale, out);
+    }
+    break;
+  case 'u':
+  case 'b':
+    switch (m_word_size) {
+    case 1: convert<uint8_t>(src, count, scale, out);  break;
+    case 2: convert<uint16_t>(src, count, scale, out); break;
+    case 4: convert<uint32_t>(src, count, scale, out); break;
+    default: convert<uint64_t>(src, count, scale, out);
+    }
+    break;
+  }
+}
+
+void mapped_npy_array::prefetch_rows(const std::vector<int>& indices) const {
+  if (m_file == nullptr || indices.empty()) { return; }
+  std::vector<int> rows(indices);
+  std::sort(rows.begin(), rows.end());
+  const size_t row_bytes = m_row_size * m_word_size;
+  size_t begin = 0;
+  for (size_t i = 1; i <= rows.size(); ++i) {
+    if (i == rows.size() || rows[i] > rows[i-1] + 1) {
+      m_file->prefetch(m_data_offset + rows[begin] * row_bytes,
+                       (rows[i-1] - rows[begin] + 1) * row_bytes);
+      begin = i;
+    }
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/node_shared_buffer.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+
+namespace lbann {
+
+node_shared_buffer::~node_shared_buffer() {
+  free();
+}
+
+void node_shared_buffer::split_node_comm(const El::mpi::Comm& c) {
+  free();
+  MPI_Comm_split_type(c.GetMPIComm(), MPI_COMM_TYPE_SHARED,
+                      El::mpi::Rank(c), MPI_INFO_NULL, &m_node_comm);
+  MPI_Comm_rank(m_node_comm, &m_rank_in_node);
+}
+
+void node_shared_buffer::create_window(const std::vector<size_t>& segment_sizes) {
+  m_segment_offsets.assign(1, 0);
+  for (const auto& sz : segment_sizes) {
+    m_segment_offsets.push_back(m_segment_offsets.back() + sz);
+  }
+  m_size = m_segment_offsets.back();
+
+  // Segments are contiguous, so the buffer starts at the first one
+  void* base = nullptr;
+  const MPI_Aint local_size = segment_sizes[m_rank_in_node];
+  if (MPI_Win_allocate_shared(local_size, 1, MPI_INFO_NULL, m_node_comm,
+                              &base, &m_win) != MPI_SUCCESS) {
+    MPI_Comm_free(&m_node_comm);
+    LBANN_ERROR("failed to allocate " + std::to_string(m_size)
+                + " bytes of node-shared memory");
+  }
+  MPI_Aint root_size;
+  int disp_unit;
+  MPI_Win_shared_query(m_win, 0, &root_size, &disp_unit, &base);
+  m_data = static_cast<char*>(base);
+
+  // Allow direct loads and stores for the lifetime of the window
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, m_win);
+}
+
+void node_shared_buffer::allocate(const El::mpi::Comm& c, size_t size) {
+  split_node_comm(c);
+  int procs_in_node;
+  MPI_Comm_size(m_node_comm, &procs_in_node);
+
+  // Only the node root contributes memory to the window
+  std::vector<size_t> segment_sizes(procs_in_node, 0);
+  segment_sizes[0] = size;
+  create_window(segment_sizes);
+}
+
+void node_shared_buffer::allocate_segments(const El::mpi::Comm& c,
+                                           size_t local_size) {
+  split_node_comm(c);
+  int procs_in_node;
+  MPI_Comm_size(m_node_comm, &procs_in_node);
+  std::vector<size_t> segment_sizes(procs_in_node);
+  unsigned long long send = local_size;
+  std::vector<unsigned long long> recv(procs_in_node);
+  MPI_Allgather(&send, 1, MPI_UNSIGNED_LONG_LONG,
+                recv.data(), 1, MPI_UNSIGNED_LONG_LONG, m_node_comm);
+  std::copy(recv.begin(), recv.end(), segment_sizes.begin());
+  create_window(segment_sizes);
+}
+
+void node_shared_buffer::free() {
+  if (m_win != MPI_WIN_NULL) {
+    MPI_Win_unlock_all(m_win);
+    MPI_Win_free(&m_win);
+  }
+  if (m_node_comm != MPI_COMM_NULL) {
+    MPI_Comm_free(&m_node_comm);
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_rank_in_node = 0;
+  m_segment_offsets.clear();
+}
+
+void node_shared_buffer::barrier() const {
+  MPI_Win_sync(m_win);
+  MPI_Barrier(m_node_comm);
+  MPI_Win_sync(m_win);
+}
+
+} // namespace lbann
@@ -0,0 +1,427 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/numa.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#ifdef LBANN_GNU_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // LBANN_GNU_LINUX
+
+namespace lbann {
+
+namespace {
+
+/** Read the first line of a file.
+ *  Returns false if the file cannot be read.
+ */
+bool read_line(const std::string& path, std::string& line) {
+  std::ifstream fs(path.c_str());
+  return fs.is_open() && std::getline(fs, line);
+}
+
+/** Read an integer from a file, or return a default value. */
+int read_int(const std::string& path, int default_value) {
+  std::string line;
+  int value;
+  if (read_line(path, line) && (std::istringstream(line) >> value)) {
+    return value;
+  }
+  return default_value;
+}
+
+/** Number of distinct non-negative entries. */
+int count_distinct(const std::vector<int>& values) {
+  std::set<int> distinct;
+  for (const auto& v : values) {
+    if (v >= 0) { distinct.insert(v); }
+  }
+  return distinct.size();
+}
+
+#if defined(LBANN_GNU_LINUX) && defined(SYS_move_pages)
+/** Thread that processes an entry in a static OpenMP schedule.
+ *  Matches the default static schedule, where the first size %
+ *  num_threads threads get one extra entry.
+ */
+size_t static_schedule_thread(size_t index, size_t size, size_t num_threads) {
+  const size_t chunk = size / num_threads;
+  const size_t num_large = size % num_threads;
+  if (index < num_large * (chunk + 1)) {
+    return index / (chunk + 1);
+  } else {
+    return num_large + (index - num_large * (chunk + 1)) / chunk;
+  }
+}
+#endif // defined(LBANN_GNU_LINUX) && defined(SYS_move_pages)
+
+} // namespace
+
+int cpu_topology::get_num_sockets() const {
+  return count_distinct(cpu_sockets);
+}
+
+int cpu_topology::get_num_cores() const {
+  return count_distinct(cpu_cores);
+}
+
+int cpu_topology::get_num_numa_nodes() const {
+  return count_distinct(cpu_numa_nodes);
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> cpus;
+  std::istringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    int first, last;
+    char dash;
+    std::istringstream range_ss(range);
+    if (!(range_ss >> first)) { continue; }
+    if (range_ss >> dash >> last && dash == '-') {
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } else {
+      cpus.push_back(first);
+    }
+  }
+  return cpus;
+}
+
+cpu_topology detect_cpu_topology(const std::string& sysfs_root) {
+  const std::string cpu_dir = sysfs_root + "/devices/system/cpu/";
+  const std::string node_dir = sysfs_root + "/devices/system/node/";
+
+  // Online CPUs
+  std::string line;
+  std::vector<int> cpus;
+  if (read_line(cpu_dir + "online", line)) {
+    cpus = parse_cpu_list(line);
+  }
+  if (cpus.empty()) {
+    const int num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+    for (int cpu = 0; cpu < num_cpus; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  const int num_cpus = *std::max_element(cpus.begin(), cpus.end()) + 1;
+  cpu_topology topo;
+  topo.cpu_sockets.assign(num_cpus, -1);
+  topo.cpu_cores.assign(num_cpus, -1);
+  topo.cpu_numa_nodes.assign(num_cpus, -1);
+
+  // Sockets and physical cores
+  // Note: Core ids are only unique within a socket.
+  std::map<std::pair<int,int>, int> core_ids;
+  for (const auto& cpu : cpus) {
+    const auto& topo_dir = cpu_dir + "cpu" + std::to_string(cpu) + "/topology/";
+    const int socket = std::max(read_int(topo_dir + "physical_package_id", 0), 0);
+    const int core = read_int(topo_dir + "core_id", -1 - cpu);
+    const auto& key = std::make_pair(socket, core);
+    if (core_ids.count(key) == 0) {
+      const int id = core_ids.size();
+      core_ids[key] = id;
+    }
+    topo.cpu_sockets[cpu] = socket;
+    topo.cpu_cores[cpu] = core_ids[key];
+  }
+
+  // NUMA nodes
+  std::vector<int> nodes;
+  if (read_line(node_dir + "online", line)) {
+    nodes = parse_cpu_list(line);
+  }
+  for (const auto& node : nodes) {
+    if (!read_line(node_dir + "node" + std::to_string(node) + "/cpulist", line)) {
+      continue;
+    }
+    for (const auto& cpu : parse_cpu_list(line)) {
+      if (cpu < num_cpus && topo.cpu_sockets[cpu] >= 0) {
+        topo.cpu_numa_nodes[cpu] = node;
+      }
+    }
+  }
+  for (const auto& cpu : cpus) {
+    if (topo.cpu_numa_nodes[cpu] < 0) {
+      topo.cpu_numa_nodes[cpu] = 0;
+    }
+  }
+
+  return topo;
+}
+
+const cpu_topology& get_cpu_topology() {
+  static const cpu_topology topo = detect_cpu_topology();
+  return topo;
+}
+
+std::vector<int> get_allowed_cpus() {
+  std::vector<int> cpus;
+#ifdef LBANN_GNU_LINUX
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif // LBANN_GNU_LINUX
+  if (cpus.empty()) {
+    const int num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+    for (int cpu = 0; cpu < num_cpus; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+thread_placement make_thread_placement(const cpu_topology& topo,
+                                       const std::vector<int>& allowed_cpus,
+                                       int num_compute_threads,
+                                       int num_io_threads) {
+  thread_placement placement;
+  if (allowed_cpus.empty() || num_compute_threads < 1) { return placement; }
+
+  // Group allowed CPUs by physical core and cores by NUMA node
+  // Note: CPUs with unknown topology are treated as separate cores.
+  std::map<int, std::vector<int>> core_cpus;
+  for (const auto& cpu : allowed_cpus) {
+    const int core = (cpu < topo.get_num_cpus() && topo.cpu_cores[cpu] >= 0 ?
+                      topo.cpu_cores[cpu] : -1 - cpu);
+    core_cpus[core].push_back(cpu);
+  }
+  std::map<int, std::vector<int>> node_cores;
+  for (const auto& entry : core_cpus) {
+    const int node = std::max(topo.get_numa_node(entry.second.front()), 0);
+    node_cores[node].push_back(entry.first);
+  }
+
+  // Order cores so that any prefix is spread evenly over NUMA nodes
+  std::vector<int> core_order;
+  for (size_t i = 0; core_order.size() < core_cpus.size(); ++i) {
+    for (const auto& entry : node_cores) {
+      if (i < entry.second.size()) {
+        core_order.push_back(entry.second[i]);
+      }
+    }
+  }
+
+  // Compute threads use the first hardware thread of as many cores
+  // as possible, then hyperthread siblings on those cores
+  const size_t num_compute_cores = std::min(core_order.size(),
+                                            size_t(num_compute_threads));
+  for (size_t sibling = 0;
+       placement.compute_cpus.size() < size_t(num_compute_threads);
+       ++sibling) {
+    bool found = false;
+    for (size_t i = 0; i < num_compute_cores; ++i) {
+      const auto& cpus = core_cpus[core_order[i]];
+      if (sibling < cpus.size()
+          && placement.compute_cpus.size() < size_t(num_compute_threads)) {
+        placement.compute_cpus.push_back(cpus[sibling]);
+        found = true;
+      }
+    }
+    if (!found) { break; }
+  }
+
+  // Group compute threads by NUMA node, so that neighboring threads
+  // in a static schedule share memory
+  auto node_order = [&topo] (int a, int b) {
+    return (std::make_tuple(topo.get_numa_node(a), a)
+            < std::make_tuple(topo.get_numa_node(b), b));
+  };
+  std::sort(placement.compute_cpus.begin(),
+            placement.compute_cpus.end(),
+            node_order);
+
+  // I/O threads use free cores, then free hyperthread siblings
+  const std::set<int> compute_set(placement.compute_cpus.begin(),
+                                  placement.compute_cpus.end());
+  std::vector<int> free_core_cpus, free_sibling_cpus;
+  for (size_t sibling = 0; ; ++sibling) {
+    bool found = false;
+    for (size_t i = 0; i < core_order.size(); ++i) {
+      const auto& cpus = core_cpus[core_order[i]];
+      if (sibling >= cpus.size()) { continue; }
+      found = true;
+      if (compute_set.count(cpus[sibling]) > 0) { continue; }
+      if (i < num_compute_cores) {
+        free_sibling_cpus.push_back(cpus[sibling]);
+      } else {
+        free_core_cpus.push_back(cpus[sibling]);
+      }
+    }
+    if (!found) { break; }
+  }
+  for (const auto* cpus : {&free_core_cpus, &free_sibling_cpus}) {
+    for (const auto& cpu : *cpus) {
+      if (placement.io_cpus.size() < size_t(std::max(num_io_threads, 0))) {
+        placement.io_cpus.push_back(cpu);
+      }
+    }
+  }
+
+  // Reuse compute CPUs if there are not enough allowed CPUs
+  for (size_t i = 0; placement.compute_cpus.size() < size_t(num_compute_threads); ++i) {
+    placement.compute_cpus.push_back(placement.compute_cpus[i]);
+  }
+
+  return placement;
+}
+
+void bind_compute_threads(const cpu_topology& topo,
+                          const std::vector<int>& compute_cpus) {
+#ifdef LBANN_GNU_LINUX
+  if (compute_cpus.empty()) { return; }
+
+  // Compute CPUs in each NUMA node
+  std::map<int, cpu_set_t> node_cpusets;
+  for (const auto& cpu : compute_cpus) {
+    const int node = topo.get_numa_node(cpu);
+    if (node_cpusets.count(node) == 0) {
+      CPU_ZERO(&node_cpusets[node]);
+    }
+    CPU_SET(cpu, &node_cpusets[node]);
+  }
+
+  // Bind each OpenMP thread
+  const int num_omp_threads = omp_get_max_threads();
+  int num_errors = 0;
+  LBANN_OMP_PARALLEL_ARGS(num_threads(num_omp_threads) reduction(+:num_errors))
+  {
+    const int tid = omp_get_thread_num();
+    const int cpu = compute_cpus[tid % compute_cpus.size()];
+    const auto& cpuset = node_cpusets.at(topo.get_numa_node(cpu));
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+      ++num_errors;
+    }
+  }
+  if (num_errors > 0) {
+    LBANN_ERROR("failed to bind " + std::to_string(num_errors)
+                + " OpenMP threads to compute CPUs");
+  }
+#endif // LBANN_GNU_LINUX
+}
+
+void first_touch(AbsMat& m) {
+  if (m.GetDevice() != El::Device::CPU || m.Viewing()) { return; }
+  // Use a static parallel for rather than LBANN_OMP_PARALLEL_FOR: a
+  // taskloop outside a parallel region would touch every page from
+  // this thread.
+  if (m.Contiguous()) {
+    auto* buffer = m.Buffer();
+    const size_t size = m.Height() * m.Width();
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < size; ++i) {
+      buffer[i] = DataType(0);
+    }
+  } else {
+    auto const width = m.Width();
+    auto const height = m.Height();
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        m(row, col) = DataType(0);
+      }
+    }
+  }
+}
+
+std::vector<int> get_omp_thread_numa_nodes(const cpu_topology& topo) {
+  const int num_omp_threads = omp_get_max_threads();
+  std::vector<int> nodes(num_omp_threads, -1);
+#ifdef LBANN_GNU_LINUX
+  LBANN_OMP_PARALLEL_ARGS(num_threads(num_omp_threads))
+  {
+    nodes[omp_get_thread_num()] = topo.get_numa_node(sched_getcpu());
+  }
+#endif // LBANN_GNU_LINUX
+  return nodes;
+}
+
+void count_remote_pages(const void* buffer,
+                        size_t size,
+                        const std::vector<int>& thread_nodes,
+                        size_t& num_pages,
+                        size_t& num_remote_pages) {
+#if defined(LBANN_GNU_LINUX) && defined(SYS_move_pages)
+  if (buffer == nullptr || size == 0 || thread_nodes.empty()) { return; }
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const auto begin = reinterpret_cast<uintptr_t>(buffer);
+  const auto end = begin + size;
+
+  // Query NUMA node of pages in batches
+  // Note: move_pages with no target nodes reports the node of each
+  // page, or a negative error code if it is not resident.
+  constexpr size_t batch_size = 1024;
+  std::vector<void*> pages;
+  std::vector<int> status(batch_size);
+  pages.reserve(batch_size);
+  for (uintptr_t batch_begin = begin - begin % page_size;
+       batch_begin < end;
+       batch_begin += batch_size * page_size) {
+    pages.clear();
+    for (uintptr_t page = batch_begin;
+         page < end && pages.size() < batch_size;
+         page += page_size) {
+      pages.push_back(reinterpret_cast<void*>(page));
+    }
+    if (syscall(SYS_move_pages, 0, pages.size(), pages.data(),
+                nullptr, status.data(), 0) != 0) {
+      return;
+    }
+    for (size_t i = 0; i < pages.size(); ++i) {
+      if (status[i] < 0) { continue; }
+      const auto page = reinterpret_cast<uintptr_t>(pages[i]);
+      const size_t offset = std::max(page, begin) - begin;
+      const auto thread = static_schedule_thread(offset, size, thread_nodes.size());
+      const int node = thread_nodes[thread];
+      ++num_pages;
+      if (node >= 0 && node != status[i]) {
+        ++num_remote_pages;
+      }
+    }
+  }
+#endif // defined(LBANN_GNU_LINUX) && defined(SYS_move_pages)
+}
+
+} // namespace lbann
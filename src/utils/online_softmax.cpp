@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/online_softmax.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace lbann {
+
+namespace {
+
+/** Number of entries processed per block. */
+constexpr El::Int block_size = 64;
+
+} // namespace
+
+void online_softmax_stats(const DataType* x,
+                          El::Int size,
+                          DataType& max,
+                          DataType& sum) {
+  max = std::numeric_limits<DataType>::lowest();
+  sum = DataType(0);
+  for (El::Int start = 0; start < size; start += block_size) {
+    const El::Int end = std::min(start + block_size, size);
+
+    // Rescale running sum if block has a larger maximum
+    DataType block_max = max;
+    for (El::Int i = start; i < end; ++i) {
+      block_max = std::max(block_max, x[i]);
+    }
+    if (block_max > max) {
+      sum *= std::exp(max - block_max);
+      max = block_max;
+    }
+
+    // Accumulate exponentials
+    DataType block_sum = DataType(0);
+    for (El::Int i = start; i < end; ++i) {
+      block_sum += std::exp(x[i] - max);
+    }
+    sum += block_sum;
+
+  }
+}
+
+void softmax_stats_op(void* in, void* inout, int* len, MPI_Datatype* type) {
+  int type_size;
+  MPI_Type_size(*type, &type_size);
+  const int tuple_size = type_size / sizeof(DataType);
+  const auto* in_stats = static_cast<const DataType*>(in);
+  auto* inout_stats = static_cast<DataType*>(inout);
+  for (int i = 0; i < *len; ++i) {
+    const auto* a = &in_stats[i * tuple_size];
+    auto* b = &inout_stats[i * tuple_size];
+    combine_softmax_stats(b[0], b[1], a[0], a[1]);
+    for (int j = 2; j < tuple_size; ++j) {
+      b[j] += a[j];
+    }
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/packed_dataset.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace lbann {
+
+constexpr char packed_dataset::index_magic[8];
+constexpr uint32_t packed_dataset::format_version;
+constexpr size_t packed_dataset::read_alignment;
+
+namespace {
+
+using file_ptr = std::unique_ptr<std::FILE, int(*)(std::FILE*)>;
+
+file_ptr open_file(const std::string& path, const char* mode) {
+  file_ptr f(std::fopen(path.c_str(), mode), std::fclose);
+  if (f == nullptr) {
+    LBANN_ERROR("could not open " + path + " (" + std::strerror(errno) + ")");
+  }
+  return f;
+}
+
+void read_bytes(std::FILE* f, void* data, size_t size,
+                const std::string& path) {
+  if (size > 0 && std::fread(data, 1, size, f) != size) {
+    LBANN_ERROR("could not read from " + path);
+  }
+}
+
+void write_bytes(std::FILE* f, const void* data, size_t size,
+                 const std::string& path) {
+  if (size > 0 && std::fwrite(data, 1, size, f) != size) {
+    LBANN_ERROR("could not write to " + path);
+  }
+}
+
+size_t align_down(size_t x, size_t alignment) {
+  return x / alignment * alignment;
+}
+
+size_t align_up(size_t x, size_t alignment) {
+  return (x + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+bool packed_dataset::is_index_file(const std::string& path) {
+  file_ptr f(std::fopen(path.c_str(), "rb"), std::fclose);
+  char magic[sizeof(index_magic)];
+  return (f != nullptr
+          && std::fread(magic, 1, sizeof(magic), f.get()) == sizeof(magic)
+          && std::memcmp(magic, index_magic, sizeof(magic)) == 0);
+}
+
+void packed_dataset::write_index(const std::string& path,
+                                 const std::vector<std::string>& shards,
+                                 const std::vector<packed_sample>& samples) {
+  auto f = open_file(path, "wb");
+  header h;
+  std::memcpy(h.magic, index_magic, sizeof(h.magic));
+  h.version = format_version;
+  h.num_shards = shards.size();
+  h.num_samples = samples.size();
+  write_bytes(f.get(), &h, sizeof(h), path);
+  for (const auto& shard : shards) {
+    const uint32_t len = shard.size();
+    write_bytes(f.get(), &len, sizeof(len), path);
+    write_bytes(f.get(), shard.data(), len, path);
+  }
+  write_bytes(f.get(), samples.data(),
+              samples.size() * sizeof(packed_sample), path);
+  if (std::fflush(f.get()) != 0) {
+    LBANN_ERROR("could not write to " + path);
+  }
+}
+
+void packed_dataset::aligned_buffer::resize(size_t new_size) {
+  if (new_size <= size) { return; }
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, read_alignment, new_size) != 0) {
+    LBANN_ERROR("could not allocate " + std::to_string(new_size) + " bytes");
+  }
+  data.reset(static_cast<uint8_t*>(ptr));
+  size = new_size;
+}
+
+packed_dataset::packed_dataset(const std::string& index_path,
+                               bool direct_io,
+                               bool readahead)
+  : m_direct_io(direct_io), m_readahead(readahead) {
+  auto idx = std::make_shared<index>();
+  const auto slash = index_path.find_last_of('/');
+  idx->dir = (slash == std::string::npos ?
+              std::string() :
+              index_path.substr(0, slash + 1));
+
+  auto f = open_file(index_path, "rb");
+  header h;
+  read_bytes(f.get(), &h, sizeof(h), index_path);
+  if (std::memcmp(h.magic, index_magic, sizeof(h.magic)) != 0) {
+    LBANN_ERROR(index_path + " is not a packed dataset index");
+  }
+  if (h.version != format_version) {
+    LBANN_ERROR(index_path + " has unsupported version "
+                + std::to_string(h.version));
+  }
+  idx->shards.resize(h.num_shards);
+  for (auto& shard : idx->shards) {
+    uint32_t len;
+    read_bytes(f.get(), &len, sizeof(len), index_path);
+    shard.resize(len);
+    read_bytes(f.get(), &shard[0], len, index_path);
+  }
+  idx->samples.resize(h.num_samples);
+  read_bytes(f.get(), idx->samples.data(),
+             h.num_samples * sizeof(packed_sample), index_path);
+  for (const auto& s : idx->samples) {
+    if (s.shard >= h.num_shards) {
+      LBANN_ERROR(index_path + " refers to an invalid shard");
+    }
+  }
+
+  m_index = std::move(idx);
+  m_fds.assign(m_index->shards.size(), -1);
+}
+
+packed_dataset::packed_dataset(const packed_dataset& other)
+  : max_gap(other.max_gap),
+    max_read_size(other.max_read_size),
+    m_index(other.m_index),
+    m_direct_io(other.m_direct_io),
+    m_readahead(other.m_readahead),
+    m_fds(other.m_fds.size(), -1) {}
+
+packed_dataset::~packed_dataset() {
+  for (const auto& fd : m_fds) {
+    if (fd >= 0) { close(fd); }
+  }
+}
+
+int packed_dataset::get_fd(uint32_t shard) const {
+  std::lock_guard<std::mutex> lock(m_fds_mutex);
+  int& fd = m_fds[shard];
+  if (fd < 0) {
+    const std::string path = m_index->dir + m_index->shards[shard];
+    int flags = O_RDONLY;
+#ifdef O_DIRECT
+    if (m_direct_io) { flags |= O_DIRECT; }
+#endif // O_DIRECT
+    fd = open(path.c_str(), flags);
+    if (fd < 0) {
+      LBANN_ERROR("could not open " + path + " (" + std::strerror(errno) + ")");
+    }
+#ifdef POSIX_FADV_RANDOM
+    if (!m_direct_io) {
+      // Reads are planned by prefetch, so generic readahead is wasted
+      posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    }
+#endif // POSIX_FADV_RANDOM
+  }
+  return fd;
+}
+
+size_t packed_dataset::read_range(uint32_t shard, uint64_t offset,
+                                  size_t size, uint8_t* buf) const {
+  const int fd = get_fd(shard);
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    const ssize_t r = pread(fd, buf + bytes_read, size - bytes_read,
+                            offset + bytes_read);
+    if (r < 0) {
+      if (errno == EINTR) { continue; }
+      LBANN_ERROR("could not read " + m_index->shards[shard]
+                  + " (" + std::strerror(errno) + ")");
+    }
+    if (r == 0) { break; }
+    bytes_read += r;
+  }
+  return bytes_read;
+}
+
+void packed_dataset::prefetch(const std::vector<size_t>& samples) {
+  m_prefetched.clear();
+  if (samples.empty()) { return; }
+
+  // Sort samples by location
+  std::vector<size_t> order(samples);
+  std::sort(order.begin(), order.end(),
+            [this](size_t a, size_t b) {
+              const auto& sa = get_sample(a);
+              const auto& sb = get_sample(b);
+              return (sa.shard < sb.shard
+                      || (sa.shard == sb.shard && sa.offset < sb.offset));
+            });
+  order.erase(std::unique(order.begin(), order.end()), order.end());
+
+  // Coalesce neighboring samples into aligned reads
+  struct read_op {
+    uint32_t shard;
+    uint64_t offset, size;
+    size_t buffer_pos;
+    size_t first, last;
+  };
+  std::vector<read_op> reads;
+  size_t buffer_size = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const auto& s = get_sample(order[i]);
+    const uint64_t begin = align_down(s.offset, read_alignment);
+    const uint64_t end = align_up(s.offset + s.size, read_alignment);
+    if (!reads.empty()) {
+      auto& r = reads.back();
+      const uint64_t r_end = r.offset + r.size;
+      if (r.shard == s.shard
+          && begin <= r_end + max_gap
+          && std::max(end, r_end) - r.offset <= max_read_size) {
+        buffer_size += std::max(end, r_end) - r_end;
+        r.size = std::max(end, r_end) - r.offset;
+        r.last = i;
+        continue;
+      }
+    }
+    reads.push_back({s.shard, begin, end - begin, buffer_size, i, i});
+    buffer_size += end - begin;
+  }
+
+  // Ask the kernel to start reading everything at once
+#ifdef POSIX_FADV_WILLNEED
+  if (m_readahead && !m_direct_io) {
+    for (const auto& r : reads) {
+      posix_fadvise(get_fd(r.shard), r.offset, r.size, POSIX_FADV_WILLNEED);
+    }
+  }
+#endif // POSIX_FADV_WILLNEED
+
+  // Read data
+  m_buffer.resize(buffer_size);
+  for (const auto& r : reads) {
+    const size_t bytes_read = read_range(r.shard, r.offset, r.size,
+                                         m_buffer.data.get() + r.buffer_pos);
+    for (size_t i = r.first; i <= r.last; ++i) {
+      const auto& s = get_sample(order[i]);
+      if (s.offset + s.size > r.offset + bytes_read) {
+        LBANN_ERROR("unexpected end of " + m_index->shards[r.shard]);
+      }
+      m_prefetched[order[i]] = r.buffer_pos + (s.offset - r.offset);
+    }
+  }
+
+}
+
+uint8_t* packed_dataset::get_prefetched(size_t index) const {
+  const auto it = m_prefetched.find(index);
+  if (it == m_prefetched.end()) { return nullptr; }
+  return m_buffer.data.get() + it->second;
+}
+
+void packed_dataset::read_sample(size_t index, uint8_t* buf) const {
+  const auto& s = get_sample(index);
+  if (!m_direct_io) {
+    if (read_range(s.shard, s.offset, s.size, buf) != s.size) {
+      LBANN_ERROR("unexpected end of " + m_index->shards[s.shard]);
+    }
+    return;
+  }
+  const uint64_t begin = align_down(s.offset, read_alignment);
+  const uint64_t end = align_up(s.offset + s.size, read_alignment);
+  aligned_buffer tmp;
+  tmp.resize(end - begin);
+  const size_t bytes_read = read_range(s.shard, begin, end - begin,
+                                       tmp.data.get());
+  if (s.offset + s.size > begin + bytes_read) {
+    LBANN_ERROR("unexpected end of " + m_index->shards[s.shard]);
+  }
+  std::memcpy(buf, tmp.data.get() + (s.offset - begin), s.size);
+}
+
+} // namespace lbann
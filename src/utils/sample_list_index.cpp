@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/sample_list_index.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace lbann {
+
+namespace {
+
+struct index_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t num_files;
+  uint64_t num_samples;
+  uint64_t file_table_offset;
+  uint64_t sample_table_offset;
+  uint64_t names_offset;
+  uint64_t names_size;
+  uint64_t file_dir_offset;
+  uint64_t file_dir_length;
+};
+
+struct file_record {
+  uint64_t name_offset;
+  uint32_t name_length;
+  uint32_t reserved;
+  uint64_t num_samples;
+};
+
+struct sample_record {
+  uint32_t file_id;
+  uint32_t name_length;
+  uint64_t name_offset;
+};
+
+constexpr char index_magic[8] = "LBSLIDX";
+constexpr uint32_t index_version = 1;
+
+/** Read a record that may not be aligned. */
+template <typename T>
+T read_record(const char* table, size_t i) {
+  T r;
+  std::memcpy(&r, table + i * sizeof(T), sizeof(T));
+  return r;
+}
+
+/** Append a record to a table. */
+template <typename T>
+void append_record(std::vector<char>& table, const T& r) {
+  const char* p = reinterpret_cast<const char*>(&r);
+  table.insert(table.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+void sample_list_index::attach(const char* buf, size_t size,
+                               const std::string& path) {
+  m_path = path;
+  index_header h;
+  if (buf == nullptr || size < sizeof(h)) {
+    LBANN_ERROR("sample list index " + m_path + " is truncated");
+  }
+  std::memcpy(&h, buf, sizeof(h));
+  if (std::memcmp(h.magic, index_magic, sizeof(index_magic)) != 0) {
+    LBANN_ERROR(m_path + " is not a sample list index");
+  }
+  if (h.version != index_version) {
+    LBANN_ERROR("sample list index " + m_path + " has unsupported version "
+                + std::to_string(h.version));
+  }
+  const bool valid
+    = (h.file_table_offset <= size
+       && h.num_files <= (size - h.file_table_offset) / sizeof(file_record)
+       && h.sample_table_offset <= size
+       && h.num_samples <= (size - h.sample_table_offset) / sizeof(sample_record)
+       && h.names_offset <= size
+       && h.names_size <= size - h.names_offset
+       && h.file_dir_offset <= h.names_size
+       && h.file_dir_length <= h.names_size - h.file_dir_offset);
+  if (!valid) {
+    LBANN_ERROR("sample list index " + m_path + " is corrupt");
+  }
+  m_buf = buf;
+  m_size = size;
+  m_num_files = h.num_files;
+  m_num_samples = h.num_samples;
+  m_files = buf + h.file_table_offset;
+  m_samples = buf + h.sample_table_offset;
+  m_names = buf + h.names_offset;
+  m_names_size = h.names_size;
+  m_file_dir_offset = h.file_dir_offset;
+  m_file_dir_length = h.file_dir_length;
+}
+
+std::string sample_list_index::get_name(uint64_t offset, uint64_t length) const {
+  if (offset > m_names_size || length > m_names_size - offset) {
+    LBANN_ERROR("sample list index " + m_path + " is corrupt");
+  }
+  return std::string(m_names + offset, length);
+}
+
+std::string sample_list_index::get_file_dir() const {
+  return get_name(m_file_dir_offset, m_file_dir_length);
+}
+
+void sample_list_index::check_file_id(size_t file_id) const {
+  if (file_id >= m_num_files) {
+    LBANN_ERROR("file id " + std::to_string(file_id)
+                + " is out of range for sample list index " + m_path
+                + " with " + std::to_string(m_num_files) + " files");
+  }
+}
+
+void sample_list_index::check_sample_index(size_t i) const {
+  if (i >= m_num_samples) {
+    LBANN_ERROR("sample " + std::to_string(i)
+                + " is out of range for sample list index " + m_path
+                + " with " + std::to_string(m_num_samples) + " samples");
+  }
+}
+
+std::string sample_list_index::get_file_name(size_t file_id) const {
+  check_file_id(file_id);
+  const auto r = read_record<file_record>(m_files, file_id);
+  return get_name(r.name_offset, r.name_length);
+}
+
+size_t sample_list_index::get_file_num_samples(size_t file_id) const {
+  check_file_id(file_id);
+  return read_record<file_record>(m_files, file_id).num_samples;
+}
+
+size_t sample_list_index::get_sample_file_id(size_t i) const {
+  check_sample_index(i);
+  const size_t file_id = read_record<sample_record>(m_samples, i).file_id;
+  if (file_id >= m_num_files) {
+    LBANN_ERROR("sample list index " + m_path + " is corrupt: sample "
+                + std::to_string(i) + " refers to file "
+                + std::to_string(file_id) + " of "
+                + std::to_string(m_num_files));
+  }
+  return file_id;
+}
+
+std::string sample_list_index::get_sample_name(size_t i) const {
+  check_sample_index(i);
+  const auto r = read_record<sample_record>(m_samples, i);
+  return get_name(r.name_offset, r.name_length);
+}
+
+bool sample_list_index::is_index_file(const std::string& path) {
+  char magic[sizeof(index_magic)];
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  return (ifs.read(magic, sizeof(magic))
+          && std::memcmp(magic, index_magic, sizeof(magic)) == 0);
+}
+
+void sample_list_index::get_slice(size_t num_samples,
+                                  size_t num_slices,
+                                  size_t slice,
+                                  size_t& begin,
+                                  size_t& end) {
+  begin = (num_samples / num_slices) * slice
+    + std::min(slice, num_samples % num_slices);
+  end = begin + num_samples / num_slices
+    + (slice < num_samples % num_slices ? 1 : 0);
+}
+
+sample_list_index_writer::sample_list_index_writer(const std::string& file_dir)
+  : m_file_dir_length(file_dir.size()) {
+  add_name(file_dir);
+}
+
+uint64_t sample_list_index_writer::add_name(const std::string& name) {
+  const uint64_t offset = m_names.size();
+  m_names += name;
+  return offset;
+}
+
+size_t sample_list_index_writer::add_file(const std::string& name,
+                                          size_t num_samples) {
+  if (name.size() > UINT32_MAX) {
+    LBANN_ERROR("file name is too long for a sample list index");
+  }
+  if (m_num_files >= UINT32_MAX) {
+    LBANN_ERROR("too many files for a sample list index");
+  }
+  file_record r;
+  r.name_length = name.size();
+  r.reserved = 0;
+  r.num_samples = num_samples;
+  r.name_offset = add_name(name);
+  append_record(m_files, r);
+  return m_num_files++;
+}
+
+void sample_list_index_writer::add_sample(size_t file_id,
+                                          const std::string& name) {
+  if (file_id >= m_num_files) {
+    LBANN_ERROR("sample added for unknown file " + std::to_string(file_id));
+  }
+  if (name.size() > UINT32_MAX) {
+    LBANN_ERROR("sample name is too long for a sample list index");
+  }
+  sample_record r;
+  r.file_id = file_id;
+  r.name_length = name.size();
+  r.name_offset = add_name(name);
+  append_record(m_samples, r);
+  m_num_samples++;
+}
+
+void sample_list_index_writer::write(const std::string& path) const {
+  index_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, index_magic, sizeof(index_magic));
+  h.version = index_version;
+  h.num_files = m_num_files;
+  h.num_samples = m_num_samples;
+  h.file_table_offset = sizeof(h);
+  h.sample_table_offset = h.file_table_offset + m_files.size();
+  h.names_offset = h.sample_table_offset + m_samples.size();
+  h.names_size = m_names.size();
+  h.file_dir_offset = 0;
+  h.file_dir_length = m_file_dir_length;
+
+  const std::string tmp_path = path + ".tmp";
+  std::ofstream ofs(tmp_path, std::ios::out | std::ios::binary);
+  if (!ofs) {
+    LBANN_ERROR("failed to open " + tmp_path);
+  }
+  ofs.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  ofs.write(m_files.data(), m_files.size());
+  ofs.write(m_samples.data(), m_samples.size());
+  ofs.write(m_names.data(), m_names.size());
+  ofs.close();
+  if (!ofs || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    LBANN_ERROR("failed to write sample list index " + path);
+  }
+}
+
+} // namespace lbann
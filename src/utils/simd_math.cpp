@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/simd_math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace lbann {
+
+namespace {
+
+// =========================================================
+// Packs of single-precision values
+// =========================================================
+// Each pack type provides a float vector, an int32 vector with
+// the same number of lanes, and a lane mask. The math kernels below
+// are written once against these operations. scalar_pack has a
+// single lane and is used for leftover entries and on machines
+// without a supported instruction set. min and max return their
+// first argument if either argument is NaN.
+
+struct scalar_pack {
+  using float_type = float;
+  using int_type = std::int32_t;
+  using mask_type = bool;
+  static constexpr int width = 1;
+  static float_type load(const float* p) { return *p; }
+  static void store(float* p, float_type x) { *p = x; }
+  static float_type broadcast(float x) { return x; }
+  static int_type broadcast_int(std::int32_t x) { return x; }
+  static float_type add(float_type a, float_type b) { return a + b; }
+  static float_type sub(float_type a, float_type b) { return a - b; }
+  static float_type mul(float_type a, float_type b) { return a * b; }
+  static float_type div(float_type a, float_type b) { return a / b; }
+  static float_type fma(float_type a, float_type b, float_type c) {
+    return std::fma(a, b, c);
+  }
+  static float_type min(float_type a, float_type b) { return b < a ? b : a; }
+  static float_type max(float_type a, float_type b) { return b > a ? b : a; }
+  static float_type abs(float_type a) { return std::fabs(a); }
+  static float_type round(float_type a) { return std::nearbyint(a); }
+  static mask_type lt(float_type a, float_type b) { return a < b; }
+  static mask_type eq(float_type a, float_type b) { return a == b; }
+  static mask_type is_nan(float_type a) { return a != a; }
+  static mask_type mask_or(mask_type a, mask_type b) { return a || b; }
+  static float_type select(mask_type m, float_type a, float_type b) {
+    return m ? a : b;
+  }
+  static int_type to_int(float_type a) {
+    return static_cast<int_type>(a);
+  }
+  static float_type to_float(int_type a) {
+    return static_cast<float_type>(a);
+  }
+  static int_type as_int(float_type a) {
+    int_type b;
+    std::memcpy(&b, &a, sizeof(b));
+    return b;
+  }
+  static float_type as_float(int_type a) {
+    float_type b;
+    std::memcpy(&b, &a, sizeof(b));
+    return b;
+  }
+  static int_type add_int(int_type a, int_type b) { return a + b; }
+  static int_type sub_int(int_type a, int_type b) { return a - b; }
+  static int_type and_int(int_type a, int_type b) { return a & b; }
+  static int_type or_int(int_type a, int_type b) { return a | b; }
+  template <int n> static int_type shift_left(int_type a) {
+    return static_cast<int_type>(static_cast<std::uint32_t>(a) << n);
+  }
+  template <int n> static int_type shift_right_logical(int_type a) {
+    return static_cast<int_type>(static_cast<std::uint32_t>(a) >> n);
+  }
+  template <int n> static int_type shift_right_arithmetic(int_type a) {
+    return a >= 0 ? a >> n : ~(~a >> n);
+  }
+};
+
+#if defined(__AVX512F__)
+
+struct vector_pack {
+  using float_type = __m512;
+  using int_type = __m512i;
+  using mask_type = __mmask16;
+  static constexpr int width = 16;
+  static float_type load(const float* p) { return _mm512_loadu_ps(p); }
+  static void store(float* p, float_type x) { _mm512_storeu_ps(p, x); }
+  static float_type broadcast(float x) { return _mm512_set1_ps(x); }
+  static int_type broadcast_int(std::int32_t x) { return _mm512_set1_epi32(x); }
+  static float_type add(float_type a, float_type b) { return _mm512_add_ps(a, b); }
+  static float_type sub(float_type a, float_type b) { return _mm512_sub_ps(a, b); }
+  static float_type mul(float_type a, float_type b) { return _mm512_mul_ps(a, b); }
+  static float_type div(float_type a, float_type b) { return _mm512_div_ps(a, b); }
+  static float_type fma(float_type a, float_type b, float_type c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  static float_type min(float_type a, float_type b) { return _mm512_min_ps(b, a); }
+  static float_type max(float_type a, float_type b) { return _mm512_max_ps(b, a); }
+  static float_type abs(float_type a) { return _mm512_abs_ps(a); }
+  static float_type round(float_type a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static mask_type lt(float_type a, float_type b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+  }
+  static mask_type eq(float_type a, float_type b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+  }
+  static mask_type is_nan(float_type a) {
+    return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q);
+  }
+  static mask_type mask_or(mask_type a, mask_type b) { return a | b; }
+  static float_type select(mask_type m, float_type a, float_type b) {
+    return _mm512_mask_blend_ps(m, b, a);
+  }
+  static int_type to_int(float_type a) { return _mm512_cvttps_epi32(a); }
+  static float_type to_float(int_type a) { return _mm512_cvtepi32_ps(a); }
+  static int_type as_int(float_type a) { return _mm512_castps_si512(a); }
+  static float_type as_float(int_type a) { return _mm512_castsi512_ps(a); }
+  static int_type add_int(int_type a, int_type b) { return _mm512_add_epi32(a, b); }
+  static int_type sub_int(int_type a, int_type b) { return _mm512_sub_epi32(a, b); }
+  static int_type and_int(int_type a, int_type b) { return _mm512_and_si512(a, b); }
+  static int_type or_int(int_type a, int_type b) { return _mm512_or_si512(a, b); }
+  template <int n> static int_type shift_left(int_type a) {
+    return _mm512_slli_epi32(a, n);
+  }
+  template <int n> static int_type shift_right_logical(int_type a) {
+    return _mm512_srli_epi32(a, n);
+  }
+  template <int n> static int_type shift_right_arithmetic(int_type a) {
+    return _mm512_srai_epi32(a, n);
+  }
+};
+constexpr const char* vector_instruction_set = "AVX-512";
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+struct vector_pack {
+  using float_type = __m256;
+  using int_type = __m256i;
+  using mask_type = __m256;
+  static constexpr int width = 8;
+  static float_type load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, float_type x) { _mm256_storeu_ps(p, x); }
+  static float_type broadcast(float x) { return _mm256_set1_ps(x); }
+  static int_type broadcast_int(std::int32_t x) { return _mm256_set1_epi32(x); }
+  static float_type add(float_type a, float_type b) { return _mm256_add_ps(a, b); }
+  static float_type sub(float_type a, float_type b) { return _mm256_sub_ps(a, b); }
+  static float_type mul(float_type a, float_type b) { return _mm256_mul_ps(a, b); }
+  static float_type div(float_type a, float_type b) { return _mm256_div_ps(a, b); }
+  static float_type fma(float_type a, float_type b, float_type c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  static float_type min(float_type a, float_type b) { return _mm256_min_ps(b, a); }
+  static float_type max(float_type a, float_type b) { return _mm256_max_ps(b, a); }
+  static float_type abs(float_type a) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a);
+  }
+  static float_type round(float_type a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static mask_type lt(float_type a, float_type b) {
+    return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+  }
+  static mask_type eq(float_type a, float_type b) {
+    return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+  }
+  static mask_type is_nan(float_type a) {
+    return _mm256_cmp_ps(a, a, _CMP_UNORD_Q);
+  }
+  static mask_type mask_or(mask_type a, mask_type b) { return _mm256_or_ps(a, b); }
+  static float_type select(mask_type m, float_type a, float_type b) {
+    return _mm256_blendv_ps(b, a, m);
+  }
+  static int_type to_int(float_type a) { return _mm256_cvttps_epi32(a); }
+  static float_type to_float(int_type a) { return _mm256_cvtepi32_ps(a); }
+  static int_type as_int(float_type a) { return _mm256_castps_si256(a); }
+  static float_type as_float(int_type a) { return _mm256_castsi256_ps(a); }
+  static int_type add_int(int_type a, int_type b) { return _mm256_add_epi32(a, b); }
+  static int_type sub_int(int_type a, int_type b) { return _mm256_sub_epi32(a, b); }
+  static int_type and_int(int_type a, int_type b) { return _mm256_and_si256(a, b); }
+  static int_type or_int(int_type a, int_type b) { return _mm256_or_si256(a, b); }
+  template <int n> static int_type shift_left(int_type a) {
+    return _mm256_slli_epi32(a, n);
+  }
+  template <int n> static int_type shift_right_logical(int_type a) {
+    return _mm256_srli_epi32(a, n);
+  }
+  template <int n> static int_type shift_right_arithmetic(int_type a) {
+    return _mm256_srai_epi32(a, n);
+  }
+};
+constexpr const char* vector_instruction_set = "AVX2";
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+struct vector_pack {
+  using float_type = float32x4_t;
+  using int_type = int32x4_t;
+  using mask_type = uint32x4_t;
+  static constexpr int width = 4;
+  static float_type load(const float* p) { return vld1q_f32(p); }
+  static void store(float* p, float_type x) { vst1q_f32(p, x); }
+  static float_type broadcast(float x) { return vdupq_n_f32(x); }
+  static int_type broadcast_int(std::int32_t x) { return vdupq_n_s32(x); }
+  static float_type add(float_type a, float_type b) { return vaddq_f32(a, b); }
+  static float_type sub(float_type a, float_type b) { return vsubq_f32(a, b); }
+  static float_type mul(float_type a, float_type b) { return vmulq_f32(a, b); }
+  static float_type div(float_type a, float_type b) { return vdivq_f32(a, b); }
+  static float_type fma(float_type a, float_type b, float_type c) {
+    return vfmaq_f32(c, a, b);
+  }
+  static float_type min(float_type a, float_type b) {
+    return vbslq_f32(vcltq_f32(b, a), b, a);
+  }
+  static float_type max(float_type a, float_type b) {
+    return vbslq_f32(vcgtq_f32(b, a), b, a);
+  }
+  static float_type abs(float_type a) { return vabsq_f32(a); }
+  static float_type round(float_type a) { return vrndnq_f32(a); }
+  static mask_type lt(float_type a, float_type b) { return vcltq_f32(a, b); }
+  static mask_type eq(float_type a, float_type b) { return vceqq_f32(a, b); }
+  static mask_type is_nan(float_type a) { return vmvnq_u32(vceqq_f32(a, a)); }
+  static mask_type mask_or(mask_type a, mask_type b) { return vorrq_u32(a, b); }
+  static float_type select(mask_type m, float_type a, float_type b) {
+    return vbslq_f32(m, a, b);
+  }
+  static int_type to_int(float_type a) { return vcvtq_s32_f32(a); }
+  static float_type to_float(int_type a) { return vcvtq_f32_s32(a); }
+  static int_type as_int(float_type a) { return vreinterpretq_s32_f32(a); }
+  static float_type as_float(int_type a) { return vreinterpretq_f32_s32(a); }
+  static int_type add_int(int_type a, int_type b) { return vaddq_s32(a, b); }
+  static int_type sub_int(int_type a, int_type b) { return vsubq_s32(a, b); }
+  static int_type and_int(int_type a, int_type b) { return vandq_s32(a, b); }
+  static int_type or_int(int_type a, int_type b) { return vorrq_s32(a, b); }
+  template <int n> static int_type shift_left(int_type a) {
+    return vshlq_n_s32(a, n);
+  }
+  template <int n> static int_type shift_right_logical(int_type a) {
+    return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), n));
+  }
+  template <int n> static int_type shift_right_arithmetic(int_type a) {
+    return vshrq_n_s32(a, n);
+  }
+};
+constexpr const char* vector_instruction_set = "NEON";
+
+#else
+
+using vector_pack = scalar_pack;
+constexpr const char* vector_instruction_set = "scalar";
+
+#endif
+
+// =========================================================
+// Math kernels
+// =========================================================
+// Polynomial approximations are from the Cephes library (expf,
+// logf, tanhf) and from Numerical Recipes (erfc). Lanes are
+// computed without branches and special values are patched in with
+// selects at the end. Products are never followed directly by a sum:
+// those are written as FMAs, so that compilers that contract
+// floating-point expressions produce the same scalar and vector
+// results.
+
+/** Constant in all lanes. */
+template <typename P>
+inline typename P::float_type c(float x) { return P::broadcast(x); }
+
+/** Magnitude of a with the sign of b. */
+template <typename P>
+inline typename P::float_type copy_sign(typename P::float_type a,
+                                        typename P::float_type b) {
+  const auto sign_bit = P::broadcast_int(std::numeric_limits<std::int32_t>::min());
+  return P::as_float(P::or_int(P::as_int(P::abs(a)),
+                               P::and_int(P::as_int(b), sign_bit)));
+}
+
+/** @f$ 2^n @f$ for integer n in [-126, 127]. */
+template <typename P>
+inline typename P::float_type pow2(typename P::int_type n) {
+  return P::as_float(P::template shift_left<23>(P::add_int(n, P::broadcast_int(127))));
+}
+
+template <typename P>
+inline typename P::float_type exp_kernel(typename P::float_type x) {
+
+  // Range reduction: x = n log(2) + r with |r| <= log(2)/2
+  // Note: Inputs are clamped so that results underflow to zero and
+  // overflow to infinity. NaNs are clamped too and restored below.
+  const auto xc = P::min(c<P>(89.f), P::max(c<P>(-104.f), x));
+  const auto n = P::round(P::mul(xc, c<P>(1.44269504088896341f)));
+  auto r = P::fma(n, c<P>(-0.693359375f), xc);
+  r = P::fma(n, c<P>(2.12194440e-4f), r);
+
+  // Polynomial approximation of exp(r)
+  auto p = c<P>(1.9875691500e-4f);
+  p = P::fma(p, r, c<P>(1.3981999507e-3f));
+  p = P::fma(p, r, c<P>(8.3334519073e-3f));
+  p = P::fma(p, r, c<P>(4.1665795894e-2f));
+  p = P::fma(p, r, c<P>(1.6666665459e-1f));
+  p = P::fma(p, r, c<P>(5.0000001201e-1f));
+  auto y = P::fma(p, P::mul(r, r), P::add(r, c<P>(1.f)));
+
+  // Scale by 2^n in two steps to reach subnormals and overflow
+  const auto ni = P::to_int(n);
+  const auto n1 = P::template shift_right_arithmetic<1>(ni);
+  const auto n2 = P::sub_int(ni, n1);
+  y = P::mul(P::mul(y, pow2<P>(n1)), pow2<P>(n2));
+
+  return P::select(P::is_nan(x), x, y);
+}
+
+template <typename P>
+inline typename P::float_type log_kernel(typename P::float_type x) {
+  const auto zero = c<P>(0.f);
+  const auto inf = c<P>(std::numeric_limits<float>::infinity());
+
+  // Scale subnormals into the normal range
+  const auto is_subnormal = P::lt(x, c<P>(std::numeric_limits<float>::min()));
+  const auto xs = P::select(is_subnormal, P::mul(x, c<P>(8388608.f)), x);
+  auto e = P::select(is_subnormal, c<P>(-23.f), zero);
+
+  // Decompose x = m 2^e with m in [sqrt(1/2), sqrt(2))
+  const auto bits = P::as_int(xs);
+  e = P::add(e, P::to_float(P::sub_int(P::template shift_right_logical<23>(bits),
+                                        P::broadcast_int(126))));
+  auto m = P::as_float(P::or_int(P::and_int(bits, P::broadcast_int(0x007fffff)),
+                                 P::broadcast_int(0x3f000000)));
+  const auto is_small = P::lt(m, c<P>(0.707106781186547524f));
+  e = P::sub(e, P::select(is_small, c<P>(1.f), zero));
+  m = P::sub(P::select(is_small, P::add(m, m), m), c<P>(1.f));
+
+  // Polynomial approximation of log(1+m)
+  const auto z = P::mul(m, m);
+  auto p = c<P>(7.0376836292e-2f);
+  p = P::fma(p, m, c<P>(-1.1514610310e-1f));
+  p = P::fma(p, m, c<P>(1.1676998740e-1f));
+  p = P::fma(p, m, c<P>(-1.2420140846e-1f));
+  p = P::fma(p, m, c<P>(1.4249322787e-1f));
+  p = P::fma(p, m, c<P>(-1.6668057665e-1f));
+  p = P::fma(p, m, c<P>(2.0000714765e-1f));
+  p = P::fma(p, m, c<P>(-2.4999993993e-1f));
+  p = P::fma(p, m, c<P>(3.3333331174e-1f));
+  auto y = P::mul(P::mul(p, m), z);
+  y = P::fma(e, c<P>(-2.12194440e-4f), y);
+  y = P::fma(z, c<P>(-0.5f), y);
+  y = P::add(m, y);
+  y = P::fma(e, c<P>(0.693359375f), y);
+
+  // Special values
+  y = P::select(P::eq(x, inf), inf, y);
+  y = P::select(P::eq(x, zero), c<P>(-std::numeric_limits<float>::infinity()), y);
+  y = P::select(P::mask_or(P::lt(x, zero), P::is_nan(x)),
+                c<P>(std::numeric_limits<float>::quiet_NaN()), y);
+  return y;
+}
+
+/** @f$ \log(1+u) @f$ for u >= 0. */
+template <typename P>
+inline typename P::float_type log1p_kernel(typename P::float_type u) {
+  // Note: log(w) u / (w-1) with w = 1+u cancels the rounding error
+  // in w (Goldberg, 1991).
+  const auto w = P::add(c<P>(1.f), u);
+  const auto y = P::div(P::mul(log_kernel<P>(w), u), P::sub(w, c<P>(1.f)));
+  return P::select(P::eq(w, c<P>(1.f)), u, y);
+}
+
+template <typename P>
+inline typename P::float_type tanh_kernel(typename P::float_type x) {
+  const auto ax = P::abs(x);
+
+  // Polynomial approximation for small inputs
+  const auto z = P::mul(x, x);
+  auto p = c<P>(-5.70498872745e-3f);
+  p = P::fma(p, z, c<P>(2.06390887954e-2f));
+  p = P::fma(p, z, c<P>(-5.37397155531e-2f));
+  p = P::fma(p, z, c<P>(1.33314422036e-1f));
+  p = P::fma(p, z, c<P>(-3.33332819422e-1f));
+  const auto y_small = P::fma(P::mul(p, z), x, x);
+
+  // tanh(x) = 1 - 2 / (exp(2x) + 1) for large inputs
+  const auto e = exp_kernel<P>(P::add(ax, ax));
+  const auto y_large = P::sub(c<P>(1.f),
+                              P::div(c<P>(2.f), P::add(e, c<P>(1.f))));
+
+  return P::select(P::lt(ax, c<P>(0.625f)),
+                   y_small,
+                   copy_sign<P>(y_large, x));
+}
+
+template <typename P>
+inline typename P::float_type sigmoid_kernel(typename P::float_type x) {
+  // sigmoid(x) = 1 / (1 + exp(-x)) if x >= 0
+  //            = exp(x) / (1 + exp(x)) otherwise
+  const auto e = exp_kernel<P>(P::sub(c<P>(0.f), P::abs(x)));
+  const auto y = P::div(c<P>(1.f), P::add(c<P>(1.f), e));
+  return P::select(P::lt(x, c<P>(0.f)), P::mul(e, y), y);
+}
+
+template <typename P>
+inline typename P::float_type softplus_kernel(typename P::float_type x) {
+  // softplus(x) = max(x,0) + log(1 + exp(-|x|))
+  const auto e = exp_kernel<P>(P::sub(c<P>(0.f), P::abs(x)));
+  const auto y = P::add(P::max(x, c<P>(0.f)), log1p_kernel<P>(e));
+  return P::select(P::is_nan(x), x, y);
+}
+
+template <typename P>
+inline typename P::float_type erf_kernel(typename P::float_type x) {
+  const auto ax = P::abs(x);
+
+  // Taylor series for |x| < 1
+  const auto z = P::mul(x, x);
+  auto p = c<P>(-1.2290555301717926e-09f);
+  p = P::fma(p, z, c<P>(1.4807192815879218e-08f));
+  p = P::fma(p, z, c<P>(-1.6365844691234924e-07f));
+  p = P::fma(p, z, c<P>(1.6462114365889246e-06f));
+  p = P::fma(p, z, c<P>(-1.4925650358406250e-05f));
+  p = P::fma(p, z, c<P>(1.2055332981789664e-04f));
+  p = P::fma(p, z, c<P>(-8.5483270234508522e-04f));
+  p = P::fma(p, z, c<P>(5.2239776254421879e-03f));
+  p = P::fma(p, z, c<P>(-2.6866170645131252e-02f));
+  p = P::fma(p, z, c<P>(1.1283791670955126e-01f));
+  p = P::fma(p, z, c<P>(-3.7612638903183754e-01f));
+  p = P::fma(p, z, c<P>(1.1283791670955126e+00f));
+  const auto y_small = P::mul(p, x);
+
+  // erf(x) = 1 - erfc(x) for |x| >= 1
+  // Note: erfc approximation has a fractional error below 1.2e-7.
+  const auto t = P::div(c<P>(1.f), P::fma(c<P>(0.5f), ax, c<P>(1.f)));
+  auto q = c<P>(0.17087277f);
+  q = P::fma(q, t, c<P>(-0.82215223f));
+  q = P::fma(q, t, c<P>(1.48851587f));
+  q = P::fma(q, t, c<P>(-1.13520398f));
+  q = P::fma(q, t, c<P>(0.27886807f));
+  q = P::fma(q, t, c<P>(-0.18628806f));
+  q = P::fma(q, t, c<P>(0.09678418f));
+  q = P::fma(q, t, c<P>(0.37409196f));
+  q = P::fma(q, t, c<P>(1.00002368f));
+  q = P::fma(q, t, c<P>(-1.26551223f));
+  const auto minus_ax = P::sub(c<P>(0.f), ax);
+  q = P::fma(minus_ax, ax, q);
+  const auto e = exp_kernel<P>(q);
+  const auto y_large = P::fma(P::sub(c<P>(0.f), t), e, c<P>(1.f));
+
+  return P::select(P::lt(ax, c<P>(1.f)),
+                   y_small,
+                   copy_sign<P>(y_large, x));
+}
+
+// =========================================================
+// Array loops
+// =========================================================
+
+#define LBANN_SIMD_MATH_KERNEL(name)                                    \
+  struct name##_functor {                                               \
+    template <typename P>                                               \
+    typename P::float_type apply(typename P::float_type x) const {      \
+      return name##_kernel<P>(x);                                       \
+    }                                                                   \
+  };
+LBANN_SIMD_MATH_KERNEL(exp)
+LBANN_SIMD_MATH_KERNEL(log)
+LBANN_SIMD_MATH_KERNEL(tanh)
+LBANN_SIMD_MATH_KERNEL(sigmoid)
+LBANN_SIMD_MATH_KERNEL(softplus)
+LBANN_SIMD_MATH_KERNEL(erf)
+#undef LBANN_SIMD_MATH_KERNEL
+
+/** Apply a math kernel to an array with full packs, then with single
+ *  lanes for the remaining entries. */
+template <typename Functor>
+void apply_kernel(const float* x, float* y, El::Int size) {
+  const Functor f;
+  constexpr El::Int width = vector_pack::width;
+  El::Int i = 0;
+  for (; i + width <= size; i += width) {
+    vector_pack::store(&y[i],
+                       f.template apply<vector_pack>(vector_pack::load(&x[i])));
+  }
+  for (; i < size; ++i) {
+    y[i] = f.template apply<scalar_pack>(x[i]);
+  }
+}
+
+} // namespace
+
+const char* simd_math_instruction_set() {
+  return vector_instruction_set;
+}
+
+void vector_exp(const float* x, float* y, El::Int size) {
+  apply_kernel<exp_functor>(x, y, size);
+}
+void vector_exp(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) { y[i] = std::exp(x[i]); }
+}
+
+void vector_log(const float* x, float* y, El::Int size) {
+  apply_kernel<log_functor>(x, y, size);
+}
+void vector_log(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) { y[i] = std::log(x[i]); }
+}
+
+void vector_tanh(const float* x, float* y, El::Int size) {
+  apply_kernel<tanh_functor>(x, y, size);
+}
+void vector_tanh(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) { y[i] = std::tanh(x[i]); }
+}
+
+void vector_sigmoid(const float* x, float* y, El::Int size) {
+  apply_kernel<sigmoid_functor>(x, y, size);
+}
+void vector_sigmoid(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) { y[i] = 1 / (1 + std::exp(-x[i])); }
+}
+
+void vector_softplus(const float* x, float* y, El::Int size) {
+  apply_kernel<softplus_functor>(x, y, size);
+}
+void vector_softplus(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) {
+    y[i] = std::max(x[i], 0.) + std::log1p(std::exp(-std::fabs(x[i])));
+  }
+}
+
+void vector_erf(const float* x, float* y, El::Int size) {
+  apply_kernel<erf_functor>(x, y, size);
+}
+void vector_erf(const double* x, double* y, El::Int size) {
+  for (El::Int i = 0; i < size; ++i) { y[i] = std::erf(x[i]); }
+}
+
+} // namespace lbann
@@ -27,13 +27,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/utils/summary.hpp"
+#include <algorithm>
+#include <limits>
 
 namespace lbann {
 
 #ifdef LBANN_HAS_TBINF
 
-lbann_summary::lbann_summary(std::string logdir, lbann_comm *comm)
-  : m_comm(comm) {
+lbann_summary::lbann_summary(std::string logdir, lbann_comm *comm,
+                             bool async_write)
+  : m_comm(comm), m_async_write(async_write) {
   if (m_comm->am_world_master()) {
     m_sw = new TBinf::SummaryWriter(logdir);
   } else {
@@ -44,6 +47,9 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm *comm)
 
 lbann_summary::~lbann_summary() {
   flush();
+  if (m_write_future.valid()) {
+    m_write_future.wait();
+  }
   if (m_sw != nullptr) {
     delete m_sw;
   }
@@ -137,43 +143,33 @@ void lbann_summary::reduce_scalar_all(const std::string tag,
 void lbann_summary::reduce_histogram(const std::string tag,
                                      const AbsDistMat& mat,
                                      int step) {
-  DataType mat_local_min = local_min(mat.LockedMatrix());
-  DataType mat_local_max = local_max(mat.LockedMatrix());
-  // Local sum and squared sum
-  DataType sum = 0.0f;
-  DataType sqsum = 0.0f;
+  // Local statistics and buckets
+  DataType sum = DataType(0);
+  DataType sqsum = DataType(0);
+  DataType min = std::numeric_limits<DataType>::max();
+  DataType max = std::numeric_limits<DataType>::lowest();
+  std::vector<float> buckets(m_histogram_buckets.size(), 0.0f);
+
   // Check distributed matrix format
   El::DistData mat_format(mat);
   if(mat_format.colDist == El::STAR && mat_format.rowDist == El::STAR) {
-    // Compute local sums on master process if matrix is Star,Star
+    // Compute local statistics on master process if matrix is Star,Star
     if(m_comm->am_trainer_master()) {
-      local_sum_sqsum(mat.LockedMatrix(), sum, sqsum);
+      local_statistics(mat.LockedMatrix(), sum, sqsum, min, max,
+                       buckets.data());
     }
   } else {
-    // Compute local sums on all processes if matrix is in MC,MR;
+    // Compute local statistics on all processes if matrix is in MC,MR;
     // Star,VC; or similar format
     // TODO: implement for matrices in Circ,Circ; MC,Star; or similar
     // formats
-    local_sum_sqsum(mat.LockedMatrix(), sum, sqsum);
-  }
-  // Compute local buckets.
-  std::vector<float> buckets(m_histogram_buckets.size(), 0.0f);
-  const int height = mat.LocalHeight();
-  const int width = mat.LocalWidth();
-  const int ldim = mat.LDim();
-  const DataType *__restrict__ mat_buf = mat.LockedMatrix().LockedBuffer();
-  for (int row = 0; row < height; ++row) {
-    for (int col = 0; col < width; ++col) {
-      // Note: This could be optimized; upper_bound takes O(logn) time.
-      int bucket = std::upper_bound(
-                     m_histogram_buckets.begin(), m_histogram_buckets.end(),
-                     mat_buf[row + col * ldim]) - m_histogram_buckets.begin();
-      buckets[bucket] += 1.0f;
-    }
+    local_statistics(mat.LockedMatrix(), sum, sqsum, min, max,
+                     buckets.data());
   }
+
   // Add to list of pending histograms.
   m_pending_histograms.emplace_back(
-    tag, step, buckets, mat_local_min, mat_local_max, mat.Height() * mat.Width(),
+    tag, step, std::move(buckets), min, max, mat.Height() * mat.Width(),
     sum, sqsum);
   // TODO: Support histograms on multiple models.
 }
@@ -186,157 +182,202 @@ void lbann_summary::reduce_2norm(const std::string tag, const AbsDistMat& mat,
 }
 
 void lbann_summary::flush() {
-  flush_means();
-  flush_mins();
-  flush_maxes();
-  flush_stdevs();
-  flush_scalars();
-  flush_sum_scalars();
-  flush_scalar_alls();
-  flush_histograms();
-  if (m_sw != nullptr) {
-    m_sw->flush();
+  std::vector<scalar_event> scalars;
+  std::vector<histogram_event> histograms;
+  flush_trainer_ops(scalars, histograms);
+  flush_scalar_alls(scalars);
+  if (m_sw == nullptr) {
+    return;
   }
-}
 
-void lbann_summary::flush_means() {
-  if (m_pending_means.empty()) {
-    return;
+  // Write events, possibly on a background thread
+  // Note: TBinf is not thread-safe, so only one write is in flight.
+  if (m_write_future.valid()) {
+    m_write_future.wait();
+  }
+  if (m_async_write) {
+    m_write_future = std::async(std::launch::async,
+                                [this, scalars, histograms] () {
+                                  write_events(scalars, histograms);
+                                });
+  } else {
+    write_events(scalars, histograms);
   }
+}
+
+void lbann_summary::flush_trainer_ops(std::vector<scalar_event>& scalars,
+                                      std::vector<histogram_event>& histograms) {
+  const size_t num_buckets = m_histogram_buckets.size();
+  const size_t num_histograms = m_pending_histograms.size();
+
+  // Pack all values that are summed within the trainer
+  // Note: Layout is means, stdevs (sum and squared sum), sum-scalars,
+  // then histograms (sum, squared sum, and buckets).
   std::vector<DataType> local_sums;
+  local_sums.reserve(m_pending_means.size()
+                     + 2 * m_pending_stdevs.size()
+                     + m_pending_sum_scalars.size()
+                     + num_histograms * (2 + num_buckets));
   for (const auto& op : m_pending_means) {
     local_sums.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    // Compute the means in-place.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] /= m_pending_means[i].num;
-    }
-    gather_scalar_summary(m_pending_means, global_sums);
-  } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
+  for (const auto& op : m_pending_stdevs) {
+    local_sums.push_back(op.local);
+    local_sums.push_back(op.local2);
   }
-  m_pending_means.clear();
-}
-
-void lbann_summary::flush_mins() {
-  if (m_pending_mins.empty()) {
-    return;
+  for (const auto& op : m_pending_sum_scalars) {
+    local_sums.push_back(op.local);
+  }
+  for (const auto& op : m_pending_histograms) {
+    local_sums.push_back(op.sum);
+    local_sums.push_back(op.sqsum);
+    local_sums.insert(local_sums.end(), op.buckets.begin(), op.buckets.end());
   }
+
+  // Pack all values that are minimized within the trainer
+  // Note: Maxes are negated so that a single min-reduction
+  // suffices. Layout is mins, maxes, then histograms (min and max).
   std::vector<DataType> local_mins;
+  local_mins.reserve(m_pending_mins.size()
+                     + m_pending_maxes.size()
+                     + 2 * num_histograms);
   for (const auto& op : m_pending_mins) {
     local_mins.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_mins(local_mins.size());
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         global_mins.data(), El::mpi::MIN);
-    gather_scalar_summary(m_pending_mins, global_mins);
-  } else {
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         m_comm->get_trainer_master(), El::mpi::MIN);
-  }
-  m_pending_mins.clear();
-}
-
-void lbann_summary::flush_maxes() {
-  if (m_pending_maxes.empty()) {
-    return;
-  }
-  std::vector<DataType> local_maxes;
   for (const auto& op : m_pending_maxes) {
-    local_maxes.push_back(op.local);
+    local_mins.push_back(-op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_maxes(local_maxes.size());
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         global_maxes.data(), El::mpi::MAX);
-    gather_scalar_summary(m_pending_maxes, global_maxes);
-  } else {
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         m_comm->get_trainer_master(), El::mpi::MAX);
-  }
-  m_pending_maxes.clear();
-}
-
-void lbann_summary::flush_stdevs() {
-  if (m_pending_stdevs.empty()) {
-    return;
-  }
-  std::vector<DataType> local_sums;
-  std::vector<DataType> local_sqsums;
-  for (const auto& op : m_pending_stdevs) {
-    local_sums.push_back(op.local);
-    local_sqsums.push_back(op.local2);
-  }
-  if (m_comm->am_trainer_master()) {
-    // Compute the model sample standard deviation as:
-    // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
-    // The n-1 is to use an unbiased variance estimate.
-    // This unrolls the usual formulation of standard deviation some, to avoid
-    // global operations when pushing the operation.
-    std::vector<DataType> global_sums(local_sums.size());
-    std::vector<DataType> global_sqsums(local_sqsums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         global_sqsums.data());
-    // Re-use the global_sums vector for the standard deviation.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] = std::sqrt(
-                         (global_sqsums[i] -
-                          global_sums[i] * global_sums[i] / m_pending_stdevs[i].num) /
-                         (m_pending_stdevs[i].num - 1));
+  for (const auto& op : m_pending_histograms) {
+    local_mins.push_back(op.min);
+    local_mins.push_back(-op.max);
+  }
+
+  // Reduce to trainer master
+  const bool am_trainer_master = m_comm->am_trainer_master();
+  std::vector<DataType> trainer_sums, trainer_mins;
+  if (am_trainer_master) {
+    trainer_sums.resize(local_sums.size());
+    trainer_mins.resize(local_mins.size());
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
+                             trainer_sums.data());
+    }
+    if (!local_mins.empty()) {
+      m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
+                             trainer_mins.data(), El::mpi::MIN);
     }
-    gather_scalar_summary(m_pending_stdevs, global_sums);
   } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         m_comm->get_trainer_master());
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
+                             m_comm->get_trainer_master());
+    }
+    if (!local_mins.empty()) {
+      m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
+                             m_comm->get_trainer_master(), El::mpi::MIN);
+    }
   }
-  m_pending_stdevs.clear();
-}
 
-void lbann_summary::flush_scalars() {
-  if (m_pending_scalars.empty()) {
-    return;
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> local_scalars;
+  // Compute trainer results and gather to world master
+  // Note: Layout is means, mins, maxes, stdevs, scalars,
+  // sum-scalars, then histograms (min, max, sum, squared sum, and
+  // buckets). Scalars are only pending on trainer masters.
+  if (am_trainer_master) {
+    const size_t num_scalars = (m_pending_means.size()
+                                + m_pending_mins.size()
+                                + m_pending_maxes.size()
+                                + m_pending_stdevs.size()
+                                + m_pending_scalars.size()
+                                + m_pending_sum_scalars.size());
+    const size_t histogram_size = 4 + num_buckets;
+    std::vector<DataType> results;
+    results.reserve(num_scalars + num_histograms * histogram_size);
+    size_t sum_pos = 0, min_pos = 0;
+    for (const auto& op : m_pending_means) {
+      results.push_back(trainer_sums[sum_pos++] / op.num);
+    }
+    for (size_t i = 0; i < m_pending_mins.size(); ++i) {
+      results.push_back(trainer_mins[min_pos++]);
+    }
+    for (size_t i = 0; i < m_pending_maxes.size(); ++i) {
+      results.push_back(-trainer_mins[min_pos++]);
+    }
+    for (const auto& op : m_pending_stdevs) {
+      // Compute the model sample standard deviation as:
+      // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
+      // The n-1 is to use an unbiased variance estimate.
+      const DataType sum = trainer_sums[sum_pos++];
+      const DataType sqsum = trainer_sums[sum_pos++];
+      results.push_back(std::sqrt((sqsum - sum * sum / op.num)
+                                  / (op.num - 1)));
+    }
     for (const auto& op : m_pending_scalars) {
-      local_scalars.push_back(op.local);
+      results.push_back(op.local);
+    }
+    for (size_t i = 0; i < m_pending_sum_scalars.size(); ++i) {
+      results.push_back(trainer_sums[sum_pos++]);
+    }
+    for (size_t i = 0; i < num_histograms; ++i) {
+      results.push_back(trainer_mins[min_pos++]);
+      results.push_back(-trainer_mins[min_pos++]);
+      results.insert(results.end(),
+                     trainer_sums.begin() + sum_pos,
+                     trainer_sums.begin() + sum_pos + 2 + num_buckets);
+      sum_pos += 2 + num_buckets;
     }
-    gather_scalar_summary(m_pending_scalars, local_scalars);
-  }
-  m_pending_scalars.clear();
-}
 
-void lbann_summary::flush_sum_scalars() {
-  if (m_pending_sum_scalars.empty()) {
-    return;
-  }
-  std::vector<DataType> local_sums;
-  for (const auto& op : m_pending_sum_scalars) {
-    local_sums.push_back(op.local);
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         global_sums.data());
-    gather_scalar_summary(m_pending_sum_scalars, global_sums);
-  } else {
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
+    if (!results.empty()) {
+      if (m_comm->am_world_master()) {
+        const int num_trainers = m_comm->get_num_trainers();
+        std::vector<DataType> global_results(num_trainers * results.size());
+        m_comm->intertrainer_gather(results.data(), results.size(),
+                                    global_results.data());
+
+        // Construct events for each trainer
+        for (int model = 0; model < num_trainers; ++model) {
+          const DataType* buf = &global_results[model * results.size()];
+          auto add_scalars = [&] (const std::vector<pending_op>& ops) {
+            for (const auto& op : ops) {
+              scalars.push_back({prepend_model(op.tag, model), *buf++, op.step});
+            }
+          };
+          add_scalars(m_pending_means);
+          add_scalars(m_pending_mins);
+          add_scalars(m_pending_maxes);
+          add_scalars(m_pending_stdevs);
+          add_scalars(m_pending_scalars);
+          add_scalars(m_pending_sum_scalars);
+          for (const auto& op : m_pending_histograms) {
+            histogram_event e;
+            e.tag = prepend_model(op.tag, model);
+            e.min = buf[0];
+            e.max = buf[1];
+            e.num = op.num;
+            e.sum = buf[2];
+            e.sqsum = buf[3];
+            e.buckets.assign(buf + 4, buf + histogram_size);
+            e.step = op.step;
+            histograms.push_back(std::move(e));
+            buf += histogram_size;
+          }
+        }
+
+      } else {
+        m_comm->intertrainer_gather(results.data(), results.size(),
+                                    m_comm->get_intertrainer_master());
+      }
+    }
   }
+
+  m_pending_means.clear();
+  m_pending_mins.clear();
+  m_pending_maxes.clear();
+  m_pending_stdevs.clear();
+  m_pending_scalars.clear();
   m_pending_sum_scalars.clear();
+  m_pending_histograms.clear();
 }
 
-void lbann_summary::flush_scalar_alls() {
+void lbann_summary::flush_scalar_alls(std::vector<scalar_event>& scalars) {
   if (m_pending_scalar_alls.empty()) {
     return;
   }
@@ -346,18 +387,18 @@ void lbann_summary::flush_scalar_alls() {
     local_scalars.push_back(op.local);
   }
   if (m_comm->am_world_master()) {
-    std::vector<DataType> scalars(
+    std::vector<DataType> global_scalars(
       m_comm->get_procs_in_world()*local_scalars.size());
     m_comm->gather(local_scalars.data(), local_scalars.size(),
-                   scalars.data(), m_comm->get_world_comm());
-    for (size_t i = 0; i < scalars.size(); ++i) {
+                   global_scalars.data(), m_comm->get_world_comm());
+    for (size_t i = 0; i < global_scalars.size(); ++i) {
       int rank = i / local_scalars.size();
       int model = rank / m_comm->get_procs_per_trainer();
       int pos = i % local_scalars.size();
-      m_sw->add_scalar(
-        prepend_model("rank" + std::to_string(rank) + "/" +
-                      m_pending_scalar_alls[pos].tag, model),
-        scalars[i], m_pending_scalar_alls[pos].step);
+      scalars.push_back({
+          prepend_model("rank" + std::to_string(rank) + "/" +
+                        m_pending_scalar_alls[pos].tag, model),
+          global_scalars[i], m_pending_scalar_alls[pos].step});
     }
   } else {
     m_comm->gather(local_scalars.data(), local_scalars.size(),
@@ -366,97 +407,101 @@ void lbann_summary::flush_scalar_alls() {
   m_pending_scalar_alls.clear();
 }
 
-void lbann_summary::flush_histograms() {
-  if (m_pending_histograms.empty()) {
-    return;
+void lbann_summary::write_events(const std::vector<scalar_event>& scalars,
+                                 const std::vector<histogram_event>& histograms) {
+  for (const auto& e : scalars) {
+    m_sw->add_scalar(e.tag, e.value, e.step);
   }
-  std::vector<DataType> local_mins;
-  std::vector<DataType> local_maxes;
-  std::vector<DataType> local_sums;
-  std::vector<DataType> local_sqsums;
-  std::vector<float> buckets;
-  for (const auto& op : m_pending_histograms) {
-    local_mins.push_back(op.min);
-    local_maxes.push_back(op.max);
-    local_sums.push_back(op.sum);
-    local_sqsums.push_back(op.sqsum);
-    buckets.insert(buckets.end(), op.buckets.begin(), op.buckets.end());
+  for (const auto& e : histograms) {
+    m_sw->add_histogram(e.tag, e.buckets, e.min, e.max, e.num,
+                        e.sum, e.sqsum, e.step);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<DataType> model_mins(local_mins.size());
-    std::vector<DataType> model_maxes(local_maxes.size());
-    std::vector<DataType> model_sums(local_sums.size());
-    std::vector<DataType> model_sqsums(local_sqsums.size());
-    std::vector<float> model_buckets(buckets.size());
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         model_mins.data(), El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         model_maxes.data(), El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(), model_sums.size(),
-                         model_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         model_sqsums.data());
-    m_comm->trainer_reduce(buckets.data(), buckets.size(),
-                         model_buckets.data());
-    // Gather to the world master for writing out.
-    if (m_comm->am_world_master()) {
-      std::vector<DataType> global_mins(
-        m_comm->get_num_trainers() * model_mins.size());
-      std::vector<DataType> global_maxes(
-        m_comm->get_num_trainers() * model_maxes.size());
-      std::vector<DataType> global_sums(
-        m_comm->get_num_trainers() * model_sums.size());
-      std::vector<DataType> global_sqsums(
-        m_comm->get_num_trainers() * model_sqsums.size());
-      std::vector<float> global_buckets(
-        m_comm->get_num_trainers() * model_buckets.size());
-      m_comm->intertrainer_gather(model_mins.data(), model_mins.size(),
-                                global_mins.data());
-      m_comm->intertrainer_gather(model_maxes.data(), model_maxes.size(),
-                                global_maxes.data());
-      m_comm->intertrainer_gather(model_sums.data(), model_sums.size(),
-                                global_sums.data());
-      m_comm->intertrainer_gather(model_sqsums.data(), model_sqsums.size(),
-                                global_sqsums.data());
-      m_comm->intertrainer_gather(model_buckets.data(), model_buckets.size(),
-                                global_buckets.data());
-      for (unsigned i = 0; i < global_mins.size(); ++i) {
-        int model = i / m_pending_histograms.size();
-        unsigned ops_pos = i % m_pending_histograms.size();
-        std::vector<float> tmp_buckets(
-          global_buckets.begin() + i*m_histogram_buckets.size(),
-          global_buckets.begin() + (i+1)*m_histogram_buckets.size());
-        m_sw->add_histogram(prepend_model(m_pending_histograms[ops_pos].tag, model),
-                            tmp_buckets, global_mins[i], global_maxes[i],
-                            m_pending_histograms[ops_pos].num,
-                            global_sums[i], global_sqsums[i],
-                            m_pending_histograms[ops_pos].step);
+  m_sw->flush();
+}
+
+void lbann_summary::local_statistics(const Mat& mat,
+                                     DataType& sum, DataType& sqsum,
+                                     DataType& min, DataType& max,
+                                     float* buckets) const {
+  // Treat contiguous matrices as a single column
+  El::Int height = mat.Height();
+  El::Int width = mat.Width();
+  const El::Int ldim = mat.LDim();
+  if (ldim == height) {
+    height = height * width;
+    width = height > 0 ? 1 : 0;
+  }
+  const El::Int size = height * width;
+  const DataType * __restrict__ mat_buf = mat.LockedBuffer();
+  const double * __restrict__ limits = m_histogram_buckets.data();
+  const El::Int num_buckets = m_histogram_buckets.size();
+
+  // Each thread accumulates statistics for a contiguous range of
+  // entries in column-major order
+  const El::Int num_chunks = std::max(std::min(El::Int(omp_get_max_threads()),
+                                               size),
+                                      El::Int(1));
+  std::vector<DataType> chunk_stats(4 * num_chunks);
+  std::vector<float> chunk_buckets(buckets != nullptr ?
+                                   num_chunks * num_buckets : 0);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int chunk = 0; chunk < num_chunks; ++chunk) {
+    const El::Int begin = (size * chunk) / num_chunks;
+    const El::Int end = (size * (chunk + 1)) / num_chunks;
+    auto chunk_sum = DataType(0);
+    auto chunk_sqsum = DataType(0);
+    auto chunk_min = std::numeric_limits<DataType>::max();
+    auto chunk_max = std::numeric_limits<DataType>::lowest();
+    float* chunk_bucket_buf = (buckets != nullptr ?
+                               &chunk_buckets[chunk * num_buckets] :
+                               nullptr);
+    El::Int row = (height > 0 ? begin % height : 0);
+    El::Int col = (height > 0 ? begin / height : 0);
+    for (El::Int i = begin; i < end;) {
+      const El::Int row_end = std::min(height, row + (end - i));
+      const DataType * __restrict__ col_buf = &mat_buf[col * ldim];
+      for (El::Int r = row; r < row_end; ++r) {
+        const DataType val = col_buf[r];
+        chunk_sum += val;
+        chunk_sqsum += val * val;
+        chunk_min = std::min(chunk_min, val);
+        chunk_max = std::max(chunk_max, val);
+      }
+      if (chunk_bucket_buf != nullptr) {
+        for (El::Int r = row; r < row_end; ++r) {
+          const El::Int bucket = (std::upper_bound(limits,
+                                                   limits + num_buckets,
+                                                   col_buf[r])
+                                  - limits);
+          chunk_bucket_buf[std::min(bucket, num_buckets - 1)] += 1.0f;
+        }
+      }
+      i += row_end - row;
+      row = 0;
+      ++col;
+    }
+    chunk_stats[4*chunk] = chunk_sum;
+    chunk_stats[4*chunk+1] = chunk_sqsum;
+    chunk_stats[4*chunk+2] = chunk_min;
+    chunk_stats[4*chunk+3] = chunk_max;
+  }
+
+  // Combine statistics from each thread
+  for (El::Int chunk = 0; chunk < num_chunks; ++chunk) {
+    sum += chunk_stats[4*chunk];
+    sqsum += chunk_stats[4*chunk+1];
+    min = std::min(min, chunk_stats[4*chunk+2]);
+    max = std::max(max, chunk_stats[4*chunk+3]);
+  }
+  if (buckets != nullptr) {
+    for (El::Int chunk = 0; chunk < num_chunks; ++chunk) {
+      const float* chunk_bucket_buf = &chunk_buckets[chunk * num_buckets];
+      for (El::Int b = 0; b < num_buckets; ++b) {
+        buckets[b] += chunk_bucket_buf[b];
       }
-    } else {
-      m_comm->intertrainer_gather(model_mins.data(), model_mins.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_maxes.data(), model_maxes.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sums.data(), model_sums.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sqsums.data(), model_sqsums.size(),
-                                m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_buckets.data(), model_buckets.size(),
-                                m_comm->get_intertrainer_master());
     }
-  } else {
-    m_comm->trainer_reduce(local_mins.data(), local_mins.size(),
-                         m_comm->get_trainer_master(), El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(), local_maxes.size(),
-                         m_comm->get_trainer_master(), El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(), local_sums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(local_sqsums.data(), local_sqsums.size(),
-                         m_comm->get_trainer_master());
-    m_comm->trainer_reduce(buckets.data(), buckets.size(),
-                         m_comm->get_trainer_master());
   }
-  m_pending_histograms.clear();
+
 }
 
 DataType lbann_summary::local_sum(const Mat& mat) const {
@@ -540,7 +585,7 @@ DataType lbann_summary::local_max(const Mat& mat) const {
   const El::Int width = mat.Width();
   const El::Int ldim = mat.LDim();
   const DataType * __restrict__ mat_buf = mat.LockedBuffer();
-  auto max = std::numeric_limits<DataType>::min();
+  auto max = std::numeric_limits<DataType>::lowest();
   if (ldim == height) {
     const El::Int size = height*width;
     LBANN_OMP_PARALLEL_FOR_ARGS(reduction(max:max))
@@ -587,37 +632,6 @@ std::string lbann_summary::prepend_model(const std::string tag,
   return "model" + std::to_string(model) + "/" + tag;
 }
 
-void lbann_summary::gather_scalar_summary(
-  const std::vector<pending_op>& ops, std::vector<DataType>& scalars) {
-  if (m_comm->am_world_master()) {
-    std::vector<DataType> data(m_comm->get_num_trainers() * scalars.size());
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(), data.data());
-    for (unsigned i = 0; i < data.size(); ++i) {
-      int model = i / ops.size();
-      unsigned ops_pos = i % ops.size();
-      m_sw->add_scalar(prepend_model(ops[ops_pos].tag, model),
-                       data[i], ops[ops_pos].step);
-    }
-  } else {
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(),
-                              m_comm->get_intertrainer_master());
-  }
-}
-
-void lbann_summary::gather_scalar_summary(const std::string tag,
-                                          DataType s,
-                                          int step) {
-  if (m_comm->am_world_master()) {
-    std::vector<DataType> data(m_comm->get_num_trainers());
-    m_comm->intertrainer_gather(s, data);
-    for (size_t model = 0; model < data.size(); ++model) {
-      m_sw->add_scalar(prepend_model(tag, model), data[model], step);
-    }
-  } else {
-    m_comm->intertrainer_gather(s, m_comm->get_intertrainer_master());
-  }
-}
-
 #endif  // LBANN_HAS_TBINF
 
 }  // namespace lbann
@@ -1,4 +1,5 @@
 #include "lbann/utils/threads/thread_pool.hpp"
+#include "lbann/utils/trace.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -43,6 +44,7 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int cpu_offset) {
   m_thread_id_to_local_id_map.reserve(num_threads);
 
   m_threads_offset = cpu_offset;
+  m_pinned_cpus.clear();
 
   // Find the current thread affinity
   cpu_set_t cpuset, ht_cpuset;
@@ -76,6 +78,33 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int cpu_offset) {
   }
 }
 
+void thread_pool::launch_pinned_threads(size_type num_threads,
+                                        const std::vector<int>& cpus) {
+  if (cpus.empty()) {
+    LBANN_ERROR("attempted to pin threads to an empty set of CPUs");
+  }
+  m_pinned_cpus = cpus;
+  threads_.reserve(num_threads);
+  m_work_group.reserve(num_threads);
+  m_thread_id_to_local_id_map.reserve(num_threads);
+
+  // Try to launch each worker thread
+  try
+  {
+    for (size_type cnt = 0; cnt < num_threads; ++cnt) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(m_pinned_cpus[cnt % m_pinned_cpus.size()], &cpuset);
+      threads_.emplace_back(&thread_pool::do_thread_work_pinned_thread_,this, cnt, cpuset);
+    }
+  }
+  catch(...)
+  {
+    all_work_done_ = true;
+    throw;
+  }
+}
+
 void thread_pool::reap_threads() {
   all_work_done_ = true;
   do {
@@ -95,7 +124,12 @@ void thread_pool::reap_threads() {
 
 void thread_pool::relaunch_pinned_threads(size_type num_threads) {
   reap_threads();
-  launch_pinned_threads(num_threads, m_threads_offset);
+  if (m_pinned_cpus.empty()) {
+    launch_pinned_threads(num_threads, m_threads_offset);
+  } else {
+    const auto cpus = m_pinned_cpus;
+    launch_pinned_threads(num_threads, cpus);
+  }
   return;
 }
 
@@ -105,6 +139,7 @@ void thread_pool::do_thread_work_()
   {
     auto task = global_work_queue_.wait_and_pop();
     if (task) {
+      LBANN_TRACE_SCOPE(trace_category::io, "thread_pool_job");
       (*task)();
     }
   }
@@ -128,6 +163,7 @@ void thread_pool::do_thread_work_pinned_thread_(int tid, cpu_set_t cpu_set)
   {
     auto task = global_work_queue_.wait_and_pop();
     if (task) {
+      LBANN_TRACE_SCOPE(trace_category::io, "thread_pool_job");
       (*task)();
     }
   }
@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/top_k.hpp"
+#include "lbann/comm.hpp"
+#include <algorithm>
+
+namespace lbann {
+
+constexpr DataType top_k_entry::min_value;
+constexpr El::Int top_k_entry::max_index;
+
+namespace {
+
+/** Number of values checked against the heap threshold at once. */
+constexpr El::Int select_block_size = 16;
+
+/** Merge received top-k lists into local lists for a column range. */
+void merge_column_range(top_k_entry* top_entries,
+                        const std::vector<top_k_entry>& recv_entries,
+                        El::Int k,
+                        El::Int col_begin,
+                        El::Int col_end) {
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = col_begin; col < col_end; ++col) {
+    std::vector<top_k_entry> merged(k);
+    merge_top_k(&top_entries[col*k],
+                &recv_entries[(col-col_begin)*k],
+                k,
+                merged.data());
+    std::copy(merged.begin(), merged.end(), &top_entries[col*k]);
+  }
+}
+
+/** Exchange top-k lists for column ranges with another rank.
+ *  Entries in [send_begin, send_end) are sent to rank and entries for
+ *  [recv_begin, recv_end) are received into recv_entries.
+ */
+void exchange_column_range(lbann_comm& comm,
+                           const El::mpi::Comm& c,
+                           int rank,
+                           El::Int k,
+                           const top_k_entry* top_entries,
+                           El::Int send_begin,
+                           El::Int send_end,
+                           std::vector<top_k_entry>& recv_entries,
+                           El::Int recv_begin,
+                           El::Int recv_end) {
+  const El::Int send_size = (send_end - send_begin) * k;
+  const El::Int recv_size = (recv_end - recv_begin) * k;
+  recv_entries.resize(std::max(recv_size, El::Int(1)));
+  const auto* send_buf = top_entries + send_begin * k;
+  comm.sendrecv(reinterpret_cast<const El::byte*>(send_buf),
+                send_size * sizeof(top_k_entry),
+                rank,
+                reinterpret_cast<El::byte*>(recv_entries.data()),
+                recv_size * sizeof(top_k_entry),
+                rank,
+                c);
+}
+
+} // namespace
+
+void select_top_k(const DataType* values,
+                  El::Int size,
+                  El::Int k,
+                  El::Int index_offset,
+                  El::Int index_stride,
+                  top_k_entry* top_entries) {
+  if (k < 1) { return; }
+
+  // Heap of the k best entries seen so far, worst entry at front
+  top_k_entry* heap_begin = top_entries;
+  top_k_entry* heap_end = top_entries + k;
+  std::fill(heap_begin, heap_end, top_k_entry());
+  DataType threshold = heap_begin->value;
+  auto insert = [&] (El::Int i) {
+    top_k_entry e;
+    e.value = values[i];
+    e.index = index_offset + i * index_stride;
+    if (top_k_entry::compare(e, *heap_begin)) {
+      std::pop_heap(heap_begin, heap_end, top_k_entry::compare);
+      *(heap_end - 1) = e;
+      std::push_heap(heap_begin, heap_end, top_k_entry::compare);
+      threshold = heap_begin->value;
+    }
+  };
+
+  // Scan blocks of values and only inspect blocks with candidates
+  El::Int i = 0;
+  for (; i + select_block_size <= size; i += select_block_size) {
+    const DataType* block = &values[i];
+    bool has_candidate = false;
+    for (El::Int j = 0; j < select_block_size; ++j) {
+      has_candidate |= (block[j] >= threshold);
+    }
+    if (has_candidate) {
+      for (El::Int j = 0; j < select_block_size; ++j) {
+        insert(i + j);
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    insert(i);
+  }
+
+  // Sort entries from best to worst
+  std::sort_heap(heap_begin, heap_end, top_k_entry::compare);
+
+}
+
+void merge_top_k(const top_k_entry* a,
+                 const top_k_entry* b,
+                 El::Int k,
+                 top_k_entry* out) {
+  El::Int ia = 0, ib = 0;
+  for (El::Int i = 0; i < k; ++i) {
+    if (top_k_entry::compare(b[ib], a[ia])) {
+      out[i] = b[ib++];
+    } else {
+      out[i] = a[ia++];
+    }
+  }
+}
+
+void reduce_top_k(lbann_comm& comm,
+                  const El::mpi::Comm& c,
+                  El::Int k,
+                  El::Int num_cols,
+                  top_k_entry* top_entries,
+                  int root) {
+  const int size = El::mpi::Size(c);
+  const int rank = El::mpi::Rank(c);
+  if (size < 2 || k < 1 || num_cols < 1) { return; }
+  const bool all = root < 0;
+  if (all) { root = 0; }
+
+  // Relabel ranks so that root is virtual rank 0
+  const int vrank = (rank - root + size) % size;
+  auto real_rank = [&] (int v) { return (v + root) % size; };
+
+  // Largest power of two not exceeding communicator size
+  int pof2 = 1;
+  while (2 * pof2 <= size) { pof2 *= 2; }
+
+  std::vector<top_k_entry> recv_entries;
+
+  // Fold extra ranks into the power-of-two group
+  if (vrank >= pof2) {
+    exchange_column_range(comm, c, real_rank(vrank - pof2), k,
+                          top_entries, 0, num_cols,
+                          recv_entries, 0, 0);
+  } else if (vrank + pof2 < size) {
+    exchange_column_range(comm, c, real_rank(vrank + pof2), k,
+                          top_entries, 0, 0,
+                          recv_entries, 0, num_cols);
+    merge_column_range(top_entries, recv_entries, k, 0, num_cols);
+  }
+
+  if (vrank < pof2) {
+
+    // Reduce-scatter with recursive halving
+    // Note: Column ranges are recorded so they can be reassembled.
+    std::vector<std::pair<El::Int, El::Int>> ranges;
+    El::Int col_begin = 0, col_end = num_cols;
+    for (int mask = pof2 / 2; mask > 0; mask /= 2) {
+      const int partner = vrank ^ mask;
+      const El::Int col_mid = col_begin + (col_end - col_begin) / 2;
+      ranges.emplace_back(col_begin, col_end);
+      if (vrank & mask) {
+        exchange_column_range(comm, c, real_rank(partner), k,
+                              top_entries, col_begin, col_mid,
+                              recv_entries, col_mid, col_end);
+        col_begin = col_mid;
+      } else {
+        exchange_column_range(comm, c, real_rank(partner), k,
+                              top_entries, col_mid, col_end,
+                              recv_entries, col_begin, col_mid);
+        col_end = col_mid;
+      }
+      merge_column_range(top_entries, recv_entries, k, col_begin, col_end);
+    }
+
+    // Reassemble column blocks, either on every rank with recursive
+    // doubling or on root with a binomial gather
+    for (int mask = 1; mask < pof2; mask *= 2) {
+      const int partner = vrank ^ mask;
+      const auto range = ranges.back();
+      ranges.pop_back();
+      const bool send = all || (vrank % (2 * mask) == mask);
+      const bool recv = all || (vrank % (2 * mask) == 0);
+      if (!send && !recv) { continue; }
+      const bool upper = vrank & mask;
+      const El::Int partner_begin = upper ? range.first : col_end;
+      const El::Int partner_end = upper ? col_begin : range.second;
+      exchange_column_range(comm, c, real_rank(partner), k,
+                            top_entries,
+                            send ? col_begin : 0,
+                            send ? col_end : 0,
+                            recv_entries,
+                            recv ? partner_begin : 0,
+                            recv ? partner_end : 0);
+      if (recv) {
+        std::copy(recv_entries.begin(),
+                  recv_entries.begin() + (partner_end - partner_begin) * k,
+                  top_entries + partner_begin * k);
+      }
+      col_begin = range.first;
+      col_end = range.second;
+    }
+
+  }
+
+  // Send result to extra ranks
+  if (all) {
+    if (vrank >= pof2) {
+      exchange_column_range(comm, c, real_rank(vrank - pof2), k,
+                            top_entries, 0, 0,
+                            recv_entries, 0, num_cols);
+      std::copy(recv_entries.begin(),
+                recv_entries.begin() + num_cols * k,
+                top_entries);
+    } else if (vrank + pof2 < size) {
+      exchange_column_range(comm, c, real_rank(vrank + pof2), k,
+                            top_entries, 0, num_cols,
+                            recv_entries, 0, 0);
+    }
+  }
+
+}
+
+} // namespace lbann
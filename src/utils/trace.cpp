@@ -0,0 +1,428 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/trace.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace lbann {
+
+namespace {
+
+/** Number of ping-pong rounds used to estimate each clock offset. */
+constexpr int clock_sync_rounds = 8;
+/** MPI tag for clock synchronization messages. */
+constexpr int clock_sync_tag = 7301;
+/** Current trace file format version. */
+constexpr std::uint32_t trace_version = 1;
+
+/** Ring buffer of calling thread. */
+thread_local void* thread_buffer = nullptr;
+
+void write_or_throw(const void* data, std::size_t size, std::FILE* f) {
+  if (size > 0 && std::fwrite(data, 1, size, f) != size) {
+    LBANN_ERROR("failed to write trace file");
+  }
+}
+
+void read_or_throw(void* data, std::size_t size, std::FILE* f,
+                   const std::string& path) {
+  if (size > 0 && std::fread(data, 1, size, f) != size) {
+    LBANN_ERROR("failed to read trace file " + path);
+  }
+}
+
+} // namespace
+
+const char* trace_category_name(trace_category category) {
+  switch (category) {
+  case trace_category::forward_prop:  return "fp";
+  case trace_category::backward_prop: return "bp";
+  case trace_category::optimize:      return "opt";
+  case trace_category::comm:          return "comm";
+  case trace_category::io:            return "io";
+  case trace_category::data_store:    return "data_store";
+  default:                            return "other";
+  }
+}
+
+struct tracer::ring_buffer {
+  ring_buffer(std::size_t capacity, std::uint16_t thread_)
+    : events(capacity), mask(capacity - 1), thread(thread_), head(0), tail(0) {}
+  std::vector<trace_event> events;
+  std::uint64_t mask;
+  std::uint16_t thread;
+  /** Next slot to write (owned by recording thread). */
+  std::atomic<std::uint64_t> head;
+  /** Next slot to read (owned by writer thread). */
+  std::atomic<std::uint64_t> tail;
+};
+
+struct tracer::state {
+
+  /** Protects names and name_ids. */
+  std::mutex names_mutex;
+  std::vector<std::string> names;
+  std::unordered_map<std::string, std::uint32_t> name_ids;
+  /** Number of names already written to file. */
+  std::size_t names_written = 0;
+
+  /** Protects buffers. */
+  std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<ring_buffer>> buffers;
+  std::size_t buffer_size = 65536;
+
+  /** Output file. */
+  std::FILE* file = nullptr;
+  /** Scratch space for drained events. */
+  std::vector<trace_event> drain_buffer;
+
+  /** Background writer. */
+  std::thread writer;
+  std::mutex writer_mutex;
+  std::condition_variable writer_cv;
+  bool stop_writer = false;
+  std::chrono::milliseconds flush_interval{1000};
+  /** Error raised in background writer, rethrown by stop. */
+  std::exception_ptr writer_error;
+
+};
+
+tracer& tracer::get() {
+  static tracer instance;
+  return instance;
+}
+
+tracer::tracer()
+  : m_enabled(false), m_dropped(0), m_state(new state) {}
+
+tracer::~tracer() {
+  // Errors cannot propagate out of a destructor
+  try {
+    if (m_num_users > 0) {
+      m_num_users = 1;
+      stop();
+    }
+  } catch (...) {}
+}
+
+std::uint32_t tracer::intern(const std::string& name) {
+  auto& s = *m_state;
+  std::lock_guard<std::mutex> lock(s.names_mutex);
+  auto it = s.name_ids.find(name);
+  if (it != s.name_ids.end()) {
+    return it->second;
+  }
+  const std::uint32_t id = s.names.size();
+  s.names.push_back(name);
+  s.name_ids.emplace(name, id);
+  return id;
+}
+
+tracer::ring_buffer& tracer::get_thread_buffer() {
+  if (thread_buffer == nullptr) {
+    auto& s = *m_state;
+    std::lock_guard<std::mutex> lock(s.buffers_mutex);
+    s.buffers.emplace_back(new ring_buffer(s.buffer_size, s.buffers.size()));
+    thread_buffer = s.buffers.back().get();
+  }
+  return *static_cast<ring_buffer*>(thread_buffer);
+}
+
+void tracer::record(trace_category category,
+                    std::uint32_t name,
+                    std::uint64_t start,
+                    std::uint64_t end) {
+  if (!enabled()) { return; }
+  auto& buffer = get_thread_buffer();
+  const auto head = buffer.head.load(std::memory_order_relaxed);
+  const auto tail = buffer.tail.load(std::memory_order_acquire);
+  if (head - tail > buffer.mask) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto& e = buffer.events[head & buffer.mask];
+  e.start = start;
+  e.end = end;
+  e.name = name;
+  e.category = static_cast<std::uint16_t>(category);
+  e.thread = buffer.thread;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void tracer::start(const std::string& path,
+                   lbann_comm& comm,
+                   double flush_interval,
+                   std::size_t buffer_size) {
+  // Share the active trace with other users, e.g. a second model
+  if (m_num_users > 0) {
+    ++m_num_users;
+    return;
+  }
+  auto& s = *m_state;
+  const auto clock_offset = align_clocks(comm);
+
+  // Open file and write header
+  s.file = std::fopen(path.c_str(), "wb");
+  if (s.file == nullptr) {
+    LBANN_ERROR("could not open trace file " + path);
+  }
+  trace_file_header header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, "LBTRACE", sizeof(header.magic));
+  header.version = trace_version;
+  header.rank = comm.get_rank_in_world();
+  header.trainer = comm.get_trainer_rank();
+  header.clock_offset = clock_offset;
+  try {
+    write_or_throw(&header, sizeof(header), s.file);
+  } catch (...) {
+    std::fclose(s.file);
+    s.file = nullptr;
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(s.names_mutex);
+    s.names_written = 0;
+  }
+
+  // Reset ring buffers
+  // Note: Buffers created earlier keep their size.
+  {
+    std::lock_guard<std::mutex> lock(s.buffers_mutex);
+    std::size_t size = 1;
+    while (size < std::max(buffer_size, std::size_t(2))) { size *= 2; }
+    s.buffer_size = size;
+    for (auto& buffer : s.buffers) {
+      buffer->tail.store(buffer->head.load());
+    }
+  }
+  m_dropped = 0;
+
+  // Launch background writer
+  s.flush_interval = std::chrono::milliseconds(
+    std::max(static_cast<long>(flush_interval * 1000), 1l));
+  s.stop_writer = false;
+  s.writer_error = nullptr;
+  m_enabled = true;
+  s.writer = std::thread(&tracer::writer_loop, this);
+  m_num_users = 1;
+
+}
+
+void tracer::stop() {
+  if (m_num_users == 0) { return; }
+  if (--m_num_users > 0) { return; }
+  auto& s = *m_state;
+  m_enabled = false;
+  {
+    std::lock_guard<std::mutex> lock(s.writer_mutex);
+    s.stop_writer = true;
+  }
+  s.writer_cv.notify_one();
+  s.writer.join();
+
+  // Write remaining events, unless the writer has failed
+  auto error = s.writer_error;
+  s.writer_error = nullptr;
+  if (!error) {
+    try {
+      drain();
+      trace_record_header record;
+      record.type = trace_record_header::dropped;
+      record.count = static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(m_dropped.load(),
+                                std::numeric_limits<std::uint32_t>::max()));
+      write_or_throw(&record, sizeof(record), s.file);
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  std::fclose(s.file);
+  s.file = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void tracer::writer_loop() {
+  auto& s = *m_state;
+  std::unique_lock<std::mutex> lock(s.writer_mutex);
+  try {
+    while (!s.stop_writer) {
+      s.writer_cv.wait_for(lock, s.flush_interval);
+      drain();
+    }
+  } catch (...) {
+    // Stop recording and report the error when tracing is stopped
+    s.writer_error = std::current_exception();
+    m_enabled = false;
+  }
+}
+
+void tracer::drain() {
+  auto& s = *m_state;
+
+  // Write names that are new since last drain
+  // Note: Events only refer to names that were interned before they
+  // were recorded, so names are always written before events.
+  {
+    std::lock_guard<std::mutex> lock(s.names_mutex);
+    for (; s.names_written < s.names.size(); ++s.names_written) {
+      const auto& name = s.names[s.names_written];
+      trace_record_header record;
+      record.type = trace_record_header::name;
+      record.count = name.size();
+      const std::uint32_t id = s.names_written;
+      write_or_throw(&record, sizeof(record), s.file);
+      write_or_throw(&id, sizeof(id), s.file);
+      write_or_throw(name.data(), name.size(), s.file);
+    }
+  }
+
+  // Copy events out of ring buffers and write them
+  s.drain_buffer.clear();
+  {
+    std::lock_guard<std::mutex> lock(s.buffers_mutex);
+    for (auto& buffer : s.buffers) {
+      const auto tail = buffer->tail.load(std::memory_order_relaxed);
+      const auto head = buffer->head.load(std::memory_order_acquire);
+      for (auto i = tail; i < head; ++i) {
+        s.drain_buffer.push_back(buffer->events[i & buffer->mask]);
+      }
+      buffer->tail.store(head, std::memory_order_release);
+    }
+  }
+  if (!s.drain_buffer.empty()) {
+    trace_record_header record;
+    record.type = trace_record_header::events;
+    record.count = s.drain_buffer.size();
+    write_or_throw(&record, sizeof(record), s.file);
+    write_or_throw(s.drain_buffer.data(),
+                   s.drain_buffer.size() * sizeof(trace_event),
+                   s.file);
+  }
+  if (std::fflush(s.file) != 0) {
+    LBANN_ERROR("failed to write trace file");
+  }
+
+}
+
+std::int64_t tracer::align_clocks(lbann_comm& comm) {
+  // Estimate offsets with ping-pong messages to the world master,
+  // keeping the round with the shortest round trip (Cristian's
+  // algorithm)
+  const auto& world = comm.get_world_comm();
+  const auto c = world.GetMPIComm();
+  const int rank = comm.get_rank_in_world();
+  const int size = comm.get_procs_in_world();
+  const int root = comm.get_world_master();
+  std::int64_t offset = 0;
+  comm.barrier(world);
+  if (rank == root) {
+    for (int r = 0; r < size; ++r) {
+      if (r == root) { continue; }
+      for (int round = 0; round < clock_sync_rounds; ++round) {
+        std::int64_t t = 0;
+        MPI_Recv(&t, 1, MPI_INT64_T, r, clock_sync_tag, c, MPI_STATUS_IGNORE);
+        t = static_cast<std::int64_t>(now());
+        MPI_Send(&t, 1, MPI_INT64_T, r, clock_sync_tag, c);
+      }
+    }
+  } else {
+    auto best_rtt = std::numeric_limits<std::int64_t>::max();
+    for (int round = 0; round < clock_sync_rounds; ++round) {
+      std::int64_t root_time = 0;
+      const auto send_time = static_cast<std::int64_t>(now());
+      MPI_Send(&root_time, 1, MPI_INT64_T, root, clock_sync_tag, c);
+      MPI_Recv(&root_time, 1, MPI_INT64_T, root, clock_sync_tag, c,
+               MPI_STATUS_IGNORE);
+      const auto recv_time = static_cast<std::int64_t>(now());
+      const auto rtt = recv_time - send_time;
+      if (rtt < best_rtt) {
+        best_rtt = rtt;
+        offset = root_time - (send_time + rtt / 2);
+      }
+    }
+  }
+  comm.barrier(world);
+  return offset;
+}
+
+trace_file_data read_trace_file(const std::string& path) {
+  std::unique_ptr<std::FILE, int(*)(std::FILE*)> f(std::fopen(path.c_str(), "rb"),
+                                                   &std::fclose);
+  if (f == nullptr) {
+    LBANN_ERROR("could not open trace file " + path);
+  }
+  trace_file_data data;
+  read_or_throw(&data.header, sizeof(data.header), f.get(), path);
+  if (std::strncmp(data.header.magic, "LBTRACE", sizeof(data.header.magic)) != 0
+      || data.header.version != trace_version) {
+    LBANN_ERROR(path + " is not a supported trace file");
+  }
+  trace_record_header record;
+  while (std::fread(&record, sizeof(record), 1, f.get()) == 1) {
+    switch (record.type) {
+    case trace_record_header::name:
+      {
+        std::uint32_t id;
+        read_or_throw(&id, sizeof(id), f.get(), path);
+        if (id >= data.names.size()) { data.names.resize(id + 1); }
+        data.names[id].resize(record.count);
+        read_or_throw(&data.names[id][0], record.count, f.get(), path);
+      }
+      break;
+    case trace_record_header::events:
+      {
+        const auto offset = data.events.size();
+        data.events.resize(offset + record.count);
+        read_or_throw(&data.events[offset],
+                      record.count * sizeof(trace_event),
+                      f.get(), path);
+      }
+      break;
+    case trace_record_header::dropped:
+      data.dropped += record.count;
+      break;
+    default:
+      LBANN_ERROR("unrecognized record type in trace file " + path);
+    }
+  }
+  return data;
+}
+
+} // namespace lbann
@@ -0,0 +1,73 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/autotune.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+TEST_CASE("Testing autotuning cache", "[autotune][utilities]") {
+  using lbann::autotune_cache;
+  using lbann::autotune_choice;
+  const std::string path = "autotune_test.cache";
+  std::remove(path.c_str());
+
+  SECTION("Missing cache file is empty") {
+    autotune_cache cache(path);
+    cache.load();
+    REQUIRE(cache.size() == 0);
+    autotune_choice choice;
+    REQUIRE_FALSE(cache.find("convolution;inputs=3x32x32", choice));
+  }
+
+  SECTION("Entries survive save and load") {
+    autotune_cache cache(path);
+    autotune_choice choice;
+    choice.algorithm = "batched_im2col";
+    choice.num_threads = 8;
+    cache.insert("convolution;inputs=3x32x32;cpu=Some CPU @ 2.00GHz", choice);
+    choice.algorithm = "gemm";
+    choice.num_threads = 2;
+    cache.insert("fully connected;inputs=1024\tbad\nkey", choice);
+    cache.save();
+
+    autotune_cache loaded(path);
+    loaded.load();
+    REQUIRE(loaded.size() == 2);
+    autotune_choice found;
+    REQUIRE(loaded.find("convolution;inputs=3x32x32;cpu=Some CPU @ 2.00GHz", found));
+    REQUIRE(found.algorithm == "batched_im2col");
+    REQUIRE(found.num_threads == 8);
+    REQUIRE(loaded.find("fully connected;inputs=1024\tbad\nkey", found));
+    REQUIRE(found.algorithm == "gemm");
+    REQUIRE(found.num_threads == 2);
+  }
+
+  SECTION("Malformed lines are ignored") {
+    {
+      std::ofstream fs(path.c_str());
+      fs << "no tabs here\n"
+         << "pooling;inputs=64x8x8\tim2col\tfour\n"
+         << "pooling;inputs=64x4x4\tim2col\t4\n";
+    }
+    autotune_cache cache(path);
+    cache.load();
+    REQUIRE(cache.size() == 1);
+    autotune_choice found;
+    REQUIRE(cache.find("pooling;inputs=64x4x4", found));
+    REQUIRE(found.algorithm == "im2col");
+    REQUIRE(found.num_threads == 4);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("Testing autotuning thread counts", "[autotune][utilities]") {
+  using lbann::get_autotune_thread_counts;
+  REQUIRE(get_autotune_thread_counts(1) == std::vector<int>{1});
+  REQUIRE(get_autotune_thread_counts(0) == std::vector<int>{1});
+  REQUIRE(get_autotune_thread_counts(12) == std::vector<int>({12, 6, 3, 1}));
+  REQUIRE(get_autotune_thread_counts(16) == std::vector<int>({16, 8, 4, 2, 1}));
+}
@@ -0,0 +1,198 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/im2col.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+/** 3D convolution geometry. Dimensions are ordered as (z, y, x). */
+struct geometry {
+  int channels;
+  int dims[3];
+  int pads[3];
+  int window[3];
+  int strides[3];
+  int offset_num(int d) const {
+    return (dims[d] + 2 * pads[d] - window[d]) / strides[d] + 1;
+  }
+  int num_offsets() const {
+    return offset_num(0) * offset_num(1) * offset_num(2);
+  }
+  int window_size() const {
+    return channels * window[0] * window[1] * window[2];
+  }
+  int im_size() const {
+    return channels * dims[0] * dims[1] * dims[2];
+  }
+};
+
+/** Reference transposed im2col with per-entry index arithmetic. */
+std::vector<lbann::DataType> reference_im2col(const geometry& g,
+                                              const std::vector<lbann::DataType>& im) {
+  std::vector<lbann::DataType> col(g.num_offsets() * g.window_size());
+  int row = 0;
+  for (int oz = 0; oz < g.offset_num(0); ++oz) {
+    for (int oy = 0; oy < g.offset_num(1); ++oy) {
+      for (int ox = 0; ox < g.offset_num(2); ++ox, ++row) {
+        int col_index = 0;
+        for (int c = 0; c < g.channels; ++c) {
+          for (int wz = 0; wz < g.window[0]; ++wz) {
+            for (int wy = 0; wy < g.window[1]; ++wy) {
+              for (int wx = 0; wx < g.window[2]; ++wx, ++col_index) {
+                const int z = oz * g.strides[0] - g.pads[0] + wz;
+                const int y = oy * g.strides[1] - g.pads[1] + wy;
+                const int x = ox * g.strides[2] - g.pads[2] + wx;
+                const bool valid = (0 <= z && z < g.dims[0]
+                                    && 0 <= y && y < g.dims[1]
+                                    && 0 <= x && x < g.dims[2]);
+                const int im_index = x + g.dims[2] * (y + g.dims[1] * (z + g.dims[0] * c));
+                col[row + col_index * g.num_offsets()] = valid ? im[im_index] : 0;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return col;
+}
+
+/** Call im2col_transposed_3d on a slab of window shifts. */
+void im2col_slab(const geometry& g, const lbann::DataType* im,
+                 lbann::DataType* col, int ldim, int z_begin, int z_end) {
+  lbann::im2col_transposed_3d(im, col, ldim,
+                              g.dims[2], g.dims[1], g.dims[0],
+                              g.pads[2], g.pads[1], g.pads[0],
+                              g.channels,
+                              g.window[2], g.window[1], g.window[0],
+                              g.strides[2], g.strides[1], g.strides[0],
+                              z_begin, z_end);
+}
+
+/** Call col2im_transposed_3d on a slab of window shifts. */
+void col2im_slab(const geometry& g, const lbann::DataType* col, int ldim,
+                 lbann::DataType* im, int z_begin, int z_end) {
+  lbann::col2im_transposed_3d(col, ldim, im,
+                              g.dims[2], g.dims[1], g.dims[0],
+                              g.pads[2], g.pads[1], g.pads[0],
+                              g.channels,
+                              g.window[2], g.window[1], g.window[0],
+                              g.strides[2], g.strides[1], g.strides[0],
+                              z_begin, z_end);
+}
+
+} // namespace
+
+TEST_CASE("Testing 3D im2col", "[im2col][utilities]") {
+  const std::vector<geometry> geometries = {
+    {2, {5, 6, 7}, {0, 0, 0}, {3, 3, 3}, {1, 1, 1}},
+    {3, {6, 5, 8}, {1, 2, 1}, {3, 2, 4}, {1, 1, 1}},
+    {2, {9, 7, 9}, {1, 0, 2}, {3, 3, 3}, {2, 3, 2}},
+    {1, {4, 4, 4}, {0, 0, 0}, {1, 1, 1}, {1, 1, 1}},
+    {4, {7, 7, 7}, {0, 0, 0}, {4, 4, 4}, {2, 2, 2}},
+  };
+  std::mt19937 gen(20190803);
+  std::uniform_real_distribution<lbann::DataType> dist(-1, 1);
+  auto make_im = [&] (const geometry& g) {
+    std::vector<lbann::DataType> im(g.im_size());
+    for (auto& v : im) { v = dist(gen); }
+    return im;
+  };
+
+  SECTION("im2col matches reference") {
+    for (const auto& g : geometries) {
+      const auto im = make_im(g);
+      const auto expected = reference_im2col(g, im);
+      std::vector<lbann::DataType> col(expected.size(), lbann::DataType(-7));
+      im2col_slab(g, im.data(), col.data(), g.num_offsets(), 0, g.offset_num(0));
+      CHECK(col == expected);
+    }
+  }
+
+  SECTION("im2col in slabs matches reference") {
+    for (const auto& g : geometries) {
+      const auto im = make_im(g);
+      const auto expected = reference_im2col(g, im);
+      const int num_offsets = g.num_offsets();
+      const int slice_size = num_offsets / g.offset_num(0);
+      for (int z = 0; z < g.offset_num(0); ++z) {
+        std::vector<lbann::DataType> col(slice_size * g.window_size());
+        im2col_slab(g, im.data(), col.data(), slice_size, z, z + 1);
+        bool match = true;
+        for (int j = 0; j < g.window_size(); ++j) {
+          for (int i = 0; i < slice_size; ++i) {
+            match = match && (col[i + j * slice_size]
+                              == expected[z * slice_size + i + j * num_offsets]);
+          }
+        }
+        CHECK(match);
+      }
+    }
+  }
+
+  SECTION("col2im is the adjoint of im2col") {
+    // <im2col(x), y> must equal <x, col2im(y)>
+    for (const auto& g : geometries) {
+      const auto im = make_im(g);
+      const auto expected = reference_im2col(g, im);
+      const int num_offsets = g.num_offsets();
+      const int slice_size = num_offsets / g.offset_num(0);
+      std::vector<lbann::DataType> y(expected.size());
+      for (auto& v : y) { v = dist(gen); }
+      double lhs = 0;
+      for (size_t i = 0; i < y.size(); ++i) { lhs += double(expected[i]) * y[i]; }
+      std::vector<lbann::DataType> x(im.size(), lbann::DataType(0));
+      for (int z = 0; z < g.offset_num(0); ++z) {
+        col2im_slab(g, &y[z * slice_size], num_offsets, x.data(), z, z + 1);
+      }
+      double rhs = 0;
+      for (size_t i = 0; i < x.size(); ++i) { rhs += double(im[i]) * x[i]; }
+      CHECK(lhs == Approx(rhs).epsilon(1e-5));
+    }
+  }
+
+}
+
+TEST_CASE("Testing sample stacking", "[im2col][utilities]") {
+  const El::Int num_samples = 5, channel_size = 7, num_channels = 3;
+  const El::Int ldim = num_channels * channel_size + 2;
+  std::vector<lbann::DataType> samples(num_samples * ldim);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = lbann::DataType(i);
+  }
+
+  SECTION("stack_samples places samples along rows") {
+    const El::Int block_ldim = num_samples * channel_size;
+    std::vector<lbann::DataType> block(block_ldim * num_channels);
+    lbann::stack_samples(samples.data(), ldim, block.data(), block_ldim,
+                         num_samples, channel_size, num_channels);
+    for (El::Int j = 0; j < num_samples; ++j) {
+      for (El::Int c = 0; c < num_channels; ++c) {
+        for (El::Int i = 0; i < channel_size; ++i) {
+          REQUIRE(block[j * channel_size + i + c * block_ldim]
+                  == samples[j * ldim + c * channel_size + i]);
+        }
+      }
+    }
+  }
+
+  SECTION("unstack_samples inverts stack_samples") {
+    const El::Int block_ldim = num_samples * channel_size;
+    std::vector<lbann::DataType> block(block_ldim * num_channels);
+    std::vector<lbann::DataType> result(samples.size(), lbann::DataType(-1));
+    lbann::stack_samples(samples.data(), ldim, block.data(), block_ldim,
+                         num_samples, channel_size, num_channels);
+    lbann::unstack_samples(block.data(), block_ldim, result.data(), ldim,
+                           num_samples, channel_size, num_channels);
+    for (El::Int j = 0; j < num_samples; ++j) {
+      for (El::Int i = 0; i < num_channels * channel_size; ++i) {
+        REQUIRE(result[j * ldim + i] == samples[j * ldim + i]);
+      }
+    }
+  }
+
+}
@@ -3,6 +3,10 @@
 
 // File being tested
 #include <lbann/utils/image.hpp>
+#include <lbann/utils/opencv.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <cmath>
 
 // Hide by default because this will create a file.
 TEST_CASE("Testing image utils", "[.image-utils][utilities]") {
@@ -49,3 +53,51 @@ TEST_CASE("Testing image utils", "[.image-utils][utilities]") {
     }
   }
 }
+
+TEST_CASE("Testing reduced resolution image decode", "[image-utils][utilities]") {
+  // Smooth 3-channel test image, encoded as a high-quality JPEG.
+  const size_t height = 203, width = 317;
+  cv::Mat image(height, width, CV_8UC3);
+  for (size_t row = 0; row < height; ++row) {
+    for (size_t col = 0; col < width; ++col) {
+      auto& pixel = image.at<cv::Vec3b>(row, col);
+      pixel[0] = 255 * row / height;
+      pixel[1] = 255 * col / width;
+      pixel[2] = 128 + 100 * std::sin(0.05 * row) * std::cos(0.03 * col);
+    }
+  }
+  std::vector<uint8_t> encoded_buf;
+  cv::imencode(".jpg", image, encoded_buf, {cv::IMWRITE_JPEG_QUALITY, 95});
+  El::Matrix<uint8_t> encoded(encoded_buf.size(), 1,
+                              encoded_buf.data(), encoded_buf.size());
+
+  SECTION("header dims") {
+    std::vector<size_t> dims;
+    REQUIRE(lbann::get_encoded_image_dims(encoded, dims));
+    REQUIRE(dims == std::vector<size_t>({3, height, width}));
+  }
+
+  SECTION("matches full decode and resize") {
+    El::Matrix<uint8_t> full;
+    std::vector<size_t> full_dims;
+    lbann::decode_image(encoded, full, full_dims);
+    for (size_t scale : {1, 2, 4, 8}) {
+      El::Matrix<uint8_t> reduced;
+      std::vector<size_t> dims;
+      REQUIRE_NOTHROW(lbann::decode_image(encoded, reduced, dims, scale));
+      REQUIRE(dims[0] == 3);
+      REQUIRE(dims[1] == (height + scale - 1) / scale);
+      REQUIRE(dims[2] == (width + scale - 1) / scale);
+      // Compare with OpenCV's area-averaging downscale.
+      cv::Mat ref;
+      cv::resize(lbann::utils::get_opencv_mat(full, full_dims), ref,
+                 cv::Size(dims[2], dims[1]), 0, 0, cv::INTER_AREA);
+      cv::Mat diff;
+      cv::absdiff(lbann::utils::get_opencv_mat(reduced, dims), ref, diff);
+      const auto mean_diff = cv::mean(diff);
+      for (int c = 0; c < 3; ++c) {
+        REQUIRE(mean_diff[c] < 3.0);
+      }
+    }
+  }
+}
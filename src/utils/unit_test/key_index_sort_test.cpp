@@ -0,0 +1,88 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/key_index_sort.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** Check that the first k outputs are sorted and that the output is
+ *  a permutation of the input. */
+template <typename T>
+void check_sort(const std::vector<T>& values, bool descending, long k) {
+  const long size = values.size();
+  std::vector<T> sorted_values(size);
+  std::vector<long> sorted_indices(size);
+  lbann::key_index_sorter<T, long> sorter;
+  sorter.sort(values.data(), size, descending,
+              sorted_values.data(), sorted_indices.data(), k);
+
+  std::vector<T> ref(values);
+  if (descending) {
+    std::sort(ref.begin(), ref.end(), std::greater<T>());
+  } else {
+    std::sort(ref.begin(), ref.end());
+  }
+  const long num_sorted = (k > 0 && k < size) ? k : size;
+  for (long i = 0; i < num_sorted; ++i) {
+    REQUIRE(sorted_values[i] == ref[i]);
+  }
+
+  std::vector<int> counts(size, 0);
+  for (long i = 0; i < size; ++i) {
+    REQUIRE(sorted_values[i] == values[sorted_indices[i]]);
+    counts[sorted_indices[i]]++;
+  }
+  for (const auto& c : counts) {
+    REQUIRE(c == 1);
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Testing key_index_sorter", "[sort][utilities]") {
+  std::mt19937 gen(20190612);
+  std::normal_distribution<float> dist;
+  for (const long size : {1l, 17l, 255l, 256l, 4000l}) {
+    std::vector<float> values(size);
+    for (auto& v : values) {
+      v = dist(gen);
+      // Introduce ties
+      if (gen() % 4 == 0) { v = std::round(v); }
+    }
+    SECTION("full sort, size " + std::to_string(size)) {
+      check_sort(values, false, 0);
+      check_sort(values, true, 0);
+    }
+    SECTION("top-k sort, size " + std::to_string(size)) {
+      check_sort(values, false, 5);
+      check_sort(values, true, 5);
+    }
+  }
+
+  SECTION("doubles") {
+    std::vector<double> values = {3.0, -1.0, 0.0, -0.0, 1e300, -2.5, 3.0};
+    check_sort(values, false, 0);
+    check_sort(values, true, 0);
+    check_sort(values, true, 2);
+  }
+
+  SECTION("deterministic ties") {
+    std::vector<float> values(1000, 1.f);
+    std::vector<float> sorted_values(values.size());
+    std::vector<long> sorted_indices(values.size());
+    lbann::key_index_sorter<float, long> sorter;
+    sorter.sort(values.data(), values.size(), true,
+                sorted_values.data(), sorted_indices.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+      REQUIRE(sorted_indices[i] == static_cast<long>(i));
+    }
+  }
+}
@@ -0,0 +1,56 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/mapped_file.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+TEST_CASE("Testing memory-mapped files", "[mapped_file][utilities]") {
+  using lbann::mapped_file;
+  const std::string path = "mapped_file_test.txt";
+  const std::string contents = "a,b,c\n1,2,3\n4,5,6";
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  REQUIRE(f != nullptr);
+  REQUIRE(std::fwrite(contents.data(), 1, contents.size(), f) == contents.size());
+  std::fclose(f);
+
+  SECTION("contents") {
+    mapped_file file(path);
+    REQUIRE(file.is_open());
+    REQUIRE(file.path() == path);
+    REQUIRE(file.size() == contents.size());
+    REQUIRE(std::memcmp(file.data(), contents.data(), contents.size()) == 0);
+    file.close();
+    REQUIRE_FALSE(file.is_open());
+    REQUIRE(file.data() == nullptr);
+  }
+
+  SECTION("move") {
+    mapped_file file(path);
+    mapped_file other(std::move(file));
+    REQUIRE_FALSE(file.is_open());
+    REQUIRE(other.is_open());
+    REQUIRE(std::string(other.data(), other.size()) == contents);
+    file = std::move(other);
+    REQUIRE(file.is_open());
+    REQUIRE_FALSE(other.is_open());
+  }
+
+  SECTION("empty file") {
+    const std::string empty_path = "mapped_file_test.empty";
+    std::FILE* g = std::fopen(empty_path.c_str(), "wb");
+    REQUIRE(g != nullptr);
+    std::fclose(g);
+    mapped_file file(empty_path);
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == 0);
+    REQUIRE(file.data() == nullptr);
+    std::remove(empty_path.c_str());
+  }
+
+  std::remove(path.c_str());
+}
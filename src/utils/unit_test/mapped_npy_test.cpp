@@ -0,0 +1,152 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/mapped_npy.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+/** Contents of a .npy file. */
+std::string make_npy(const std::string& descr,
+                     const std::string& shape,
+                     const void* data,
+                     size_t size) {
+  std::string header = ("{'descr': '" + descr + "', 'fortran_order': False, "
+                        + "'shape': " + shape + ", }");
+  header.append(63 - (10 + header.size()) % 64, ' ');
+  header += '\n';
+  const uint16_t header_size = header.size();
+  std::string npy("\x93NUMPY\x01\x00", 8);
+  npy.append(reinterpret_cast<const char*>(&header_size), 2);
+  npy += header;
+  npy.append(static_cast<const char*>(data), size);
+  return npy;
+}
+
+/** Append a little-endian integer. */
+template <typename T>
+void append(std::string& s, T x) {
+  s.append(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+/** Contents of a .npz file with one uncompressed member. */
+std::string make_npz(const std::string& key,
+                     const std::string& npy,
+                     uint16_t method = 0) {
+  const std::string name = key + ".npy";
+  std::string zip;
+  append<uint32_t>(zip, 0x04034b50);
+  append<uint16_t>(zip, 20);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, method);
+  append<uint32_t>(zip, 0);
+  append<uint32_t>(zip, 0);
+  append<uint32_t>(zip, npy.size());
+  append<uint32_t>(zip, npy.size());
+  append<uint16_t>(zip, name.size());
+  append<uint16_t>(zip, 0);
+  zip += name;
+  zip += npy;
+  const uint32_t cd_offset = zip.size();
+  append<uint32_t>(zip, 0x02014b50);
+  append<uint16_t>(zip, 20);
+  append<uint16_t>(zip, 20);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, method);
+  append<uint32_t>(zip, 0);
+  append<uint32_t>(zip, 0);
+  append<uint32_t>(zip, npy.size());
+  append<uint32_t>(zip, npy.size());
+  append<uint16_t>(zip, name.size());
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, 0);
+  append<uint32_t>(zip, 0);
+  append<uint32_t>(zip, 0);
+  zip += name;
+  const uint32_t cd_size = zip.size() - cd_offset;
+  append<uint32_t>(zip, 0x06054b50);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, 0);
+  append<uint16_t>(zip, 1);
+  append<uint16_t>(zip, 1);
+  append<uint32_t>(zip, cd_size);
+  append<uint32_t>(zip, cd_offset);
+  append<uint16_t>(zip, 0);
+  return zip;
+}
+
+void write_file(const std::string& path, const std::string& contents) {
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  REQUIRE(f != nullptr);
+  REQUIRE(std::fwrite(contents.data(), 1, contents.size(), f) == contents.size());
+  std::fclose(f);
+}
+
+} // namespace
+
+TEST_CASE("Testing memory-mapped numpy arrays", "[mapped_npy][utilities]") {
+  using lbann::DataType;
+  using lbann::mapped_npy_array;
+
+  std::vector<double> float64_data(24);
+  std::vector<int16_t> int16_data(24);
+  for (size_t i = 0; i < float64_data.size(); ++i) {
+    float64_data[i] = 0.25 * i;
+    int16_data[i] = int16_t(i) - 12;
+  }
+
+  SECTION(".npy file") {
+    const std::string path = "mapped_npy_test.npy";
+    write_file(path, make_npy("<f8", "(4, 3, 2)", float64_data.data(),
+                              float64_data.size() * sizeof(double)));
+    mapped_npy_array ary;
+    ary.open_npy(path);
+    REQUIRE(ary.is_open());
+    REQUIRE(ary.get_type() == 'f');
+    REQUIRE(ary.get_word_size() == 8);
+    REQUIRE(ary.get_shape() == std::vector<size_t>({4, 3, 2}));
+    REQUIRE(ary.get_num_rows() == 4);
+    REQUIRE(ary.get_row_size() == 6);
+    std::vector<DataType> row(6);
+    ary.copy_row(2, 0, 6, row.data());
+    for (size_t i = 0; i < row.size(); ++i) {
+      REQUIRE(row[i] == DataType(float64_data[12 + i]));
+    }
+    REQUIRE(ary.get_value(3, 5) == DataType(float64_data[23]));
+    REQUIRE_THROWS(ary.copy_row(4, 0, 1, row.data()));
+    REQUIRE_THROWS(ary.copy_row(0, 5, 2, row.data()));
+    std::remove(path.c_str());
+  }
+
+  SECTION(".npz file") {
+    const std::string path = "mapped_npy_test.npz";
+    const auto npy = make_npy("<i2", "(4, 6)", int16_data.data(),
+                              int16_data.size() * sizeof(int16_t));
+    write_file(path, make_npz("data", npy));
+    mapped_npy_array ary;
+    REQUIRE_FALSE(ary.open_npz(path, "labels"));
+    REQUIRE(ary.open_npz(path, "data"));
+    REQUIRE(ary.get_type() == 'i');
+    REQUIRE(ary.get_word_size() == 2);
+    std::vector<DataType> row(6);
+    ary.copy_row(1, 0, 6, row.data(), DataType(0.5));
+    for (size_t i = 0; i < row.size(); ++i) {
+      REQUIRE(row[i] == DataType(int16_data[6 + i]) * DataType(0.5));
+    }
+
+    // Compressed members are not mapped
+    write_file(path, make_npz("data", npy, 8));
+    REQUIRE_FALSE(ary.open_npz(path, "data"));
+    REQUIRE_FALSE(ary.is_open());
+    std::remove(path.c_str());
+  }
+
+}
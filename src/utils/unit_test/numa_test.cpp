@@ -0,0 +1,122 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/numa.hpp>
+
+#include <fstream>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+
+namespace {
+
+/** Two sockets, each a NUMA node with 4 cores and 2 hyperthreads per
+ *  core. CPUs i and i+8 are siblings. */
+lbann::cpu_topology make_dual_socket_topology() {
+  lbann::cpu_topology topo;
+  for (int cpu = 0; cpu < 16; ++cpu) {
+    const int core = cpu % 8;
+    topo.cpu_sockets.push_back(core / 4);
+    topo.cpu_cores.push_back(core);
+    topo.cpu_numa_nodes.push_back(core / 4);
+  }
+  return topo;
+}
+
+void write_file(const std::string& path, const std::string& contents) {
+  std::ofstream fs(path.c_str());
+  fs << contents << "\n";
+}
+
+} // namespace
+
+TEST_CASE("Testing CPU list parsing", "[numa][utilities]") {
+  using lbann::parse_cpu_list;
+  REQUIRE(parse_cpu_list("0") == std::vector<int>{0});
+  REQUIRE(parse_cpu_list("0-3,8,10-11")
+          == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+  REQUIRE(parse_cpu_list("").empty());
+}
+
+TEST_CASE("Testing topology detection", "[numa][utilities]") {
+  const std::string root = "numa_test_sysfs";
+  const std::string cpu_dir = root + "/devices/system/cpu/";
+  const std::string node_dir = root + "/devices/system/node/";
+  for (const auto& dir : {root, root + "/devices", root + "/devices/system",
+                          cpu_dir, node_dir,
+                          node_dir + "node0", node_dir + "node1"}) {
+    mkdir(dir.c_str(), 0755);
+  }
+  write_file(cpu_dir + "online", "0-3");
+  for (int cpu = 0; cpu < 4; ++cpu) {
+    const auto& dir = cpu_dir + "cpu" + std::to_string(cpu);
+    mkdir(dir.c_str(), 0755);
+    mkdir((dir + "/topology").c_str(), 0755);
+    write_file(dir + "/topology/physical_package_id", std::to_string(cpu / 2));
+    write_file(dir + "/topology/core_id", "0");
+  }
+  write_file(node_dir + "online", "0-1");
+  write_file(node_dir + "node0/cpulist", "0-1");
+  write_file(node_dir + "node1/cpulist", "2-3");
+
+  const auto& topo = lbann::detect_cpu_topology(root);
+  REQUIRE(topo.get_num_cpus() == 4);
+  REQUIRE(topo.get_num_sockets() == 2);
+  REQUIRE(topo.get_num_cores() == 2);
+  REQUIRE(topo.get_num_numa_nodes() == 2);
+  REQUIRE(topo.cpu_cores[0] == topo.cpu_cores[1]);
+  REQUIRE(topo.cpu_cores[0] != topo.cpu_cores[2]);
+  REQUIRE(topo.get_numa_node(3) == 1);
+  REQUIRE(topo.get_numa_node(4) == -1);
+
+  SECTION("Missing sysfs") {
+    const auto& fallback = lbann::detect_cpu_topology("numa_test_missing");
+    REQUIRE(fallback.get_num_cpus() > 0);
+    REQUIRE(fallback.get_num_sockets() == 1);
+    REQUIRE(fallback.get_num_numa_nodes() == 1);
+    REQUIRE(fallback.get_num_cores() == fallback.get_num_cpus());
+  }
+}
+
+TEST_CASE("Testing thread placement", "[numa][utilities]") {
+  using lbann::make_thread_placement;
+  const auto& topo = make_dual_socket_topology();
+  std::vector<int> all_cpus;
+  for (int cpu = 0; cpu < 16; ++cpu) { all_cpus.push_back(cpu); }
+
+  SECTION("Compute and I/O threads use disjoint cores") {
+    const auto& placement = make_thread_placement(topo, all_cpus, 6, 2);
+    REQUIRE(placement.compute_cpus == std::vector<int>({0, 1, 2, 4, 5, 6}));
+    REQUIRE(placement.io_cpus == std::vector<int>({3, 7}));
+  }
+
+  SECTION("I/O threads fall back to hyperthread siblings") {
+    const auto& placement = make_thread_placement(topo, all_cpus, 8, 3);
+    REQUIRE(placement.compute_cpus.size() == 8);
+    REQUIRE(placement.io_cpus.size() == 3);
+    std::set<int> cores;
+    for (const auto& cpu : placement.compute_cpus) {
+      REQUIRE(cpu < 8);
+      cores.insert(topo.cpu_cores[cpu]);
+    }
+    REQUIRE(cores.size() == 8);
+    for (const auto& cpu : placement.io_cpus) {
+      REQUIRE(cpu >= 8);
+    }
+  }
+
+  SECTION("Placement is restricted to allowed CPUs") {
+    const std::vector<int> socket1 = {4, 5, 6, 7, 12, 13, 14, 15};
+    const auto& placement = make_thread_placement(topo, socket1, 4, 4);
+    REQUIRE(placement.compute_cpus == std::vector<int>({4, 5, 6, 7}));
+    REQUIRE(placement.io_cpus == std::vector<int>({12, 13, 14, 15}));
+  }
+
+  SECTION("Oversubscribed compute threads reuse CPUs") {
+    const auto& placement = make_thread_placement(topo, {0, 8}, 3, 1);
+    REQUIRE(placement.compute_cpus == std::vector<int>({0, 8, 0}));
+    REQUIRE(placement.io_cpus.empty());
+  }
+
+}
@@ -0,0 +1,81 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/packed_dataset.hpp>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("Testing packed datasets", "[packed_dataset][utilities]") {
+  using lbann::packed_dataset;
+  using lbann::packed_sample;
+  std::mt19937 gen(20191019);
+  std::uniform_int_distribution<int> byte_dist(0, 255);
+  std::uniform_int_distribution<size_t> size_dist(1, 10000);
+
+  // Write shards and index
+  const std::vector<std::string> shards = {"packed_dataset_test.0.pack",
+                                           "packed_dataset_test.1.pack"};
+  const std::string index_path = "packed_dataset_test.index";
+  std::vector<packed_sample> samples;
+  std::vector<std::vector<uint8_t>> data;
+  for (size_t shard = 0; shard < shards.size(); ++shard) {
+    std::FILE* f = std::fopen(shards[shard].c_str(), "wb");
+    REQUIRE(f != nullptr);
+    uint64_t offset = 0;
+    for (int i = 0; i < 50; ++i) {
+      std::vector<uint8_t> sample(size_dist(gen));
+      for (auto& x : sample) { x = byte_dist(gen); }
+      REQUIRE(std::fwrite(sample.data(), 1, sample.size(), f) == sample.size());
+      samples.push_back({offset, static_cast<uint32_t>(sample.size()),
+                         static_cast<uint32_t>(shard), i % 10, 0});
+      offset += sample.size();
+      data.push_back(sample);
+    }
+    std::fclose(f);
+  }
+  packed_dataset::write_index(index_path, shards, samples);
+
+  SECTION("index") {
+    REQUIRE(packed_dataset::is_index_file(index_path));
+    REQUIRE_FALSE(packed_dataset::is_index_file(shards[0]));
+    packed_dataset ds(index_path);
+    REQUIRE(ds.get_num_samples() == samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+      REQUIRE(ds.get_sample(i).offset == samples[i].offset);
+      REQUIRE(ds.get_sample(i).size == samples[i].size);
+      REQUIRE(ds.get_sample(i).label == samples[i].label);
+    }
+  }
+
+  SECTION("reading samples") {
+    packed_dataset ds(index_path);
+    ds.max_gap = 20000;
+    ds.max_read_size = 100000;
+    std::uniform_int_distribution<size_t> index_dist(0, samples.size() - 1);
+    for (int iter = 0; iter < 10; ++iter) {
+      std::vector<size_t> batch(16);
+      for (auto& i : batch) { i = index_dist(gen); }
+      ds.prefetch(batch);
+      for (const auto& i : batch) {
+        const uint8_t* buf = ds.get_prefetched(i);
+        REQUIRE(buf != nullptr);
+        REQUIRE(std::vector<uint8_t>(buf, buf + data[i].size()) == data[i]);
+      }
+    }
+    packed_dataset copy(ds);
+    for (size_t i = 0; i < samples.size(); ++i) {
+      std::vector<uint8_t> buf(samples[i].size);
+      copy.read_sample(i, buf.data());
+      REQUIRE(buf == data[i]);
+    }
+  }
+
+  std::remove(index_path.c_str());
+  for (const auto& shard : shards) {
+    std::remove(shard.c_str());
+  }
+}
@@ -0,0 +1,94 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/sample_list_index.hpp>
+#include <lbann/utils/mapped_file.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("Testing binary sample list indices", "[sample_list_index][utilities]") {
+  using lbann::sample_list_index;
+  const std::string path = "sample_list_index_test.bin";
+
+  lbann::sample_list_index_writer writer("/data/jag");
+  REQUIRE(writer.add_file("a.bundle", 3) == 0);
+  writer.add_sample(0, "RUN_0");
+  writer.add_sample(0, "RUN_2");
+  REQUIRE(writer.add_file("b.bundle", 2) == 1);
+  writer.add_sample(1, "RUN_1");
+  REQUIRE_THROWS(writer.add_sample(2, "RUN_3"));
+  writer.write(path);
+  REQUIRE(sample_list_index::is_index_file(path));
+
+  SECTION("lookup") {
+    lbann::mapped_file file(path);
+    sample_list_index index;
+    REQUIRE_FALSE(index.is_attached());
+    index.attach(file.data(), file.size(), path);
+    REQUIRE(index.is_attached());
+    REQUIRE(index.get_file_dir() == "/data/jag");
+    REQUIRE(index.get_num_files() == 2);
+    REQUIRE(index.get_file_name(0) == "a.bundle");
+    REQUIRE(index.get_file_name(1) == "b.bundle");
+    REQUIRE(index.get_file_num_samples(0) == 3);
+    REQUIRE(index.get_file_num_samples(1) == 2);
+    REQUIRE(index.get_num_samples() == 3);
+    REQUIRE(index.get_sample_file_id(0) == 0);
+    REQUIRE(index.get_sample_name(0) == "RUN_0");
+    REQUIRE(index.get_sample_file_id(1) == 0);
+    REQUIRE(index.get_sample_name(1) == "RUN_2");
+    REQUIRE(index.get_sample_file_id(2) == 1);
+    REQUIRE(index.get_sample_name(2) == "RUN_1");
+  }
+
+  SECTION("invalid indices") {
+    lbann::mapped_file file(path);
+    sample_list_index index;
+    REQUIRE_THROWS(index.attach(file.data(), 16, path));
+    const std::string text = "CONDUIT_HDF5_INCLUSION\n";
+    REQUIRE_THROWS(index.attach(text.data(), text.size(), "text"));
+    REQUIRE_FALSE(sample_list_index::is_index_file("sample_list_index_test.missing"));
+  }
+
+  SECTION("out-of-range ids") {
+    lbann::mapped_file file(path);
+    sample_list_index index;
+    index.attach(file.data(), file.size(), path);
+    REQUIRE_THROWS(index.get_file_name(2));
+    REQUIRE_THROWS(index.get_file_num_samples(2));
+    REQUIRE_THROWS(index.get_sample_file_id(3));
+    REQUIRE_THROWS(index.get_sample_name(3));
+
+    // Point the first sample at a file that is not in the index
+    // (the sample table offset is at byte 40 of the header)
+    lbann::mapped_file file2(path);
+    std::string buf(file2.data(), file2.size());
+    uint64_t sample_table_offset;
+    std::memcpy(&sample_table_offset, &buf[40], sizeof(sample_table_offset));
+    const uint32_t bad_file_id = 7;
+    std::memcpy(&buf[sample_table_offset], &bad_file_id, sizeof(bad_file_id));
+    sample_list_index corrupt;
+    corrupt.attach(buf.data(), buf.size(), "corrupt");
+    REQUIRE_THROWS(corrupt.get_sample_file_id(0));
+    REQUIRE(corrupt.get_sample_file_id(1) == 0);
+  }
+
+  SECTION("slices") {
+    size_t begin, end, next = 0;
+    for (size_t slice = 0; slice < 4; ++slice) {
+      sample_list_index::get_slice(10, 4, slice, begin, end);
+      REQUIRE(begin == next);
+      REQUIRE(end - begin == (slice < 2 ? 3u : 2u));
+      next = end;
+    }
+    REQUIRE(next == 10);
+    sample_list_index::get_slice(2, 4, 3, begin, end);
+    REQUIRE(begin == end);
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,100 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+#include <lbann_config.hpp>
+
+#ifdef LBANN_HAS_CONDUIT
+// File being tested
+#include <conduit/conduit.hpp>
+#include <lbann/data_readers/sample_list_open_files.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct test_file_handle {
+  int id = 0;
+};
+
+} // namespace
+
+namespace lbann {
+template <>
+inline test_file_handle uninitialized_file_handle<test_file_handle>() {
+  return test_file_handle();
+}
+} // namespace lbann
+
+namespace {
+
+/** Sample list that records which files are opened. */
+class test_sample_list
+  : public lbann::sample_list_open_files<std::string, test_file_handle> {
+public:
+  bool is_file_handle_valid(const test_file_handle& h) const override {
+    return h.id > 0;
+  }
+  std::vector<std::string> opened_files;
+protected:
+  void obtain_sample_names(test_file_handle& h,
+                           std::vector<std::string>& sample_names) const override {
+    sample_names.clear();
+  }
+  test_file_handle open_file_handle_for_read(const std::string& path) override {
+    opened_files.push_back(path);
+    test_file_handle h;
+    h.id = opened_files.size();
+    return h;
+  }
+  void close_file_handle(test_file_handle& h) override {}
+  void clear_file_handle(test_file_handle& h) override {
+    h = test_file_handle();
+  }
+};
+
+} // namespace
+
+TEST_CASE("Testing sample lists with a non-zero slice start",
+          "[sample_list_index][utilities]") {
+  using lbann::sample_list_index;
+  const std::string path = "sample_list_open_files_test.bin";
+  const std::vector<std::string> files = {"sample_list_open_files_test_a.bundle",
+                                          "sample_list_open_files_test_b.bundle"};
+  for (const auto& f : files) {
+    std::ofstream(f).put('\0');
+  }
+  lbann::sample_list_index_writer writer(".");
+  for (size_t f = 0; f < files.size(); ++f) {
+    writer.add_file(files[f], 2);
+    writer.add_sample(f, "RUN_" + std::to_string(2*f));
+    writer.add_sample(f, "RUN_" + std::to_string(2*f+1));
+  }
+  writer.write(path);
+
+  // A shared index keeps global sample indices, so the second of two
+  // ranks starts in the second file
+  test_sample_list list;
+  list.load_index(path);
+  REQUIRE(list.size() == 4);
+  size_t begin, end;
+  sample_list_index::get_slice(list.size(), 2, 1, begin, end);
+  REQUIRE(begin == 2);
+  REQUIRE(list.get_sample_file_id(begin) == 1);
+
+  SECTION("only the file of the first local sample is opened") {
+    list.open_samples_file_handle(begin, true);
+    REQUIRE(list.is_file_handle_valid(list.get_samples_file_handle(1)));
+    REQUIRE_FALSE(list.is_file_handle_valid(list.get_samples_file_handle(0)));
+    REQUIRE(list.opened_files.size() == 1);
+    REQUIRE(list.opened_files[0].find(files[1]) != std::string::npos);
+  }
+
+  std::remove(path.c_str());
+  for (const auto& f : files) {
+    std::remove(f.c_str());
+  }
+}
+#endif // LBANN_HAS_CONDUIT
@@ -0,0 +1,137 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/simd_math.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+/** Number of representable floats between a and b. */
+std::int64_t ulp_distance(float a, float b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return (std::isnan(a) && std::isnan(b)) ? 0 : std::numeric_limits<std::int64_t>::max();
+  }
+  auto to_ordered = [] (float x) {
+    std::int32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    return (i < 0 ?
+            std::int64_t(std::numeric_limits<std::int32_t>::min()) - i :
+            std::int64_t(i));
+  };
+  return std::abs(to_ordered(a) - to_ordered(b));
+}
+
+/** Inputs spread over [-max_abs, max_abs] with many small values. */
+std::vector<float> make_inputs(float max_abs, bool positive) {
+  std::mt19937 gen(20190801);
+  std::uniform_real_distribution<float> uniform(-max_abs, max_abs);
+  std::uniform_real_distribution<float> log_uniform(-20.f, std::log2(max_abs));
+  std::vector<float> x;
+  for (int i = 0; i < 50000; ++i) {
+    x.push_back(uniform(gen));
+    const float y = std::exp2(log_uniform(gen));
+    x.push_back(i % 2 == 0 ? y : -y);
+  }
+  if (positive) {
+    for (auto& v : x) { v = std::fabs(v); }
+  }
+  return x;
+}
+
+/** Check maximum ULP error against a double-precision reference,
+ *  and that leftover entries match full vector lanes. */
+template <typename Function, typename Reference>
+void check_function(Function f, Reference ref,
+                    const std::vector<float>& x,
+                    std::int64_t max_ulps) {
+  std::vector<float> y(x.size());
+  f(x.data(), y.data(), x.size());
+  std::int64_t max_error = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    const auto y_ref = static_cast<float>(ref(static_cast<double>(x[i])));
+    max_error = std::max(max_error, ulp_distance(y[i], y_ref));
+  }
+  CHECK(max_error <= max_ulps);
+  for (size_t i = 0; i < 100; ++i) {
+    float y_single;
+    f(&x[i], &y_single, 1);
+    CHECK(ulp_distance(y_single, y[i]) == 0);
+  }
+}
+
+} // namespace
+
+TEST_CASE("Testing vectorized math functions", "[simd][utilities]") {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  SECTION("exp") {
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_exp(x, y, n); },
+      [] (double x) { return std::exp(x); },
+      make_inputs(103.f, false), 1);
+    const std::vector<float> x = {0.f, -inf, inf, nan, 100.f, -110.f};
+    std::vector<float> y(x.size());
+    lbann::vector_exp(x.data(), y.data(), x.size());
+    CHECK(y[0] == 1.f);
+    CHECK(y[1] == 0.f);
+    CHECK(y[2] == inf);
+    CHECK(std::isnan(y[3]));
+    CHECK(y[4] == inf);
+    CHECK(y[5] == 0.f);
+  }
+
+  SECTION("log") {
+    auto x = make_inputs(1e30f, true);
+    x.push_back(std::numeric_limits<float>::denorm_min());
+    x.push_back(1e-40f);
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_log(x, y, n); },
+      [] (double x) { return std::log(x); },
+      x, 1);
+    const std::vector<float> special = {1.f, 0.f, -1.f, inf, nan};
+    std::vector<float> y(special.size());
+    lbann::vector_log(special.data(), y.data(), special.size());
+    CHECK(y[0] == 0.f);
+    CHECK(y[1] == -inf);
+    CHECK(std::isnan(y[2]));
+    CHECK(y[3] == inf);
+    CHECK(std::isnan(y[4]));
+  }
+
+  SECTION("tanh") {
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_tanh(x, y, n); },
+      [] (double x) { return std::tanh(x); },
+      make_inputs(20.f, false), 2);
+  }
+
+  SECTION("sigmoid") {
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_sigmoid(x, y, n); },
+      [] (double x) { return 1 / (1 + std::exp(-x)); },
+      make_inputs(100.f, false), 3);
+  }
+
+  SECTION("softplus") {
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_softplus(x, y, n); },
+      [] (double x) { return std::max(x, 0.) + std::log1p(std::exp(-std::fabs(x))); },
+      make_inputs(100.f, false), 3);
+  }
+
+  SECTION("erf") {
+    check_function(
+      [] (const float* x, float* y, El::Int n) { lbann::vector_erf(x, y, n); },
+      [] (double x) { return std::erf(x); },
+      make_inputs(6.f, false), 3);
+  }
+
+}
@@ -0,0 +1,58 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/top_k.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("Testing top-k selection", "[top-k][utilities]") {
+  using lbann::top_k_entry;
+  std::mt19937 gen(20190612);
+  std::uniform_int_distribution<int> dist(0, 100);
+
+  SECTION("select_top_k") {
+    for (const El::Int size : {1, 5, 16, 100, 1000}) {
+      for (const El::Int k : {1, 3, 10}) {
+        std::vector<lbann::DataType> values(size);
+        for (auto& v : values) { v = dist(gen); }
+        std::vector<top_k_entry> top_entries(k);
+        lbann::select_top_k(values.data(), size, k, 3, 2, top_entries.data());
+
+        std::vector<top_k_entry> ref(std::max(size, k));
+        for (El::Int i = 0; i < size; ++i) {
+          ref[i].value = values[i];
+          ref[i].index = 3 + 2 * i;
+        }
+        std::sort(ref.begin(), ref.end(), top_k_entry::compare);
+        for (El::Int i = 0; i < k; ++i) {
+          REQUIRE(top_entries[i].value == ref[i].value);
+          REQUIRE(top_entries[i].index == ref[i].index);
+        }
+      }
+    }
+  }
+
+  SECTION("merge_top_k") {
+    const El::Int k = 8;
+    std::vector<top_k_entry> a(k), b(k), out(k), ref(2*k);
+    for (El::Int i = 0; i < k; ++i) {
+      a[i].value = dist(gen);
+      a[i].index = 2 * i;
+      b[i].value = dist(gen);
+      b[i].index = 2 * i + 1;
+      ref[i] = a[i];
+      ref[k+i] = b[i];
+    }
+    std::sort(a.begin(), a.end(), top_k_entry::compare);
+    std::sort(b.begin(), b.end(), top_k_entry::compare);
+    std::sort(ref.begin(), ref.end(), top_k_entry::compare);
+    lbann::merge_top_k(a.data(), b.data(), k, out.data());
+    for (El::Int i = 0; i < k; ++i) {
+      REQUIRE(out[i].value == ref[i].value);
+      REQUIRE(out[i].index == ref[i].index);
+    }
+  }
+}
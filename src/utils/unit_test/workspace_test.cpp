@@ -0,0 +1,72 @@
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/workspace.hpp>
+
+#include <cstdint>
+
+TEST_CASE("Testing workspace manager", "[workspace][utilities]") {
+  using lbann::workspace_manager;
+  workspace_manager workspace;
+  workspace.declare(100);
+  workspace.declare(1000);
+  workspace.declare(10);
+  workspace.setup(2);
+
+  SECTION("Slots hold the largest declared buffer") {
+    REQUIRE(workspace.get_slot_size() == 1024);
+    REQUIRE(workspace.get_num_slots() == 2);
+    REQUIRE(workspace.get_total_size() == 2048);
+  }
+
+  SECTION("Buffers are aligned and come from the arena") {
+    auto a = workspace.borrow(1000);
+    auto b = workspace.borrow(8);
+    REQUIRE(a.size() == 1000);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(a.get<float>()) % workspace_manager::alignment == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(b.get<float>()) % workspace_manager::alignment == 0);
+    REQUIRE(a.get<char>() != b.get<char>());
+    REQUIRE(workspace.get_num_borrows() == 2);
+    REQUIRE(workspace.get_num_fallbacks() == 0);
+  }
+
+  SECTION("Released slots are reused") {
+    char* ptr = nullptr;
+    {
+      auto a = workspace.borrow(64);
+      ptr = a.get<char>();
+    }
+    auto b = workspace.borrow(64);
+    REQUIRE(b.get<char>() == ptr);
+    workspace_manager::buffer c;
+    c = std::move(b);
+    REQUIRE(c.get<char>() == ptr);
+    REQUIRE(workspace.get_num_borrows() == 2);
+  }
+
+  SECTION("Heap allocation when slots are exhausted or too small") {
+    auto a = workspace.borrow(16);
+    auto b = workspace.borrow(16);
+    auto c = workspace.borrow(16);
+    auto d = workspace.borrow(4096);
+    REQUIRE(workspace.get_num_borrows() == 2);
+    REQUIRE(workspace.get_num_fallbacks() == 2);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(d.get<float>()) % workspace_manager::alignment == 0);
+    d.get<char>()[4095] = 1;
+    workspace.reset_counters();
+    REQUIRE(workspace.get_num_borrows() == 0);
+    REQUIRE(workspace.get_num_fallbacks() == 0);
+  }
+
+  SECTION("Copies have their own arena") {
+    auto a = workspace.borrow(16);
+    auto b = workspace.borrow(16);
+    workspace_manager copy(workspace);
+    REQUIRE(copy.get_total_size() == workspace.get_total_size());
+    auto c = copy.borrow(16);
+    REQUIRE(copy.get_num_borrows() == 1);
+    REQUIRE(copy.get_num_fallbacks() == 0);
+  }
+
+}
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/workspace.hpp"
+#include "lbann/utils/exception.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace lbann {
+
+constexpr size_t workspace_manager::alignment;
+
+namespace {
+
+/** Granularity of first-touch initialization, in bytes. */
+constexpr size_t first_touch_block_size = 4096;
+
+} // namespace
+
+workspace_manager::buffer::buffer(buffer&& other)
+  : m_workspace(other.m_workspace),
+    m_slot(other.m_slot),
+    m_data(other.m_data),
+    m_size(other.m_size) {
+  other.m_workspace = nullptr;
+  other.m_slot = -1;
+  other.m_data = nullptr;
+  other.m_size = 0;
+}
+
+workspace_manager::buffer&
+workspace_manager::buffer::operator=(buffer&& other) {
+  if (this != &other) {
+    release();
+    std::swap(m_workspace, other.m_workspace);
+    std::swap(m_slot, other.m_slot);
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+  }
+  return *this;
+}
+
+workspace_manager::buffer::~buffer() {
+  release();
+}
+
+void workspace_manager::buffer::release() {
+  if (m_slot >= 0) {
+    m_workspace->m_slot_in_use[m_slot].store(false, std::memory_order_release);
+  } else {
+    std::free(m_data);
+  }
+  m_workspace = nullptr;
+  m_slot = -1;
+  m_data = nullptr;
+  m_size = 0;
+}
+
+workspace_manager::workspace_manager(const workspace_manager& other)
+  : m_slot_size(other.m_slot_size) {
+  if (other.m_num_slots > 0) {
+    setup(other.m_num_slots);
+  }
+}
+
+workspace_manager& workspace_manager::operator=(const workspace_manager& other) {
+  if (this != &other) {
+    m_slot_size = other.m_slot_size;
+    m_num_slots = 0;
+    m_arena.reset();
+    m_slot_in_use.reset();
+    if (other.m_num_slots > 0) {
+      setup(other.m_num_slots);
+    }
+  }
+  return *this;
+}
+
+void workspace_manager::declare(size_t size) {
+  if (m_num_slots > 0) {
+    LBANN_ERROR("attempted to declare a workspace buffer "
+                "after the workspace was set up");
+  }
+  m_slot_size = std::max(m_slot_size, align(size));
+}
+
+void workspace_manager::setup(int num_slots) {
+  if (m_num_slots > 0) {
+    LBANN_ERROR("attempted to set up workspace twice");
+  }
+  m_num_slots = (m_slot_size > 0 ? std::max(num_slots, 1) : 0);
+  m_slot_in_use.reset(new std::atomic<bool>[m_num_slots]);
+  for (int i = 0; i < m_num_slots; ++i) {
+    m_slot_in_use[i].store(false);
+  }
+  const size_t total_size = get_total_size();
+  if (total_size == 0) { return; }
+  m_arena.reset(allocate(total_size));
+
+  // First-touch initialization
+  // Note: Pages are placed on the NUMA node of the thread that first
+  // writes them, so every thread zeroes part of the arena.
+  auto* arena = m_arena.get();
+  const El::Int num_blocks = (total_size + first_touch_block_size - 1) / first_touch_block_size;
+  #pragma omp parallel for schedule(static)
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const size_t begin = block * first_touch_block_size;
+    const size_t end = std::min(begin + first_touch_block_size, total_size);
+    std::memset(arena + begin, 0, end - begin);
+  }
+
+}
+
+workspace_manager::buffer workspace_manager::borrow(size_t size) {
+  buffer b;
+  b.m_size = size;
+  if (size == 0) { return b; }
+  if (size <= m_slot_size) {
+    for (int i = 0; i < m_num_slots; ++i) {
+      if (!m_slot_in_use[i].exchange(true, std::memory_order_acquire)) {
+        b.m_workspace = this;
+        b.m_slot = i;
+        b.m_data = m_arena.get() + i * m_slot_size;
+        ++m_num_borrows;
+        return b;
+      }
+    }
+  }
+  b.m_data = allocate(size);
+  ++m_num_fallbacks;
+  return b;
+}
+
+void workspace_manager::reset_counters() {
+  m_num_borrows = 0;
+  m_num_fallbacks = 0;
+}
+
+unsigned char* workspace_manager::allocate(size_t size) {
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, align(size)) != 0) {
+    LBANN_ERROR("could not allocate " + std::to_string(size) + " bytes");
+  }
+  return static_cast<unsigned char*>(ptr);
+}
+
+} // namespace lbann